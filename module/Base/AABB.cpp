@@ -793,7 +793,7 @@ void Register_AABB(HSQUIRRELVM vm)
     typedef AABB::Value Val;
 
     RootTable(vm).Bind(Typename::Str,
-        Class< AABB >(vm, Typename::Str)
+        Class< AABB, InlineAllocator< AABB > >(vm, Typename::Str)
         // Constructors
         .Ctor()
         .Ctor< const AABB & >()
@@ -551,7 +551,7 @@ void Register_Circle(HSQUIRRELVM vm)
     typedef Circle::Value Val;
 
     RootTable(vm).Bind(Typename::Str,
-        Class< Circle >(vm, Typename::Str)
+        Class< Circle, InlineAllocator< Circle > >(vm, Typename::Str)
         // Constructors
         .Ctor()
         .Ctor< Val >()
@@ -770,7 +770,7 @@ void Register_Quaternion(HSQUIRRELVM vm)
     typedef Quaternion::Value Val;
 
     RootTable(vm).Bind(Typename::Str,
-        Class< Quaternion >(vm, Typename::Str)
+        Class< Quaternion, InlineAllocator< Quaternion > >(vm, Typename::Str)
         // Constructors
         .Ctor()
         .Ctor< Val >()
@@ -526,7 +526,7 @@ void Register_Sphere(HSQUIRRELVM vm)
     typedef Sphere::Value Val;
 
     RootTable(vm).Bind(Typename::Str,
-        Class< Sphere >(vm, Typename::Str)
+        Class< Sphere, InlineAllocator< Sphere > >(vm, Typename::Str)
         // Constructors
         .Ctor()
         .Ctor< Val >()
@@ -428,7 +428,7 @@ void Register_Vector2(HSQUIRRELVM vm)
     typedef Vector2::Value Val;
 
     RootTable(vm).Bind(Typename::Str,
-        Class< Vector2 >(vm, Typename::Str)
+        Class< Vector2, InlineAllocator< Vector2 > >(vm, Typename::Str)
         // Constructors
         .Ctor()
         .Ctor< Val >()
@@ -3,9 +3,13 @@
 #include "Logger.hpp"
 #include "Core/Areas.hpp"
 #include "Core/Signal.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Buffer.hpp"
+#include "Core/FrameBudget.hpp"
 #include "Core/ThreadPool.hpp"
 #include "Library/IO/Buffer.hpp"
+#include "Library/IO/BufferView.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include "Entity/Blip.hpp"
@@ -43,12 +47,15 @@ extern void AnnounceTerminate();
 extern void InitializeTasks();
 extern void InitializeRoutines();
 extern void TerminateAreas();
+extern void TerminateSpatial();
 extern void TerminateTasks();
 extern void TerminatePrivileges();
 extern void TerminateRoutines();
 extern void TerminateCommands();
 extern void TerminateSignals();
 extern void TerminateNet();
+extern void TerminateCURL();
+extern void TerminateSQLite();
 #ifdef SQMOD_DISCORD
     extern void TerminateDiscord();
 #endif
@@ -186,8 +193,11 @@ Core::Core() noexcept
     , m_LockPostLoadSignal(false)
     , m_LockUnloadSignal(false)
     , m_EmptyInit(false)
+    , m_ScriptCache()
     , m_Verbosity(1)
     , m_ClientData()
+    , m_ClientDataView(false)
+    , m_GCPause(200)
     , m_NullBlip()
     , m_NullCheckpoint()
     , m_NullKeyBind()
@@ -250,6 +260,18 @@ bool Core::Initialize()
         ThreadPool::Get().Terminate();
         return false;
     } else cLogDbg(m_Verbosity >= 1, "Initialized %zu worker threads", ThreadPool::Get().GetThreadCount());
+    // Limit how many items of each subsystem can run at the same time
+    ThreadPool::Get().SetLaneLimit(TPL_HTTP, static_cast< uint32_t >(conf.GetLongValue("General", "WorkerLimitHTTP", 0)));
+    ThreadPool::Get().SetLaneLimit(TPL_DATABASE, static_cast< uint32_t >(conf.GetLongValue("General", "WorkerLimitDatabase", 0)));
+    // Limit how much work each main-thread drain can perform in a single frame
+    FrameBudget::Get().SetFrameTime(conf.GetLongValue("FrameBudget", "FrameTime", 0));
+    for (size_t i = 0; i < FrameBudget::Get().GetCount(); ++i)
+    {
+        FrameBudget::Stage & s = FrameBudget::Get().GetStage(static_cast< SQInteger >(i));
+        // Configuration keys are prefixed with the name of the stage (i.e. ThreadsItems, ThreadsTime)
+        s.mItems = static_cast< size_t >(std::max(conf.GetLongValue("FrameBudget", (s.mName + "Items").c_str(), static_cast< long >(s.mItems)), 0L));
+        s.mTime = std::max(conf.GetLongValue("FrameBudget", (s.mName + "Time").c_str(), static_cast< long >(s.mTime)), 0L);
+    }
 #ifdef VCMP_ENABLE_OFFICIAL
     // See if debugging options should be enabled
     m_Official = conf.GetBoolValue("Squirrel", "OfficialCompatibility", m_Official);
@@ -258,8 +280,35 @@ bool Core::Initialize()
     m_Debugging = conf.GetBoolValue("Squirrel", "Debugging", m_Debugging);
     // Configure the empty initialization
     m_EmptyInit = conf.GetBoolValue("Squirrel", "EmptyInit", false);
+    // Configure where the byte code of compiled scripts is cached
+    m_ScriptCache = conf.GetValue("Squirrel", "ScriptCache", "");
+    // Configure whether client script data is viewed in place or copied into a buffer
+    m_ClientDataView = conf.GetBoolValue("Squirrel", "ClientDataView", m_ClientDataView);
+    // Configure when the cyclic garbage collection starts
+    SetGCPause(conf.GetLongValue("Squirrel", "GCPause", static_cast< long >(m_GCPause)));
     // Configure the verbosity level
     m_Verbosity = conf.GetLongValue("Log", "VerbosityLevel", 1);
+    // Configure the log file writer before the file is opened
+    Logger::Get().SetBufferSlots(static_cast< size_t >(conf.GetLongValue("Log", "BufferSlots", 4096)));
+    Logger::Get().SetFlushInterval(static_cast< uint32_t >(conf.GetLongValue("Log", "FlushInterval", 200)));
+    Logger::Get().SetRotateSize(static_cast< uint64_t >(conf.GetLongValue("Log", "RotateSize", 0)));
+    Logger::Get().SetRotateInterval(static_cast< uint32_t >(conf.GetLongValue("Log", "RotateInterval", 0)));
+    {
+        const String overflow(conf.GetValue("Log", "Overflow", "count"));
+        // Identify the overflow policy
+        if (overflow == "drop")
+        {
+            Logger::Get().SetOverflow(LOGO_DROP);
+        }
+        else if (overflow == "block")
+        {
+            Logger::Get().SetOverflow(LOGO_BLOCK);
+        }
+        else
+        {
+            Logger::Get().SetOverflow(LOGO_COUNT);
+        }
+    }
     // Initialize the log filename
     Logger::Get().SetLogFilename(conf.GetValue("Log", "Filename", nullptr));
     // Configure the logging timestamps
@@ -547,6 +596,9 @@ void Core::Terminate(bool shutdown)
     // Release all managed areas
     TerminateAreas();
     cLogDbg(m_Verbosity >= 2, "Areas terminated");
+    // Forget the position of all entities
+    TerminateSpatial();
+    cLogDbg(m_Verbosity >= 2, "Spatial index terminated");
     // Release privilege managers
     TerminatePrivileges();
     cLogDbg(m_Verbosity >= 2, "Privileges terminated");
@@ -556,11 +608,17 @@ void Core::Terminate(bool shutdown)
     // Release network
     TerminateNet();
     cLogDbg(m_Verbosity >= 1, "Network terminated");
+    // Abort pending HTTP transfers and complete them
+    TerminateCURL();
+    cLogDbg(m_Verbosity >= 1, "HTTP transfers terminated");
     // Release DPP
 #ifdef SQMOD_DISCORD
     TerminateDiscord();
     cLogDbg(m_Verbosity >= 1, "Discord terminated");
 #endif
+    // Commit queries that were left to the SQLite writers
+    TerminateSQLite();
+    cLogDbg(m_Verbosity >= 1, "SQLite writers terminated");
     // Release Poco statement results
     TerminatePocoNet();
     TerminatePocoData();
@@ -738,6 +796,55 @@ Core::Scripts::iterator Core::FindPendingScript(const SQChar * src)
     return m_PendingScripts.end();
 }
 
+// ------------------------------------------------------------------------------------------------
+LightObj & Core::GetClientDataBuffer()
+{
+    // A view that no longer borrows anything is kept around for reuse only
+    if (m_ClientDataView && !m_ClientData.IsNull() && !m_ClientData.CastI< SqBufferView >()->IsValid())
+    {
+        return NullLightObj();
+    }
+    // Return the current buffer or view, if any
+    return m_ClientData;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t Core::CollectGarbage(FrameSlice & slice)
+{
+    // Is there a virtual machine and is the collection enabled?
+    if (!m_VM || m_GCPause <= 0)
+    {
+        return 0;
+    }
+    SQGCStats stats{};
+    sq_getgcstats(m_VM, &stats);
+    // Wait for the heap to grow enough before starting a new cycle
+    if (stats.phase == SQGC_IDLE && stats.objects < (stats.live * m_GCPause) / 100)
+    {
+        return 0;
+    }
+    // Whatever time is left in the slice
+    const int64_t time = slice.mDeadline > 0 ? std::max(slice.mDeadline - FrameSlice::Now(), int64_t{1}) : 0;
+    // Let the virtual machine do its part
+    slice.mCount += static_cast< size_t >(sq_gcstep(m_VM, static_cast< SQInteger >(slice.mLimit), time));
+    // Is the cycle still going?
+    sq_getgcstats(m_VM, &stats);
+    if (stats.phase != SQGC_IDLE)
+    {
+        slice.mHit = true;
+        // Roughly what is left to trace
+        return static_cast< size_t >(std::max(stats.live - stats.traced, SQInteger{1}));
+    }
+    // Cycle completed
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ProcessGC(FrameSlice & slice)
+{
+    return Core::Get().CollectGarbage(slice);
+}
+
 // ------------------------------------------------------------------------------------------------
 bool Core::LoadScript(const SQChar * filepath, Function & cb, LightObj & ctx, bool delay)
 {
@@ -800,7 +907,15 @@ bool Core::LoadScript(const SQChar * filepath, Function & cb, LightObj & ctx, bo
         // Attempt to load and compile the script file
         try
         {
-            m_Scripts.back().mExec.CompileFile(path);
+            // Was the byte code loaded from the cache?
+            if (m_Scripts.back().Compile(m_ScriptCache))
+            {
+                cLogDbg(m_Verbosity >= 3, "Loaded cached script: %s", path.c_str());
+            }
+            else
+            {
+                cLogDbg(m_Verbosity >= 3, "Compiled script: %s", path.c_str());
+            }
         }
         catch (const std::exception & e)
         {
@@ -810,8 +925,6 @@ bool Core::LoadScript(const SQChar * filepath, Function & cb, LightObj & ctx, bo
             // Failed to compile properly
             return false;
         }
-        // At this point the script should be completely loaded
-        cLogDbg(m_Verbosity >= 3, "Compiled script: %s", path.c_str());
 
         // Attempt to execute the compiled script code
         try
@@ -905,12 +1018,12 @@ String Core::FetchCodeLine(const SQChar * src, SQInteger line, bool trim)
     // Find the script we're looking for
     auto script = FindScript(src);
     // Do we have a valid script and line?
-    if ((script == m_Scripts.end()) || !(script->mInfo) || (static_cast< SQInteger >(script->mLine.size()) < line))
+    if ((script == m_Scripts.end()) || !(script->mInfo) || (line < 0))
     {
         return String{}; // No such script!
     }
     // Fetch the line of code
-    return script->FetchLine(line, trim);
+    return script->FetchLine(static_cast< size_t >(line), trim);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1006,7 +1119,15 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
         // Attempt to load and compile the script file
         try
         {
-            (*itr).mExec.CompileFile((*itr).mPath);
+            // Was the byte code loaded from the cache?
+            if ((*itr).Compile(Get().m_ScriptCache))
+            {
+                cLogDbg(Get().m_Verbosity >= 3, "Loaded cached script: %s", (*itr).mPath.c_str());
+            }
+            else
+            {
+                cLogDbg(Get().m_Verbosity >= 3, "Compiled script: %s", (*itr).mPath.c_str());
+            }
         }
         catch (const std::exception & e)
         {
@@ -1015,8 +1136,6 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
             return false;
         }
 
-        cLogDbg(Get().m_Verbosity >= 3, "Compiled script: %s", (*itr).mPath.c_str());
-
         // Should we delay the execution of this script?
         if ((*itr).mDelay)
         {
@@ -1352,6 +1471,8 @@ BlipInst & Core::AllocBlip(int32_t id, bool owned, int32_t header, LightObj & pa
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_BLIP).Insert(id, inst.mInst->GetTag());
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -1447,6 +1568,8 @@ CheckpointInst & Core::AllocCheckpoint(int32_t id, bool owned, int32_t header, L
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_CHECKPOINT).Insert(id, inst.mInst->GetTag());
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -1506,6 +1629,8 @@ KeyBindInst & Core::AllocKeyBind(int32_t id, bool owned, int32_t header, LightOb
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_KEYBIND).Insert(id, inst.mInst->GetTag());
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -1601,6 +1726,10 @@ ObjectInst & Core::AllocObject(int32_t id, bool owned, int32_t header, LightObj
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_OBJECT).Insert(id, inst.mInst->GetTag());
+    // Track the position of the entity
+    SpatialIndex::Get().Refresh(ENT_OBJECT, id);
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -1696,6 +1825,10 @@ PickupInst & Core::AllocPickup(int32_t id, bool owned, int32_t header, LightObj
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_PICKUP).Insert(id, inst.mInst->GetTag());
+    // Track the position of the entity
+    SpatialIndex::Get().Refresh(ENT_PICKUP, id);
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -1791,6 +1924,10 @@ VehicleInst & Core::AllocVehicle(int32_t id, bool owned, int32_t header, LightOb
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_VEHICLE).Insert(id, inst.mInst->GetTag());
+    // Track the position of the entity
+    SpatialIndex::Get().Refresh(ENT_VEHICLE, id);
     // Specify whether the entity is owned by this plug-in
     if (owned)
     {
@@ -2227,6 +2364,8 @@ void Core::ConnectPlayer(int32_t id, int32_t header, LightObj & payload)
     }
     // Assign the specified entity identifier
     inst.mID = id;
+    // Index the tag of the entity
+    TagIndex::Get(ENT_PLAYER).Insert(id, inst.mInst->GetTag());
     // Should we enable area tracking?
     if (m_AreasEnabled)
     {
@@ -2234,6 +2373,8 @@ void Core::ConnectPlayer(int32_t id, int32_t header, LightObj & payload)
     }
     // Initialize the position
     _Func->GetPlayerPosition(id, &inst.mLastPosition.x, &inst.mLastPosition.y, &inst.mLastPosition.z);
+    // Track the position of the entity
+    SpatialIndex::Get().Update(ENT_PLAYER, id, inst.mLastPosition.x, inst.mLastPosition.y, inst.mLastPosition.z);
     // Initialize the remaining attributes
     inst.mLastWeapon = _Func->GetPlayerWeapon(id);
     inst.mLastHealth = _Func->GetPlayerHealth(id);
@@ -2974,6 +3115,76 @@ static SQInteger SqSendExtCommandStr(int32_t target, int32_t req, int32_t tag, S
                                         str.mLen <= 0 ? 0 : static_cast< size_t >(str.mLen));
 }
 
+// ------------------------------------------------------------------------------------------------
+static Table SqGCStats()
+{
+    SQGCStats stats{};
+    sq_getgcstats(SqVM(), &stats);
+    // Create the table with the statistics
+    Table t(SqVM());
+    t.SetValue(_SC("Phase"), stats.phase);
+    t.SetValue(_SC("Objects"), stats.objects);
+    t.SetValue(_SC("Live"), stats.live);
+    t.SetValue(_SC("Traced"), stats.traced);
+    t.SetValue(_SC("LastTraced"), stats.lasttraced);
+    t.SetValue(_SC("Collected"), stats.collected);
+    t.SetValue(_SC("LastCollected"), stats.lastcollected);
+    t.SetValue(_SC("Cycles"), stats.cycles);
+    t.SetValue(_SC("LastPause"), stats.lastpause);
+    t.SetValue(_SC("MaxPause"), stats.maxpause);
+    t.SetValue(_SC("TotalTime"), stats.totaltime);
+    // Return the table
+    return t;
+}
+
+// ------------------------------------------------------------------------------------------------
+static Array SqMemStats()
+{
+    const SQInteger count = sq_getmemclasses();
+    // Create the array that will hold a table for each size class
+    Array arr(SqVM(), count);
+    // Collect the statistics of every size class
+    for (SQInteger i = 0; i < count; ++i)
+    {
+        SQMemStats stats{};
+        sq_getmemstats(i, &stats);
+        // Create the table with the statistics
+        Table t(SqVM());
+        t.SetValue(_SC("Size"), stats.size);
+        t.SetValue(_SC("Chunks"), stats.chunks);
+        t.SetValue(_SC("Blocks"), stats.blocks);
+        t.SetValue(_SC("Bytes"), stats.bytes);
+        t.SetValue(_SC("Allocs"), stats.allocs);
+        arr.SetValue(i, t);
+    }
+    // Return the array
+    return arr;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqGCStep(SQInteger time)
+{
+    return sq_gcstep(SqVM(), 0, time > 0 ? time : 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqGCCollect()
+{
+    return sq_collectgarbage(SqVM());
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqGetGCPause()
+{
+    return Core::Get().GetGCPause();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqSetGCPause(SQInteger pause)
+{
+    Core::Get().SetGCPause(pause);
+}
+
 // ================================================================================================
 void Register_Core(HSQUIRRELVM vm)
 {
@@ -3025,6 +3236,12 @@ void Register_Core(HSQUIRRELVM vm)
         .Func(_SC("ClientDataBuffer"), &SqGetClientDataBuffer)
         .Func(_SC("SendExtCommand"), &SqSendExtCommand)
         .FmtFunc(_SC("SendExtCommandStr"), &SqSendExtCommandStr)
+        .Func(_SC("GCStats"), &SqGCStats)
+        .Func(_SC("MemStats"), &SqMemStats)
+        .Func(_SC("GCStep"), &SqGCStep)
+        .Func(_SC("GCCollect"), &SqGCCollect)
+        .Func(_SC("GetGCPause"), &SqGetGCPause)
+        .Func(_SC("SetGCPause"), &SqSetGCPause)
         .Func(_SC("OnPreLoad"), &SqGetPreLoadEvent)
         .Func(_SC("OnPostLoad"), &SqGetPostLoadEvent)
         .Func(_SC("OnUnload"), &SqGetUnloadEvent)
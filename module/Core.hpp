@@ -15,6 +15,9 @@
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+struct FrameSlice;
+
 /* ------------------------------------------------------------------------------------------------
  * Circular locks employed by the central core.
 */
@@ -107,11 +110,16 @@ private:
     bool                            m_LockPostLoadSignal; // Lock post load signal container.
     bool                            m_LockUnloadSignal; // Lock unload signal container.
     bool                            m_EmptyInit; // Whether to initialize without any scripts.
+    String                          m_ScriptCache; // Directory where the byte code of scripts is cached.
     // --------------------------------------------------------------------------------------------
     int32_t                         m_Verbosity; // Restrict the amount of outputted information.
 
     // --------------------------------------------------------------------------------------------
     LightObj                        m_ClientData; // Currently processed client data buffer.
+    bool                            m_ClientDataView; // Whether client data is borrowed instead of copied.
+
+    // --------------------------------------------------------------------------------------------
+    SQInteger                       m_GCPause; // Heap growth, in percent, before a new collection cycle starts.
 
     // --------------------------------------------------------------------------------------------
     LightObj                        m_NullBlip; // Null Blips instance.
@@ -395,9 +403,27 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Retrieve the current client data buffer, if any.
     */
-    SQMOD_NODISCARD LightObj & GetClientDataBuffer()
+    SQMOD_NODISCARD LightObj & GetClientDataBuffer();
+
+    /* --------------------------------------------------------------------------------------------
+     * Advance the incremental collection of cyclic garbage within the given slice.
+    */
+    size_t CollectGarbage(FrameSlice & slice);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the heap growth, in percent, before a new collection cycle starts.
+    */
+    SQMOD_NODISCARD SQInteger GetGCPause() const
+    {
+        return m_GCPause;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the heap growth, in percent, before a new collection cycle starts. Zero disables it.
+    */
+    void SetGCPause(SQInteger pause)
     {
-        return m_ClientData;
+        m_GCPause = pause > 0 ? pause : 0;
     }
 
     /* --------------------------------------------------------------------------------------------
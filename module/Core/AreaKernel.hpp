@@ -0,0 +1,233 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define SQMOD_AREA_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SQMOD_AREA_SSE2 1
+#endif
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Point-in-polygon kernels used by areas. They only deal with plain floats so that they can be
+ * tested and measured on their own.
+ *
+ * Edge components are stored one after the other, each taking `stride` lanes:
+ * [x1 ...][x2 ...][ay ...][by ...][k ...][m ...]
+ * Where x1/x2 is the sorted x range of the edge, ay/by the y of its end points and k/m the slope and
+ * offset of the line equation. Padding lanes use an empty x range so they never count as crossed.
+*/
+
+// ------------------------------------------------------------------------------------------------
+static constexpr uint8_t g_AreaBitCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/* ------------------------------------------------------------------------------------------------
+ * Build the edges of the polygon formed by the specified points. Returns the stride.
+*/
+template < class P > inline size_t AreaBuildEdges(const P * points, size_t n, std::vector< float > & edges)
+{
+    // Round the number of lanes up so that vector kernels never need a tail
+    const size_t s = (n + 7) & ~static_cast< size_t >(7);
+    // Allocate the arrays and mark all lanes as padding
+    edges.assign(s * 6, 0.0f);
+    std::fill_n(edges.begin(), s, std::numeric_limits< float >::infinity());
+    std::fill_n(edges.begin() + static_cast< ptrdiff_t >(s), s, -std::numeric_limits< float >::infinity());
+    // http://sidvind.com/wiki/Point-in-polygon:_Jordan_Curve_Theorem
+    for (size_t i = 0; i < n; ++i)
+    {
+        const P & a = points[i];
+        const P & b = points[(i + 1) % n];
+        // This is done to ensure that we get the same result when
+        // the line goes from left to right and right to left.
+        if (a.x < b.x)
+        {
+            edges[i] = a.x;
+            edges[s + i] = b.x;
+        }
+        else
+        {
+            edges[i] = b.x;
+            edges[s + i] = a.x;
+        }
+        // Remember the end points used to check if the ray is able to cross the line
+        edges[s * 2 + i] = a.y;
+        edges[s * 3 + i] = b.y;
+        // Calculate the equation of the line
+        const float dx = (b.x - a.x);
+        const float dy = (b.y - a.y);
+        float k;
+
+        if (fabsf(dx) < 0.000001f)
+        {
+            k = static_cast< float >(0xffffffffu); // NOLINT(bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions)
+        }
+        else
+        {
+            k = (dy / dx);
+        }
+
+        edges[s * 4 + i] = k;
+        edges[s * 5 + i] = (a.y - k * a.x);
+    }
+    return s;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * See whether the ray cast from the specified point crosses a single edge.
+*/
+inline uint32_t AreaEdgeCrossing(const float * e, size_t s, size_t i, float x, float y)
+{
+    return (x > e[i] && x <= e[s + i] && (y < e[s * 2 + i] || y <= e[s * 3 + i]) &&
+            y <= (e[s * 4 + i] * x + e[s * 5 + i])) ? 1u : 0u;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Count how many edges the ray cast from the specified point crosses. Odd means inside.
+*/
+inline uint32_t AreaCountCrossings(const float * e, size_t s, float x, float y)
+{
+    uint32_t crossings = 0;
+    size_t i = 0;
+#ifdef SQMOD_AREA_AVX
+    const __m256 x8 = _mm256_set1_ps(x), y8 = _mm256_set1_ps(y);
+    // Test eight edges at a time
+    for (; (i + 8) <= s; i += 8)
+    {
+        __m256 c = _mm256_and_ps(_mm256_cmp_ps(x8, _mm256_loadu_ps(e + i), _CMP_GT_OQ),
+                                 _mm256_cmp_ps(x8, _mm256_loadu_ps(e + s + i), _CMP_LE_OQ));
+        c = _mm256_and_ps(c, _mm256_or_ps(_mm256_cmp_ps(y8, _mm256_loadu_ps(e + s * 2 + i), _CMP_LT_OQ),
+                                          _mm256_cmp_ps(y8, _mm256_loadu_ps(e + s * 3 + i), _CMP_LE_OQ)));
+        c = _mm256_and_ps(c, _mm256_cmp_ps(y8, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(e + s * 4 + i), x8),
+                                                             _mm256_loadu_ps(e + s * 5 + i)), _CMP_LE_OQ));
+        // Count the crossed edges
+        const int mask = _mm256_movemask_ps(c);
+        crossings += g_AreaBitCount[mask & 0xF] + g_AreaBitCount[(mask >> 4) & 0xF];
+    }
+#endif // SQMOD_AREA_AVX
+#ifdef SQMOD_AREA_SSE2
+    const __m128 x4 = _mm_set1_ps(x), y4 = _mm_set1_ps(y);
+    // Test four edges at a time
+    for (; (i + 4) <= s; i += 4)
+    {
+        __m128 c = _mm_and_ps(_mm_cmpgt_ps(x4, _mm_loadu_ps(e + i)), _mm_cmple_ps(x4, _mm_loadu_ps(e + s + i)));
+        c = _mm_and_ps(c, _mm_or_ps(_mm_cmplt_ps(y4, _mm_loadu_ps(e + s * 2 + i)),
+                                    _mm_cmple_ps(y4, _mm_loadu_ps(e + s * 3 + i))));
+        c = _mm_and_ps(c, _mm_cmple_ps(y4, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(e + s * 4 + i), x4),
+                                                      _mm_loadu_ps(e + s * 5 + i))));
+        // Count the crossed edges
+        crossings += g_AreaBitCount[_mm_movemask_ps(c)];
+    }
+#endif // SQMOD_AREA_SSE2
+    // Test whatever is left (or everything if there is no vector support)
+    for (; i < s; ++i)
+    {
+        crossings += AreaEdgeCrossing(e, s, i, x, y);
+    }
+    return crossings;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Test many points against the edges of one polygon and its bounding box (left, bottom, right, top).
+ * Each result is 1 if the point is inside and 0 otherwise. Without edges only the box is tested.
+*/
+inline void AreaTestPoints(const float * e, size_t s, size_t edges, float l, float b, float r, float t,
+                           const float * xs, const float * ys, size_t n, uint8_t * out)
+{
+    size_t i = 0;
+    // Each vector lane holds a different point while the edges are broadcast one at a time
+#ifdef SQMOD_AREA_AVX
+    const __m256 l8 = _mm256_set1_ps(l), b8 = _mm256_set1_ps(b), r8 = _mm256_set1_ps(r), t8 = _mm256_set1_ps(t);
+    // Test eight points at a time
+    for (; (i + 8) <= n; i += 8)
+    {
+        const __m256 x8 = _mm256_loadu_ps(xs + i), y8 = _mm256_loadu_ps(ys + i);
+        // Which points are in the bounding box?
+        int mask = _mm256_movemask_ps(_mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(l8, x8, _CMP_LE_OQ), _mm256_cmp_ps(r8, x8, _CMP_GE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(b8, y8, _CMP_LE_OQ), _mm256_cmp_ps(t8, y8, _CMP_GE_OQ))));
+        // Bother with the edges only if there are points to test
+        if (mask != 0 && edges > 0)
+        {
+            __m256 odd = _mm256_setzero_ps();
+            for (size_t j = 0; j < edges; ++j)
+            {
+                __m256 c = _mm256_and_ps(_mm256_cmp_ps(x8, _mm256_set1_ps(e[j]), _CMP_GT_OQ),
+                                         _mm256_cmp_ps(x8, _mm256_set1_ps(e[s + j]), _CMP_LE_OQ));
+                c = _mm256_and_ps(c, _mm256_or_ps(_mm256_cmp_ps(y8, _mm256_set1_ps(e[s * 2 + j]), _CMP_LT_OQ),
+                                                  _mm256_cmp_ps(y8, _mm256_set1_ps(e[s * 3 + j]), _CMP_LE_OQ)));
+                c = _mm256_and_ps(c, _mm256_cmp_ps(y8, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(e[s * 4 + j]), x8),
+                                                                     _mm256_set1_ps(e[s * 5 + j])), _CMP_LE_OQ));
+                // Only the parity of the crossings matters
+                odd = _mm256_xor_ps(odd, c);
+            }
+            mask &= _mm256_movemask_ps(odd);
+        }
+        // Store the results
+        for (size_t k = 0; k < 8; ++k)
+        {
+            out[i + k] = static_cast< uint8_t >((mask >> k) & 1);
+        }
+    }
+#endif // SQMOD_AREA_AVX
+#ifdef SQMOD_AREA_SSE2
+    const __m128 l4 = _mm_set1_ps(l), b4 = _mm_set1_ps(b), r4 = _mm_set1_ps(r), t4 = _mm_set1_ps(t);
+    // Test four points at a time
+    for (; (i + 4) <= n; i += 4)
+    {
+        const __m128 x4 = _mm_loadu_ps(xs + i), y4 = _mm_loadu_ps(ys + i);
+        // Which points are in the bounding box?
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(_mm_cmple_ps(l4, x4), _mm_cmpge_ps(r4, x4)),
+                                              _mm_and_ps(_mm_cmple_ps(b4, y4), _mm_cmpge_ps(t4, y4))));
+        // Bother with the edges only if there are points to test
+        if (mask != 0 && edges > 0)
+        {
+            __m128 odd = _mm_setzero_ps();
+            for (size_t j = 0; j < edges; ++j)
+            {
+                __m128 c = _mm_and_ps(_mm_cmpgt_ps(x4, _mm_set1_ps(e[j])), _mm_cmple_ps(x4, _mm_set1_ps(e[s + j])));
+                c = _mm_and_ps(c, _mm_or_ps(_mm_cmplt_ps(y4, _mm_set1_ps(e[s * 2 + j])),
+                                            _mm_cmple_ps(y4, _mm_set1_ps(e[s * 3 + j]))));
+                c = _mm_and_ps(c, _mm_cmple_ps(y4, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[s * 4 + j]), x4),
+                                                              _mm_set1_ps(e[s * 5 + j]))));
+                // Only the parity of the crossings matters
+                odd = _mm_xor_ps(odd, c);
+            }
+            mask &= _mm_movemask_ps(odd);
+        }
+        // Store the results
+        for (size_t k = 0; k < 4; ++k)
+        {
+            out[i + k] = static_cast< uint8_t >((mask >> k) & 1);
+        }
+    }
+#endif // SQMOD_AREA_SSE2
+    // Test whatever is left (or everything if there is no vector support)
+    for (; i < n; ++i)
+    {
+        const float x = xs[i], y = ys[i];
+        // Is the given point in this bounding box at least?
+        if (l <= x && r >= x && b <= y && t >= y)
+        {
+            out[i] = (edges == 0 || (AreaCountCrossings(e, s, x, y) % 2 == 1)) ? 1 : 0;
+        }
+        else
+        {
+            out[i] = 0;
+        }
+    }
+}
+
+} // Namespace:: SqMod
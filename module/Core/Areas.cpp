@@ -1,8 +1,14 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core/Areas.hpp"
+#include "Core/AreaKernel.hpp"
+#include "Core/Entity.hpp"
+#include "Entity/Player.hpp"
+#include "Entity/Vehicle.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <algorithm>
+#include <iterator>
+#include <functional>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -63,6 +69,8 @@ void Area::AddCircleEx(SQFloat cx, SQFloat cy, SQFloat cr, SQInteger num_segment
         SQFloat y = (cr * std::sin(theta)) + cy;
         // Insert the point into the list
         mPoints.emplace_back(static_cast< Vector2::Value >(x), static_cast< Vector2::Value >(y));
+        // Edges must be rebuilt
+        mStride = 0;
         // Update the bounding box
         Expand(static_cast< Vector2::Value >(x), static_cast< Vector2::Value >(y));
     }
@@ -99,6 +107,13 @@ bool Area::Unmanage()
     return mCells.empty();
 }
 
+// ------------------------------------------------------------------------------------------------
+void Area::UpdateEdges() const
+{
+    // Build the edges and remember the stride, which also marks them as up to date
+    mStride = static_cast< uint32_t >(AreaBuildEdges(mPoints.data(), mPoints.size(), mEdges));
+}
+
 // ------------------------------------------------------------------------------------------------
 bool Area::IsInside(float x, float y) const
 {
@@ -107,114 +122,127 @@ bool Area::IsInside(float x, float y) const
     {
         return false; // Can't possibly be in an area that doesn't exist
     }
-    // http://sidvind.com/wiki/Point-in-polygon:_Jordan_Curve_Theorem
-    // The points creating the polygon
-    float x1, x2;
-    // How many times the ray crosses a line segment
-    int crossings = 0;
-    // Iterate through each line
-    for (uint32_t i = 0, n = static_cast< uint32_t >(mPoints.size()); i < n; ++i)
-    {
-        Points::const_reference a = mPoints[i];
-        Points::const_reference b = mPoints[(i + 1) % n];
-        // This is done to ensure that we get the same result when
-        // the line goes from left to right and right to left.
-        if (a.x < b.x)
+    // Make sure the edges reflect the current points
+    if (mStride == 0)
+    {
+        UpdateEdges();
+    }
+    // Return if the crossings are not even
+    return (AreaCountCrossings(mEdges.data(), mStride, x, y) % 2 == 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Area::TestPoints(const float * xs, const float * ys, size_t n, uint8_t * out) const
+{
+    const size_t edges = mPoints.size();
+    // Can't possibly be in an area that doesn't exist
+    if (edges > 0 && edges < 3)
+    {
+        std::fill_n(out, n, static_cast< uint8_t >(0));
+        return;
+    }
+    // Make sure the edges reflect the current points
+    else if (edges > 0 && mStride == 0)
+    {
+        UpdateEdges();
+    }
+    // Test the points against the bounding box and the edges
+    AreaTestPoints(mEdges.data(), mStride, edges, mL, mB, mR, mT, xs, ys, n, out);
+}
+
+// ------------------------------------------------------------------------------------------------
+Sqrat::Array Area::Filter(const Sqrat::Array & a) const
+{
+    std::vector< LightObj > objs;
+    std::vector< float > xs, ys;
+    // Reserve memory in advance
+    const auto sz = static_cast< size_t >(a.Length());
+    objs.reserve(sz);
+    xs.reserve(sz);
+    ys.reserve(sz);
+    // Collect the positions of the given elements
+    a.Foreach([&objs, &xs, &ys](HSQUIRRELVM vm, SQInteger) -> SQRESULT {
+        // Only instances can be tested
+        if (sq_gettype(vm, -1) != OT_INSTANCE)
         {
-            x1 = a.x;
-            x2 = b.x;
+            return SQ_OK;
         }
-        else
+        SQUserPointer tag = nullptr;
+        // Retrieve the type of the instance
+        if (SQ_FAILED(sq_gettypetag(vm, -1, &tag)))
         {
-            x1 = b.x;
-            x2 = a.x;
+            return SQ_OK;
         }
-        // First check if the ray is able to cross the line
-        if (x > x1 && x <= x2 && (y < a.y || y <= b.y))
+        auto type = static_cast< AbstractStaticClassData * >(tag);
+        // 2D vector?
+        if (type == StaticClassTypeTag< Vector2 >::Get())
         {
-            // Calculate the equation of the line
-            const float dx = (b.x - a.x);
-            const float dy = (b.y - a.y);
-            float k;
-
-            if (fabsf(dx) < 0.000001f)
-            {
-                k = static_cast< float >(0xffffffffu); // NOLINT(bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions)
-            }
-            else
+            const Vector2 & v = *ClassType< Vector2 >::GetInstance(vm, -1);
+            xs.push_back(v.x);
+            ys.push_back(v.y);
+        } // 3D vector?
+        else if (type == StaticClassTypeTag< Vector3 >::Get())
+        {
+            const Vector3 & v = *ClassType< Vector3 >::GetInstance(vm, -1);
+            xs.push_back(v.x);
+            ys.push_back(v.y);
+        } // Player?
+        else if (type == StaticClassTypeTag< CPlayer >::Get())
+        {
+            const CPlayer & p = *ClassType< CPlayer >::GetInstance(vm, -1);
+            // Ignore players that are no longer active
+            if (!p.IsActive())
             {
-                k = (dy / dx);
+                return SQ_OK;
             }
-
-            const float m = (a.y - k * a.x);
-            const float y2 = (k * x + m);
-            // Does the ray cross the line?
-            if (y <= y2)
+            const Vector3 v = p.GetPosition();
+            xs.push_back(v.x);
+            ys.push_back(v.y);
+        } // Vehicle?
+        else if (type == StaticClassTypeTag< CVehicle >::Get())
+        {
+            const CVehicle & p = *ClassType< CVehicle >::GetInstance(vm, -1);
+            // Ignore vehicles that are no longer active
+            if (!p.IsActive())
             {
-                ++crossings;
+                return SQ_OK;
             }
+            const Vector3 v = p.GetPosition();
+            xs.push_back(v.x);
+            ys.push_back(v.y);
+        } // Ignore anything else
+        else
+        {
+            return SQ_OK;
+        }
+        // Remember the element
+        objs.emplace_back(-1, vm);
+        // Continue
+        return SQ_OK;
+    });
+    // Test all positions at once
+    std::vector< uint8_t > res(objs.size());
+    TestPoints(xs.data(), ys.data(), objs.size(), res.data());
+    // Collect the elements that are inside
+    Sqrat::Array arr(SqVM());
+    for (size_t i = 0; i < objs.size(); ++i)
+    {
+        if (res[i])
+        {
+            arr.Append(objs[i]);
         }
     }
-    // Return if the crossings are not even
-    return (crossings % 2 == 1);
+    return arr;
 }
 
 // ------------------------------------------------------------------------------------------------
 AreaManager::AreaManager(size_t sz) noexcept
-    : m_Queue(), m_ProcList(), m_Grid{}, m_Cells{}
-{
-    // Negative half grid size (left)
-    int l = (-GRIDH * CELLD);
-    // Positive half grid size minus one cell (bottom)
-    int b = (abs(l) - CELLD);
-    // Negative half grid size minus one cell (right)
-    int r = (l + CELLD);
-    // Positive half grid size (top)
-    int t = abs(l);
-    // Row/Column of the grid
-    int row = 0, col = 0;
-    // Initialize the grid cells
-    for (auto & a : m_Grid)
-    {
-        // Reset the column
-        col = 0;
-        // Process row
-        for (auto & c : a)
-        {
-            auto & cx = m_Cells[row][col];
-            // Grab a reference to the cell
-            // Configure the range of the cell
-            c.mL = cx.mL = static_cast< float >(l);
-            c.mB = cx.mB = static_cast< float >(b);
-            c.mR = cx.mR = static_cast< float >(r);
-            c.mT = cx.mT = static_cast< float >(t);
-            // Reserve area memory if requested
-            c.mAreas.reserve(sz);
-            // Reset the locks on this area
-            c.mLocks = 0;
-            // Set the row and column
-            c.mRow = row;
-            c.mCol = col++;
-            // Advance the left side
-            l = r;
-            // Advance the right side
-            r += CELLD;
-            // Should we advance to the next row?
-            if (r > (GRIDH * CELLD))
-            {
-                // Reset the left side
-                l = (-GRIDH * CELLD);
-                // Reset the right side
-                r = (l + CELLD);
-                // Advance the bottom
-                b -= CELLD;
-                // Advance the top
-                t -= CELLD;
-            }
-        }
-        // Advance row
-        ++row;
-    }
+    : m_Queue(), m_ProcList(), m_Root(), m_Reserve(sz), m_Version(1)
+{
+    // Start with a root cell centered at the origin of the world
+    m_Root = std::make_unique< AreaCell >(-CELLD * 0.5f, -CELLD * 0.5f, CELLD * 0.5f, CELLD * 0.5f);
+    // Reserve area memory if requested
+    m_Root->mAreas.reserve(m_Reserve);
     // Reserve some space in the queue
     m_Queue.reserve(128);
     m_ProcList.reserve(128);
@@ -231,6 +259,8 @@ void AreaManager::Insert(AreaCell & c, Area & a, LightObj & obj)
     else
     {
         c.mAreas.emplace_back(&a, obj);
+        // Tracked points may collide with this area now
+        ++m_Version;
     }
     // Associate the area with this cell so it can't be managed again (even while in the queue)
     a.mCells.push_back(&c);
@@ -255,6 +285,8 @@ void AreaManager::Remove(AreaCell & c, Area & a)
         if (itr != c.mAreas.end())
         {
             c.mAreas.erase(itr); // Erase it
+            // Tracked points may no longer collide with this area
+            ++m_Version;
         }
     }
     // Dissociate the area with this cell so it can be managed again (even while in the queue)
@@ -266,6 +298,139 @@ void AreaManager::Remove(AreaCell & c, Area & a)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void AreaManager::Distribute(AreaCell & c, Area & a, LightObj & obj)
+{
+    // Does the bounding box of this cell intersect with the one of the area?
+    if (!Overlaps(c, a))
+    {
+        return; // Nothing to do here
+    }
+    // Is this a cell that can hold areas?
+    else if (c.IsLeaf())
+    {
+        Insert(c, a, obj); // Attempt to insert the area into this cell
+    }
+    else
+    {
+        // Forward the area to the quadrants
+        for (auto & n : c.mNodes)
+        {
+            Distribute(*n, a, obj);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void AreaManager::Grow(float l, float b, float r, float t)
+{
+    // Ignore bounding boxes which could never be included
+    if (!std::isfinite(l) || !std::isfinite(b) || !std::isfinite(r) || !std::isfinite(t))
+    {
+        return;
+    }
+    // Keep doubling the root cell until the bounding box is included
+    while (m_Root->Size() < CELLX && (l < m_Root->mL || b < m_Root->mB || r > m_Root->mR || t > m_Root->mT))
+    {
+        const AreaCell & c = *m_Root;
+        const float sz = c.Size();
+        // Figure out in which direction to grow
+        const bool left = (l < c.mL), down = (b < c.mB);
+        // Create the new root cell
+        const float nl = left ? c.mL - sz : c.mL, nb = down ? c.mB - sz : c.mB;
+        AreaCell::Pointer root = std::make_unique< AreaCell >(nl, nb, nl + sz * 2.0f, nb + sz * 2.0f);
+        // The previous root cell becomes one of the quadrants
+        const int q = (left ? 1 : 0) | (down ? 2 : 0);
+        // Create the remaining quadrants
+        for (int i = 0; i < 4; ++i)
+        {
+            root->mNodes[i] = (i == q) ? std::move(m_Root) : root->MakeQuadrant(i);
+        }
+        // Replace the root cell
+        m_Root = std::move(root);
+        // Tracked points may be in different cells now
+        ++m_Version;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool AreaManager::ShouldSplit(const AreaCell & c)
+{
+    // Is this cell allowed to be split?
+    if (!c.IsLeaf() || c.mLocks || c.mAreas.size() <= SPLIT || (c.Size() * 0.5f) < CELLM)
+    {
+        return false;
+    }
+    // Areas that cover the entire cell would end up in every quadrant so don't count them
+    size_t n = 0;
+    // Count the areas that would benefit from being split
+    for (const auto & ap : c.mAreas)
+    {
+        if (!Covers(c, *ap.first) && (++n) > SPLIT)
+        {
+            return true;
+        }
+    }
+    // Not worth splitting
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AreaManager::Split(AreaCell & c)
+{
+    // Create the quadrants
+    for (int i = 0; i < 4; ++i)
+    {
+        c.mNodes[i] = c.MakeQuadrant(i);
+    }
+    // Tracked points may be in different cells now
+    ++m_Version;
+    // Take the areas from this cell since it is no longer a leaf
+    AreaCell::Areas areas;
+    areas.swap(c.mAreas);
+    // Move the areas into the quadrants
+    for (auto & ap : areas)
+    {
+        Area & a = *(ap.first);
+        // Dissociate the area with this cell
+        auto itr = std::find(a.mCells.begin(), a.mCells.end(), &c);
+        // Was is associated?
+        if (itr != a.mCells.end())
+        {
+            a.mCells.erase(itr); // Dissociate them
+        }
+        // Associate the area with the quadrants it intersects
+        for (auto & n : c.mNodes)
+        {
+            if (Overlaps(*n, a))
+            {
+                n->mAreas.emplace_back(ap.first, ap.second);
+                a.mCells.push_back(n.get());
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void AreaManager::Refine(AreaCell & c)
+{
+    // Is this a leaf that needs to be split?
+    if (c.IsLeaf())
+    {
+        if (!ShouldSplit(c))
+        {
+            return; // Nothing to do
+        }
+        // Split it
+        Split(c);
+    }
+    // See if the quadrants need to be split as well
+    for (auto & n : c.mNodes)
+    {
+        Refine(*n);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void AreaManager::ProcQueue()
 {
@@ -303,17 +468,46 @@ void AreaManager::ProcQueue()
 // ------------------------------------------------------------------------------------------------
 void AreaManager::Clear()
 {
-    // Clear the cells
-    for (AreaCell (&row)[GRIDN] : m_Grid)
+    bool locked = false;
+    // Clear the cells and dissociate the areas from them
+    std::function< void(AreaCell &) > clear_cell = [&](AreaCell & c) {
+        // Is anything iterating this cell?
+        locked = locked || (c.mLocks > 0);
+        // Dissociate the areas
+        for (auto & ap : c.mAreas)
+        {
+            ap.first->mCells.clear();
+        }
+        c.mAreas.clear();
+        // Clear the quadrants as well
+        if (!c.IsLeaf())
+        {
+            for (auto & n : c.mNodes)
+            {
+                clear_cell(*n);
+            }
+        }
+    };
+    clear_cell(*m_Root);
+    // Dissociate areas that are still waiting to be inserted
+    for (auto & e : m_Queue)
     {
-        for (AreaCell & c : row)
+        if (!e.mObj.IsNull())
         {
-            c.mAreas.clear();
+            e.mArea->mCells.clear();
         }
     }
     // Clear the queue as well
     m_Queue.clear();
     m_ProcList.clear();
+    // Tracked points may no longer collide with any area
+    ++m_Version;
+    // Start over with a single cell if nothing is using the current ones
+    if (!locked)
+    {
+        m_Root = std::make_unique< AreaCell >(-CELLD * 0.5f, -CELLD * 0.5f, CELLD * 0.5f, CELLD * 0.5f);
+        m_Root->mAreas.reserve(m_Reserve);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -324,73 +518,175 @@ void AreaManager::InsertArea(Area & a, LightObj & obj)
     {
         return; // Already managed or nothing to manage
     }
+    // Make sure the area is included in the tree
+    Grow(a.mL, a.mB, a.mR, a.mT);
     // Go through each cell and check if the area touches it
-    for (auto & y : m_Grid)
+    Distribute(*m_Root, a, obj);
+    // Split cells only when there are no pending actions that may reference them
+    if (m_Queue.empty())
     {
-        for (auto & c : y)
+        // Cells may be split while refining so work with a copy
+        const Area::Cells cells(a.mCells);
+        // Refine the cells that received the area
+        for (auto c : cells)
         {
-            // Does the bounding box of this cell intersect with the one of the area?
-            if (a.mL <= c.mR && c.mL <= a.mR && a.mB <= c.mT && c.mB <= a.mT)
-            {
-                Insert(c, a, obj); // Attempt to insert the area into this cell
-            }
+            Refine(*c);
         }
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void AreaManager::InsertAreas(AreaCell::Areas & areas)
+{
+    float l = Area::DEF_L, b = Area::DEF_B, r = Area::DEF_R, t = Area::DEF_T;
+    // Compute the bounding box of all areas that need to be managed
+    for (auto & ap : areas)
+    {
+        const Area & a = *(ap.first);
+        // Skip areas that would not be inserted
+        if (a.mCells.empty() && !a.mPoints.empty())
+        {
+            l = std::fmin(l, a.mL);
+            b = std::fmin(b, a.mB);
+            r = std::fmax(r, a.mR);
+            t = std::fmax(t, a.mT);
+        }
+    }
+    // Enlarge the tree once for all areas
+    Grow(l, b, r, t);
+    // Insert the areas without splitting any cells
+    for (auto & ap : areas)
+    {
+        Area & a = *(ap.first);
+        // See if this area is already managed
+        if (a.mCells.empty() && !a.mPoints.empty())
+        {
+            Distribute(*m_Root, a, ap.second);
+        }
+    }
+    // Now split the cells from the top down
+    if (m_Queue.empty())
+    {
+        Refine(*m_Root);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void AreaManager::RemoveArea(Area & a)
 {
+    // Cells are removed from the list as we go so work with a copy
+    const Area::Cells cells(a.mCells);
     // Just remove the associated cells
-    for (auto c : a.mCells)
+    for (auto c : cells)
     {
         Remove(*c, a);
     }
 }
 
 // ------------------------------------------------------------------------------------------------
-Vector2i AreaManager::LocateCell(float x, float y)
+bool AreaManager::Track(AreaTracker & tr, AreaCell::Areas & areas, float x, float y, AreaCell::Areas & left, AreaCell::Areas & entered)
 {
-    for (int r = 0; r < GRIDN; ++r)
+    // Is the point still inside the region where nothing can change?
+    if (tr.mVersion == m_Version && tr.mL < x && tr.mR > x && tr.mB < y && tr.mT > y)
+    {
+        return false; // Same areas as before
+    }
+    // Find the cell that contains the point
+    const AreaCell * c = LocateLeaf(x, y);
+    // Areas that currently contain the point
+    AreaCell::Areas now;
+    // Begin with the bounds of the cell and shrink them to exclude the bounding box of each area
+    float l = x, b = y, r = x, t = y;
+    // The region is not usable if the point is inside the bounding box of any area
+    bool stable = (c != nullptr);
+    // Are there any areas to test?
+    if (c != nullptr)
     {
-        for (int c = 0; c < GRIDN; ++c)
+        l = c->mL, b = c->mB, r = c->mR, t = c->mT;
+        // Test the areas in this cell
+        for (const auto & ap : c->mAreas)
         {
-            auto & bb = m_Cells[r][c];
-            // Check whether point is inside cell
-            if (bb.mL <= x && bb.mR >= x && bb.mB <= y && bb.mT >= y)
+            const Area & a = *(ap.first);
+            // Is the point inside the bounding box of this area?
+            if (a.mL <= x && a.mR >= x && a.mB <= y && a.mT >= y)
             {
-                return {r, c}; // Is inside
+                // Moving around may change the outcome of the polygon test
+                stable = false;
+                // Is the point inside the area?
+                if (ap.first->TestEx(x, y))
+                {
+                    now.emplace_back(ap);
+                }
             }
+            // Keep the bounding box of this area outside of the region
+            else if (stable)
+            {
+                if (a.mR < x) l = std::fmax(l, a.mR);
+                else if (a.mL > x) r = std::fmin(r, a.mL);
+                else if (a.mT < y) b = std::fmax(b, a.mT);
+                else t = std::fmin(t, a.mB);
+            }
+        }
+    }
+    // Areas that are no longer managed only count as left once the point is outside of them
+    for (const auto & ap : areas)
+    {
+        // Is this area still found in the cell?
+        if (std::find_if(now.begin(), now.end(), [a = ap.first](AreaCell::Areas::const_reference p) -> bool {
+                return (a == p.first);
+            }) != now.end())
+        {
+            continue;
+        }
+        // Is the point still inside of it?
+        else if (ap.first->TestEx(x, y))
+        {
+            now.emplace_back(ap);
+            // The region of the cell does not account for this area
+            stable = false;
         }
     }
-    // Point is out of bounds
-    return {NOCELL, NOCELL};
-/*
-    // Transform the world coordinates into a cell coordinates
-    // and cast to integral after rounding the value
-    int xc = static_cast< int >(std::round(x / CELLD));
-    int yc = static_cast< int >(std::round(y / CELLD));
-    // Grab the absolute cell coordinates for range checking
-    const int xca = std::abs(xc);
-    const int yca = std::abs(yc);
-    // Make sure the cell coordinates are within range
-    if (xca > (GRIDH+1) || yca > (GRIDH+1))
+    // Remember the region (an empty region forces a full test next time)
+    tr.mVersion = m_Version;
+    if (stable)
     {
-        return {NOCELL, NOCELL}; // Out of our scanning area
+        tr.mL = l, tr.mB = b, tr.mR = r, tr.mT = t;
     }
-    // Clamp the x coordinate if necessary
-    if (xca >= (GRIDH))
+    else
     {
-        xc = xc < 0 ? -(GRIDH-1) : (GRIDH-1);
+        tr.mL = tr.mR = x, tr.mB = tr.mT = y;
     }
-    // Clamp the y coordinate if necessary
-    if (yca >= (GRIDH))
+    // Nothing to compare if the point was and still is outside of any areas
+    if (now.empty() && areas.empty())
+    {
+        return false;
+    }
+    // Keep the areas sorted so that we can compare them
+    auto cmp = [](AreaCell::Areas::const_reference a, AreaCell::Areas::const_reference b) -> bool {
+        return a.first < b.first;
+    };
+    std::sort(now.begin(), now.end(), cmp);
+    // Find the areas that the point left and entered
+    std::set_difference(areas.begin(), areas.end(), now.begin(), now.end(), std::back_inserter(left), cmp);
+    std::set_difference(now.begin(), now.end(), areas.begin(), areas.end(), std::back_inserter(entered), cmp);
+    // Remember the current areas
+    areas.swap(now);
+    // Report whether anything changed
+    return !left.empty() || !entered.empty();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector2i AreaManager::LocateCell(float x, float y)
+{
+    // Find the cell that contains the point
+    const AreaCell * c = LocateLeaf(x, y);
+    // Is the point out of bounds?
+    if (c == nullptr)
     {
-        yc = xc < 0 ? -(GRIDH-1) : (GRIDH-1);
+        return {NOCELL, NOCELL};
     }
     // Return the identified cell row and column
-    return {GRIDH+xc, GRIDH-yc};
-*/
+    return {c->mRow, c->mCol};
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -440,6 +736,23 @@ static Vector2i Areas_LocatePointCellEx(float x, float y)
     return AreaManager::Get().LocateCell(x, y);
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger Areas_ManageArray(const Sqrat::Array & arr)
+{
+    AreaCell::Areas areas;
+    // Collect the areas from the array
+    arr.Foreach([&areas](HSQUIRRELVM vm, SQInteger) -> SQRESULT {
+        areas.emplace_back(ClassType< Area >::GetInstance(vm, -1), LightObj(-1, vm));
+        // Continue
+        return SQ_OK;
+    });
+    // Manage them all at once
+    AreaManager::Get().InsertAreas(areas);
+    // Count how many areas are now managed
+    return static_cast< SQInteger >(std::count_if(areas.begin(), areas.end(),
+        [](AreaCell::Areas::const_reference ap) -> bool { return !ap.first->mCells.empty(); }));
+}
+
 // ------------------------------------------------------------------------------------------------
 void TerminateAreas()
 {
@@ -494,6 +807,7 @@ void Register_Areas(HSQUIRRELVM vm)
         .Func(_SC("AddArray"), &Area::AddArray)
         .Func(_SC("Test"), &Area::Test)
         .Func(_SC("TestEx"), &Area::TestEx)
+        .Func(_SC("Filter"), &Area::Filter)
         .Func(_SC("Manage"), &Area::Manage)
         .Func(_SC("Unmanage"), &Area::Unmanage)
         .CbFunc(_SC("EachCell"), &Area::EachCell)
@@ -504,6 +818,7 @@ void Register_Areas(HSQUIRRELVM vm)
         .StaticFunc(_SC("GlobalTestOnEx"), &Areas_TestPointOnEx)
         .StaticFunc(_SC("LocatePointCell"), &Areas_LocatePointCell)
         .StaticFunc(_SC("LocatePointCellEx"), &Areas_LocatePointCellEx)
+        .StaticFunc(_SC("ManageArray"), &Areas_ManageArray)
         .StaticFunc(_SC("UnmanageAll"), &TerminateAreas)
     );
 }
@@ -8,39 +8,101 @@
 #include "Base/Vector2i.hpp"
 
 // ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <memory>
 #include <vector>
 #include <utility>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+struct AreaTracker;
+
 /* ------------------------------------------------------------------------------------------------
- * Various information associated with an area cell.
+ * Various information associated with an area cell. Cells form a quad-tree where only the leaf
+ * cells store areas and the remaining cells only store the four quadrants they were split into.
 */
 struct AreaCell
 {
     // --------------------------------------------------------------------------------------------
     typedef std::pair< Area *, LightObj > AreaPair; // A reference to an area object.
     typedef std::vector< AreaPair > Areas; // A list of area objects.
+    typedef std::unique_ptr< AreaCell > Pointer; // Owning reference to a cell.
 
     // --------------------------------------------------------------------------------------------
     float   mL, mB, mR, mT; // Left-Bottom, Right-Top components of the cell bounding box.
     // --------------------------------------------------------------------------------------------
     Areas   mAreas; // Areas that intersect with the cell.
     // --------------------------------------------------------------------------------------------
+    Pointer mNodes[4]; // Quadrants of this cell, if it was split.
+    // --------------------------------------------------------------------------------------------
     int     mLocks; // The amount of locks on the cell.
-    int     mRow; // Row location in the grid.
-    int     mCol; // Column location in the grid.
+    int     mRow; // Row location in a grid made of cells with the same size.
+    int     mCol; // Column location in a grid made of cells with the same size.
 
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
     */
     AreaCell()
-        : mL(0), mB(0), mR(0), mT(0), mAreas(0), mLocks(0), mRow(0), mCol(0)
+        : mL(0), mB(0), mR(0), mT(0), mAreas(0), mNodes{}, mLocks(0), mRow(0), mCol(0)
+    {
+        //...
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Bounding box constructor.
+    */
+    AreaCell(float l, float b, float r, float t)
+        : mL(l), mB(b), mR(r), mT(t), mAreas(0), mNodes{}, mLocks(0)
+        , mRow(static_cast< int >(std::floor(b / (t - b))))
+        , mCol(static_cast< int >(std::floor(l / (r - l))))
     {
         //...
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * See whether this cell was not split into quadrants.
+    */
+    SQMOD_NODISCARD bool IsLeaf() const noexcept
+    {
+        return !mNodes[0];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the width (and height) of this cell.
+    */
+    SQMOD_NODISCARD float Size() const noexcept
+    {
+        return mR - mL;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a point is inside the bounding box of this cell.
+    */
+    SQMOD_NODISCARD bool Contains(float x, float y) const noexcept
+    {
+        return mL <= x && mR >= x && mB <= y && mT >= y;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the quadrant in which a point falls. Assumes this cell was split.
+    */
+    SQMOD_NODISCARD AreaCell & Quadrant(float x, float y) const noexcept
+    {
+        return *mNodes[(x >= (mL + mR) * 0.5f ? 1 : 0) | (y >= (mB + mT) * 0.5f ? 2 : 0)];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a cell that covers the specified quadrant of this cell.
+    */
+    SQMOD_NODISCARD Pointer MakeQuadrant(int i) const
+    {
+        const float mx = (mL + mR) * 0.5f, my = (mB + mT) * 0.5f;
+        // Bit 0 selects the right half and bit 1 selects the top half
+        return std::make_unique< AreaCell >((i & 1) ? mx : mL, (i & 2) ? my : mB, (i & 1) ? mR : mx, (i & 2) ? mT : my);
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Show information (mainly for debug purposes).
     */
@@ -67,6 +129,9 @@ struct Area
     // --------------------------------------------------------------------------------------------
     Points      mPoints; // Collection of points that make up the area.
     // --------------------------------------------------------------------------------------------
+    mutable std::vector< float >    mEdges{}; // Edges of the area stored as a structure of arrays.
+    mutable uint32_t                mStride{0}; // Number of lanes in each edge array. Zero if outdated.
+    // --------------------------------------------------------------------------------------------
     SQInteger   mID; // The user identifier given to this area.
     // --------------------------------------------------------------------------------------------
     Cells       mCells; // The cells covered by this area.
@@ -350,6 +415,8 @@ struct Area
         CheckLock();
         // Perform the requested action
         mPoints.clear();
+        // Edges must be rebuilt
+        mStride = 0;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -372,6 +439,8 @@ struct Area
         CheckLock();
         // Perform the requested action
         mPoints.emplace_back(v);
+        // Edges must be rebuilt
+        mStride = 0;
         // Update the bounding box
         Expand(v.x, v.y);
     }
@@ -384,6 +453,8 @@ struct Area
         CheckLock();
         // Perform the requested action
         mPoints.emplace_back(x, y);
+        // Edges must be rebuilt
+        mStride = 0;
         // Update the bounding box
         Expand(x, y);
     }
@@ -454,6 +525,17 @@ struct Area
         return false;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Test multiple points against the bounding box and then the area in a single pass. Coordinates
+     * are given as separate arrays and the result of each test is stored at the same index in `out`.
+    */
+    void TestPoints(const float * xs, const float * ys, size_t n, uint8_t * out) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the elements of an array of positions or entities that are inside this area.
+    */
+    SQMOD_NODISCARD Sqrat::Array Filter(const Sqrat::Array & a) const;
+
     /* --------------------------------------------------------------------------------------------
      * Add this area to the manager to be scanned. MUST BE CALLED ONLY FROM SCRIPT!
     */
@@ -482,6 +564,11 @@ protected:
     */
     SQMOD_NODISCARD bool IsInside(float x, float y) const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Generate the edge arrays used to test points against the area.
+    */
+    void UpdateEdges() const;
+
     /* --------------------------------------------------------------------------------------------
      * Expand the bounding box area to include the given point.
     */
@@ -496,6 +583,9 @@ protected:
 
 /* ------------------------------------------------------------------------------------------------
  * Manager responsible for storing and partitioning areas.
+ * Areas are stored in an adaptive quad-tree. The root cell grows as needed to include any area
+ * and leaf cells are split into quadrants when too many areas that don't cover them entirely
+ * end up in them. This allows point queries to be resolved by descending the tree.
 */
 class AreaManager
 {
@@ -536,12 +626,11 @@ protected:
     };
 
     // --------------------------------------------------------------------------------------------
-    static constexpr int GRIDN = 16; // Number of horizontal and vertical number of cells.
-    static constexpr int GRIDH = GRIDN/2; // Half of the grid horizontal and vertical size.
-    static constexpr int CELLS = GRIDN*GRIDN; // Total number of cells in the grid.
-    static constexpr int CELLH = CELLS/2; // Half total number of cells in the grid.
-    static constexpr int CELLD = 256; // Area covered by a cell in the world.
-    static constexpr int NOCELL = std::numeric_limits< int >::max(); // Inexistent cell index.
+    static constexpr float  CELLD = 4096.0f; // Initial area covered by the root cell in the world.
+    static constexpr float  CELLM = 32.0f; // Cells are not split if the quadrants would be smaller.
+    static constexpr float  CELLX = 16777216.0f; // The root cell does not grow beyond this size.
+    static constexpr size_t SPLIT = 8; // Number of areas in a cell before it should be split.
+    static constexpr int    NOCELL = std::numeric_limits< int >::max(); // Inexistent cell index.
 
     /* --------------------------------------------------------------------------------------------
      * Helper used to queue a certain action if the cell is locked.
@@ -624,17 +713,59 @@ protected:
     */
     void Remove(AreaCell & c, Area & a);
 
+    /* --------------------------------------------------------------------------------------------
+     * Insert an area into all the leaf cells under the specified cell that it intersects with.
+    */
+    void Distribute(AreaCell & c, Area & a, LightObj & obj);
+
+    /* --------------------------------------------------------------------------------------------
+     * Enlarge the root cell until it includes the specified bounding box.
+    */
+    void Grow(float l, float b, float r, float t);
+
+    /* --------------------------------------------------------------------------------------------
+     * Split the leaf cells under the specified cell that hold too many areas.
+    */
+    void Refine(AreaCell & c);
+
+    /* --------------------------------------------------------------------------------------------
+     * Move the areas of a leaf cell into four newly created quadrants.
+    */
+    void Split(AreaCell & c);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a leaf cell would benefit from being split.
+    */
+    SQMOD_NODISCARD static bool ShouldSplit(const AreaCell & c);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the bounding box of an area intersects with a cell.
+    */
+    SQMOD_NODISCARD static bool Overlaps(const AreaCell & c, const Area & a) noexcept
+    {
+        return a.mL <= c.mR && c.mL <= a.mR && a.mB <= c.mT && c.mB <= a.mT;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the bounding box of an area includes a cell entirely.
+    */
+    SQMOD_NODISCARD static bool Covers(const AreaCell & c, const Area & a) noexcept
+    {
+        return a.mL <= c.mL && a.mR >= c.mR && a.mB <= c.mB && a.mT >= c.mT;
+    }
+
 private:
 
     // --------------------------------------------------------------------------------------------
-    Queue       m_Queue; // Actions currently queued.
-    ProcList    m_ProcList; // Actions ready to be completed.
+    Queue               m_Queue; // Actions currently queued.
+    ProcList            m_ProcList; // Actions ready to be completed.
+    // --------------------------------------------------------------------------------------------
+    AreaCell::Pointer   m_Root; // The cell that includes all other cells.
     // --------------------------------------------------------------------------------------------
-    AreaCell    m_Grid[GRIDN][GRIDN]; // A grid of area lists.
+    size_t              m_Reserve; // Area memory to reserve in the root cell.
     // --------------------------------------------------------------------------------------------
-    struct {
-        float   mL, mB, mR, mT;
-    } m_Cells[GRIDN][GRIDN];
+    uint32_t            m_Version; // Incremented whenever the cells or their areas change.
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -680,13 +811,46 @@ public:
     */
     void InsertArea(Area & a, LightObj & obj);
 
+    /* --------------------------------------------------------------------------------------------
+     * Add multiple areas to be managed. The cells are split only after all areas were inserted.
+    */
+    void InsertAreas(AreaCell::Areas & areas);
+
     /* --------------------------------------------------------------------------------------------
      * Add an area to be managed.
     */
     void RemoveArea(Area & a);
 
     /* --------------------------------------------------------------------------------------------
-     * Clear all cell lists and release any script references.
+     * Retrieve the leaf cell that contains the specified point. Null if outside the root cell.
+    */
+    SQMOD_NODISCARD AreaCell * LocateLeaf(float x, float y) const
+    {
+        AreaCell * c = m_Root.get();
+        // Is the point even inside the root cell?
+        if (!c->Contains(x, y))
+        {
+            return nullptr;
+        }
+        // Descend until we find a cell that was not split
+        while (!c->IsLeaf())
+        {
+            c = &(c->Quadrant(x, y));
+        }
+        // Return the cell we found
+        return c;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Update the areas that contain a moving point. The list of areas must be sorted by address.
+     * The areas that the point left or entered are appended to the given lists. Returns false
+     * without testing any area if the point did not leave the region stored in the tracker.
+     * Areas that stop being managed are kept until the point actually leaves them.
+    */
+    bool Track(AreaTracker & tr, AreaCell::Areas & areas, float x, float y, AreaCell::Areas & left, AreaCell::Areas & entered);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the row and column of the cell that contains the specified point.
     */
     Vector2i LocateCell(float x, float y);
 
@@ -695,24 +859,17 @@ public:
     */
     template < typename F > void TestPoint(F && f, float x, float y)
     {
-        // Transform the world coordinates into a cell coordinates
-        const Vector2i cc(LocateCell(x, y));
-        // Were these coordinates valid?
-        if (cc.x == NOCELL)
-        {
-            return; // Not our problem
-        }
-        // Retrieve a reference to the identified cell
-        AreaCell & c = m_Grid[cc.x][cc.y];
-        // Is this cell empty?
-        if (c.mAreas.empty())
+        // Find the cell that contains these coordinates
+        AreaCell * c = LocateLeaf(x, y);
+        // Were these coordinates valid? Is this cell empty?
+        if (c == nullptr || c->mAreas.empty())
         {
             return; // Nothing to test
         }
         // Guard the cell while processing
-        const CellGuard cg(c);
+        const CellGuard cg(*c);
         // Finally, begin processing the areas in this cell
-        for (auto & a : c.mAreas)
+        for (auto & a : c->mAreas)
         {
             if (a.first->TestEx(x, y))
             {
@@ -3,6 +3,11 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
+#include <atomic>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+#include <concurrentqueue.h>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -21,6 +26,110 @@ SQMOD_NODISCARD inline unsigned int NextPow2(unsigned int num)
     return ++num;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Thread-safe pool of memory blocks grouped in power of two size classes.
+*/
+class BufferPool
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr unsigned MIN_CLASS = 3; // Smallest pooled block is 8 bytes.
+    static constexpr unsigned MAX_CLASS = 16; // Largest pooled block is 64 KiB.
+    static constexpr size_t CLASS_BYTES = 512 * 1024; // Maximum memory held idle by each class.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Idle blocks of a certain size.
+    */
+    struct SizeClass
+    {
+        moodycamel::ConcurrentQueue< Buffer::Pointer >  mBlocks{}; // Blocks that can be reused.
+        std::atomic< size_t >                           mCount{0}; // Number of blocks in the queue.
+        size_t                                          mLimit{0}; // Maximum number of idle blocks.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    SizeClass m_Classes[MAX_CLASS - MIN_CLASS + 1];
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    BufferPool()
+    {
+        for (unsigned c = MIN_CLASS; c <= MAX_CLASS; ++c)
+        {
+            m_Classes[c - MIN_CLASS].mLimit = std::min< size_t >(256, std::max< size_t >(8, CLASS_BYTES >> c));
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size class of a block. Returns null if the size is not pooled.
+    */
+    SizeClass * Find(Buffer::SzType n)
+    {
+        // Only power of two sizes within range are pooled
+        if (n < (1u << MIN_CLASS) || n > (1u << MAX_CLASS) || (n & (n - 1)) != 0)
+        {
+            return nullptr;
+        }
+        unsigned c = MIN_CLASS;
+        // Identify the class
+        while ((1u << c) < n)
+        {
+            ++c;
+        }
+        return &m_Classes[c - MIN_CLASS];
+    }
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the pool instance. Never destroyed because buffers can outlive static destruction.
+    */
+    static BufferPool & Get()
+    {
+        static auto * pool = new BufferPool();
+        return *pool;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Obtain a block of the specified size, reusing an idle one if possible.
+    */
+    Buffer::Pointer Acquire(Buffer::SzType n)
+    {
+        SizeClass * sc = Find(n);
+        Buffer::Pointer ptr = nullptr;
+        // Is there an idle block that we can reuse?
+        if (sc && sc->mBlocks.try_dequeue(ptr))
+        {
+            --(sc->mCount);
+            return ptr;
+        }
+        // Allocate a new one
+        return new Buffer::Value[n];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Give back a block of the specified size.
+    */
+    void Recycle(Buffer::Pointer ptr, Buffer::SzType n)
+    {
+        SizeClass * sc = Find(n);
+        // Keep it if the class has room for it
+        if (sc && sc->mCount.load(std::memory_order_relaxed) < sc->mLimit)
+        {
+            ++(sc->mCount);
+            sc->mBlocks.enqueue(ptr);
+        }
+        else
+        {
+            delete[] ptr;
+        }
+    }
+};
+
 // ------------------------------------------------------------------------------------------------
 Buffer::Buffer(const Buffer & o)
     : m_Ptr(nullptr), m_Cap(o.m_Cap), m_Cur(o.m_Cur)
@@ -86,8 +195,8 @@ void Buffer::Grow(SzType n)
 {
     // Backup the current memory
     Buffer bkp(m_Ptr, m_Cap, m_Cur);
-    // Acquire a bigger buffer
-    Request(bkp.m_Cap + n);
+    // Acquire a bigger buffer, at least twice the current size so that appends are amortized
+    Request(std::max(bkp.m_Cap + n, bkp.m_Cap * 2));
     // Copy the data from the old buffer
     std::memcpy(m_Ptr, bkp.m_Ptr, bkp.m_Cap);
     // Copy the previous edit cursor
@@ -102,9 +211,15 @@ void Buffer::Request(SzType n)
     // Round up the size to a power of two number
     n = (n & (n - 1)) ? NextPow2(n) : n;
     // Release previous memory if any
-    delete[] m_Ptr; // Implicitly handles null!
+    if (m_Ptr)
+    {
+        BufferPool::Get().Recycle(m_Ptr, m_Cap);
+        // Don't release it twice if the allocation fails
+        m_Ptr = nullptr;
+        m_Cap = 0;
+    }
     // Attempt to allocate memory
-    m_Ptr = new Value[n];
+    m_Ptr = BufferPool::Get().Acquire(n);
     // If no errors occurred then we can set the size
     m_Cap = n;
 }
@@ -112,8 +227,11 @@ void Buffer::Request(SzType n)
 // ------------------------------------------------------------------------------------------------
 void Buffer::Release()
 {
-    // Deallocate the memory
-    delete[] m_Ptr; // Implicitly handles null!
+    // Give the memory back to the pool
+    if (m_Ptr)
+    {
+        BufferPool::Get().Recycle(m_Ptr, m_Cap);
+    }
     // Explicitly reset the buffer
     m_Ptr = nullptr;
     m_Cap = 0;
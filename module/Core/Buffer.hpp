@@ -479,7 +479,7 @@ public:
         // Do we need to scale the buffer?
         if ((m_Cur + (n * sizeof(T))) > m_Cap)
         {
-            Grow(m_Cur + (n * sizeof(T)));
+            Grow((m_Cur + (n * sizeof(T))) - m_Cap);
         }
         // Advance to the specified position
         m_Cur += (n * sizeof(T));
@@ -510,7 +510,7 @@ public:
         // Do we need to scale the buffer?
         if ((n * sizeof(T)) > m_Cap)
         {
-            Grow(n * sizeof(T));
+            Grow((n * sizeof(T)) - m_Cap);
         }
         // Move to the specified position
         m_Cur = (n * sizeof(T));
@@ -524,7 +524,7 @@ public:
         // Do we need to scale the buffer?
         if ((m_Cur + sizeof(T)) > m_Cap)
         {
-            Grow(m_Cap + sizeof(T));
+            Grow((m_Cur + sizeof(T)) - m_Cap);
         }
         // Assign the specified value
         *reinterpret_cast< T * >(m_Ptr + m_Cur) = v;
@@ -691,7 +691,8 @@ public:
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Grow the size of the internal buffer by the specified amount of bytes.
+     * Grow the size of the internal buffer by at least the specified amount of bytes.
+     * The capacity is at least doubled so that repeated appends are amortized.
     */
     void Grow(SzType n);
 
@@ -154,18 +154,15 @@ Object & Controller::Attach(Object && obj, Listener * ptr)
     // Obtain the unique identifier of the specified name
     const std::size_t hash = std::hash< String >()(name);
     // Make sure the command doesn't already exist
-    for (const auto & cmd : m_Commands)
+    if (m_Index.find(name) != m_Index.end())
     {
-        // Are the hashes identical?
-        if (cmd.mHash == hash)
-        {
-            // Include information necessary to help identify hash collisions!
-            STHROWF("Command '{}' already exists as '{}' for hash ({})",
-                        name.c_str(), cmd.mName.c_str(), hash);
-        }
+        STHROWF("Command '{}' already exists", name.c_str());
     }
     // Attempt to insert the command
     m_Commands.emplace_back(hash, name, ptr, std::move(obj), m_Manager->GetCtr());
+    // Index the command
+    m_Index.emplace(m_Commands.back().mName, m_Commands.size() - 1);
+    m_Sorted.clear();
     // Return the script object of the listener
     return m_Commands.back().mObj;
 }
@@ -211,18 +208,15 @@ Object & Controller::Attach(Object && obj, Listener * ptr, String name)
     // Obtain the unique identifier of the specified name
     const std::size_t hash = std::hash< String >()(name);
     // Make sure the command doesn't already exist
-    for (const auto & cmd : m_Commands)
+    if (m_Index.find(name) != m_Index.end())
     {
-        // Are the hashes identical?
-        if (cmd.mHash == hash)
-        {
-            // Include information necessary to help identify hash collisions!
-            STHROWF("Command '{}' already exists as '{}' for hash ({})",
-                        name.c_str(), cmd.mName.c_str(), hash);
-        }
+        STHROWF("Command '{}' already exists", name.c_str());
     }
     // Attempt to insert the command
     m_Commands.emplace_back(hash, std::move(name), ptr, std::move(obj), m_Manager->GetCtr());
+    // Index the command
+    m_Index.emplace(m_Commands.back().mName, m_Commands.size() - 1);
+    m_Sorted.clear();
     // Return the script object of the listener
     return m_Commands.back().mObj;
 }
@@ -332,17 +326,20 @@ int32_t Controller::Run(const Guard & guard, const char * command)
         return -1;
     }
     // Attempt to find the specified command
-    ctx.mObject = FindByName(ctx.mCommand);
+    const Command * cmd = m_Abbreviate ? FindAbbreviated(ctx.mCommand) : Find(ctx.mCommand);
     // Have we found anything?
-    if (ctx.mObject.IsNull())
+    if (cmd == nullptr || cmd->mObj.IsNull())
     {
         // Tell the script callback to deal with the error
         SqError(CMDERR_UNKNOWN_COMMAND, _SC("Unable to find the specified command"), ctx.mCommand);
         // Execution failed!
         return -1;
     }
+    // Save the command object and use the full name in case it was abbreviated
+    ctx.mObject = cmd->mObj;
+    ctx.mCommand.assign(cmd->mName);
     // Save the command instance
-    ctx.mInstance = ctx.mObject.Cast< Listener * >();
+    ctx.mInstance = cmd->mPtr ? cmd->mPtr : ctx.mObject.Cast< Listener * >();
     // Is the command instance valid? (just in case)
     if (!ctx.mInstance)
     {
@@ -373,8 +370,9 @@ int32_t Controller::Run(const Guard & guard, const char * command)
 // ------------------------------------------------------------------------------------------------
 int32_t Controller::Exec(Context & ctx)
 {
-    // Clear previous arguments
+    // Clear previous arguments and make room for as many as the command accepts
     ctx.mArgv.clear();
+    ctx.mArgv.reserve(static_cast< size_t >(ctx.mInstance->GetMaxArgC()));
     // Reset the argument counter
     ctx.mArgc = 0;
     // Is this command suspended from further executions?
@@ -1172,12 +1170,15 @@ void Register(HSQUIRRELVM vm)
         .Prop(_SC("Listener"), &Manager::GetListener)
         .Prop(_SC("Command"), &Manager::GetCommand)
         .Prop(_SC("Argument"), &Manager::GetArgument)
+        .Prop(_SC("Abbreviate"), &Manager::GetAbbreviate, &Manager::SetAbbreviate)
         // Member Methods
         .FmtFunc(_SC("Run"), &Manager::Run)
         .Func(_SC("Sort"), &Manager::Sort)
         .Func(_SC("Clear"), &Manager::Clear)
         .Func(_SC("Attach"), &Manager::Attach)
         .FmtFunc(_SC("FindByName"), &Manager::FindByName)
+        .FmtFunc(_SC("FindByPrefix"), &Manager::FindByPrefix)
+        .FmtFunc(_SC("Complete"), &Manager::Complete)
         .CbFunc(_SC("BindFail"), &Manager::SetOnFail)
         .CbFunc(_SC("BindAuth"), &Manager::SetOnAuth)
         .Func(_SC("GetArray"), &Manager::GetCommandsArray)
@@ -12,6 +12,7 @@
 #include <map>
 #include <vector>
 #include <iterator>
+#include <unordered_map>
 #include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
@@ -348,6 +349,11 @@ private:
     Commands        m_Commands; // List of available command instances.
     CtxRef          m_Context; // Context of the currently executed command.
 
+    // --------------------------------------------------------------------------------------------
+    std::unordered_map< String, size_t >    m_Index; // Position of each command name in the list.
+    std::vector< size_t >                   m_Sorted; // Positions ordered by name. Rebuilt when needed.
+    bool                                    m_Abbreviate; // Whether unique name prefixes run the command.
+
     // --------------------------------------------------------------------------------------------
     Function        m_OnFail; // Callback when something failed while running a command.
     Function        m_OnAuth; // Callback to authenticate execution for a certain invoker.
@@ -366,6 +372,9 @@ protected:
     explicit Controller(Manager * mgr)
         : m_Commands()
         , m_Context()
+        , m_Index()
+        , m_Sorted()
+        , m_Abbreviate(false)
         , m_OnFail()
         , m_OnAuth()
         , m_Manager(mgr)
@@ -402,6 +411,93 @@ protected:
         }
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Rebuild the name index after the positions of the commands have changed.
+    */
+    void Reindex()
+    {
+        m_Index.clear();
+        m_Index.reserve(m_Commands.size());
+        // Map each name to its position
+        for (size_t i = 0; i < m_Commands.size(); ++i)
+        {
+            m_Index.emplace(m_Commands[i].mName, i);
+        }
+        // Prefix index is rebuilt on demand
+        m_Sorted.clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the positions of the commands ordered by name.
+    */
+    const std::vector< size_t > & GetSorted()
+    {
+        // Is the prefix index outdated?
+        if (m_Sorted.size() != m_Commands.size())
+        {
+            m_Sorted.resize(m_Commands.size());
+            // Start with the current order
+            for (size_t i = 0; i < m_Sorted.size(); ++i)
+            {
+                m_Sorted[i] = i;
+            }
+            std::sort(m_Sorted.begin(), m_Sorted.end(), [this](size_t a, size_t b) -> bool {
+                return (m_Commands[a].mName < m_Commands[b].mName);
+            });
+        }
+        return m_Sorted;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the range of sorted positions with names that begin with the specified prefix.
+    */
+    std::pair< std::vector< size_t >::const_iterator, std::vector< size_t >::const_iterator >
+        PrefixRange(const String & prefix)
+    {
+        const std::vector< size_t > & sorted = GetSorted();
+        // Find the first name that is not less than the prefix
+        auto first = std::lower_bound(sorted.cbegin(), sorted.cend(), prefix, [this](size_t i, const String & p) -> bool {
+            return (m_Commands[i].mName < p);
+        });
+        auto last = first;
+        // Names with the same prefix are adjacent
+        while (last != sorted.cend() && m_Commands[*last].mName.compare(0, prefix.size(), prefix) == 0)
+        {
+            ++last;
+        }
+        return {first, last};
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Locate a command by name. Returns null if not found.
+    */
+    SQMOD_NODISCARD const Command * Find(const String & name) const
+    {
+        auto itr = m_Index.find(name);
+        // Was there a command with this name?
+        return (itr == m_Index.end()) ? nullptr : &m_Commands[itr->second];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Locate a command by name or a unique prefix of its name. Returns null if not found or ambiguous.
+    */
+    const Command * FindAbbreviated(const String & name)
+    {
+        // Exact matches have priority
+        const Command * cmd = Find(name);
+        // Try the prefix if necessary
+        if (cmd == nullptr)
+        {
+            auto range = PrefixRange(name);
+            // Only a single match is accepted
+            if (std::distance(range.first, range.second) == 1)
+            {
+                cmd = &m_Commands[*range.first];
+            }
+        }
+        return cmd;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Execute one of the managed commands.
     */
@@ -464,16 +560,14 @@ protected:
     */
     void Detach(const String & name)
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
         // Attempt to find the specified command
-        auto itr = std::find_if(m_Commands.cbegin(), m_Commands.cend(), [=](Commands::const_reference c) {
-            return (c.mHash == hash);
-        });
+        auto itr = m_Index.find(name);
         // Make sure the command exist before attempting to remove it
-        if (itr != m_Commands.end())
+        if (itr != m_Index.end())
         {
-            m_Commands.erase(itr);
+            m_Commands.erase(m_Commands.begin() + static_cast< std::ptrdiff_t >(itr->second));
+            // Positions have changed
+            Reindex();
         }
     }
 
@@ -490,6 +584,8 @@ protected:
         if (itr != m_Commands.end())
         {
             m_Commands.erase(itr);
+            // Positions have changed
+            Reindex();
         }
     }
 
@@ -552,19 +648,7 @@ public:
     */
     SQMOD_NODISCARD bool Attached(const String & name) const
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
-        // Attempt to find the specified command
-        for (const auto & cmd : m_Commands) // NOLINT(readability-use-anyofallof)
-        {
-            // Are the hashes identical?
-            if (cmd.mHash == hash)
-            {
-                return true; // We found our command!
-            }
-        }
-        // No such command exists
-        return false;
+        return (m_Index.find(name) != m_Index.end());
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -594,6 +678,8 @@ public:
             [](Commands::const_reference a, Commands::const_reference b) -> bool {
                 return (a.mName < b.mName); // NOLINT(modernize-use-nullptr)
             });
+        // Positions have changed
+        Reindex();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -602,6 +688,8 @@ public:
     void Clear()
     {
         m_Commands.clear();
+        m_Index.clear();
+        m_Sorted.clear();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -609,19 +697,52 @@ public:
     */
     const Object & FindByName(const String & name)
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
-        // Attempt to find the specified command
-        for (const auto & cmd : m_Commands)
+        const Command * cmd = Find(name);
+        // Return the listener if found
+        return cmd ? cmd->mObj : NullObject();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Locate and retrieve a command listener by name or by a unique prefix of its name.
+    */
+    const Object & FindByPrefix(const String & prefix)
+    {
+        const Command * cmd = FindAbbreviated(prefix);
+        // Return the listener if found
+        return cmd ? cmd->mObj : NullObject();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the names of the commands which begin with the specified prefix, in ascending order.
+    */
+    SQMOD_NODISCARD Array Complete(const String & prefix, SQInteger limit)
+    {
+        auto range = PrefixRange(prefix);
+        // Allocate an empty array
+        Array arr(SqVM());
+        // Populate the array with the matching names
+        for (auto itr = range.first; itr != range.second && (limit <= 0 || arr.Length() < limit); ++itr)
         {
-            // Are the hashes identical?
-            if (cmd.mHash == hash)
-            {
-                return cmd.mObj; // We found our command!
-            }
+            arr.Append(m_Commands[*itr].mName);
         }
-        // No such command exist
-        return NullObject();
+        // Return the resulted array
+        return arr;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether unique prefixes of command names are accepted when running commands.
+    */
+    SQMOD_NODISCARD bool GetAbbreviate() const
+    {
+        return m_Abbreviate;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Set whether unique prefixes of command names are accepted when running commands.
+    */
+    void SetAbbreviate(bool toggle)
+    {
+        m_Abbreviate = toggle;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -927,6 +1048,54 @@ public:
         return GetValid()->FindByName(String(name.mPtr, static_cast< size_t >(name.mLen)));
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Locate and retrieve a command listener by name or by a unique prefix of its name.
+    */
+    const Object & FindByPrefix(StackStrF & prefix)
+    {
+        // Validate the specified prefix
+        if ((SQ_FAILED(prefix.Proc())))
+        {
+            STHROWF("Unable to extract a valid command name");
+        }
+        else if (prefix.mLen <= 0)
+        {
+            STHROWF("Invalid or empty command name");
+        }
+        // Attempt to return the requested command
+        return GetValid()->FindByPrefix(String(prefix.mPtr, static_cast< size_t >(prefix.mLen)));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the names of the commands which begin with the specified prefix.
+    */
+    SQMOD_NODISCARD Array Complete(SQInteger limit, StackStrF & prefix)
+    {
+        // Validate the specified prefix
+        if ((SQ_FAILED(prefix.Proc())))
+        {
+            STHROWF("Unable to extract a valid command name");
+        }
+        // Attempt to return the matching names
+        return GetValid()->Complete(String(prefix.mPtr, static_cast< size_t >(prefix.mLen <= 0 ? 0 : prefix.mLen)), limit);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether unique prefixes of command names are accepted when running commands.
+    */
+    SQMOD_NODISCARD bool GetAbbreviate() const
+    {
+        return GetValid()->GetAbbreviate();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Set whether unique prefixes of command names are accepted when running commands.
+    */
+    void SetAbbreviate(bool toggle)
+    {
+        GetValid()->SetAbbreviate(toggle);
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the number of managed command listeners.
     */
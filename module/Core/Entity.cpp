@@ -1,6 +1,8 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core/Entity.hpp"
 #include "Core.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Logger.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -139,6 +141,8 @@ void BlipInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->DestroyCoordBlip(mID);
     }
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_BLIP).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -192,6 +196,8 @@ void CheckpointInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->DeleteCheckPoint(mID);
     }
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_CHECKPOINT).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -233,6 +239,8 @@ void KeyBindInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->RemoveKeyBind(mID);
     }
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_KEYBIND).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -286,6 +294,10 @@ void ObjectInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->DeleteObject(mID);
     }
+    // Stop tracking the position of this entity
+    SpatialIndex::Get().Remove(ENT_OBJECT, mID);
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_OBJECT).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -339,6 +351,10 @@ void PickupInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->DeletePickup(mID);
     }
+    // Stop tracking the position of this entity
+    SpatialIndex::Get().Remove(ENT_PICKUP, mID);
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_PICKUP).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -386,6 +402,10 @@ void PlayerInst::Destroy(bool /*destroy*/, int32_t header, LightObj & payload)
 #endif
     // Release tasks, if any
     CleanupTasks(mID, ENT_PLAYER);
+    // Stop tracking the position of this entity
+    SpatialIndex::Get().Remove(ENT_PLAYER, mID);
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_PLAYER).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -439,6 +459,10 @@ void VehicleInst::Destroy(bool destroy, int32_t header, LightObj & payload)
         // Now attempt to destroy this entity from the server
         _Func->DeleteVehicle(mID);
     }
+    // Stop tracking the position of this entity
+    SpatialIndex::Get().Remove(ENT_VEHICLE, mID);
+    // Forget the tag of this entity
+    TagIndex::Get(ENT_VEHICLE).Remove(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
@@ -495,6 +519,7 @@ void PlayerInst::ResetInstance()
     mID = -1;
     mFlags = ENF_DEFAULT;
     mAreas.clear();
+    mAreaTracker.Reset();
     mDistance = 0;
     mTrackPosition = 0;
     mTrackHeading = 0;
@@ -516,6 +541,7 @@ void VehicleInst::ResetInstance()
     mID = -1;
     mFlags = ENF_DEFAULT;
     mAreas.clear();
+    mAreaTracker.Reset();
     mDistance = 0;
     mTrackPosition = 0;
     mTrackRotation = 0;
@@ -15,6 +15,25 @@ namespace SqMod {
 // --------------------------------------------------------------------------------------------
 typedef std::vector< std::pair< Area *, LightObj > > AreaList; // List of collided areas.
 
+/* --------------------------------------------------------------------------------------------
+ * Region around the last known position of an entity where the collided areas cannot change.
+*/
+struct AreaTracker
+{
+    // ----------------------------------------------------------------------------------------
+    uint32_t    mVersion{0}; // Version of the area manager when the region was computed.
+    float       mL{0}, mB{0}, mR{0}, mT{0}; // Left-Bottom, Right-Top components of the region.
+
+    /* ----------------------------------------------------------------------------------------
+     * Forget the region so that the next test is performed in full.
+    */
+    void Reset()
+    {
+        mVersion = 0;
+        mL = mB = mR = mT = 0;
+    }
+};
+
 // --------------------------------------------------------------------------------------------
 #ifdef VCMP_ENABLE_OFFICIAL
     struct LgCheckpoint;
@@ -499,7 +518,8 @@ struct PlayerInst
     LightObj        mObj{}; // Script object of the instance used to interact this entity.
 
     // ----------------------------------------------------------------------------------------
-    AreaList        mAreas{}; // Areas the player is currently in.
+    AreaList        mAreas{}; // Areas the player is currently in. (sorted by address)
+    AreaTracker     mAreaTracker{}; // Used to skip area tests while the player doesn't leave a region.
     double          mDistance{0}; // Distance traveled while tracking was enabled.
 
     // ----------------------------------------------------------------------------------------
@@ -680,7 +700,8 @@ struct VehicleInst
     LightObj        mObj{}; // Script object of the instance used to interact this entity.
 
     // ----------------------------------------------------------------------------------------
-    AreaList        mAreas{}; // Areas the vehicle is currently in.
+    AreaList        mAreas{}; // Areas the vehicle is currently in. (sorted by address)
+    AreaTracker     mAreaTracker{}; // Used to skip area tests while the vehicle doesn't leave a region.
     double          mDistance{0}; // Distance traveled while tracking was enabled.
 
     // ----------------------------------------------------------------------------------------
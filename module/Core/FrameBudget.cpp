@@ -0,0 +1,248 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/FrameBudget.hpp"
+#include "Core/Utility.hpp"
+#include "Logger.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+extern size_t ProcessThreads(FrameSlice & slice);
+extern size_t ProcessNet(FrameSlice & slice);
+extern size_t ProcessSQLite(FrameSlice & slice);
+extern size_t ProcessCURL(FrameSlice & slice);
+extern size_t ProcessZMQ(FrameSlice & slice);
+extern size_t ProcessGC(FrameSlice & slice);
+#ifdef SQMOD_DISCORD
+    extern size_t ProcessDiscord(FrameSlice & slice);
+#endif
+
+// ------------------------------------------------------------------------------------------------
+FrameBudget FrameBudget::s_Inst;
+
+// ------------------------------------------------------------------------------------------------
+static size_t ProcessLogger(FrameSlice & slice)
+{
+    return Logger::Get().ProcessQueue(slice);
+}
+
+// ------------------------------------------------------------------------------------------------
+FrameBudget::FrameBudget()
+    : m_Stages(), m_Next(0), m_FrameTime(0)
+{
+    // Register the built-in stages. Budgets can be changed from the configuration file or scripts
+    Register("Threads", &ProcessThreads, 0, 4000);
+    Register("Net", &ProcessNet, 0, 2000);
+    Register("SQLite", &ProcessSQLite, 0, 2000);
+    Register("HTTP", &ProcessCURL, 0, 2000);
+#ifdef SQMOD_DISCORD
+    Register("Discord", &ProcessDiscord, 0, 2000);
+#endif
+    Register("Logger", &ProcessLogger, 0, 2000);
+    Register("GC", &ProcessGC, 0, 1000);
+    // Sockets are flushed only when the script asks for it
+    Register("ZMQ", &ProcessZMQ, 0, 2000, true);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t FrameBudget::Register(const String & name, Drain drain, size_t items, int64_t time, bool manual)
+{
+    m_Stages.emplace_back();
+    // Initialize the stage
+    Stage & s = m_Stages.back();
+    s.mName.assign(name);
+    s.mDrain = drain;
+    s.mManual = manual;
+    s.mItems = items;
+    s.mTime = time > 0 ? time : 0;
+    // Return the index of the stage
+    return m_Stages.size() - 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void FrameBudget::Process()
+{
+    const size_t n = m_Stages.size();
+    // Remember when the frame started
+    const int64_t start = m_FrameTime > 0 ? FrameSlice::Now() : 0;
+    // Go over all stages, starting with a different one on each frame
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t idx = (m_Next + i) % n;
+        // Is this stage run only on request?
+        if (m_Stages[idx].mManual)
+        {
+            continue;
+        }
+        // Has the frame budget been exhausted? The first stage is always allowed to run
+        else if (m_FrameTime > 0 && i > 0 && (FrameSlice::Now() - start) >= m_FrameTime)
+        {
+            ++m_Stages[idx].mSkipped;
+            // The work is carried over to the next frame
+            continue;
+        }
+        Run(idx);
+    }
+    // Rotate so that every stage gets to go first
+    if (n > 0)
+    {
+        m_Next = (m_Next + 1) % n;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t FrameBudget::Run(size_t idx)
+{
+    Stage & s = GetStage(static_cast< SQInteger >(idx));
+    // Create the slice in which the stage is allowed to work
+    FrameSlice slice(s.mItems, s.mTime);
+    // Remember when the stage started
+    const int64_t start = FrameSlice::Now();
+    // Let the stage do its work
+    s.mBacklog = s.mDrain(slice);
+    // Update statistics
+    s.mLastTime = FrameSlice::Now() - start;
+    s.mMaxTime = std::max(s.mMaxTime, s.mLastTime);
+    s.mProcessed += slice.mCount;
+    ++s.mRuns;
+    // Did the stage stop because of the budget?
+    if (slice.mHit && s.mBacklog > 0)
+    {
+        ++s.mOverruns;
+    }
+    // Return what was left
+    return s.mBacklog;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger FrameBudget::Find(const String & name) const
+{
+    for (size_t i = 0; i < m_Stages.size(); ++i)
+    {
+        if (m_Stages[i].mName == name)
+        {
+            return static_cast< SQInteger >(i);
+        }
+    }
+    // Not found
+    return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+FrameBudget::Stage & FrameBudget::GetStage(SQInteger idx)
+{
+    if (idx < 0 || static_cast< size_t >(idx) >= m_Stages.size())
+    {
+        STHROWF("Invalid frame budget stage ({})", idx);
+    }
+    // Stage is valid
+    return m_Stages[static_cast< size_t >(idx)];
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqFrameBudget_Find(StackStrF & name)
+{
+    return FrameBudget::Get().Find(String(name.mPtr, static_cast< size_t >(name.mLen <= 0 ? 0 : name.mLen)));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqFrameBudget_Count()
+{
+    return static_cast< SQInteger >(FrameBudget::Get().GetCount());
+}
+
+// ------------------------------------------------------------------------------------------------
+static const String & SqFrameBudget_Name(SQInteger idx)
+{
+    return FrameBudget::Get().GetStage(idx).mName;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqFrameBudget_GetItems(SQInteger idx)
+{
+    return static_cast< SQInteger >(FrameBudget::Get().GetStage(idx).mItems);
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqFrameBudget_SetItems(SQInteger idx, SQInteger items)
+{
+    FrameBudget::Get().GetStage(idx).mItems = items > 0 ? static_cast< size_t >(items) : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqFrameBudget_GetTime(SQInteger idx)
+{
+    return static_cast< SQInteger >(FrameBudget::Get().GetStage(idx).mTime);
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqFrameBudget_SetTime(SQInteger idx, SQInteger time)
+{
+    FrameBudget::Get().GetStage(idx).mTime = time > 0 ? static_cast< int64_t >(time) : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqFrameBudget_GetFrameTime()
+{
+    return static_cast< SQInteger >(FrameBudget::Get().GetFrameTime());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqFrameBudget_SetFrameTime(SQInteger time)
+{
+    FrameBudget::Get().SetFrameTime(static_cast< int64_t >(time));
+}
+
+// ------------------------------------------------------------------------------------------------
+static Table SqFrameBudget_Stats(SQInteger idx)
+{
+    const FrameBudget::Stage & s = FrameBudget::Get().GetStage(idx);
+    // Create the table with the statistics
+    Table t(SqVM());
+    t.SetValue(_SC("Runs"), static_cast< SQInteger >(s.mRuns));
+    t.SetValue(_SC("Processed"), static_cast< SQInteger >(s.mProcessed));
+    t.SetValue(_SC("Overruns"), static_cast< SQInteger >(s.mOverruns));
+    t.SetValue(_SC("Skipped"), static_cast< SQInteger >(s.mSkipped));
+    t.SetValue(_SC("Backlog"), static_cast< SQInteger >(s.mBacklog));
+    t.SetValue(_SC("LastTime"), static_cast< SQInteger >(s.mLastTime));
+    t.SetValue(_SC("MaxTime"), static_cast< SQInteger >(s.mMaxTime));
+    // Return the table
+    return t;
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqFrameBudget_ResetStats(SQInteger idx)
+{
+    FrameBudget::Stage & s = FrameBudget::Get().GetStage(idx);
+    // Backlog is current state, not accumulated
+    s.mRuns = 0;
+    s.mProcessed = 0;
+    s.mOverruns = 0;
+    s.mSkipped = 0;
+    s.mLastTime = 0;
+    s.mMaxTime = 0;
+}
+
+// ================================================================================================
+void Register_FrameBudget(HSQUIRRELVM vm)
+{
+    RootTable(vm)
+    .Bind(_SC("SqFrameBudget"), Table(vm)
+        .Func(_SC("Count"), &SqFrameBudget_Count)
+        .FmtFunc(_SC("Find"), &SqFrameBudget_Find)
+        .Func(_SC("Name"), &SqFrameBudget_Name)
+        .Func(_SC("GetItems"), &SqFrameBudget_GetItems)
+        .Func(_SC("SetItems"), &SqFrameBudget_SetItems)
+        .Func(_SC("GetTime"), &SqFrameBudget_GetTime)
+        .Func(_SC("SetTime"), &SqFrameBudget_SetTime)
+        .Func(_SC("GetFrameTime"), &SqFrameBudget_GetFrameTime)
+        .Func(_SC("SetFrameTime"), &SqFrameBudget_SetFrameTime)
+        .Func(_SC("Stats"), &SqFrameBudget_Stats)
+        .Func(_SC("ResetStats"), &SqFrameBudget_ResetStats)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,246 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "SqBase.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Limits how much work a main-thread drain is allowed to perform in a single call.
+ * Whatever is left in the drained queue is simply carried over to the next call.
+*/
+struct FrameSlice
+{
+    size_t  mLimit{0}; // Maximum number of items that can be processed. Zero if unlimited.
+    int64_t mDeadline{0}; // Time-point after which no more items are processed. Zero if unlimited.
+    size_t  mCount{0}; // Number of items processed so far.
+    bool    mHit{false}; // Whether an item was refused because the slice was exhausted.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor. Creates an unlimited slice.
+    */
+    FrameSlice() noexcept = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor. The time is relative to the moment of construction, in microseconds.
+    */
+    FrameSlice(size_t limit, int64_t time) noexcept
+        : mLimit(limit), mDeadline(time > 0 ? Now() + time : 0), mCount(0), mHit(false)
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a monotonic time-point in microseconds.
+    */
+    SQMOD_NODISCARD static int64_t Now() noexcept
+    {
+        return std::chrono::duration_cast< std::chrono::microseconds >(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See if another item can be processed. The first item is always allowed.
+    */
+    SQMOD_NODISCARD bool Allow() noexcept
+    {
+        if (mCount > 0 && ((mLimit > 0 && mCount >= mLimit) || (mDeadline > 0 && Now() >= mDeadline)))
+        {
+            mHit = true;
+            // Leave the rest for later
+            return false;
+        }
+        // Allowed
+        return true;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Account for a processed item.
+    */
+    void Count() noexcept
+    {
+        ++mCount;
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Let each instance of a chain drain its work within a shared slice. Every call begins where the
+ * previous one ran out of budget, so the instances at the front of the chain cannot keep the slice
+ * to themselves. Instances past that point are still visited to report what they have left.
+*/
+template < typename T, typename F > inline size_t ProcessChain(size_t & cursor, FrameSlice & slice, F && f)
+{
+    size_t count = 0, left = 0;
+    // Find how many instances there are
+    for (T * inst = T::sHead; inst && inst->mNext != T::sHead; inst = inst->mNext)
+    {
+        ++count;
+    }
+    // Is there anything to process?
+    if (count == 0)
+    {
+        cursor = 0;
+        return 0;
+    }
+    size_t pos = cursor % count;
+    T * inst = T::sHead;
+    // Find the instance that goes first
+    for (size_t i = 0; i < pos; ++i)
+    {
+        inst = inst->mNext;
+    }
+    // Visit each instance once, wrapping around to the front of the chain
+    for (size_t n = 0; n < count && inst; ++n)
+    {
+        const bool hit = slice.mHit;
+        left += f(*inst);
+        // Did this instance exhaust the slice? Then the next one goes first next time
+        if (!hit && slice.mHit)
+        {
+            cursor = pos + 1;
+        }
+        inst = inst->mNext;
+        // Did we reach the end of the chain?
+        if (++pos == count || !inst || inst == T::sHead)
+        {
+            inst = T::sHead, pos = 0;
+        }
+    }
+    // Return what was left for later
+    return left;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Schedules the main-thread drains performed on each server frame. Each stage has its own budget
+ * and the stage which goes first is rotated every frame so that no stage is constantly left last.
+*/
+class FrameBudget
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Process items within the given slice and return how many items are (approximately) left.
+    */
+    typedef size_t (*Drain)(FrameSlice & slice);
+
+    /* --------------------------------------------------------------------------------------------
+     * Information about a single stage.
+    */
+    struct Stage
+    {
+        String      mName{}; // The name of the stage. Also used to identify it in the configuration.
+        Drain       mDrain{nullptr}; // The function that performs the work.
+        bool        mManual{false}; // Whether the stage is not run automatically on each frame.
+        // ----------------------------------------------------------------------------------------
+        size_t      mItems{0}; // Maximum number of items per run. Zero if unlimited.
+        int64_t     mTime{0}; // Maximum time per run in microseconds. Zero if unlimited.
+        // ----------------------------------------------------------------------------------------
+        uint64_t    mRuns{0}; // How many times the stage was run.
+        uint64_t    mProcessed{0}; // How many items were processed.
+        uint64_t    mOverruns{0}; // How many times the stage stopped with work left because of the budget.
+        uint64_t    mSkipped{0}; // How many times the stage did not run because the frame budget ran out.
+        size_t      mBacklog{0}; // Items left after the last run.
+        int64_t     mLastTime{0}; // Time spent in the last run.
+        int64_t     mMaxTime{0}; // Longest time spent in a single run.
+    };
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    static FrameBudget s_Inst; // FrameBudget instance.
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< Stage >    m_Stages; // Registered stages.
+    size_t                  m_Next; // The stage that goes first on the next frame.
+    int64_t                 m_FrameTime; // Maximum time for all stages in a frame. Zero if unlimited.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    FrameBudget();
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    FrameBudget(const FrameBudget & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    FrameBudget(FrameBudget && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    FrameBudget & operator = (const FrameBudget & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    FrameBudget & operator = (FrameBudget && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the frame budget instance.
+    */
+    static FrameBudget & Get()
+    {
+        return s_Inst;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Register a stage and return its index.
+    */
+    size_t Register(const String & name, Drain drain, size_t items, int64_t time, bool manual = false);
+
+    /* --------------------------------------------------------------------------------------------
+     * Run all automatic stages. Invoked on each server frame.
+    */
+    void Process();
+
+    /* --------------------------------------------------------------------------------------------
+     * Run a single stage within its budget and return how many items are left.
+    */
+    size_t Run(size_t idx);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of the stage with the specified name. Returns -1 if not found.
+    */
+    SQMOD_NODISCARD SQInteger Find(const String & name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of registered stages.
+    */
+    SQMOD_NODISCARD size_t GetCount() const
+    {
+        return m_Stages.size();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a stage and throw an exception if the index is not valid.
+    */
+    SQMOD_NODISCARD Stage & GetStage(SQInteger idx);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum time for all stages in a frame.
+    */
+    SQMOD_NODISCARD int64_t GetFrameTime() const
+    {
+        return m_FrameTime;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum time for all stages in a frame.
+    */
+    void SetFrameTime(int64_t time)
+    {
+        m_FrameTime = time > 0 ? time : 0;
+    }
+};
+
+} // Namespace:: SqMod
@@ -52,6 +52,21 @@ void PvManager::Terminate()
     m_Classes.clear();
     m_Units.clear();
     m_Entries.clear();
+    // Forget the entry slots as well
+    IndexEntries();
+}
+
+// ------------------------------------------------------------------------------------------------
+void PvManager::IndexEntries()
+{
+    m_Slots.clear();
+    // Entries are stored contiguously so their position makes a good slot
+    for (size_t i = 0; i < m_Entries.size(); ++i)
+    {
+        m_Slots.emplace((m_Entries.begin() + static_cast< ptrdiff_t >(i))->first.mID, i);
+    }
+    // Snapshots compiled with the previous slots are no longer valid
+    InvalidateSnapshots();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -70,6 +85,8 @@ LightObj PvManager::CreateEntry(SQInteger id, StackStrF & name)
     const auto h = name.CacheHash().GetHash();
     // Create it now
     auto & e = m_Entries.emplace_back(PvIdentity(id, h), std::make_shared< PvEntry >(id, std::move(name), this));
+    // Give the new entry a slot in the snapshots
+    IndexEntries();
     // Create a wrapper instance and return it
     return LightObj(SqTypeIdentity< SqPvEntry >{}, SqVM(), e);
 }
@@ -356,6 +373,8 @@ void PvManager::RemoveEntryWithID(SQInteger id)
     }
     // Finally remove it from the list
     m_Entries.erase(PvIdentity(id));
+    // Entries after this one have moved to another slot
+    IndexEntries();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -381,6 +400,8 @@ void PvManager::RemoveEntryWithTag(StackStrF & tag)
     if (itr != m_Entries.end())
     {
         m_Entries.erase(itr);
+        // Entries after this one have moved to another slot
+        IndexEntries();
     }
 }
 
@@ -410,6 +431,8 @@ void PvManager::RemoveClassWithID(SqPvClass & sub, SQInteger id)
     }
     // Finally remove it from the list
     m_Classes.erase(PvIdentity(id));
+    // Discard anything that was compiled from this class
+    InvalidateSnapshots();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -444,6 +467,8 @@ void PvManager::RemoveClassWithTag(SqPvClass & sub, StackStrF & tag)
     {
         m_Classes.erase(itr);
     }
+    // Discard anything that was compiled from this class
+    InvalidateSnapshots();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -15,6 +15,9 @@
 #include "Core/Privilege/Class.hpp"
 #include "Core/Privilege/Entry.hpp"
 
+// ------------------------------------------------------------------------------------------------
+#include <unordered_map>
+
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
@@ -75,6 +78,16 @@ struct PvManager : SqChainedInstances< PvManager >
     bool                m_LockClasses;
     bool                m_LockUnits;
 
+    /* --------------------------------------------------------------------------------------------
+     * Slot of each entry in the privilege snapshots of the units.
+    */
+    std::unordered_map< SQInteger, size_t > m_Slots;
+
+    /* --------------------------------------------------------------------------------------------
+     * Incremented by every change that can alter the effective privileges of more than one unit.
+    */
+    uint64_t            m_Version;
+
 public:
 
     /* -------------------------------------------------------------------------------------------
@@ -85,6 +98,7 @@ public:
         , m_OnQuery(),  m_OnModify(),  m_OnGained(), m_OnLost()
         , m_Tag(), m_Data()
         , m_LockEntries(false), m_LockClasses(false), m_LockUnits(false)
+        , m_Slots(), m_Version(1)
     {
         // Remember this instance
         ChainInstance();
@@ -98,6 +112,7 @@ public:
         , m_OnQuery(), m_OnModify(), m_OnGained(), m_OnLost()
         , m_Tag(std::move(tag)), m_Data()
         , m_LockEntries(false), m_LockClasses(false), m_LockUnits(false)
+        , m_Slots(), m_Version(1)
     {
         // Remember this instance
         ChainInstance();
@@ -191,6 +206,29 @@ public:
     */
     void Terminate();
 
+    /* --------------------------------------------------------------------------------------------
+     * Discard the privilege snapshots of all units. They will be compiled again by the next query.
+    */
+    void InvalidateSnapshots()
+    {
+        ++m_Version;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Assign a snapshot slot to each entry after entries were created or removed.
+    */
+    void IndexEntries();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the snapshot slot of an entry. Returns SIZE_MAX if the entry does not exist.
+    */
+    SQMOD_NODISCARD size_t FindSlot(SQInteger id) const
+    {
+        auto itr = m_Slots.find(id);
+        // Does this entry exist?
+        return itr == m_Slots.end() ? SIZE_MAX : itr->second;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Makes sure you can modify current entries.
     */
@@ -6,6 +6,7 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <memory>
+#include <vector>
 #include <utility>
 #include <algorithm>
 
@@ -26,6 +27,28 @@ struct PvManager;
 // ------------------------------------------------------------------------------------------------
 typedef VecMap< SQInteger, SQInteger > PvStatusList;
 
+/* ------------------------------------------------------------------------------------------------
+ * Outcome of a privilege query as compiled in a snapshot.
+*/
+enum PvOutcome : uint8_t
+{
+    PvDenied = 0, // The value is below the entry default.
+    PvAllowed, // The value is at least the entry default.
+    PvArbitrate // A query callback must decide.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Effective privileges of a unit, compiled from the unit, its class chain and the entry defaults so
+ * that a query does not have to walk the inheritance chain. Indexed by the slot of each entry.
+*/
+struct PvSnapshot
+{
+    PvManager *                 mManager{nullptr}; // The manager that assigned the entry slots.
+    uint64_t                    mVersion{0}; // Manager version at the time of compilation. Zero if stale.
+    std::vector< SQInteger >    mValues; // Effective value of each entry.
+    std::vector< uint8_t >      mOutcomes; // Outcome of a query on each entry. See PvOutcome.
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Used to represent unique identity for entries, units and classes.
 */
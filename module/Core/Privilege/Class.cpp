@@ -39,6 +39,23 @@ SQMOD_NODISCARD PvManager & PvClass::ValidManager() const
     return *mManager;
 }
 
+// ------------------------------------------------------------------------------------------------
+void PvClass::InvalidateSnapshots() const
+{
+    if (mManager)
+    {
+        mManager->InvalidateSnapshots();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void PvClass::SetOnQuery(Function & func)
+{
+    mOnQuery = std::move(func);
+    // Queries on the units may need arbitration now
+    InvalidateSnapshots();
+}
+
 // ------------------------------------------------------------------------------------------------
 SQMOD_NODISCARD const Function & PvClass::GetOnQuery(SQInteger id) const
 {
@@ -164,6 +181,8 @@ void PvClass::AssignPrivilege(SQInteger id, SQInteger value)
     }
     // Either way, we are setting this value
     mPrivileges[id] = value;
+    // The units may inherit this change
+    InvalidateSnapshots();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -182,6 +201,8 @@ void PvClass::RemovePrivilege(SQInteger id)
     SQInteger current = itr->second;
     // Erase this status value
     mPrivileges.erase(itr);
+    // The units may inherit this change
+    InvalidateSnapshots();
     // Retrieve the associated entry
     PvEntry & entry = ValidManager().ValidEntry(id);
     // Is there someone that can identify this change?
@@ -218,6 +239,8 @@ void PvClass::ModifyPrivilege(SQInteger id, SQInteger value)
             DoChanged(id, r.Cast< bool >(), value);
             // Use this value now as well
             mPrivileges[id] = value;
+            // The units may inherit this change
+            InvalidateSnapshots();
         }
     }
     else
@@ -226,6 +249,8 @@ void PvClass::ModifyPrivilege(SQInteger id, SQInteger value)
         DoChanged(id, value > current, value);
         // Use this value now
         mPrivileges[id] = value;
+        // The units may inherit this change
+        InvalidateSnapshots();
     }
 }
 
@@ -252,6 +277,8 @@ void PvClass::RemoveAllPrivileges()
 {
     // Discard all privileges but not before gaining ownership of them
     PvStatusList list = std::move(mPrivileges);
+    // The units may inherit this change
+    InvalidateSnapshots();
     // Go over all entries and see if this unit will gain or loose any privileges from this change
     for (const auto & e : list)
     {
@@ -290,6 +317,8 @@ void PvClass::AssignParent(const Ref & parent)
     {
         // Assign the specified class
         mParent = parent;
+        // The units may inherit this change
+        InvalidateSnapshots();
         // Propagate changes
         ValidManager().PropagateParentAssign(*this, parent);
     }
@@ -298,6 +327,8 @@ void PvClass::AssignParent(const Ref & parent)
     {
         // Assign the specified class
         mParent = parent;
+        // The units may inherit this change
+        InvalidateSnapshots();
         // Propagate changes
         ValidManager().PropagateParentChange(*this, parent);
     }
@@ -190,6 +190,16 @@ struct PvClass
     */
     SQMOD_NODISCARD PvManager & ValidManager() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Let the manager know that the effective privileges of the units may have changed.
+    */
+    void InvalidateSnapshots() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback for the privilege query event.
+    */
+    void SetOnQuery(Function & func);
+
     /* --------------------------------------------------------------------------------------------
      * Find out the callback that must be invoked to handle query events for a certain entry. 
     */
@@ -337,7 +347,7 @@ struct SqPvClass
     SQMOD_NODISCARD LightObj & GetData() const { return Valid().mData; }
     void SetData(LightObj & data) const { Valid().mData = data; }
     // --------------------------------------------------------------------------------------------
-    void SetOnQuery(Function & func) const { Valid().mOnQuery = std::move(func); }
+    void SetOnQuery(Function & func) const { Valid().SetOnQuery(func); }
     void SetOnLost(Function & func) const { Valid().mOnLost = std::move(func); }
     void SetOnGained(Function & func) const { Valid().mOnGained = std::move(func); }
     // --------------------------------------------------------------------------------------------
@@ -21,6 +21,28 @@ void PvEntry::SetTag(StackStrF & tag)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void PvEntry::SetOnQuery(Function & func)
+{
+    mOnQuery = std::move(func);
+    // Queries on this entry may need arbitration now
+    if (mManager)
+    {
+        mManager->InvalidateSnapshots();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void PvEntry::SetDefault(SQInteger value)
+{
+    mDefault = value;
+    // Queries on this entry may have a different outcome now
+    if (mManager)
+    {
+        mManager->InvalidateSnapshots();
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void PvEntry::Release()
 {
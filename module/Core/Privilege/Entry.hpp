@@ -131,6 +131,16 @@ struct PvEntry
     */
     void SetTag(StackStrF & tag);
 
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback for the privilege query event.
+    */
+    void SetOnQuery(Function & func);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the implicit privilege status value.
+    */
+    void SetDefault(SQInteger value);
+
     /* --------------------------------------------------------------------------------------------
      * Release all script resources.
     */
@@ -166,7 +176,7 @@ struct SqPvEntry
     SQMOD_NODISCARD LightObj & GetData() const { return Valid().mData; }
     void SetData(LightObj & data) const { Valid().mData = data; }
     // --------------------------------------------------------------------------------------------
-    void SetOnQuery(Function & func) const { Valid().mOnQuery = std::move(func); }
+    void SetOnQuery(Function & func) const { Valid().SetOnQuery(func); }
     void SetOnModify(Function & func) const { Valid().mOnModify = std::move(func); }
     void SetOnLost(Function & func) const { Valid().mOnLost = std::move(func); }
     void SetOnGained(Function & func) const { Valid().mOnGained = std::move(func); }
@@ -180,7 +190,7 @@ struct SqPvEntry
     SQMOD_NODISCARD SqPvEntry & ApplyInfo(StackStrF & str) { SetInfo(str); return *this; }
     // --------------------------------------------------------------------------------------------
     SQMOD_NODISCARD SQInteger GetDefault() const { return Valid().mDefault; }
-    void SetDefault(SQInteger value) const { Valid().mDefault = value; }
+    void SetDefault(SQInteger value) const { Valid().SetDefault(value); }
     // --------------------------------------------------------------------------------------------
     SQMOD_NODISCARD LightObj GetManager() const { return LightObj(Valid().mManager); }
 };
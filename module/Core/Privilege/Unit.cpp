@@ -179,6 +179,8 @@ void PvUnit::AssignPrivilege(SQInteger id, SQInteger value)
     }
     // Either way, we are setting this value
     mPrivileges[id] = value;
+    // Compile the new value of this entry
+    RefreshSnapshot(id);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -197,6 +199,8 @@ void PvUnit::RemovePrivilege(SQInteger id)
     SQInteger current = itr->second;
     // Erase this status value
     mPrivileges.erase(itr);
+    // Compile the inherited value of this entry
+    RefreshSnapshot(id);
     // Retrieve the associated entry
     PvEntry & entry = ValidManager().ValidEntry(id);
     // Is there someone that can identify this change?
@@ -233,6 +237,8 @@ void PvUnit::ModifyPrivilege(SQInteger id, SQInteger value)
             DoChanged(id, r.Cast< bool >(), value);
             // Use this value now as well
             mPrivileges[id] = value;
+            // Compile the new value of this entry
+            RefreshSnapshot(id);
         }
     }
     else
@@ -241,6 +247,8 @@ void PvUnit::ModifyPrivilege(SQInteger id, SQInteger value)
         DoChanged(id, value > current, value);
         // Use this value now
         mPrivileges[id] = value;
+        // Compile the new value of this entry
+        RefreshSnapshot(id);
     }
 }
 
@@ -267,6 +275,8 @@ void PvUnit::RemoveAllPrivileges()
 {
     // Discard all privileges but not before gaining ownership of them
     PvStatusList list = std::move(mPrivileges);
+    // Everything is inherited now
+    InvalidateSnapshot();
     // Go over all entries and see if this unit will gain or loose any privileges from this change
     for (const auto & e : list)
     {
@@ -311,15 +321,101 @@ void PvUnit::AssignClass(const std::shared_ptr< PvClass > & cls)
     }
     // Assign this class
     mClass = cls;
+    // Everything is inherited from another class now
+    InvalidateSnapshot();
     // Propagate changes
     ValidManager().PropagateClassChange(*this, cls);
 }
 
+// ------------------------------------------------------------------------------------------------
+bool PvUnit::CompileSnapshot() const
+{
+    // Without a class and manager the regular path is left to report the problem
+    if (mClass.expired())
+    {
+        return false;
+    }
+    PvManager * mgr = mClass.lock()->mManager;
+    // Is there a manager to assign the entry slots?
+    if (!mgr)
+    {
+        return false;
+    }
+    mSnapshot.mManager = mgr;
+    mSnapshot.mVersion = 0;
+    mSnapshot.mValues.resize(mgr->m_Entries.size());
+    mSnapshot.mOutcomes.resize(mgr->m_Entries.size());
+    // Compile the entries in the order of their slots
+    for (size_t i = 0; i < mgr->m_Entries.size(); ++i)
+    {
+        CompileSnapshot(i, *((mgr->m_Entries.begin() + static_cast< ptrdiff_t >(i))->second));
+    }
+    // The snapshot is now current
+    mSnapshot.mVersion = mgr->m_Version;
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void PvUnit::CompileSnapshot(size_t slot, const PvEntry & entry) const
+{
+    // Resolve the value through the class chain
+    const SQInteger value = GetEntryValue(entry.mID);
+    mSnapshot.mValues[slot] = value;
+    // Is there a callback that must arbitrate queries on this entry?
+    if (!GetOnQuery(entry.mID).IsNull())
+    {
+        mSnapshot.mOutcomes[slot] = PvArbitrate;
+    }
+    // We use the >= comparison to settle arbitration
+    else
+    {
+        mSnapshot.mOutcomes[slot] = value >= entry.mDefault ? PvAllowed : PvDenied;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t PvUnit::SnapshotSlot(SQInteger id) const
+{
+    // Was the snapshot compiled against the current state of the manager?
+    if (!mSnapshot.mManager || mSnapshot.mVersion != mSnapshot.mManager->m_Version)
+    {
+        // Can it be compiled again?
+        if (!CompileSnapshot())
+        {
+            return SIZE_MAX;
+        }
+    }
+    return mSnapshot.mManager->FindSlot(id);
+}
+
+// ------------------------------------------------------------------------------------------------
+void PvUnit::RefreshSnapshot(SQInteger id) const
+{
+    // A stale snapshot is compiled entirely by the next query anyway
+    if (!mSnapshot.mManager || mSnapshot.mVersion != mSnapshot.mManager->m_Version)
+    {
+        return;
+    }
+    const size_t slot = mSnapshot.mManager->FindSlot(id);
+    // Is this a known entry?
+    if (slot != SIZE_MAX)
+    {
+        CompileSnapshot(slot, *((mSnapshot.mManager->m_Entries.begin() + static_cast< ptrdiff_t >(slot))->second));
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PvUnit::Can(SQInteger id, SQInteger req) const
 {
+    // Look for the compiled outcome first
+    const size_t slot = SnapshotSlot(id);
+    // Can the request be settled without arbitration?
+    if (slot != SIZE_MAX && mSnapshot.mOutcomes[slot] != PvArbitrate)
+    {
+        return mSnapshot.mOutcomes[slot] == PvAllowed;
+    }
     // Get the current status of the specified entry
-    SQInteger current = GetEntryValue(id);
+    SQInteger current = slot != SIZE_MAX ? mSnapshot.mValues[slot] : GetEntryValue(id);
     // Retrieve the function responsible for the query event
     const Function & query = GetOnQuery(id);
     // Is there someone that can arbitrate this request?
@@ -71,6 +71,11 @@ struct PvUnit
     */
     std::weak_ptr< PvClass > mClass;
 
+    /* --------------------------------------------------------------------------------------------
+     * Compiled effective privileges. Rebuilt on demand when stale.
+    */
+    mutable PvSnapshot  mSnapshot;
+
     /* -------------------------------------------------------------------------------------------
      * Default constructor.
     */
@@ -80,7 +85,7 @@ struct PvUnit
         , mPrivileges()
         , mOnQuery(), mOnGained(), mOnLost()
         , mTag(), mData()
-        , mClass(std::move(cls))
+        , mClass(std::move(cls)), mSnapshot()
     {
     }
 
@@ -93,7 +98,7 @@ struct PvUnit
         , mPrivileges()
         , mOnQuery(), mOnGained(), mOnLost()
         , mTag(std::move(tag)), mData()
-        , mClass(std::move(cls))
+        , mClass(std::move(cls)), mSnapshot()
     {
     }
 
@@ -245,6 +250,46 @@ struct PvUnit
     */
     void AssignClass(const std::shared_ptr< PvClass > & cls);
 
+    /* --------------------------------------------------------------------------------------------
+     * Compile the snapshot of the effective privileges. Returns false if the unit has no valid
+     * class or manager, in which case queries take the regular path that reports the problem.
+    */
+    bool CompileSnapshot() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the value and query outcome of a single entry into the snapshot.
+    */
+    void CompileSnapshot(size_t slot, const PvEntry & entry) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Make sure the snapshot is current and retrieve the slot of an entry. Returns SIZE_MAX if the
+     * entry is unknown or the snapshot could not be compiled.
+    */
+    SQMOD_NODISCARD size_t SnapshotSlot(SQInteger id) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile again a single entry after the unit changed it, if the snapshot is current.
+    */
+    void RefreshSnapshot(SQInteger id) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the snapshot. It will be compiled again by the next query.
+    */
+    void InvalidateSnapshot() const
+    {
+        mSnapshot.mVersion = 0;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback for the privilege query event.
+    */
+    void SetOnQuery(Function & func)
+    {
+        mOnQuery = std::move(func);
+        // Queries may need arbitration now
+        InvalidateSnapshot();
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Check if this unit has a certain privilege.
     */
@@ -288,7 +333,7 @@ struct SqPvUnit
     SQMOD_NODISCARD LightObj & GetData() const { return Valid().mData; }
     void SetData(LightObj & data) const { Valid().mData = data; }
     // --------------------------------------------------------------------------------------------
-    void SetOnQuery(Function & func) const { Valid().mOnQuery = std::move(func); }
+    void SetOnQuery(Function & func) const { Valid().SetOnQuery(func); }
     void SetOnLost(Function & func) const { Valid().mOnLost = std::move(func); }
     void SetOnGained(Function & func) const { Valid().mOnGained = std::move(func); }
     // --------------------------------------------------------------------------------------------
@@ -3,9 +3,7 @@
 #include "Library/Chrono.hpp"
 
 // ------------------------------------------------------------------------------------------------
-#include <cstring>
-
-// ------------------------------------------------------------------------------------------------
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -14,13 +12,70 @@ namespace SqMod {
 SQMOD_DECL_TYPENAME(Typename, _SC("SqRoutineInstance"))
 
 // ------------------------------------------------------------------------------------------------
-Routine::Time       Routine::s_Last = 0;
-Routine::Time       Routine::s_Prev = 0;
-Routine::Interval   Routine::s_Intervals[SQMOD_MAX_ROUTINES];
-Routine::Instance   Routine::s_Instances[SQMOD_MAX_ROUTINES];
-SQInteger           Routine::s_Current = SQMOD_MAX_ROUTINES;
-bool                Routine::s_Silenced = false;
-bool                Routine::s_Persistent = false;
+Routine::Time                   Routine::s_Last = 0;
+Routine::Time                   Routine::s_Prev = 0;
+TimerHeap                       Routine::s_Timers;
+std::deque< Routine::Instance > Routine::s_Instances(SQMOD_INITIAL_ROUTINES);
+SQInteger                       Routine::s_Current = -1;
+uint32_t                        Routine::s_Hint = 0;
+bool                            Routine::s_Silenced = false;
+bool                            Routine::s_Persistent = false;
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Routine::FindUnused()
+{
+    const size_t count = s_Instances.size();
+    // Resume the search from where the last slot was found
+    for (size_t n = 0; n < count; ++n)
+    {
+        const size_t idx = (s_Hint + n) % count;
+        const Instance & r = s_Instances[idx];
+        // Either not used or not currently being executing
+        if (r.mInst.IsNull() && !(r.mExecuting))
+        {
+            s_Hint = static_cast< uint32_t >(idx + 1);
+            return static_cast< SQInteger >(idx); // Return the index of this element
+        }
+    }
+    // Enlarge the pool (references to existing elements remain valid)
+    s_Instances.emplace_back();
+    // Return the index of the new element
+    s_Hint = static_cast< uint32_t >(count + 1);
+    return static_cast< SQInteger >(count);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Routine::Schedule(uint32_t slot, Interval intrv)
+{
+    // Routines without an interval are not invoked
+    if (intrv <= 0)
+    {
+        s_Timers.Cancel(slot);
+    }
+    else
+    {
+        // Count from the time-stamp of the current frame, if we had one
+        s_Timers.Schedule(slot, (s_Last == 0 ? Chrono::GetCurrentSysTime() : s_Last) + intrv * 1000L);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Routine::GetRemaining() const
+{
+    if (m_Slot >= s_Instances.size())
+    {
+        STHROWF("This instance does not reference a valid routine");
+    }
+    // Is this routine even scheduled?
+    if (!s_Timers.IsPending(m_Slot))
+    {
+        return 0;
+    }
+    // Count from the time-stamp of the current frame, if we had one (same as when it was scheduled)
+    const Time now = (s_Last == 0 ? Chrono::GetCurrentSysTime() : s_Last);
+    // Convert the time until the deadline to milliseconds
+    return ClampMin(static_cast< SQInteger >((s_Timers.GetDeadline(m_Slot) - now) / 1000L), SQInteger(0));
+}
 
 // ------------------------------------------------------------------------------------------------
 void Routine::Process()
@@ -36,33 +91,27 @@ void Routine::Process()
     s_Prev = s_Last;
     // Get the current time-stamp
     s_Last = Chrono::GetCurrentSysTime();
-    // Calculate the elapsed time
-    const auto delta = int32_t((s_Last - s_Prev) / 1000L);
-    // Process all active routines
-    for (Interval * itr = s_Intervals; itr != (s_Intervals + SQMOD_MAX_ROUTINES); ++itr)
-    {
-        // Is this routine valid?
-        if (*itr)
+    // Process only the routines that expired since the last frame
+    s_Timers.Expire(s_Last, [](TimerHeap::Slot slot, TimerHeap::Time deadline) {
+        s_Current = static_cast< SQInteger >(slot);
+        // Execute and obtain the next interval
+        const Interval intrv = s_Instances[slot].Execute();
+        // Should this routine be invoked again?
+        if (intrv > 0)
         {
-            // Decrease the elapsed time
-            (*itr) -= delta;
-            // Have we completed the routine interval?
-            if ((*itr) <= 0)
-            {
-                s_Current = static_cast< SQInteger >(itr - s_Intervals);
-                // Execute and reset the elapsed time
-                (*itr) = s_Instances[s_Current].Execute();
-            }
+            // Carry the remainder from the previous deadline to avoid drifting. But never fire more
+            // than once per frame if we are running behind (same as the interval countdown did)
+            s_Timers.Schedule(slot, std::max(deadline + intrv * 1000L, s_Last + 1));
         }
-    }
+    });
     // Clear currently executed routine
-    s_Current = SQMOD_MAX_ROUTINES;
+    s_Current = -1;
 }
 
 // ------------------------------------------------------------------------------------------------
 void Routine::Initialize()
 {
-    std::memset(s_Intervals, 0, sizeof(s_Intervals));
+    s_Timers.Clear();
     SetSilenced(!ErrorHandling::IsEnabled());
 }
 
@@ -74,6 +123,8 @@ void Routine::Deinitialize()
     {
         r.Terminate();
     }
+    // Nothing is scheduled anymore
+    s_Timers.Clear();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -336,7 +387,7 @@ struct RoutineBuilder
         // Alright, at this point we can initialize the slot
         inst.Init(mEnv, mFunc, mInst, mInterval, static_cast< Routine::Iterator >(mIterations));
         // Now initialize the timer
-        Routine::s_Intervals[mSlot] = mInterval;
+        Routine::Schedule(static_cast< uint32_t >(mSlot), mInterval);
 #ifdef VCMP_ENABLE_OFFICIAL
         // Drop the temporary callback reference
         if (refs)
@@ -489,10 +540,13 @@ bool Routine::TerminateWithTag(StackStrF & tag)
     if (tag.mPtr != nullptr)
     {
         // Iterate routine list
-        for (auto & r : s_Instances)
+        for (size_t n = 0; n < s_Instances.size(); ++n)
         {
+            Instance & r = s_Instances[n];
+            // Is this the routine we're looking for?
             if (!r.mInst.IsNull() && r.mTag == tag.mPtr)
             {
+                s_Timers.Cancel(static_cast< uint32_t >(n));
                 r.Terminate(); // Yup, we're doing this
                 return true; // A routine was terminated
             }
@@ -2,6 +2,10 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
+#include "Core/TimerHeap.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <deque>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -25,6 +29,11 @@ public:
     typedef uint32_t                                    Iterator;
     typedef LightObj                                    Argument;
 
+    /* --------------------------------------------------------------------------------------------
+     * Slot value used by routines that don't reference anything.
+    */
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
 private:
 
     /* --------------------------------------------------------------------------------------------
@@ -264,11 +273,12 @@ protected:
 private:
 
     // --------------------------------------------------------------------------------------------
-    static Time         s_Last; // Last time point.
-    static Time         s_Prev; // Previous time point.
-    static Interval     s_Intervals[SQMOD_MAX_ROUTINES]; // List of intervals to be processed.
-    static Instance     s_Instances[SQMOD_MAX_ROUTINES]; // List of routines to be executed.
-    static SQInteger    s_Current; // Currently executed routine index (SQMOD_MAX_ROUTINES if none).
+    static Time                     s_Last; // Last time point.
+    static Time                     s_Prev; // Previous time point.
+    static TimerHeap                s_Timers; // Pending routine invocations ordered by deadline.
+    static std::deque< Instance >   s_Instances; // Pool of routine slots. Grows when full.
+    static SQInteger                s_Current; // Currently executed routine index (-1 if none).
+    static uint32_t                 s_Hint; // Slot from where to begin looking for unused slots.
     static bool         s_Silenced; // Error reporting independent from global setting.
     static bool         s_Persistent; // Whether all routines should be persistent by default.
 
@@ -285,7 +295,7 @@ protected:
      * Default constructor.
     */
     Routine()
-        : m_Slot(SQMOD_MAX_ROUTINES)
+        : m_Slot(INVALID_SLOT)
     {
         /* ... */
     }
@@ -300,21 +310,14 @@ protected:
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Find an unoccupied routine slot.
+     * Find an unoccupied routine slot. The pool is enlarged if there are no free slots.
     */
-    static SQInteger FindUnused()
-    {
-        for (const auto & r : s_Instances)
-        {
-            // Either not used or not currently being executing
-            if (r.mInst.IsNull() && !(r.mExecuting))
-            {
-                return (&r - s_Instances); // Return the index of this element
-            }
-        }
-        // No available slot
-        return -1;
-    }
+    static SQInteger FindUnused();
+
+    /* --------------------------------------------------------------------------------------------
+     * Schedule the routine in the specified slot to be invoked after the specified interval.
+    */
+    static void Schedule(uint32_t slot, Interval intrv);
 
 public:
 
@@ -323,7 +326,7 @@ public:
     */
     ~Routine()
     {
-        if (m_Slot < SQMOD_MAX_ROUTINES)
+        if (m_Slot < s_Instances.size())
         {
             Terminate();
         }
@@ -409,14 +412,6 @@ public:
         // Unable to find such routine
         STHROWF("Unable to fetch a routine with tag ({}). No such routine", tag.mPtr);
         // Should not reach this point but if it did, we have to return something
-#ifdef __clang__
-    #pragma clang diagnostic push
-    #pragma clang diagnostic ignored "-Warray-bounds"
-#endif
-        return s_Instances[SQMOD_MAX_ROUTINES].mInst; // Intentional Buffer overflow!
-#ifdef __clang__
-    #pragma clang diagnostic pop
-#endif
         SQ_UNREACHABLE
     }
 
@@ -462,7 +457,7 @@ protected:
     */
     void Validate() const
     {
-        if (m_Slot >= SQMOD_MAX_ROUTINES)
+        if (m_Slot >= s_Instances.size())
         {
             STHROWF("This instance does not reference a valid routine");
         }
@@ -473,7 +468,7 @@ protected:
     */
     SQMOD_NODISCARD Instance & GetValid() const
     {
-        if (m_Slot >= SQMOD_MAX_ROUTINES)
+        if (m_Slot >= s_Instances.size())
         {
             STHROWF("This instance does not reference a valid routine");
         }
@@ -488,7 +483,7 @@ public:
     */
     SQMOD_NODISCARD const String & ToString() const
     {
-        return (m_Slot >= SQMOD_MAX_ROUTINES) ? NullString() : s_Instances[m_Slot].mTag;
+        return (m_Slot >= s_Instances.size()) ? NullString() : s_Instances[m_Slot].mTag;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -497,8 +492,8 @@ public:
     void Terminate()
     {
         GetValid().Terminate();
-        s_Intervals[m_Slot] = 0;
-        m_Slot = SQMOD_MAX_ROUTINES;
+        s_Timers.Cancel(m_Slot);
+        m_Slot = INVALID_SLOT;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -801,7 +796,7 @@ public:
     */
     SQMOD_NODISCARD bool GetTerminated() const
     {
-        return (m_Slot == SQMOD_MAX_ROUTINES);
+        return (m_Slot >= s_Instances.size());
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -809,26 +804,18 @@ public:
     */
     SQMOD_NODISCARD SQInteger GetElapsed() const
     {
-        if (m_Slot >= SQMOD_MAX_ROUTINES)
+        if (m_Slot >= s_Instances.size())
         {
             STHROWF("This instance does not reference a valid routine");
         }
         // We know it's valid so let's return it
-        return s_Instances[m_Slot].mInterval - s_Intervals[m_Slot];
+        return s_Instances[m_Slot].mInterval - GetRemaining();
     }
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the time remaining until the routine is invoked.
     */
-    SQMOD_NODISCARD SQInteger GetRemaining() const
-    {
-        if (m_Slot >= SQMOD_MAX_ROUTINES)
-        {
-            STHROWF("This instance does not reference a valid routine");
-        }
-        // We know it's valid so let's return it
-        return s_Intervals[m_Slot];
-    }
+    SQMOD_NODISCARD SQInteger GetRemaining() const;
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the number of arguments to be forwarded.
@@ -880,7 +867,7 @@ public:
         // Activate the routine again
         inst.mInactive = inst.mFunc.IsNull();
         // Start the clock again
-        s_Intervals[m_Slot] = inst.mInterval;
+        Schedule(m_Slot, inst.mInterval);
         // Allow chaining
         return *this;
     }
@@ -890,7 +877,7 @@ public:
     */
     static LightObj & GetCurrent()
     {
-        return (s_Current != SQMOD_MAX_ROUTINES) ? s_Instances[s_Current].mInst : NullLightObj();
+        return (s_Current >= 0) ? s_Instances[static_cast< size_t >(s_Current)].mInst : NullLightObj();
     }
 
     /* --------------------------------------------------------------------------------------------
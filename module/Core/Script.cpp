@@ -5,6 +5,13 @@
 #include <cstdio>
 #include <algorithm>
 #include <stdexcept>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+#include <xxhash.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <Poco/File.h>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -72,9 +79,361 @@ public:
 };
 
 
+/* ------------------------------------------------------------------------------------------------
+ * Header written in front of the byte code of a cached script. Everything that affects the code
+ * generated by the compiler is part of it and the cached code is only used if all of it matches.
+*/
+struct ScriptCacheHeader
+{
+    uint32_t    mMagic; // Identifies the file as a cached script.
+    uint32_t    mFormat; // Version of the cache format.
+    uint32_t    mVersion; // Version of the virtual machine that compiled the code.
+    uint32_t    mPath; // Length of the script path that follows the header.
+    uint64_t    mDefs; // Size of the constant definitions that follow the path.
+    int64_t     mTime; // Modification time of the script file.
+    uint64_t    mSize; // Size of the script file.
+    uint64_t    mHash; // Hash of the script file contents.
+    uint64_t    mConsts; // Hash of the constants that were visible to the compiler.
+    uint64_t    mDebug; // Whether the compiler emitted debug information.
+};
+
+// ------------------------------------------------------------------------------------------------
+static constexpr uint32_t SQMOD_SCRIPT_CACHE_MAGIC = 0x434D5153; // SQMC
+static constexpr uint32_t SQMOD_SCRIPT_CACHE_FORMAT = 2;
+
+// ------------------------------------------------------------------------------------------------
+typedef std::unordered_map< String, uint64_t > ScriptConsts; // Hash of each value in the constant table.
+
+/* ------------------------------------------------------------------------------------------------
+ * Read the contents of a file. Returns false if the file could not be read.
+*/
+static bool ReadWholeFile(const String & path, String & data)
+{
+    std::FILE * fp = std::fopen(path.c_str(), "rb");
+    // Could the file be opened?
+    if (!fp)
+    {
+        return false;
+    }
+    // Find out the size of the file
+    std::fseek(fp, 0, SEEK_END);
+    const long length = std::ftell(fp);
+    std::fseek(fp, 0, SEEK_SET);
+    // Read the whole file
+    data.resize(length > 0 ? static_cast< size_t >(length) : 0);
+    const bool ok = length >= 0 && std::fread(&data[0], 1, data.size(), fp) == data.size();
+    std::fclose(fp);
+    return ok;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the modification time of a file in microseconds. Returns 0 if not available.
+*/
+static int64_t GetFileTime(const String & path)
+{
+    try
+    {
+        return Poco::File(path).getLastModified().epochMicroseconds();
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+static uint64_t HashTable(HSQUIRRELVM vm, SQInteger idx);
+
+/* ------------------------------------------------------------------------------------------------
+ * Hash a constant value. Only the types that can be used as constants are taken into account.
+*/
+static uint64_t HashValue(HSQUIRRELVM vm, SQInteger idx)
+{
+    const SQObjectType type = sq_gettype(vm, idx);
+    switch (type)
+    {
+        case OT_INTEGER: {
+            SQInteger v = 0;
+            sq_getinteger(vm, idx, &v);
+            return XXH64(&v, sizeof(v), type);
+        }
+        case OT_FLOAT: {
+            SQFloat v = 0;
+            sq_getfloat(vm, idx, &v);
+            return XXH64(&v, sizeof(v), type);
+        }
+        case OT_BOOL: {
+            SQBool v = SQFalse;
+            sq_getbool(vm, idx, &v);
+            return XXH64(&v, sizeof(v), type);
+        }
+        case OT_STRING: {
+            const SQChar * v = nullptr;
+            SQInteger n = 0;
+            sq_getstringandsize(vm, idx, &v, &n);
+            return XXH64(v, static_cast< size_t >(n) * sizeof(SQChar), type);
+        }
+        case OT_TABLE: {
+            const uint64_t v = HashTable(vm, idx);
+            return XXH64(&v, sizeof(v), type);
+        }
+        default: return static_cast< uint64_t >(type);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Hash the contents of a table. The entries are summed so that their order does not matter.
+*/
+static uint64_t HashTable(HSQUIRRELVM vm, SQInteger idx)
+{
+    uint64_t h = 0;
+    // Iterate over the table entries
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, idx)))
+    {
+        const SQInteger top = sq_gettop(vm);
+        const uint64_t kv[2] = {HashValue(vm, top - 1), HashValue(vm, top)};
+        h += XXH64(kv, sizeof(kv), 0);
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator
+    sq_pop(vm, 1);
+    return h;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Hash the constant table and remember the hash of every value to find out what the compiler adds.
+*/
+static uint64_t HashConsts(HSQUIRRELVM vm, ScriptConsts & consts)
+{
+    uint64_t h = 0;
+    sq_pushconsttable(vm);
+    const SQInteger idx = sq_gettop(vm);
+    // Iterate over the constants
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, idx)))
+    {
+        const SQInteger top = sq_gettop(vm);
+        const SQChar * name = nullptr;
+        SQInteger len = 0;
+        // Constants are always named
+        if (SQ_SUCCEEDED(sq_getstringandsize(vm, top - 1, &name, &len)))
+        {
+            const uint64_t kv[2] = {HashValue(vm, top - 1), HashValue(vm, top)};
+            consts.emplace(String(name, static_cast< size_t >(len)), kv[1]);
+            h += XXH64(kv, sizeof(kv), 0);
+        }
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator and the constant table
+    sq_pop(vm, 2);
+    return h;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Append a constant value to a buffer. Returns false if the value cannot be stored.
+*/
+static bool WriteConst(HSQUIRRELVM vm, SQInteger idx, String & out)
+{
+    const SQObjectType type = sq_gettype(vm, idx);
+    out.append(reinterpret_cast< const char * >(&type), sizeof(type));
+    switch (type)
+    {
+        case OT_INTEGER: {
+            SQInteger v = 0;
+            sq_getinteger(vm, idx, &v);
+            out.append(reinterpret_cast< const char * >(&v), sizeof(v));
+        } return true;
+        case OT_FLOAT: {
+            SQFloat v = 0;
+            sq_getfloat(vm, idx, &v);
+            out.append(reinterpret_cast< const char * >(&v), sizeof(v));
+        } return true;
+        case OT_BOOL: {
+            SQBool v = SQFalse;
+            sq_getbool(vm, idx, &v);
+            out.append(reinterpret_cast< const char * >(&v), sizeof(v));
+        } return true;
+        case OT_STRING: {
+            const SQChar * v = nullptr;
+            SQInteger n = 0;
+            sq_getstringandsize(vm, idx, &v, &n);
+            out.append(reinterpret_cast< const char * >(&n), sizeof(n));
+            out.append(reinterpret_cast< const char * >(v), static_cast< size_t >(n) * sizeof(SQChar));
+        } return true;
+        case OT_TABLE: {
+            SQInteger n = sq_getsize(vm, idx);
+            out.append(reinterpret_cast< const char * >(&n), sizeof(n));
+            bool ok = true;
+            // Store every entry of the enumeration
+            sq_pushnull(vm);
+            while (ok && SQ_SUCCEEDED(sq_next(vm, idx)))
+            {
+                const SQInteger top = sq_gettop(vm);
+                ok = WriteConst(vm, top - 1, out) && WriteConst(vm, top, out);
+                sq_pop(vm, 2);
+            }
+            sq_pop(vm, 1);
+            return ok;
+        }
+        default: return false;
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Read a constant value from a buffer and push it on the stack. Returns false if malformed.
+*/
+static bool ReadConst(HSQUIRRELVM vm, const char * & p, const char * end, int depth = 0)
+{
+    // Make sure the specified number of bytes can be read
+    const auto take = [&p, end](void * v, size_t n) -> bool {
+        if (static_cast< size_t >(end - p) < n) return false;
+        std::memcpy(v, p, n);
+        p += n;
+        return true;
+    };
+    SQObjectType type;
+    if (!take(&type, sizeof(type))) return false;
+    switch (type)
+    {
+        case OT_INTEGER: {
+            SQInteger v;
+            if (!take(&v, sizeof(v))) return false;
+            sq_pushinteger(vm, v);
+        } return true;
+        case OT_FLOAT: {
+            SQFloat v;
+            if (!take(&v, sizeof(v))) return false;
+            sq_pushfloat(vm, v);
+        } return true;
+        case OT_BOOL: {
+            SQBool v;
+            if (!take(&v, sizeof(v))) return false;
+            sq_pushbool(vm, v);
+        } return true;
+        case OT_STRING: {
+            SQInteger n;
+            if (!take(&n, sizeof(n)) || n < 0 || static_cast< size_t >(end - p) < static_cast< size_t >(n) * sizeof(SQChar)) return false;
+            sq_pushstring(vm, reinterpret_cast< const SQChar * >(p), n);
+            p += static_cast< size_t >(n) * sizeof(SQChar);
+        } return true;
+        case OT_TABLE: {
+            SQInteger n;
+            // Enumerations cannot be nested
+            if (depth > 0 || !take(&n, sizeof(n)) || n < 0) return false;
+            sq_newtable(vm);
+            for (SQInteger i = 0; i < n; ++i)
+            {
+                if (!ReadConst(vm, p, end, depth + 1))
+                {
+                    sq_pop(vm, 1);
+                    return false;
+                }
+                else if (!ReadConst(vm, p, end, depth + 1))
+                {
+                    sq_pop(vm, 2);
+                    return false;
+                }
+                sq_newslot(vm, -3, SQFalse);
+            }
+        } return true;
+        default: return false;
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Store the constants that were added or changed since the constant table was hashed.
+*/
+static bool WriteDefs(HSQUIRRELVM vm, const ScriptConsts & consts, String & out)
+{
+    bool ok = true;
+    sq_pushconsttable(vm);
+    const SQInteger idx = sq_gettop(vm);
+    // Iterate over the constants
+    sq_pushnull(vm);
+    while (ok && SQ_SUCCEEDED(sq_next(vm, idx)))
+    {
+        const SQInteger top = sq_gettop(vm);
+        const SQChar * name = nullptr;
+        SQInteger len = 0;
+        sq_getstringandsize(vm, top - 1, &name, &len);
+        auto itr = consts.find(String(name, static_cast< size_t >(len)));
+        // Is this a new or modified constant?
+        if (itr == consts.end() || itr->second != HashValue(vm, top))
+        {
+            ok = WriteConst(vm, top - 1, out) && WriteConst(vm, top, out);
+        }
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator and the constant table
+    sq_pop(vm, 2);
+    return ok;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Add the stored constants to the constant table, like the compiler would have.
+*/
+static bool ReadDefs(HSQUIRRELVM vm, const char * p, const char * end)
+{
+    bool ok = true;
+    sq_pushconsttable(vm);
+    while (ok && p < end)
+    {
+        if (!ReadConst(vm, p, end))
+        {
+            ok = false;
+        }
+        else if (!ReadConst(vm, p, end))
+        {
+            sq_pop(vm, 1);
+            ok = false;
+        }
+        else
+        {
+            sq_newslot(vm, -3, SQFalse);
+        }
+    }
+    // Pop the constant table
+    sq_pop(vm, 1);
+    return ok;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Byte code stream that reads from memory.
+*/
+struct ScriptCacheReader
+{
+    const char * mPtr; // Current position.
+    const char * mEnd; // End of the byte code.
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger Read(SQUserPointer up, SQUserPointer dest, SQInteger size)
+    {
+        auto * r = static_cast< ScriptCacheReader * >(up);
+        const SQInteger n = std::min(size, static_cast< SQInteger >(r->mEnd - r->mPtr));
+        std::memcpy(dest, r->mPtr, static_cast< size_t >(n));
+        r->mPtr += n;
+        return n;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger ScriptCacheWrite(SQUserPointer up, SQUserPointer src, SQInteger size)
+{
+    static_cast< String * >(up)->append(static_cast< const char * >(src), static_cast< size_t >(size));
+    return size;
+}
+
 // ------------------------------------------------------------------------------------------------
 void ScriptSrc::Process()
 {
+    // Only attempt this once
+    mRead = true;
+    // Was the file modified after it was compiled? Then the lines would not match the code
+    if (mTime != 0 && GetFileTime(mPath) != mTime)
+    {
+        return;
+    }
     // Attempt to open the specified file
     FileHandle fp(mPath.c_str());
     // First 2 bytes of the file will tell if this is a compiled script
@@ -143,8 +502,127 @@ void ScriptSrc::Process()
     {
         mLine.emplace_back(line_start, mData.size());
     }
-    // Specify that this script contains line information
-    mInfo = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Compile(const String & cache)
+{
+    HSQUIRRELVM vm = SqVM();
+    // Remember which version of the file was compiled
+    mTime = GetFileTime(mPath);
+    // Line information is read again from the file when needed
+    mData.clear();
+    mLine.clear();
+    mRead = false;
+    // Is the cache disabled?
+    if (cache.empty())
+    {
+        mExec.CompileFile(mPath);
+        return false;
+    }
+    String code;
+    // Read the script file so that the cached byte code can be validated against it
+    if (!ReadWholeFile(mPath, code) || (code.size() >= 2 &&
+        *reinterpret_cast< const uint16_t * >(code.data()) == SQ_BYTECODE_STREAM_TAG))
+    {
+        // Let the compiler deal with it (also, compiled scripts don't need a cache)
+        mExec.CompileFile(mPath);
+        return false;
+    }
+    // Describe the script and the state of the compiler
+    ScriptCacheHeader hdr{};
+    ScriptConsts consts;
+    hdr.mMagic = SQMOD_SCRIPT_CACHE_MAGIC;
+    hdr.mFormat = SQMOD_SCRIPT_CACHE_FORMAT;
+    hdr.mVersion = SQUIRREL_VERSION_NUMBER;
+    hdr.mPath = static_cast< uint32_t >(mPath.size());
+    hdr.mTime = mTime;
+    hdr.mSize = code.size();
+    hdr.mHash = XXH64(code.data(), code.size(), 0);
+    hdr.mConsts = HashConsts(vm, consts);
+    hdr.mDebug = sq_isdebuginfo(vm) ? 1 : 0;
+    // The cache file is named after the script path
+    const String file = fmt::format("{}/{:016x}.cnut", cache, XXH64(mPath.data(), mPath.size(), 0));
+    // Attempt to load the byte code from the cache
+    if (ReadWholeFile(file, code) && code.size() >= sizeof(ScriptCacheHeader))
+    {
+        ScriptCacheHeader chdr{};
+        std::memcpy(&chdr, code.data(), sizeof(chdr));
+        const char * p = code.data() + sizeof(chdr), * end = code.data() + code.size();
+        // Does the cached byte code belong to this exact script and compiler state?
+        if (chdr.mMagic == hdr.mMagic && chdr.mFormat == hdr.mFormat && chdr.mVersion == hdr.mVersion &&
+            chdr.mPath == hdr.mPath && chdr.mTime == hdr.mTime && chdr.mSize == hdr.mSize &&
+            chdr.mHash == hdr.mHash && chdr.mConsts == hdr.mConsts && chdr.mDebug == hdr.mDebug &&
+            static_cast< uint64_t >(end - p) >= chdr.mPath + chdr.mDefs &&
+            mPath.compare(0, String::npos, p, chdr.mPath) == 0)
+        {
+            const char * defs = p + chdr.mPath;
+            ScriptCacheReader r{defs + chdr.mDefs, end};
+            // Attempt to load the byte code
+            if (SQ_SUCCEEDED(sq_readclosure(vm, &ScriptCacheReader::Read, &r)))
+            {
+                mExec = Script(-1, vm);
+                sq_pop(vm, 1);
+                // Define the constants that the compiler would have defined
+                if (ReadDefs(vm, defs, defs + chdr.mDefs))
+                {
+                    return true;
+                }
+                mExec.Release();
+            }
+        }
+    }
+    // Compile the script
+    mExec.CompileFile(mPath);
+    // Attempt to store the byte code in the cache
+    try
+    {
+        String defs, bytecode;
+        // Constants cannot be stored if they're not made of basic values
+        if (!WriteDefs(vm, consts, defs))
+        {
+            return false;
+        }
+        // Serialize the byte code
+        sq_pushobject(vm, mExec.GetObj());
+        const SQRESULT res = sq_writeclosure(vm, &ScriptCacheWrite, &bytecode);
+        sq_pop(vm, 1);
+        // Could it be serialized?
+        if (SQ_FAILED(res))
+        {
+            STHROWF("Unable to serialize the byte code: {}", LastErrorString(vm));
+        }
+        hdr.mDefs = defs.size();
+        // Make sure the cache directory exists
+        Poco::File(cache).createDirectories();
+        // Write to a temporary file first to never leave a partial cache file behind
+        const String temp = file + ".tmp";
+        std::FILE * fp = std::fopen(temp.c_str(), "wb");
+        // Could the file be created?
+        if (!fp)
+        {
+            STHROWF("Unable to create cache file ({})", temp);
+        }
+        bool ok = std::fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+        ok = ok && std::fwrite(mPath.data(), 1, mPath.size(), fp) == mPath.size();
+        ok = ok && std::fwrite(defs.data(), 1, defs.size(), fp) == defs.size();
+        ok = ok && std::fwrite(bytecode.data(), 1, bytecode.size(), fp) == bytecode.size();
+        ok = (std::fclose(fp) == 0) && ok;
+        // Could the file be written?
+        if (!ok)
+        {
+            Poco::File(temp).remove();
+            STHROWF("Unable to write cache file ({})", temp);
+        }
+        // Replace the previous cache file, if any
+        Poco::File(temp).renameTo(file);
+    }
+    catch (const std::exception & e)
+    {
+        LogWrn("Unable to cache the byte code of (%s): %s", mPath.c_str(), e.what());
+    }
+    // The byte code was not loaded from the cache
+    return false;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -155,7 +633,9 @@ ScriptSrc::ScriptSrc(const String & path, Function & cb, LightObj & ctx, bool de
     , mPath(path)
     , mData()
     , mLine()
+    , mTime(0)
     , mInfo(info)
+    , mRead(false)
     , mDelay(delay)
 {
     // Is the specified path empty?
@@ -163,18 +643,25 @@ ScriptSrc::ScriptSrc(const String & path, Function & cb, LightObj & ctx, bool de
     {
         throw std::runtime_error("Invalid or empty script path");
     }
-    // Should we load the file contents for debugging purposes?
-    else if (mInfo)
-    {
-        Process();
-    }
 }
 
 // ------------------------------------------------------------------------------------------------
-String ScriptSrc::FetchLine(size_t line, bool trim) const
+String ScriptSrc::FetchLine(size_t line, bool trim)
 {
+    // Should the file contents be loaded for debugging purposes?
+    if (mInfo && !mRead)
+    {
+        try
+        {
+            Process();
+        }
+        catch (...)
+        {
+            mLine.clear(); // Line information is not essential
+        }
+    }
     // Do we have such line?
-    if (line > mLine.size())
+    if (line >= mLine.size())
     {
         return String(); // Nope!
     }
@@ -31,7 +31,9 @@ struct ScriptSrc
     String      mPath{}; // Path to the script file.
     String      mData{}; // The contents of the script file.
     Line        mLine{}; // List of lines of code in the data.
-    bool        mInfo{false}; // Whether this script contains line information.
+    int64_t     mTime{0}; // Modification time of the script file when it was compiled.
+    bool        mInfo{false}; // Whether line information should be provided for this script.
+    bool        mRead{false}; // Whether the line information was read from the script file.
     bool        mDelay{false}; // Don't execute immediately after compilation.
 
     /* --------------------------------------------------------------------------------------------
@@ -39,6 +41,12 @@ struct ScriptSrc
     */
     void Process();
 
+    /* --------------------------------------------------------------------------------------------
+     * Compile the script file or load its byte code from the specified cache directory. Returns
+     * true if the byte code was loaded from the cache. An empty directory disables the cache.
+    */
+    bool Compile(const String & cache);
+
     /* --------------------------------------------------------------------------------------------
      * Base constructor.
     */
@@ -65,9 +73,10 @@ struct ScriptSrc
     ScriptSrc & operator = (ScriptSrc && o) = default;
 
     /* --------------------------------------------------------------------------------------------
-     * Fetches a line from the code. Can also trim whitespace at the beginning.
+     * Fetches a line from the code. Can also trim whitespace at the beginning. The code is only
+     * read from the script file the first time a line is requested.
     */
-    SQMOD_NODISCARD String FetchLine(size_t line, bool trim = true) const;
+    SQMOD_NODISCARD String FetchLine(size_t line, bool trim = true);
 };
 
 
@@ -0,0 +1,667 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/Spatial.hpp"
+#include "Core.hpp"
+#include "Base/AABB.hpp"
+#include "Base/Vector3.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SpatialIndex SpatialIndex::s_Inst;
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the current time in microseconds.
+*/
+static int64_t SpatialNow()
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Take an entity out of the cell where it is stored. The last entity in the cell takes its place.
+*/
+static void SpatialUnlink(SpatialIndex::Grid & g, int32_t id)
+{
+    SpatialIndex::Entry & e = g.mEntries[static_cast< size_t >(id)];
+    auto itr = g.mCells.find(e.mCell);
+    SpatialIndex::Cell & c = itr->second;
+    // Move the last entity in the slot of the removed one
+    const int32_t last = c.back();
+    c[e.mSlot] = last;
+    g.mEntries[static_cast< size_t >(last)].mSlot = e.mSlot;
+    c.pop_back();
+    // Only cells with entities are kept
+    if (c.empty())
+    {
+        g.mCells.erase(itr);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Visit the entities in the cells that overlap the specified rectangle.
+*/
+template < typename F > static void SpatialVisit(const SpatialIndex::Grid & g, float l, float b, float r, float t, F && f)
+{
+    const int32_t cl = SpatialIndex::CellOf(l), cb = SpatialIndex::CellOf(b);
+    const int32_t cr = SpatialIndex::CellOf(r), ct = SpatialIndex::CellOf(t);
+    // Is it cheaper to go over the cells that are not empty?
+    if ((static_cast< uint64_t >(cr - cl) + 1) * (static_cast< uint64_t >(ct - cb) + 1) > g.mCells.size())
+    {
+        for (const auto & c : g.mCells)
+        {
+            const auto cx = static_cast< int32_t >(static_cast< uint32_t >(c.first >> 32));
+            const auto cy = static_cast< int32_t >(static_cast< uint32_t >(c.first));
+            // Does the cell overlap the rectangle?
+            if (cx >= cl && cx <= cr && cy >= cb && cy <= ct)
+            {
+                for (const int32_t id : c.second)
+                {
+                    f(id);
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int32_t cx = cl; cx <= cr; ++cx)
+        {
+            for (int32_t cy = cb; cy <= ct; ++cy)
+            {
+                auto itr = g.mCells.find(SpatialIndex::KeyOf(cx, cy));
+                // Are there any entities in this cell?
+                if (itr != g.mCells.end())
+                {
+                    for (const int32_t id : itr->second)
+                    {
+                        f(id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int32_t SpatialIndex::CellOf(float v) noexcept
+{
+    const float c = std::floor(v / CELL);
+    // Also takes care of values that are not a number
+    if (!(c >= static_cast< float >(-LIMIT)))
+    {
+        return -LIMIT;
+    }
+    else if (c > static_cast< float >(LIMIT))
+    {
+        return LIMIT;
+    }
+    return static_cast< int32_t >(c);
+}
+
+// ------------------------------------------------------------------------------------------------
+SpatialIndex::Grid * SpatialIndex::GetGrid(int32_t type)
+{
+    switch (type)
+    {
+        case ENT_OBJECT: return &m_Grids[0];
+        case ENT_PICKUP: return &m_Grids[1];
+        case ENT_PLAYER: return &m_Grids[2];
+        case ENT_VEHICLE: return &m_Grids[3];
+        default: return nullptr;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SpatialIndex::Grid & SpatialIndex::ValidGrid(int32_t type)
+{
+    Grid * g = GetGrid(type);
+    // Is this entity type indexed?
+    if (!g)
+    {
+        STHROWF("Entities of type ({}) are not spatially indexed", type);
+    }
+    return *g;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Sync(int32_t type, Grid & g)
+{
+    // Anything moving on its own?
+    if (g.mMoving.empty())
+    {
+        return;
+    }
+    const int64_t now = SpatialNow();
+    // Read the position of each moving entity
+    for (size_t i = 0; i < g.mMoving.size();)
+    {
+        Refresh(type, g.mMoving[i].first);
+        // Did the entity reach its destination?
+        if (now >= g.mMoving[i].second)
+        {
+            g.mMoving[i] = g.mMoving.back();
+            g.mMoving.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SpatialIndex::InWorld(int32_t type, int32_t id, int32_t world)
+{
+    // Should we filter by world?
+    if (world < 0)
+    {
+        return true;
+    }
+    switch (type)
+    {
+        case ENT_OBJECT: return _Func->GetObjectWorld(id) == world;
+        case ENT_PICKUP: return _Func->GetPickupWorld(id) == world;
+        case ENT_PLAYER: return _Func->GetPlayerWorld(id) == world;
+        case ENT_VEHICLE: return _Func->GetVehicleWorld(id) == world;
+        default: return false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Update(int32_t type, int32_t id, float x, float y, float z)
+{
+    Grid * g = GetGrid(type);
+    // Is this entity type indexed?
+    if (!g || id < 0)
+    {
+        return;
+    }
+    // Make room for this entity
+    if (static_cast< size_t >(id) >= g->mEntries.size())
+    {
+        g->mEntries.resize(static_cast< size_t >(id) + 1);
+    }
+    Entry & e = g->mEntries[static_cast< size_t >(id)];
+    const uint64_t key = KeyOf(CellOf(x), CellOf(y));
+    // Update the position
+    e.mX = x;
+    e.mY = y;
+    e.mZ = z;
+    // Is the entity already in the grid?
+    if (e.mActive)
+    {
+        // Did it leave its cell?
+        if (e.mCell == key)
+        {
+            return;
+        }
+        SpatialUnlink(*g, id);
+    }
+    else
+    {
+        e.mActive = true;
+        ++g->mCount;
+    }
+    // Store the entity in its new cell
+    Cell & c = g->mCells[key];
+    e.mCell = key;
+    e.mSlot = static_cast< uint32_t >(c.size());
+    c.push_back(id);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Refresh(int32_t type, int32_t id)
+{
+    float x = 0, y = 0, z = 0;
+    vcmpError r;
+    // Ask the server where the entity is
+    switch (type)
+    {
+        case ENT_OBJECT: r = _Func->GetObjectPosition(id, &x, &y, &z); break;
+        case ENT_PICKUP: r = _Func->GetPickupPosition(id, &x, &y, &z); break;
+        case ENT_PLAYER: r = _Func->GetPlayerPosition(id, &x, &y, &z); break;
+        case ENT_VEHICLE: r = _Func->GetVehiclePosition(id, &x, &y, &z); break;
+        default: return;
+    }
+    // Did we get a position?
+    if (r == vcmpErrorNone)
+    {
+        Update(type, id, x, y, z);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Moved(int32_t type, int32_t id, uint32_t time)
+{
+    Grid * g = GetGrid(type);
+    // Is this entity type indexed?
+    if (!g || id < 0)
+    {
+        return;
+    }
+    // Store the current position
+    Refresh(type, id);
+    // Is the entity going to move on its own?
+    if (time == 0)
+    {
+        return;
+    }
+    const int64_t deadline = SpatialNow() + static_cast< int64_t >(time) * 1000;
+    // Was it already moving?
+    for (auto & m : g->mMoving)
+    {
+        if (m.first == id)
+        {
+            m.second = deadline;
+            return;
+        }
+    }
+    g->mMoving.emplace_back(id, deadline);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Remove(int32_t type, int32_t id)
+{
+    Grid * g = GetGrid(type);
+    // Is the entity even in the grid?
+    if (!g || id < 0 || static_cast< size_t >(id) >= g->mEntries.size() || !g->mEntries[static_cast< size_t >(id)].mActive)
+    {
+        return;
+    }
+    SpatialUnlink(*g, id);
+    g->mEntries[static_cast< size_t >(id)].mActive = false;
+    --g->mCount;
+    // Stop following its movement
+    g->mMoving.erase(std::remove_if(g->mMoving.begin(), g->mMoving.end(),
+                        [id](const std::pair< int32_t, int64_t > & m) { return m.first == id; }), g->mMoving.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Clear()
+{
+    for (Grid & g : m_Grids)
+    {
+        g.mEntries.clear();
+        g.mCells.clear();
+        g.mMoving.clear();
+        g.mCount = 0;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::InRadius(int32_t type, float x, float y, float z, float r, int32_t world, Result & out)
+{
+    Grid & g = ValidGrid(type);
+    Sync(type, g);
+    // Is the radius valid?
+    if (!(r >= 0))
+    {
+        return;
+    }
+    const float r2 = r * r;
+    // Test the entities in the cells that overlap the circle
+    SpatialVisit(g, x - r, y - r, x + r, y + r, [&](int32_t id) {
+        const Entry & e = g.mEntries[static_cast< size_t >(id)];
+        const float dx = e.mX - x, dy = e.mY - y, dz = e.mZ - z;
+        // Is the entity within the specified distance?
+        if ((dx * dx + dy * dy + dz * dz) <= r2 && InWorld(type, id, world))
+        {
+            out.push_back(id);
+        }
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::InBox(int32_t type, float minx, float miny, float minz, float maxx, float maxy, float maxz,
+                            int32_t world, Result & out)
+{
+    Grid & g = ValidGrid(type);
+    Sync(type, g);
+    // Accept the corners in any order
+    if (minx > maxx) std::swap(minx, maxx);
+    if (miny > maxy) std::swap(miny, maxy);
+    if (minz > maxz) std::swap(minz, maxz);
+    // Test the entities in the cells that overlap the box
+    SpatialVisit(g, minx, miny, maxx, maxy, [&](int32_t id) {
+        const Entry & e = g.mEntries[static_cast< size_t >(id)];
+        // Is the entity inside the box?
+        if (e.mX >= minx && e.mX <= maxx && e.mY >= miny && e.mY <= maxy && e.mZ >= minz && e.mZ <= maxz &&
+            InWorld(type, id, world))
+        {
+            out.push_back(id);
+        }
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::Nearest(int32_t type, float x, float y, float z, size_t k, int32_t world, Result & out)
+{
+    Grid & g = ValidGrid(type);
+    Sync(type, g);
+    // Is there anything to look for?
+    if (k == 0 || g.mCount == 0)
+    {
+        return;
+    }
+    // Closest entities found so far, with the farthest one at the top
+    std::vector< std::pair< float, int32_t > > heap;
+    heap.reserve(std::min(k, g.mCount));
+    // Keep the entity if it is closer than the farthest one found so far
+    const auto consider = [&](int32_t id) {
+        const Entry & e = g.mEntries[static_cast< size_t >(id)];
+        const float dx = e.mX - x, dy = e.mY - y, dz = e.mZ - z;
+        float d2 = dx * dx + dy * dy + dz * dz;
+        // Positions that are not a number would break the ordering
+        if (std::isnan(d2))
+        {
+            d2 = HUGE_VALF;
+        }
+        if (heap.size() < k)
+        {
+            if (InWorld(type, id, world))
+            {
+                heap.emplace_back(d2, id);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        else if (d2 < heap.front().first && InWorld(type, id, world))
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = std::make_pair(d2, id);
+            std::push_heap(heap.begin(), heap.end());
+        }
+    };
+    // Look at the cell of the point first and then in rings of cells around it
+    const int32_t cx = CellOf(x), cy = CellOf(y);
+    size_t seen = 0;
+    for (int32_t d = 0;; ++d)
+    {
+        // Would the ring have more cells than the grid? Then just look at every entity
+        if (static_cast< size_t >(d) * 8 > g.mCells.size() + 8)
+        {
+            heap.clear();
+            for (const auto & c : g.mCells)
+            {
+                for (const int32_t id : c.second)
+                {
+                    consider(id);
+                }
+            }
+            break;
+        }
+        const auto visit = [&](int32_t ix, int32_t iy) {
+            auto itr = g.mCells.find(KeyOf(ix, iy));
+            // Are there any entities in this cell?
+            if (itr != g.mCells.end())
+            {
+                seen += itr->second.size();
+                for (const int32_t id : itr->second)
+                {
+                    consider(id);
+                }
+            }
+        };
+        // Visit the cells on the edges of the ring
+        if (d == 0)
+        {
+            visit(cx, cy);
+        }
+        else
+        {
+            for (int32_t i = -d; i <= d; ++i)
+            {
+                visit(cx + i, cy - d);
+                visit(cx + i, cy + d);
+            }
+            for (int32_t i = -d + 1; i < d; ++i)
+            {
+                visit(cx - d, cy + i);
+                visit(cx + d, cy + i);
+            }
+        }
+        // Was every entity looked at?
+        if (seen >= g.mCount)
+        {
+            break;
+        }
+        // Entities in the next ring are at least this far away on the horizontal plane
+        const float reach = static_cast< float >(d) * CELL;
+        // Is the farthest entity found so far closer than that?
+        if (heap.size() == k && heap.front().first <= reach * reach)
+        {
+            break;
+        }
+    }
+    // Order the entities from the closest to the farthest
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto & p : heap)
+    {
+        out.push_back(p.second);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialIndex::InWorld(int32_t type, int32_t world, Result & out)
+{
+    Grid & g = ValidGrid(type);
+    // Test every entity in the grid
+    for (size_t id = 0; id < g.mEntries.size(); ++id)
+    {
+        if (g.mEntries[id].mActive && InWorld(type, static_cast< int32_t >(id), world))
+        {
+            out.push_back(static_cast< int32_t >(id));
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t SpatialIndex::Count(int32_t type)
+{
+    return ValidGrid(type).mCount;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the script object of an indexed entity.
+*/
+static const LightObj & SpatialObject(int32_t type, int32_t id)
+{
+    switch (type)
+    {
+        case ENT_OBJECT: return Core::Get().GetObj(id).mObj;
+        case ENT_PICKUP: return Core::Get().GetPickup(id).mObj;
+        case ENT_PLAYER: return Core::Get().GetPlayer(id).mObj;
+        case ENT_VEHICLE: return Core::Get().GetVehicle(id).mObj;
+        default: return NullLightObj();
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create an array with the script objects of the entities in a query result.
+*/
+static Array SpatialArray(int32_t type, const SpatialIndex::Result & res)
+{
+    HSQUIRRELVM vm = SqVM();
+    const StackGuard sg(vm);
+    // Allocate an array with enough room for the result
+    sq_newarrayex(vm, static_cast< SQInteger >(res.size()));
+    // Append the entities to the array
+    for (const int32_t id : res)
+    {
+        sq_pushobject(vm, SpatialObject(type, id).GetObj());
+        sq_arrayappend(vm, -2);
+    }
+    // Return the array at the top of the stack
+    return Var< Array >(vm, -1).value;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the entities in a query result to a callback. Returning false from it stops the process.
+*/
+static SQInteger SpatialEach(int32_t type, const SpatialIndex::Result & res, Function & func)
+{
+    SQInteger count = 0;
+    for (const int32_t id : res)
+    {
+        const LightObj obj(SpatialObject(type, id));
+        // The entity might have been destroyed by a previous callback
+        if (obj.IsNull())
+        {
+            continue;
+        }
+        const LightObj ret = func.Eval(obj);
+        ++count;
+        // Should we stop here?
+        if (ret.GetType() == OT_BOOL && !ret.Cast< bool >())
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Script functions for the queries on a single entity type.
+*/
+template < int32_t T > struct SpatialQuery
+{
+    // --------------------------------------------------------------------------------------------
+    static Array InRadius(const Vector3 & p, SQFloat r, SQInteger world)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InRadius(T, p.x, p.y, p.z, static_cast< float >(r), static_cast< int32_t >(world), res);
+        return SpatialArray(T, res);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array InRadiusEx(SQFloat x, SQFloat y, SQFloat z, SQFloat r, SQInteger world)
+    {
+        return InRadius(Vector3(static_cast< float >(x), static_cast< float >(y), static_cast< float >(z)), r, world);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array InBox(const AABB & b, SQInteger world)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InBox(T, b.min.x, b.min.y, b.min.z, b.max.x, b.max.y, b.max.z, static_cast< int32_t >(world), res);
+        return SpatialArray(T, res);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array InBoxEx(SQFloat minx, SQFloat miny, SQFloat minz, SQFloat maxx, SQFloat maxy, SQFloat maxz, SQInteger world)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InBox(T, static_cast< float >(minx), static_cast< float >(miny), static_cast< float >(minz),
+                                    static_cast< float >(maxx), static_cast< float >(maxy), static_cast< float >(maxz),
+                                    static_cast< int32_t >(world), res);
+        return SpatialArray(T, res);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array Nearest(const Vector3 & p, SQInteger k, SQInteger world)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().Nearest(T, p.x, p.y, p.z, k > 0 ? static_cast< size_t >(k) : 0, static_cast< int32_t >(world), res);
+        return SpatialArray(T, res);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array NearestEx(SQFloat x, SQFloat y, SQFloat z, SQInteger k, SQInteger world)
+    {
+        return Nearest(Vector3(static_cast< float >(x), static_cast< float >(y), static_cast< float >(z)), k, world);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Array InWorld(SQInteger world)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InWorld(T, static_cast< int32_t >(world), res);
+        return SpatialArray(T, res);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger EachInRadius(const Vector3 & p, SQFloat r, SQInteger world, Function & func)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InRadius(T, p.x, p.y, p.z, static_cast< float >(r), static_cast< int32_t >(world), res);
+        return SpatialEach(T, res, func);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger EachInBox(const AABB & b, SQInteger world, Function & func)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InBox(T, b.min.x, b.min.y, b.min.z, b.max.x, b.max.y, b.max.z, static_cast< int32_t >(world), res);
+        return SpatialEach(T, res, func);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger EachNearest(const Vector3 & p, SQInteger k, SQInteger world, Function & func)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().Nearest(T, p.x, p.y, p.z, k > 0 ? static_cast< size_t >(k) : 0, static_cast< int32_t >(world), res);
+        return SpatialEach(T, res, func);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger EachInWorld(SQInteger world, Function & func)
+    {
+        SpatialIndex::Result res;
+        SpatialIndex::Get().InWorld(T, static_cast< int32_t >(world), res);
+        return SpatialEach(T, res, func);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static SQInteger Count()
+    {
+        return static_cast< SQInteger >(SpatialIndex::Get().Count(T));
+    }
+
+    // --------------------------------------------------------------------------------------------
+    static Table Bind(HSQUIRRELVM vm)
+    {
+        return Table(vm)
+            .Func(_SC("InRadius"), &InRadius)
+            .Func(_SC("InRadiusEx"), &InRadiusEx)
+            .Func(_SC("InBox"), &InBox)
+            .Func(_SC("InBoxEx"), &InBoxEx)
+            .Func(_SC("Nearest"), &Nearest)
+            .Func(_SC("NearestEx"), &NearestEx)
+            .Func(_SC("InWorld"), &InWorld)
+            .Func(_SC("EachInRadius"), &EachInRadius)
+            .Func(_SC("EachInBox"), &EachInBox)
+            .Func(_SC("EachNearest"), &EachNearest)
+            .Func(_SC("EachInWorld"), &EachInWorld)
+            .Func(_SC("Count"), &Count);
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+void TerminateSpatial()
+{
+    SpatialIndex::Get().Clear();
+}
+
+// ================================================================================================
+void Register_Spatial(HSQUIRRELVM vm)
+{
+    Table spatialns(vm);
+
+    Table objectns = SpatialQuery< ENT_OBJECT >::Bind(vm);
+    Table pickupns = SpatialQuery< ENT_PICKUP >::Bind(vm);
+    Table playerns = SpatialQuery< ENT_PLAYER >::Bind(vm);
+    Table vehiclens = SpatialQuery< ENT_VEHICLE >::Bind(vm);
+
+    spatialns.Bind(_SC("Object"), objectns);
+    spatialns.Bind(_SC("Pickup"), pickupns);
+    spatialns.Bind(_SC("Player"), playerns);
+    spatialns.Bind(_SC("Vehicle"), vehiclens);
+
+    RootTable(vm).Bind(_SC("SqSpatial"), spatialns);
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,182 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "Core/Common.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Uniform grid with the positions of the players, vehicles, objects and pickups. Cells are square
+ * on the horizontal plane and unbounded on the vertical axis. Queries only visit the cells that
+ * overlap them and compute the exact distance to the entities inside those cells.
+*/
+class SpatialIndex
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr float      CELL = 64.0f; // Width and length of a cell in world units.
+    static constexpr int32_t    LIMIT = 1 << 28; // Cell coordinates are clamped to this range.
+
+    /* --------------------------------------------------------------------------------------------
+     * Position of an entity and where it is stored in the grid.
+    */
+    struct Entry
+    {
+        float       mX{0}, mY{0}, mZ{0}; // Last known position of the entity.
+        uint64_t    mCell{0}; // Key of the cell where the entity is stored.
+        uint32_t    mSlot{0}; // Index of the entity in the cell.
+        bool        mActive{false}; // Whether the entity is in the grid.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< int32_t > Cell; // Identifiers of the entities inside a cell.
+    typedef std::vector< int32_t > Result; // Identifiers of the entities that matched a query.
+
+    /* --------------------------------------------------------------------------------------------
+     * The grid of a single entity type.
+    */
+    struct Grid
+    {
+        std::vector< Entry >                            mEntries; // Indexed by entity identifier.
+        std::unordered_map< uint64_t, Cell >            mCells; // Cells that are not empty.
+        std::vector< std::pair< int32_t, int64_t > >    mMoving; // Entities moving on their own until a deadline.
+        size_t                                          mCount{0}; // Number of entities in the grid.
+    };
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    static SpatialIndex s_Inst; // Index instance.
+
+    // --------------------------------------------------------------------------------------------
+    Grid m_Grids[4]; // Grids for objects, pickups, players and vehicles, in this order.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the grid of an entity type. Returns null for types that are not indexed.
+    */
+    SQMOD_NODISCARD Grid * GetGrid(int32_t type);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the grid of an entity type or throw an error if the type is not indexed.
+    */
+    SQMOD_NODISCARD Grid & ValidGrid(int32_t type);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read again the position of the entities that are moving on their own.
+    */
+    void Sync(int32_t type, Grid & g);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether an entity is in the specified world. A negative world matches any world.
+    */
+    SQMOD_NODISCARD static bool InWorld(int32_t type, int32_t id, int32_t world);
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    SpatialIndex() = default;
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Calculate the cell coordinate on one axis.
+    */
+    SQMOD_NODISCARD static int32_t CellOf(float v) noexcept;
+
+    /* --------------------------------------------------------------------------------------------
+     * Combine the cell coordinates into a key.
+    */
+    SQMOD_NODISCARD static uint64_t KeyOf(int32_t cx, int32_t cy) noexcept
+    {
+        return (static_cast< uint64_t >(static_cast< uint32_t >(cx)) << 32) | static_cast< uint32_t >(cy);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    SpatialIndex(const SpatialIndex & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    SpatialIndex(SpatialIndex && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    SpatialIndex & operator = (const SpatialIndex & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    SpatialIndex & operator = (SpatialIndex && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index instance.
+    */
+    SQMOD_NODISCARD static SpatialIndex & Get()
+    {
+        return s_Inst;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert an entity or update its position. Types that are not indexed are ignored.
+    */
+    void Update(int32_t type, int32_t id, float x, float y, float z);
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert an entity or update its position with the one known by the server.
+    */
+    void Refresh(int32_t type, int32_t id);
+
+    /* --------------------------------------------------------------------------------------------
+     * The entity was moved. Its position is read again before queries until the specified number
+     * of milliseconds have passed, to follow animated movement.
+    */
+    void Moved(int32_t type, int32_t id, uint32_t time = 0);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove an entity from the index.
+    */
+    void Remove(int32_t type, int32_t id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove all entities from the index.
+    */
+    void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the entities within a distance from a point.
+    */
+    void InRadius(int32_t type, float x, float y, float z, float r, int32_t world, Result & out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the entities inside a box.
+    */
+    void InBox(int32_t type, float minx, float miny, float minz, float maxx, float maxy, float maxz,
+                int32_t world, Result & out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect up to the specified number of entities closest to a point, closest first.
+    */
+    void Nearest(int32_t type, float x, float y, float z, size_t k, int32_t world, Result & out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the entities in a world.
+    */
+    void InWorld(int32_t type, int32_t world, Result & out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of entities of a type in the index.
+    */
+    SQMOD_NODISCARD size_t Count(int32_t type);
+};
+
+} // Namespace:: SqMod
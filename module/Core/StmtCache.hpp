@@ -0,0 +1,212 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "SqBase.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <list>
+#include <utility>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Least recently used cache of idle prepared statements, keyed by their query string. A statement
+ * is checked out of the cache while in use and returned once it was reset, so each one is only
+ * ever used by a single owner. Only one idle statement is kept for each query string.
+*/
+template < class T > class StmtCache
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Function used to release statements that are no longer kept.
+    */
+    typedef void (*Finalizer)(T);
+
+    /* --------------------------------------------------------------------------------------------
+     * Default number of idle statements kept by a cache.
+    */
+    static constexpr size_t DEFAULT_CAPACITY = 32;
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::list< std::pair< String, T > > List; // Idle statements, most recently used first.
+
+    // --------------------------------------------------------------------------------------------
+    List                                                m_List; // Idle statements.
+    std::unordered_map< String, typename List::iterator > m_Map; // Idle statements by query string.
+    Finalizer                                           m_Finalize; // Releases statements.
+    size_t                                              m_Capacity; // Maximum number of idle statements.
+    uint64_t                                            m_Hits; // Statements found in the cache.
+    uint64_t                                            m_Misses; // Statements not found in the cache.
+    uint64_t                                            m_Evictions; // Statements released to make room.
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the least recently used statements until there are no more than the specified number.
+    */
+    void Trim(size_t n)
+    {
+        while (m_List.size() > n)
+        {
+            m_Finalize(m_List.back().second);
+            m_Map.erase(m_List.back().first);
+            m_List.pop_back();
+            ++m_Evictions;
+        }
+    }
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit StmtCache(Finalizer finalize, size_t capacity = DEFAULT_CAPACITY)
+        : m_List(), m_Map(), m_Finalize(finalize), m_Capacity(capacity)
+        , m_Hits(0), m_Misses(0), m_Evictions(0)
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    StmtCache(const StmtCache & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    StmtCache(StmtCache && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor. The owner is expected to call Clear() while the statements can still be released.
+    */
+    ~StmtCache()
+    {
+        Clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    StmtCache & operator = (const StmtCache & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    StmtCache & operator = (StmtCache && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Take the idle statement with the specified query string out of the cache. Returns null if
+     * there is none and the caller should prepare a new one.
+    */
+    SQMOD_NODISCARD T Checkout(const String & query)
+    {
+        auto itr = m_Map.find(query);
+        // Is there an idle statement for this query?
+        if (itr == m_Map.end())
+        {
+            ++m_Misses;
+            return nullptr;
+        }
+        ++m_Hits;
+        // Take it out of the cache
+        T stmt = itr->second->second;
+        m_List.erase(itr->second);
+        m_Map.erase(itr);
+        return stmt;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Give back a statement that was reset. It is released instead if caching is disabled or an
+     * idle statement with the same query string is already cached.
+    */
+    void Return(const String & query, T stmt)
+    {
+        // Should we keep it?
+        if (m_Capacity == 0 || m_Map.find(query) != m_Map.end())
+        {
+            m_Finalize(stmt);
+            return;
+        }
+        // Make room for it
+        Trim(m_Capacity - 1);
+        // It becomes the most recently used statement
+        m_List.emplace_front(query, stmt);
+        m_Map.emplace(query, m_List.begin());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all idle statements.
+    */
+    void Clear()
+    {
+        for (auto & e : m_List)
+        {
+            m_Finalize(e.second);
+        }
+        m_List.clear();
+        m_Map.clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of idle statements.
+    */
+    SQMOD_NODISCARD size_t GetCapacity() const noexcept
+    {
+        return m_Capacity;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of idle statements. Zero disables the cache.
+    */
+    void SetCapacity(size_t n)
+    {
+        m_Capacity = n;
+        // Release what doesn't fit anymore
+        Trim(n);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of idle statements.
+    */
+    SQMOD_NODISCARD size_t GetSize() const noexcept
+    {
+        return m_List.size();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that were found in the cache.
+    */
+    SQMOD_NODISCARD uint64_t GetHits() const noexcept
+    {
+        return m_Hits;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that were not found in the cache.
+    */
+    SQMOD_NODISCARD uint64_t GetMisses() const noexcept
+    {
+        return m_Misses;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that were released to make room for others.
+    */
+    SQMOD_NODISCARD uint64_t GetEvictions() const noexcept
+    {
+        return m_Evictions;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the counters.
+    */
+    void ResetStats() noexcept
+    {
+        m_Hits = m_Misses = m_Evictions = 0;
+    }
+};
+
+} // Namespace:: SqMod
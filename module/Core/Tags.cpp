@@ -0,0 +1,156 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/Tags.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cctype>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+TagIndex TagIndex::s_Inst[ENT_VEHICLE + 1];
+
+// ------------------------------------------------------------------------------------------------
+TagIndex & TagIndex::Get(int32_t type)
+{
+    // Is this a known entity type?
+    if (type <= ENT_UNKNOWN || type > ENT_VEHICLE)
+    {
+        STHROWF("Entities of type ({}) have no tag index", type);
+    }
+    return s_Inst[type];
+}
+
+// ------------------------------------------------------------------------------------------------
+String TagIndex::Lower(const SQChar * str, size_t len)
+{
+    String s(str, len);
+    // Same conversion as the case insensitive string comparison
+    for (auto & c : s)
+    {
+        c = static_cast< SQChar >(std::tolower(static_cast< unsigned char >(c)));
+    }
+    return s;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Insert(int32_t id, const String & tag)
+{
+    // Is the identifier valid?
+    if (id < 0)
+    {
+        return;
+    }
+    // Make room for this entity
+    else if (static_cast< size_t >(id) >= m_Slots.size())
+    {
+        m_Slots.resize(static_cast< size_t >(id) + 1);
+    }
+    Slot & s = m_Slots[static_cast< size_t >(id)];
+    // Is the tag the same?
+    if (s.mActive)
+    {
+        if (s.mTag == tag)
+        {
+            return;
+        }
+        Remove(id);
+    }
+    s.mTag = tag;
+    s.mActive = true;
+    // Keep the identifiers of each tag sorted
+    Result & r = m_Exact[tag];
+    r.insert(std::upper_bound(r.begin(), r.end(), id), id);
+    // Insert the tag in the sorted sets
+    m_Sorted.emplace(tag, id);
+    m_Lower.emplace(Lower(tag.data(), tag.size()), id);
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Remove(int32_t id)
+{
+    // Is the entity even in the index?
+    if (id < 0 || static_cast< size_t >(id) >= m_Slots.size() || !m_Slots[static_cast< size_t >(id)].mActive)
+    {
+        return;
+    }
+    Slot & s = m_Slots[static_cast< size_t >(id)];
+    // Remove the entity from the entities with the same tag
+    auto itr = m_Exact.find(s.mTag);
+    if (itr != m_Exact.end())
+    {
+        Result & r = itr->second;
+        r.erase(std::lower_bound(r.begin(), r.end(), id));
+        // Only tags with entities are kept
+        if (r.empty())
+        {
+            m_Exact.erase(itr);
+        }
+    }
+    // Remove the tag from the sorted sets
+    m_Sorted.erase(Key(s.mTag, id));
+    m_Lower.erase(Key(Lower(s.mTag.data(), s.mTag.size()), id));
+    // Release the tag
+    s.mTag.clear();
+    s.mActive = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Clear()
+{
+    m_Slots.clear();
+    m_Exact.clear();
+    m_Sorted.clear();
+    m_Lower.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Find(const SQChar * tag, size_t len, bool cs, bool prefix, Result & out) const
+{
+    const size_t n = out.size();
+    // Collect the matching entities
+    Each(tag, len, cs, prefix, [&out](int32_t id) { out.push_back(id); });
+    // Entities with the same exact tag are already sorted
+    if (!cs || prefix)
+    {
+        std::sort(out.begin() + static_cast< ptrdiff_t >(n), out.end());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int32_t TagIndex::First(const SQChar * tag, size_t len, bool cs, bool prefix) const
+{
+    // Entities with the same exact tag are already sorted
+    if (cs && !prefix)
+    {
+        auto itr = m_Exact.find(String(tag, len));
+        return itr == m_Exact.end() ? -1 : itr->second.front();
+    }
+    int32_t first = -1;
+    // Look for the lowest identifier
+    Each(tag, len, cs, prefix, [&first](int32_t id) {
+        if (first < 0 || id < first)
+        {
+            first = id;
+        }
+    });
+    return first;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t TagIndex::Count(const SQChar * tag, size_t len, bool cs, bool prefix) const
+{
+    // Exact matches that respect case are counted directly
+    if (cs && !prefix)
+    {
+        auto itr = m_Exact.find(String(tag, len));
+        return itr == m_Exact.end() ? 0 : itr->second.size();
+    }
+    size_t count = 0;
+    // Count the matching entities
+    Each(tag, len, cs, prefix, [&count](int32_t) { ++count; });
+    return count;
+}
+
+} // Namespace:: SqMod
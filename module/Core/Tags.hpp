@@ -0,0 +1,166 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "Core/Common.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <set>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Index of the tags of a single entity type. Exact matches are served from a hash map while
+ * prefix matches use a sorted set, once with the tags as they are and once in lowercase for
+ * lookups that ignore case. The index keeps its own copy of each tag so that an entity can be
+ * removed without knowing its tag.
+*/
+class TagIndex
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< int32_t > Result; // Identifiers of the entities that matched a query.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::pair< String, int32_t > Key; // Tag and the identifier of the entity.
+
+    /* --------------------------------------------------------------------------------------------
+     * Tag of an entity as known by the index.
+    */
+    struct Slot
+    {
+        String  mTag; // The indexed tag.
+        bool    mActive{false}; // Whether the entity is in the index.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    static TagIndex s_Inst[ENT_VEHICLE + 1]; // Index instances, one for each entity type.
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< Slot >                     m_Slots; // Indexed by entity identifier.
+    std::unordered_map< String, Result >    m_Exact; // Entities by tag, sorted by identifier.
+    std::set< Key >                         m_Sorted; // Tags in lexicographical order.
+    std::set< Key >                         m_Lower; // Lowercase tags in lexicographical order.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    TagIndex() = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Visit the entities in a sorted set where the key begins with the specified string.
+    */
+    template < typename F > static void Range(const std::set< Key > & set, const String & str, bool prefix, F && f)
+    {
+        for (auto itr = set.lower_bound(Key(str, INT32_MIN)); itr != set.end(); ++itr)
+        {
+            // Are we past the entities that match?
+            if (prefix ? (itr->first.compare(0, str.size(), str) != 0) : (itr->first != str))
+            {
+                break;
+            }
+            f(itr->second);
+        }
+    }
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    TagIndex(const TagIndex & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    TagIndex(TagIndex && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    TagIndex & operator = (const TagIndex & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    TagIndex & operator = (TagIndex && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of an entity type.
+    */
+    SQMOD_NODISCARD static TagIndex & Get(int32_t type);
+
+    /* --------------------------------------------------------------------------------------------
+     * Convert a tag to lowercase, the way it is compared when case is ignored.
+    */
+    SQMOD_NODISCARD static String Lower(const SQChar * str, size_t len);
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert an entity or replace its tag.
+    */
+    void Insert(int32_t id, const String & tag);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove an entity from the index.
+    */
+    void Remove(int32_t id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove all entities from the index.
+    */
+    void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Visit the entities where the tag is or begins with the specified string. The identifiers
+     * are not visited in any particular order.
+    */
+    template < typename F > void Each(const SQChar * tag, size_t len, bool cs, bool prefix, F && f) const
+    {
+        // Exact matches that respect case can be looked up directly
+        if (cs && !prefix)
+        {
+            auto itr = m_Exact.find(String(tag, len));
+            // Are there any entities with this tag?
+            if (itr != m_Exact.end())
+            {
+                for (const int32_t id : itr->second)
+                {
+                    f(id);
+                }
+            }
+        }
+        else if (cs)
+        {
+            Range(m_Sorted, String(tag, len), true, std::forward< F >(f));
+        }
+        else
+        {
+            Range(m_Lower, Lower(tag, len), prefix, std::forward< F >(f));
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the entities where the tag is or begins with the specified string, sorted by their
+     * identifier.
+    */
+    void Find(const SQChar * tag, size_t len, bool cs, bool prefix, Result & out) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the entity with the lowest identifier where the tag is or begins with the specified
+     * string. Returns -1 if there is none.
+    */
+    SQMOD_NODISCARD int32_t First(const SQChar * tag, size_t len, bool cs, bool prefix) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Count the entities where the tag is or begins with the specified string.
+    */
+    SQMOD_NODISCARD size_t Count(const SQChar * tag, size_t len, bool cs, bool prefix) const;
+};
+
+} // Namespace:: SqMod
@@ -4,9 +4,7 @@
 #include "Library/Chrono.hpp"
 
 // ------------------------------------------------------------------------------------------------
-#include <cstring>
-
-// ------------------------------------------------------------------------------------------------
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -15,10 +13,11 @@ namespace SqMod {
 SQMOD_DECL_TYPENAME(Typename, _SC("SqTask"))
 
 // ------------------------------------------------------------------------------------------------
-Tasks::Time         Tasks::s_Last = 0;
-Tasks::Time         Tasks::s_Prev = 0;
-Tasks::Interval     Tasks::s_Intervals[SQMOD_MAX_TASKS];
-Tasks::Task         Tasks::s_Tasks[SQMOD_MAX_TASKS];
+Tasks::Time                 Tasks::s_Last = 0;
+Tasks::Time                 Tasks::s_Prev = 0;
+TimerHeap                   Tasks::s_Timers;
+std::deque< Tasks::Task >   Tasks::s_Tasks(SQMOD_INITIAL_TASKS);
+uint32_t                    Tasks::s_Hint = 0;
 
 // ------------------------------------------------------------------------------------------------
 void Tasks::Task::Init(HSQOBJECT & func, HSQOBJECT & inst, Interval intrv, Iterator itr, int32_t id, int32_t type)
@@ -113,30 +112,38 @@ void Tasks::Process()
     s_Prev = s_Last;
     // Get the current time-stamp
     s_Last = Chrono::GetCurrentSysTime();
-    // Calculate the elapsed time
-    const auto delta = int32_t((s_Last - s_Prev) / 1000L);
-    // Process all active tasks
-    for (Interval * itr = s_Intervals; itr != (s_Intervals + SQMOD_MAX_TASKS); ++itr)
-    {
-        // Is this task valid?
-        if (*itr)
+    // Process only the tasks that expired since the last frame
+    s_Timers.Expire(s_Last, [](TimerHeap::Slot slot, TimerHeap::Time deadline) {
+        // Execute and obtain the next interval
+        const Interval intrv = s_Tasks[slot].Execute();
+        // Should this task be invoked again?
+        if (intrv > 0)
         {
-            // Decrease the elapsed time
-            (*itr) -= delta;
-            // Have we completed the routine interval?
-            if ((*itr) <= 0)
-            {
-                // Execute and reset the elapsed time
-                (*itr) = s_Tasks[itr - s_Intervals].Execute();
-            }
+            // Carry the remainder from the previous deadline but never fire more than once per frame
+            s_Timers.Schedule(slot, std::max(deadline + intrv * 1000L, s_Last + 1));
         }
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+void Tasks::Schedule(uint32_t slot, Interval intrv)
+{
+    // Tasks without an interval are not invoked
+    if (intrv <= 0)
+    {
+        s_Timers.Cancel(slot);
+    }
+    else
+    {
+        // Count from the time-stamp of the current frame, if we had one
+        s_Timers.Schedule(slot, (s_Last == 0 ? Chrono::GetCurrentSysTime() : s_Last) + intrv * 1000L);
     }
 }
 
 // ------------------------------------------------------------------------------------------------
 void Tasks::Initialize()
 {
-    std::memset(s_Intervals, 0, sizeof(s_Intervals));
+    s_Timers.Clear();
     // Transform all task instances to script objects
     for (auto & t : s_Tasks)
     {
@@ -180,6 +187,8 @@ void Tasks::Deinitialize()
         t.Terminate();
         t.mSelf.Release();
     }
+    // Nothing is scheduled anymore
+    s_Timers.Clear();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -201,15 +210,25 @@ LightObj & Tasks::FindEntity(int32_t id, int32_t type)
 // ------------------------------------------------------------------------------------------------
 SQInteger Tasks::FindUnused()
 {
-    for (const auto & t : s_Tasks)
+    const size_t count = s_Tasks.size();
+    // Resume the search from where the last slot was found
+    for (size_t n = 0; n < count; ++n)
     {
-        if (INVALID_ENTITY(t.mEntity))
+        const size_t idx = (s_Hint + n) % count;
+        // Is this slot unused?
+        if (INVALID_ENTITY(s_Tasks[idx].mEntity))
         {
-            return (&t - s_Tasks); // Return the index of this element
+            s_Hint = static_cast< uint32_t >(idx + 1);
+            return static_cast< SQInteger >(idx); // Return the index of this element
         }
     }
-    // No available slot
-    return -1;
+    // Enlarge the pool (references to existing elements remain valid)
+    Task & t = s_Tasks.emplace_back();
+    // Transform the new task instance to a script object
+    t.mSelf = LightObj(&t);
+    // Return the index of the new element
+    s_Hint = static_cast< uint32_t >(count + 1);
+    return static_cast< SQInteger >(count);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -316,7 +335,7 @@ SQInteger Tasks::Create(int32_t id, int32_t type, HSQUIRRELVM vm)
     // Alright, at this point we can initialize the slot
     task.Init(func, inst, intrv, static_cast< Iterator >(itr), id, type);
     // Now initialize the timer
-    s_Intervals[slot] = intrv;
+    Schedule(static_cast< uint32_t >(slot), intrv);
     // Push the tag instance on the stack
     sq_pushobject(vm, task.mSelf);
     // Specify that this function returns a value
@@ -347,11 +366,13 @@ SQInteger Tasks::Find(int32_t id, int32_t type, SQInteger & pos, HSQUIRRELVM vm)
             return tag.mRes; // Propagate the error!
         }
         // Attempt to find the requested task
-        for (const auto & t : s_Tasks)
+        for (size_t n = 0; n < s_Tasks.size(); ++n)
         {
+            const Task & t = s_Tasks[n];
+            // Does this task match the criteria?
             if (t.mEntity == id && t.mType == type && t.mTag.compare(0, String::npos, tag.mPtr) == 0)
             {
-                pos = static_cast< SQInteger >(&t - s_Tasks); // Store the index of this element
+                pos = static_cast< SQInteger >(n); // Store the index of this element
             }
         }
     }
@@ -374,11 +395,13 @@ SQInteger Tasks::Find(int32_t id, int32_t type, SQInteger & pos, HSQUIRRELVM vm)
         // Grab the hash of the callback object
         const SQHash chash = sq_gethash(vm, 2);
         // Attempt to find the requested task
-        for (const auto & t : s_Tasks)
+        for (size_t n = 0; n < s_Tasks.size(); ++n)
         {
+            const Task & t = s_Tasks[n];
+            // Does this task match the criteria?
             if (t.mHash == chash && t.mEntity == id && t.mType == type && t.mInterval == intrv)
             {
-                pos = static_cast< SQInteger >(&t - s_Tasks); // Store the index of this element
+                pos = static_cast< SQInteger >(n); // Store the index of this element
             }
         }
     }
@@ -405,11 +428,13 @@ SQInteger Tasks::Find(int32_t id, int32_t type, SQInteger & pos, HSQUIRRELVM vm)
         // Cast iterations to the right type
         const Iterator itr = ConvTo< Iterator >::From(sqitr);
         // Attempt to find the requested task
-        for (const auto & t : s_Tasks)
+        for (size_t n = 0; n < s_Tasks.size(); ++n)
         {
+            const Task & t = s_Tasks[n];
+            // Does this task match the criteria?
             if (t.mHash == chash && t.mEntity == id && t.mType == type && t.mInterval == intrv && t.mIterations == itr)
             {
-                pos = static_cast< SQInteger >(&t - s_Tasks); // Store the index of this element
+                pos = static_cast< SQInteger >(n); // Store the index of this element
             }
         }
     }
@@ -418,11 +443,13 @@ SQInteger Tasks::Find(int32_t id, int32_t type, SQInteger & pos, HSQUIRRELVM vm)
         // Grab the hash of the callback object
         const SQHash chash = sq_gethash(vm, 2);
         // Attempt to find the requested task
-        for (const auto & t : s_Tasks)
+        for (size_t n = 0; n < s_Tasks.size(); ++n)
         {
+            const Task & t = s_Tasks[n];
+            // Does this task match the criteria?
             if (t.mHash == chash && t.mEntity == id && t.mType == type)
             {
-                pos = static_cast< SQInteger >(&t - s_Tasks); // Store the index of this element
+                pos = static_cast< SQInteger >(n); // Store the index of this element
             }
         }
     }
@@ -452,7 +479,7 @@ SQInteger Tasks::Remove(int32_t id, int32_t type, HSQUIRRELVM vm)
         // Release task resources
         s_Tasks[pos].Terminate();
         // Reset the timer
-        s_Intervals[pos] = 0;
+        s_Timers.Cancel(static_cast< uint32_t >(pos));
         // A task was successfully removed
         sq_pushbool(vm, SQTrue);
     }
@@ -498,13 +525,15 @@ const Tasks::Task & Tasks::FindByTag(int32_t id, int32_t type, StackStrF & tag)
 // ------------------------------------------------------------------------------------------------
 void Tasks::Cleanup(int32_t id, int32_t type)
 {
-    for (auto & t : s_Tasks)
+    for (size_t n = 0; n < s_Tasks.size(); ++n)
     {
+        Task & t = s_Tasks[n];
+        // Does this task belong to the specified entity?
         if (t.mEntity == id && t.mType == type)
         {
             t.Terminate();
             // Also disable the timer
-            s_Intervals[&t - s_Tasks] = 0;
+            s_Timers.Cancel(static_cast< uint32_t >(n));
         }
     }
 }
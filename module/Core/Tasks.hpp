@@ -2,6 +2,10 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
+#include "Core/TimerHeap.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <deque>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -265,10 +269,11 @@ private:
     };
 
     // --------------------------------------------------------------------------------------------
-    static Time         s_Last; // Last time point.
-    static Time         s_Prev; // Previous time point.
-    static Interval     s_Intervals[SQMOD_MAX_TASKS]; // List of intervals to be processed.
-    static Task         s_Tasks[SQMOD_MAX_TASKS]; // List of tasks to be executed.
+    static Time                 s_Last; // Last time point.
+    static Time                 s_Prev; // Previous time point.
+    static TimerHeap            s_Timers; // Pending task invocations ordered by deadline.
+    static std::deque< Task >   s_Tasks; // Pool of task slots. Grows when full.
+    static uint32_t             s_Hint; // Slot from where to begin looking for unused slots.
 
 public:
 
@@ -330,10 +335,15 @@ protected:
     static LightObj & FindEntity(int32_t id, int32_t type);
 
     /* --------------------------------------------------------------------------------------------
-     * Find an unoccupied task slot.
+     * Find an unoccupied task slot. The pool is enlarged if there are no free slots.
     */
     static SQInteger FindUnused();
 
+    /* --------------------------------------------------------------------------------------------
+     * Schedule the task in the specified slot to be invoked after the specified interval.
+    */
+    static void Schedule(uint32_t slot, Interval intrv);
+
     /* --------------------------------------------------------------------------------------------
      * Locate the first task with the specified parameters.
     */
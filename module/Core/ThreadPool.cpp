@@ -1,8 +1,13 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core/ThreadPool.hpp"
+#include "Core/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <sqratConst.h>
 
 // ------------------------------------------------------------------------------------------------
 #include <chrono>
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -11,32 +16,63 @@ namespace SqMod {
 ThreadPool ThreadPool::s_Inst;
 
 // ------------------------------------------------------------------------------------------------
-void ProcessThreads()
+size_t ProcessThreads(FrameSlice & slice)
+{
+    return ThreadPool::Get().Process(slice);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve a monotonic time-point in microseconds. Safe to be called from any thread.
+*/
+static inline int64_t ThreadPoolTime()
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Raise the value of an atomic counter if the given value is greater.
+*/
+static inline void ThreadPoolMax(std::atomic< uint64_t > & a, uint64_t v)
 {
-    ThreadPool::Get().Process();
+    for (uint64_t c = a.load(std::memory_order_relaxed); c < v;)
+    {
+        if (a.compare_exchange_weak(c, v, std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
 ThreadPool::ThreadPool() noexcept
     : m_Running(false)
+    , m_Pending(0)
+    , m_Sleeping(0)
     , m_Mutex()
     , m_CV()
-    , m_Queue()
     , m_Finished()
     , m_Threads()
+    , m_Next(0)
+    , m_Lanes()
+    , m_LaneCount(TPL_BUILTIN)
 {
     m_Threads.reserve(MAX_WORKER_THREADS + 1); // Reserve thread memory in advance
+    // Name the built-in lanes
+    m_Lanes[TPL_GENERAL].mName.assign("general");
+    m_Lanes[TPL_HTTP].mName.assign("http");
+    m_Lanes[TPL_DATABASE].mName.assign("database");
 }
 
 // ------------------------------------------------------------------------------------------------
 ThreadPool::~ThreadPool()
 {
     // Desperate attempt to gracefully shutdown
-    for (auto & t : m_Threads)
+    for (auto & w : m_Threads)
     {
-        if (t.joinable())
+        if (w->mThread.joinable())
         {
-            t.join(); // Will block until work is finished!
+            w->mThread.join(); // Will block until work is finished!
         }
     }
     // Clear all thread instances
@@ -58,10 +94,15 @@ bool ThreadPool::Initialize(uint32_t count)
     }
     // Make sure the threads don't stop after creation
     m_Running = true;
-    // Create the specified amount of worker threads
+    // Create the specified amount of workers
     for (uint32_t i = 0; i < count; ++i)
     {
-        m_Threads.emplace_back(&ThreadPool::WorkerProc, this);
+        m_Threads.emplace_back(std::make_unique< Worker >());
+    }
+    // Start the threads only after all workers exist because they steal from each other
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        m_Threads[i]->mThread = std::thread(&ThreadPool::WorkerProc, this, static_cast< size_t >(i));
     }
     // Thread pool initialized
     return m_Running;
@@ -70,7 +111,7 @@ bool ThreadPool::Initialize(uint32_t count)
 // ------------------------------------------------------------------------------------------------
 void ThreadPool::Terminate(bool SQ_UNUSED_ARG(shutdown))
 {
-    // Are there threads running? 
+    // Are there threads running?
     if (m_Threads.empty() || !m_Running)
     {
         return; // Don't bother!
@@ -79,24 +120,55 @@ void ThreadPool::Terminate(bool SQ_UNUSED_ARG(shutdown))
     m_Running = false;
     {
         std::lock_guard< std::mutex > lg(m_Mutex);
-        // Enqueue dummy items to wake the threads and allow them to stop
-        for (size_t n = 0; n < m_Threads.size(); ++n)
-        {
-            m_Queue.push(Item());
-        }
-        // Allow threads to process the dummy items and stop
+        // Wake the sleeping threads and allow them to stop
         m_CV.notify_all();
     }
     // Attempt to join the threads
-    for (auto & t : m_Threads)
+    for (auto & w : m_Threads)
+    {
+        if (w->mThread.joinable())
+        {
+            w->mThread.join(); // Will block until work is finished!
+        }
+    }
+    // Items that never got the chance to be processed are aborted
+    auto abort = [this](Item & item) {
+        try {
+            item->OnAborted(false); // It should mark itself as aborted somehow!
+        } catch (const std::exception & e) {
+            LogErr("Exception occured in %s forced cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+        }
+        m_Finished.enqueue(std::move(item));
+    };
+    // Collect items from the worker queues
+    for (auto & w : m_Threads)
+    {
+        for (auto & q : w->mQueues)
+        {
+            for (Item item; q.try_dequeue(item);)
+            {
+                abort(item);
+            }
+        }
+    }
+    // Collect items that were waiting for their lane
+    for (uint32_t i = 0; i < m_LaneCount; ++i)
     {
-        if (t.joinable())
+        Lane & l = m_Lanes[i];
+        // Abort each parked item
+        for (auto & item : l.mParked)
         {
-            t.join(); // Will block until work is finished!
+            abort(item);
         }
+        l.mParked.clear();
+        // Nothing is queued or running anymore
+        l.mQueued = 0;
+        l.mRunning = 0;
     }
     // Clear all thread instances
     m_Threads.clear();
+    m_Pending = 0;
+    m_Next = 0;
     // Retrieve each item individually and process it
     for (Item item; m_Finished.try_dequeue(item);)
     {
@@ -111,23 +183,26 @@ void ThreadPool::Terminate(bool SQ_UNUSED_ARG(shutdown))
 }
 
 // ------------------------------------------------------------------------------------------------
-void ThreadPool::Process()
+size_t ThreadPool::Process(FrameSlice & slice)
 {
     // Process only what's currently in the queue
     const size_t count = m_Finished.size_approx();
-    // Retrieve each item individually and process it
-    for (size_t n = 0; n <= count; ++n)
+    // Retrieve each item individually and process it, as long as the slice allows it
+    for (size_t n = 0; n <= count && slice.Allow(); ++n)
     {
         Item item;
         // Try to get an item from the queue
         if (m_Finished.try_dequeue(item))
         {
+            slice.Count();
             // Is the item valid?
             if (item)
             {
                 try {
+                    // Cancelled items are completed as if the pool is shutting down
+                    const bool cancelled = item->mCancelled.load();
                     // Allow the item to finish itself
-                    if (item->OnCompleted(false))
+                    if (item->OnCompleted(cancelled) && !cancelled)
                     {
                         Enqueue(std::move(item)); // Queue again
                     }
@@ -137,92 +212,493 @@ void ThreadPool::Process()
             }
         }
     }
+    // Whatever is left is carried over
+    return m_Finished.size_approx();
 }
 
 // ------------------------------------------------------------------------------------------------
-void ThreadPool::WorkerProc()
+void ThreadPool::Enqueue(Item && item)
 {
-    // Whether this item wants to try again
-    bool retry = false;
-    // Pointer to the dequeued item
-    Item item;
-    // Initialize third-party allocator for this thread
-    auto rpmallocinit = std::make_unique< RPMallocThreadInit >();
-    // Constantly process items from the queue
-    while (true)
+    // Only queue valid items
+    if (!item || !m_Running) return;
+    // Validate the lane of the item
+    const uint32_t lane = item->Lane();
+    // Remember where the item was queued and when
+    item->mLaneID = lane < m_LaneCount ? lane : static_cast< uint32_t >(TPL_GENERAL);
+    item->mEpoch = m_Lanes[item->mLaneID].mEpoch.load();
+    item->mQueuedAt = ThreadPoolTime();
+    // Only queue if worker threads exist
+    if (!m_Threads.empty())
+    {
+        // The item is now waiting in its lane
+        m_Lanes[item->mLaneID].mQueued.fetch_add(1);
+        // Distribute items among the workers and let them steal from each other if necessary
+        Push(m_Next, std::move(item));
+        // Move to the next worker
+        m_Next = (m_Next + 1) % m_Threads.size();
+    }
+    else
     {
-        // Do we have to stop?
-        if (!m_Running)
+        ProcessInPlace(std::move(item));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::Push(size_t worker, Item && item)
+{
+    const uint32_t priority = item->Priority();
+    // Account for the item before it can be taken by another thread
+    m_Pending.fetch_add(1);
+    // Push the item in the queue of the specified worker
+    m_Threads[worker]->mQueues[priority < TPP_MAX ? priority : static_cast< uint32_t >(TPP_LOW)].enqueue(std::move(item));
+    // Is there any worker waiting for items?
+    if (m_Sleeping.load() > 0)
+    {
+        // Acquire the mutex so the notification is not lost by a worker about to sleep
+        std::lock_guard< std::mutex > lg(m_Mutex);
+        // Notify one thread that there's work
+        m_CV.notify_one();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ThreadPool::Take(size_t worker, Item & item)
+{
+    const size_t n = m_Threads.size();
+    // Higher priority items are taken first, regardless of the worker that owns them
+    for (auto & p : {TPP_HIGH, TPP_NORMAL, TPP_LOW})
+    {
+        // Look in our own queue first and then steal from the others
+        for (size_t i = 0; i < n; ++i)
         {
-            // Is there an item that requested to try again?
-            if (item)
+            if (m_Threads[(worker + i) % n]->mQueues[p].try_dequeue(item))
             {
-                try {
-                    item->OnAborted(true); // NOLINT(bugprone-use-after-move) There's an `if` condition above idiot!
-                } catch (const std::exception & e) {
-                    LogErr("Exception occured in %s cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
-                }
+                m_Pending.fetch_sub(1);
+                // Got one
+                return true;
             }
-            // Exit the loop
-            break;
         }
-        // Attempt to get an item from the queue
-        if (!retry)
+    }
+    // Nothing to do
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ThreadPool::Acquire(Item & item)
+{
+    Lane & l = m_Lanes[item->mLaneID];
+    // Lanes without a limit only need to keep count
+    if (l.mLimit.load() == 0)
+    {
+        l.mRunning.fetch_add(1);
+        // Allowed
+        return true;
+    }
+    std::lock_guard< std::mutex > lg(l.mMutex);
+    // The limit could have changed since we last checked
+    const uint32_t limit = l.mLimit.load();
+    // Is there room for one more item?
+    if (limit == 0 || l.mRunning.load() < limit)
+    {
+        l.mRunning.fetch_add(1);
+        // Allowed
+        return true;
+    }
+    // Wait until an item from this lane finishes
+    l.mParked.push_back(std::move(item));
+    // Not allowed
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::Release(size_t worker, uint32_t lane)
+{
+    Lane & l = m_Lanes[lane];
+    // Lanes without a limit don't park items
+    if (l.mLimit.load() == 0)
+    {
+        l.mRunning.fetch_sub(1);
+        // Nothing to resume
+        return;
+    }
+    Item item;
+    // Take the oldest parked item, if any
+    {
+        std::lock_guard< std::mutex > lg(l.mMutex);
+        // One less item running
+        l.mRunning.fetch_sub(1);
+        // Is there anything waiting?
+        if (l.mParked.empty())
+        {
+            return;
+        }
+        item = std::move(l.mParked.front());
+        l.mParked.pop_front();
+    }
+    // Allow the item to compete for the lane again
+    Push(worker, std::move(item));
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::ProcessInPlace(Item && item)
+{
+    bool r = false;
+    // Attempt preparation
+    try {
+        r = item->OnPrepare();
+    } catch (const std::exception & e) {
+        LogErr("Exception occured in %s preparation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+    }
+    // Perform the task in-place
+    if (r)
+    {
+        try {
+            r = item->OnProcess();
+        } catch (const std::exception & e) {
+            LogErr("Exception occured in %s processing stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+        }
+        if (r)
+        {
+            try {
+                item->OnAborted(true); // Not accepted in single thread
+            } catch (const std::exception & e) {
+                LogErr("Exception occured in %s cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+            }
+        }
+    }
+    // Task is completed in processing stage
+    m_Finished.enqueue(std::move(item));
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::WorkerProc(size_t id)
+{
+    // Pointer to the dequeued item
+    Item item;
+    // Initialize third-party allocator for this thread
+    auto rpmallocinit = std::make_unique< RPMallocThreadInit >();
+    // Constantly process items from the queues
+    while (m_Running)
+    {
+        // Attempt to get an item from the queues
+        if (!Take(id, item))
         {
             // Acquire a lock on the mutex
             std::unique_lock< std::mutex > lock(m_Mutex);
-            // Wait until there are items in the queue
-            while (m_Queue.empty())
+            // Let the others know we are waiting
+            m_Sleeping.fetch_add(1);
+            // Wait until there are items in the queues
+            while (m_Running && m_Pending.load() == 0)
             {
                 m_CV.wait(lock);
             }
-            // Retrieve top item the queue
-            item = std::move(m_Queue.front());
-            // Remove it from the queue
-            m_Queue.pop();
+            // No longer waiting
+            m_Sleeping.fetch_sub(1);
+            // Try again
+            continue;
         }
-        // Do we have to stop?
-        if (!m_Running)
+        Lane & lane = m_Lanes[item->mLaneID];
+        // Was the item cancelled while it was waiting?
+        if (item->mCancelled.load() || item->mEpoch != lane.mEpoch.load())
         {
-            // Is there an item to be processed?
-            if (item)
+            item->mCancelled = true;
+            // Update statistics
+            lane.mQueued.fetch_sub(1);
+            lane.mCancelled.fetch_add(1);
+            // Let the item know it will not be processed
+            try {
+                item->OnAborted(false);
+            } catch (const std::exception & e) {
+                LogErr("Exception occured in %s cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+            }
+            // Complete it in the main thread
+            m_Finished.enqueue(std::move(item));
+            continue;
+        }
+        // Is the lane allowed to run another item? Otherwise, the lane takes ownership of it
+        if (!Acquire(item))
+        {
+            continue;
+        }
+        // Account for the time spent waiting
+        const int64_t start = ThreadPoolTime();
+        const auto wait = static_cast< uint64_t >(std::max< int64_t >(start - item->mQueuedAt, 0));
+        lane.mQueued.fetch_sub(1);
+        lane.mWaitTime.fetch_add(wait);
+        ThreadPoolMax(lane.mMaxWait, wait);
+        // Whether this item wants to try again
+        bool retry;
+        // Keep processing until the item is done or we have to stop
+        do {
+            bool r = false;
+            // Attempt preparation
+            try {
+                r = item->OnPrepare();
+            } catch (const std::exception & e) {
+                LogErr("Exception occured in %s preparation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+            }
+            retry = false;
+            // Perform the task
+            if (r)
             {
                 try {
-                    item->OnAborted(false); // It should mark itself as aborted somehow!
+                    retry = item->OnProcess();
                 } catch (const std::exception & e) {
-                    LogErr("Exception occured in %s forced cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+                    LogErr("Exception occured in %s processing stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
                 }
             }
-            // Exit the loop
-            break;
-        }
-        bool r;
-        // Attempt preparation
-        try {
-            r = item->OnPrepare();
-        } catch (const std::exception & e) {
-            LogErr("Exception occured in %s preparation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
-        }
-        // Perform the task
-        if (r)
+        } while (retry && m_Running && !item->mCancelled.load());
+        // Did the item want to try again?
+        if (retry)
         {
             try {
-                retry = item->OnProcess();
+                item->OnAborted(true);
             } catch (const std::exception & e) {
-                LogErr("Exception occured in %s processing stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
+                LogErr("Exception occured in %s cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
             }
         }
+        // Account for the time spent processing
+        const auto run = static_cast< uint64_t >(std::max< int64_t >(ThreadPoolTime() - start, 0));
+        lane.mRunTime.fetch_add(run);
+        lane.mCompleted.fetch_add(1);
+        ThreadPoolMax(lane.mMaxRun, run);
+        // Allow another item from this lane to run
+        Release(id, item->mLaneID);
         // The task was performed
-        if (!retry)
+        m_Finished.enqueue(std::move(item));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool::Lane & ThreadPool::GetValidLane(uint32_t lane)
+{
+    if (lane >= m_LaneCount)
+    {
+        STHROWF("Invalid thread pool lane ({})", lane);
+    }
+    // Lane is valid
+    return m_Lanes[lane];
+}
+
+// ------------------------------------------------------------------------------------------------
+uint32_t ThreadPool::RegisterLane(const String & name, uint32_t limit)
+{
+    // Does this lane exist already?
+    const int32_t id = FindLane(name);
+    // Use the existing one
+    if (id >= 0)
+    {
+        return static_cast< uint32_t >(id);
+    }
+    else if (name.empty())
+    {
+        STHROWF("Invalid thread pool lane name");
+    }
+    else if (m_LaneCount >= MAX_WORKER_LANES)
+    {
+        STHROWF("Reached the maximum number of thread pool lanes ({})", MAX_WORKER_LANES);
+    }
+    // Initialize the lane
+    Lane & l = m_Lanes[m_LaneCount];
+    l.mName.assign(name);
+    l.mLimit = limit;
+    // Return the lane identifier
+    return m_LaneCount++;
+}
+
+// ------------------------------------------------------------------------------------------------
+int32_t ThreadPool::FindLane(const String & name) const
+{
+    for (uint32_t i = 0; i < m_LaneCount; ++i)
+    {
+        if (m_Lanes[i].mName == name)
         {
-            m_Finished.enqueue(std::move(item));
+            return static_cast< int32_t >(i);
         }
     }
-    // Did we take an item from the queue?
-    if (item)
+    // Not found
+    return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+const String & ThreadPool::GetLaneName(uint32_t lane)
+{
+    return GetValidLane(lane).mName;
+}
+
+// ------------------------------------------------------------------------------------------------
+uint32_t ThreadPool::GetLaneLimit(uint32_t lane)
+{
+    return GetValidLane(lane).mLimit.load();
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::SetLaneLimit(uint32_t lane, uint32_t limit)
+{
+    Lane & l = GetValidLane(lane);
+    std::deque< Item > parked;
+    // Apply the limit and take the parked items
+    {
+        std::lock_guard< std::mutex > lg(l.mMutex);
+        l.mLimit = limit;
+        parked.swap(l.mParked);
+    }
+    // Allow them to compete for the lane with the new limit
+    for (auto & item : parked)
+    {
+        Push(m_Next, std::move(item));
+        m_Next = (m_Next + 1) % m_Threads.size();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::CancelLane(uint32_t lane)
+{
+    Lane & l = GetValidLane(lane);
+    std::deque< Item > parked;
+    // Invalidate all items queued so far and take the parked items
     {
-        m_Finished.enqueue(std::move(item)); // Return it, even if not completed
+        std::lock_guard< std::mutex > lg(l.mMutex);
+        l.mEpoch.fetch_add(1);
+        parked.swap(l.mParked);
     }
+    // Let the workers abort them
+    for (auto & item : parked)
+    {
+        Push(m_Next, std::move(item));
+        m_Next = (m_Next + 1) % m_Threads.size();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool::LaneStats ThreadPool::GetLaneStats(uint32_t lane)
+{
+    Lane & l = GetValidLane(lane);
+    // Take a snapshot of the statistics
+    LaneStats s;
+    s.mLimit = l.mLimit.load();
+    s.mQueued = l.mQueued.load();
+    s.mRunning = l.mRunning.load();
+    s.mCompleted = l.mCompleted.load();
+    s.mCancelled = l.mCancelled.load();
+    s.mWaitTime = l.mWaitTime.load();
+    s.mMaxWait = l.mMaxWait.load();
+    s.mRunTime = l.mRunTime.load();
+    s.mMaxRun = l.mMaxRun.load();
+    // Return the snapshot
+    return s;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::ResetLaneStats(uint32_t lane)
+{
+    Lane & l = GetValidLane(lane);
+    // Queued and running items are current state, not accumulated
+    l.mCompleted = 0;
+    l.mCancelled = 0;
+    l.mWaitTime = 0;
+    l.mMaxWait = 0;
+    l.mRunTime = 0;
+    l.mMaxRun = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqThreadPool_FindLane(StackStrF & name)
+{
+    return ThreadPool::Get().FindLane(String(name.mPtr, static_cast< size_t >(name.mLen <= 0 ? 0 : name.mLen)));
+}
+
+// ------------------------------------------------------------------------------------------------
+static const String & SqThreadPool_LaneName(SQInteger lane)
+{
+    return ThreadPool::Get().GetLaneName(ConvTo< uint32_t >::From(lane));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqThreadPool_GetLaneLimit(SQInteger lane)
+{
+    return ThreadPool::Get().GetLaneLimit(ConvTo< uint32_t >::From(lane));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqThreadPool_SetLaneLimit(SQInteger lane, SQInteger limit)
+{
+    ThreadPool::Get().SetLaneLimit(ConvTo< uint32_t >::From(lane), ConvTo< uint32_t >::From(limit));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqThreadPool_CancelLane(SQInteger lane)
+{
+    ThreadPool::Get().CancelLane(ConvTo< uint32_t >::From(lane));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqThreadPool_ResetLaneStats(SQInteger lane)
+{
+    ThreadPool::Get().ResetLaneStats(ConvTo< uint32_t >::From(lane));
+}
+
+// ------------------------------------------------------------------------------------------------
+static Table SqThreadPool_LaneStats(SQInteger lane)
+{
+    const ThreadPool::LaneStats s = ThreadPool::Get().GetLaneStats(ConvTo< uint32_t >::From(lane));
+    // Create the table with the statistics
+    Table t(SqVM());
+    t.SetValue(_SC("Limit"), static_cast< SQInteger >(s.mLimit));
+    t.SetValue(_SC("Queued"), static_cast< SQInteger >(s.mQueued));
+    t.SetValue(_SC("Running"), static_cast< SQInteger >(s.mRunning));
+    t.SetValue(_SC("Completed"), static_cast< SQInteger >(s.mCompleted));
+    t.SetValue(_SC("Cancelled"), static_cast< SQInteger >(s.mCancelled));
+    t.SetValue(_SC("WaitTime"), static_cast< SQInteger >(s.mWaitTime));
+    t.SetValue(_SC("MaxWait"), static_cast< SQInteger >(s.mMaxWait));
+    t.SetValue(_SC("AvgWait"), static_cast< SQInteger >(s.mCompleted ? s.mWaitTime / s.mCompleted : 0));
+    t.SetValue(_SC("RunTime"), static_cast< SQInteger >(s.mRunTime));
+    t.SetValue(_SC("MaxRun"), static_cast< SQInteger >(s.mMaxRun));
+    t.SetValue(_SC("AvgRun"), static_cast< SQInteger >(s.mCompleted ? s.mRunTime / s.mCompleted : 0));
+    // Return the table
+    return t;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqThreadPool_Threads()
+{
+    return static_cast< SQInteger >(ThreadPool::Get().GetThreadCount());
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqThreadPool_Pending()
+{
+    return static_cast< SQInteger >(ThreadPool::Get().GetPending());
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqThreadPool_Lanes()
+{
+    return static_cast< SQInteger >(ThreadPool::Get().GetLaneCount());
+}
+
+// ================================================================================================
+void Register_ThreadPool(HSQUIRRELVM vm)
+{
+    RootTable(vm)
+    .Bind(_SC("SqThreadPool"), Table(vm)
+        .Func(_SC("Threads"), &SqThreadPool_Threads)
+        .Func(_SC("Pending"), &SqThreadPool_Pending)
+        .Func(_SC("Lanes"), &SqThreadPool_Lanes)
+        .FmtFunc(_SC("FindLane"), &SqThreadPool_FindLane)
+        .Func(_SC("LaneName"), &SqThreadPool_LaneName)
+        .Func(_SC("GetLaneLimit"), &SqThreadPool_GetLaneLimit)
+        .Func(_SC("SetLaneLimit"), &SqThreadPool_SetLaneLimit)
+        .Func(_SC("CancelLane"), &SqThreadPool_CancelLane)
+        .Func(_SC("LaneStats"), &SqThreadPool_LaneStats)
+        .Func(_SC("ResetLaneStats"), &SqThreadPool_ResetLaneStats)
+    );
+    // --------------------------------------------------------------------------------------------
+    ConstTable(vm).Enum(_SC("SqThreadLane"), Enumeration(vm)
+        .Const(_SC("General"),  static_cast< SQInteger >(TPL_GENERAL))
+        .Const(_SC("HTTP"),     static_cast< SQInteger >(TPL_HTTP))
+        .Const(_SC("Database"), static_cast< SQInteger >(TPL_DATABASE))
+    );
 }
 
 } // Namespace:: SqMod
@@ -2,13 +2,16 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core/Common.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <concurrentqueue.h>
 
 // ------------------------------------------------------------------------------------------------
-#include <queue>
+#include <array>
+#include <deque>
 #include <mutex>
+#include <memory>
 #include <vector>
 #include <atomic>
 #include <thread>
@@ -19,6 +22,31 @@ namespace SqMod {
 
 // ------------------------------------------------------------------------------------------------
 static constexpr uint32_t MAX_WORKER_THREADS = 32; // Hard coded worker threads limit.
+static constexpr uint32_t MAX_WORKER_LANES = 16; // Hard coded subsystem lanes limit.
+
+/* ------------------------------------------------------------------------------------------------
+ * Priority classes of items. Items with a higher priority are always taken first.
+*/
+enum ThreadPoolPriority
+{
+    TPP_HIGH = 0,
+    TPP_NORMAL,
+    TPP_LOW,
+    // Number of priority classes
+    TPP_MAX
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Built-in subsystem lanes. Each lane can limit how many of its items run at the same time.
+*/
+enum ThreadPoolLane
+{
+    TPL_GENERAL = 0,
+    TPL_HTTP,
+    TPL_DATABASE,
+    // Number of built-in lanes
+    TPL_BUILTIN
+};
 
 /* ------------------------------------------------------------------------------------------------
  * Item that can be given to the thread pool to process data in a separate thread.
@@ -89,10 +117,50 @@ struct ThreadPoolItem
      * Most likely due to a shutdown of the thread pool.
     */
     virtual void OnAborted(bool SQ_UNUSED_ARG(retry)) { }
+
+    /* --------------------------------------------------------------------------------------------
+     * Provide the subsystem lane in which the item should be processed.
+    */
+    SQMOD_NODISCARD virtual uint32_t Lane() noexcept { return TPL_GENERAL; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Provide the priority class of the item.
+    */
+    SQMOD_NODISCARD virtual uint32_t Priority() noexcept { return TPP_NORMAL; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Request the item to be cancelled. If it was not started yet, it will be aborted instead.
+     * Cancelled items are completed as if the thread pool is shutting down. Can be called from any thread.
+    */
+    void Cancel() noexcept
+    {
+        mCancelled.store(true);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the item was cancelled.
+    */
+    SQMOD_NODISCARD bool IsCancelled() const noexcept
+    {
+        return mCancelled.load();
+    }
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    friend class ThreadPool;
+    // --------------------------------------------------------------------------------------------
+    std::atomic_bool    mCancelled{false}; // Whether the item was cancelled.
+    // --------------------------------------------------------------------------------------------
+    uint32_t            mLaneID{TPL_GENERAL}; // Lane in which the item was queued.
+    uint32_t            mEpoch{0}; // Cancellation epoch of the lane when the item was queued.
+    int64_t             mQueuedAt{0}; // Time-point when the item was queued. (microseconds)
 };
 
 /* ------------------------------------------------------------------------------------------------
  * Internal thread pool used to reduce stuttering from the plug-in whenever necessary and/or possible.
+ * Each worker owns a lock-free queue for every priority class and idle workers steal from the others.
+ * Items are grouped in subsystem lanes which can limit how many of their items run concurrently.
 */
 class ThreadPool
 {
@@ -113,29 +181,108 @@ private:
 public:
     // --------------------------------------------------------------------------------------------
     using Item = std::unique_ptr< ThreadPoolItem >; // Owning pointer of an item.
+
+    /* --------------------------------------------------------------------------------------------
+     * Snapshot of the statistics of a lane. Times are in microseconds.
+    */
+    struct LaneStats
+    {
+        uint32_t    mLimit{0}; // Maximum number of items allowed to run concurrently. Zero if unlimited.
+        uint64_t    mQueued{0}; // Items waiting to be processed.
+        uint64_t    mRunning{0}; // Items currently being processed.
+        uint64_t    mCompleted{0}; // Items that were processed.
+        uint64_t    mCancelled{0}; // Items that were cancelled before being processed.
+        uint64_t    mWaitTime{0}; // Total time items spent waiting in the queue.
+        uint64_t    mMaxWait{0}; // Longest time an item spent waiting in the queue.
+        uint64_t    mRunTime{0}; // Total time spent processing items.
+        uint64_t    mMaxRun{0}; // Longest time spent processing an item.
+    };
+
 private:
 
+    /* --------------------------------------------------------------------------------------------
+     * Subsystem lane information.
+    */
+    struct Lane
+    {
+        String                  mName{}; // The name of the lane. Only accessed from the main thread.
+        // ----------------------------------------------------------------------------------------
+        std::atomic< uint32_t > mLimit{0}; // Maximum number of items allowed to run concurrently.
+        std::atomic< uint32_t > mEpoch{0}; // Incremented to cancel all items queued so far.
+        // ----------------------------------------------------------------------------------------
+        std::atomic< uint64_t > mQueued{0}, mRunning{0}, mCompleted{0}, mCancelled{0};
+        std::atomic< uint64_t > mWaitTime{0}, mMaxWait{0}, mRunTime{0}, mMaxRun{0};
+        // ----------------------------------------------------------------------------------------
+        std::mutex              mMutex{}; // Guards the parked items and the running counter of limited lanes.
+        std::deque< Item >      mParked{}; // Items waiting for the lane to allow them to run.
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Worker thread information.
+    */
+    struct Worker
+    {
+        std::thread                         mThread{}; // The actual thread.
+        moodycamel::ConcurrentQueue< Item > mQueues[TPP_MAX]{}; // Queued items of each priority.
+    };
+
     // --------------------------------------------------------------------------------------------
-    using Pool = std::vector< std::thread >; // Worker container.
+    using Pool = std::vector< std::unique_ptr< Worker > >; // Worker container.
+    using Lanes = std::array< Lane, MAX_WORKER_LANES >; // Lane container.
     using Finished = moodycamel::ConcurrentQueue< Item >; // Finished items.
 
     // --------------------------------------------------------------------------------------------
     std::atomic_bool        m_Running; // Whether the threads are allowed to run.
     // --------------------------------------------------------------------------------------------
-    std::mutex              m_Mutex;
+    std::atomic< size_t >   m_Pending; // Number of items in the worker queues.
+    std::atomic< size_t >   m_Sleeping; // Number of workers waiting for items.
+    std::mutex              m_Mutex; // Only used to put idle workers to sleep.
     std::condition_variable m_CV;
-    std::queue< Item >      m_Queue;
     // --------------------------------------------------------------------------------------------
     Finished                m_Finished; // Non-blocking concurrent queue of finished items.
     // --------------------------------------------------------------------------------------------
     Pool                    m_Threads; // Pool of worker threads.
+    size_t                  m_Next; // The worker which receives the next item. Only used by the main thread.
+    // --------------------------------------------------------------------------------------------
+    Lanes                   m_Lanes; // Subsystem lanes.
+    uint32_t                m_LaneCount; // Number of lanes in use.
 
 private:
 
     /* --------------------------------------------------------------------------------------------
      * Internal function used to process tasks.
     */
-    void WorkerProc();
+    void WorkerProc(size_t id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Push an item in the queue of a worker and wake a thread if necessary.
+    */
+    void Push(size_t worker, Item && item);
+
+    /* --------------------------------------------------------------------------------------------
+     * Take the item with the highest priority, from the specified worker first and then the others.
+    */
+    SQMOD_NODISCARD bool Take(size_t worker, Item & item);
+
+    /* --------------------------------------------------------------------------------------------
+     * Attempt to reserve a slot in the lane of the item. Parks the item in the lane if it fails.
+    */
+    SQMOD_NODISCARD bool Acquire(Item & item);
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the slot reserved by an item from the specified lane and resume a parked item, if any.
+    */
+    void Release(size_t worker, uint32_t lane);
+
+    /* --------------------------------------------------------------------------------------------
+     * Process an item in-place when no worker threads exist.
+    */
+    void ProcessInPlace(Item && item);
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate a lane identifier and retrieve the associated lane.
+    */
+    SQMOD_NODISCARD Lane & GetValidLane(uint32_t lane);
 
 public:
 
@@ -178,9 +325,9 @@ public:
     void Terminate(bool shutdown = false);
 
     /* --------------------------------------------------------------------------------------------
-     * Process finished items.
+     * Process finished items within the given slice. Returns how many items are left.
     */
-    void Process();
+    size_t Process(FrameSlice & slice);
 
     /* --------------------------------------------------------------------------------------------
      * Queue an item to be processed. Will take ownership of the given pointer!
@@ -201,52 +348,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Queue an item to be processed. Will take ownership of the given pointer!
     */
-    void Enqueue(Item && item)
-    {
-        // Only queue valid items
-        if (!item || !m_Running) return;
-        // Only queue if worker threads exist
-        if (!m_Threads.empty())
-        {
-            // Acquire a lock on the mutex
-            std::unique_lock< std::mutex > lock(m_Mutex);
-            // Push the item in the queue
-            m_Queue.push(std::forward< Item >(item));
-            // Release the mutex before notifying
-            lock.unlock();
-            // Notify one thread that there's work
-            m_CV.notify_one(); 
-        }
-        else
-        {
-            bool r;
-            // Attempt preparation
-            try {
-                r = item->OnPrepare();
-            } catch (const std::exception & e) {
-                LogErr("Exception occured in %s preparation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
-            }
-            // Perform the task in-place
-            if (r)
-            {
-                try {
-                    r = item->OnProcess();
-                } catch (const std::exception & e) {
-                    LogErr("Exception occured in %s processing stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
-                }
-                if (r)
-                {
-                    try {
-                        item->OnAborted(true); // Not accepted in single thread
-                    } catch (const std::exception & e) {
-                        LogErr("Exception occured in %s cancelation stage [%s] for [%s]", item->TypeName(), e.what(), item->IdentifiableInfo());
-                    }
-                }
-            }
-            // Task is completed in processing stage
-            m_Finished.enqueue(std::forward< Item >(item));
-        }
-    }
+    void Enqueue(Item && item);
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the number of worker threads.
@@ -255,6 +357,62 @@ public:
     {
         return m_Threads.size();
     }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of items waiting in the worker queues.
+    */
+    SQMOD_NODISCARD size_t GetPending() const
+    {
+        return m_Pending.load();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a new lane or retrieve an existing lane with the specified name.
+    */
+    uint32_t RegisterLane(const String & name, uint32_t limit = 0);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the identifier of the lane with the specified name. Returns -1 if not found.
+    */
+    SQMOD_NODISCARD int32_t FindLane(const String & name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of lanes in use.
+    */
+    SQMOD_NODISCARD uint32_t GetLaneCount() const
+    {
+        return m_LaneCount;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the name of a lane.
+    */
+    SQMOD_NODISCARD const String & GetLaneName(uint32_t lane);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of items from a lane that are allowed to run concurrently.
+    */
+    SQMOD_NODISCARD uint32_t GetLaneLimit(uint32_t lane);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of items from a lane that are allowed to run concurrently.
+    */
+    void SetLaneLimit(uint32_t lane, uint32_t limit);
+
+    /* --------------------------------------------------------------------------------------------
+     * Cancel all items currently queued in a lane. Items that are already running are not affected.
+    */
+    void CancelLane(uint32_t lane);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a snapshot of the statistics of a lane.
+    */
+    SQMOD_NODISCARD LaneStats GetLaneStats(uint32_t lane);
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the accumulated statistics of a lane.
+    */
+    void ResetLaneStats(uint32_t lane);
 };
 
 } // Namespace:: SqMod
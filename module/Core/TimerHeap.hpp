@@ -0,0 +1,220 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "SqBase.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Min-heap of deadlines used to schedule slot based timers (routines, tasks etc.)
+ * Deadlines are absolute time-points in microseconds so that no precision is lost between frames.
+ * Cancelled or re-scheduled entries are not removed from the heap. Instead, each slot keeps a stamp
+ * which is incremented on every change and heap entries with an outdated stamp are simply skipped.
+*/
+class TimerHeap
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef int64_t     Time;
+    typedef uint32_t    Slot;
+    typedef uint32_t    Stamp;
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Entry stored in the heap.
+    */
+    struct Entry
+    {
+        Time    mDeadline; // The time-point when the associated slot should be expired.
+        Slot    mSlot; // The slot to which this entry belongs.
+        Stamp   mStamp; // The stamp of the slot when this entry was created.
+
+        /* ----------------------------------------------------------------------------------------
+         * Order entries such that the earliest deadline ends up at the top of the heap.
+        */
+        bool operator < (const Entry & o) const noexcept
+        {
+            return mDeadline > o.mDeadline;
+        }
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Scheduling information for a single slot.
+    */
+    struct State
+    {
+        Time    mDeadline{0}; // The time-point when this slot should expire.
+        Stamp   mStamp{0}; // Incremented each time the slot is scheduled or cancelled.
+        bool    mPending{false}; // Whether the slot is currently scheduled.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< Entry >    m_Heap; // Pending and outdated entries.
+    std::vector< State >    m_State; // Scheduling information for each slot.
+    size_t                  m_Pending; // Number of slots currently scheduled.
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    TimerHeap() noexcept
+        : m_Heap(), m_State(), m_Pending(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    TimerHeap(const TimerHeap & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    TimerHeap(TimerHeap && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    TimerHeap & operator = (const TimerHeap & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    TimerHeap & operator = (TimerHeap && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Schedule the specified slot to expire at the specified time-point. Replaces any previous deadline.
+    */
+    void Schedule(Slot slot, Time deadline)
+    {
+        // Make sure we have state information for this slot
+        if (slot >= m_State.size())
+        {
+            m_State.resize(static_cast< size_t >(slot) + 1);
+        }
+        State & s = m_State[slot];
+        // Account for newly scheduled slots
+        if (!s.mPending)
+        {
+            ++m_Pending;
+        }
+        // Invalidate previous entries and remember the new deadline
+        s.mDeadline = deadline;
+        s.mPending = true;
+        ++s.mStamp;
+        // Insert the entry into the heap
+        m_Heap.push_back(Entry{deadline, slot, s.mStamp});
+        std::push_heap(m_Heap.begin(), m_Heap.end());
+        // Get rid of outdated entries if they start to dominate the heap
+        if (m_Heap.size() > 64 && m_Heap.size() > (m_Pending * 4))
+        {
+            Compact();
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Prevent the specified slot from expiring.
+    */
+    void Cancel(Slot slot)
+    {
+        if (slot < m_State.size() && m_State[slot].mPending)
+        {
+            State & s = m_State[slot];
+            // Invalidate any entries in the heap
+            s.mPending = false;
+            ++s.mStamp;
+            --m_Pending;
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified slot is currently scheduled.
+    */
+    SQMOD_NODISCARD bool IsPending(Slot slot) const noexcept
+    {
+        return slot < m_State.size() && m_State[slot].mPending;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the deadline of the specified slot. Only meaningful if the slot is scheduled.
+    */
+    SQMOD_NODISCARD Time GetDeadline(Slot slot) const noexcept
+    {
+        return slot < m_State.size() ? m_State[slot].mDeadline : 0;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of scheduled slots.
+    */
+    SQMOD_NODISCARD size_t GetPending() const noexcept
+    {
+        return m_Pending;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Expire all slots with a deadline lower or equal to the specified time-point. The slot is no
+     * longer considered scheduled when the callback is invoked, which receives the slot and the
+     * deadline it had. The callback is allowed to schedule or cancel any slot, including this one.
+    */
+    template < class F > void Expire(Time now, F && f)
+    {
+        while (!m_Heap.empty() && m_Heap.front().mDeadline <= now)
+        {
+            // Take the earliest entry out of the heap
+            std::pop_heap(m_Heap.begin(), m_Heap.end());
+            const Entry e = m_Heap.back();
+            m_Heap.pop_back();
+            // Ignore outdated entries
+            State & s = m_State[e.mSlot];
+            if (!s.mPending || s.mStamp != e.mStamp)
+            {
+                continue;
+            }
+            // This slot is no longer scheduled
+            s.mPending = false;
+            --m_Pending;
+            // Let the owner process it
+            f(e.mSlot, e.mDeadline);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Cancel all scheduled slots and release the associated memory.
+    */
+    void Clear()
+    {
+        m_Heap.clear();
+        m_Heap.shrink_to_fit();
+        m_State.clear();
+        m_State.shrink_to_fit();
+        m_Pending = 0;
+    }
+
+protected:
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove outdated entries from the heap.
+    */
+    void Compact()
+    {
+        m_Heap.erase(std::remove_if(m_Heap.begin(), m_Heap.end(), [this](const Entry & e) {
+            const State & s = m_State[e.mSlot];
+            return !s.mPending || s.mStamp != e.mStamp;
+        }), m_Heap.end());
+        std::make_heap(m_Heap.begin(), m_Heap.end());
+    }
+};
+
+} // Namespace:: SqMod
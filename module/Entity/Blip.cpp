@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Entity/Blip.hpp"
 #include "Core.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -56,6 +57,11 @@ void CBlip::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_BLIP).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include "Base/Color4.hpp"
 #include "Base/Vector3.hpp"
 #include "Core.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -59,6 +60,11 @@ void CCheckpoint::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_CHECKPOINT).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
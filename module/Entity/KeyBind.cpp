@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Entity/KeyBind.hpp"
 #include "Core.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -56,6 +57,11 @@ void CKeyBind::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_KEYBIND).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
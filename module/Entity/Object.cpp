@@ -4,6 +4,8 @@
 #include "Base/Quaternion.hpp"
 #include "Base/Vector3.hpp"
 #include "Core.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -65,6 +67,11 @@ void CObject::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_OBJECT).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -221,6 +228,8 @@ void CObject::MoveTo(const Vector3 & pos, uint32_t time) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectTo(m_ID, pos.x, pos.y, pos.z, time);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, time);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -230,6 +239,8 @@ void CObject::MoveToEx(float x, float y, float z, uint32_t time) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectTo(m_ID, x, y, z, time);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, time);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -239,6 +250,8 @@ void CObject::MoveBy(const Vector3 & pos, uint32_t time) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectBy(m_ID, pos.x, pos.y, pos.z, time);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, time);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -248,6 +261,8 @@ void CObject::MoveByEx(float x, float y, float z, uint32_t time) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectBy(m_ID, x, y, z, time);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, time);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -270,6 +285,8 @@ void CObject::SetPosition(const Vector3 & pos) const
     Validate();
     // Perform the requested operation
     _Func->SetObjectPosition(m_ID, pos.x, pos.y, pos.z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -279,6 +296,8 @@ void CObject::SetPositionEx(float x, float y, float z) const
     Validate();
     // Perform the requested operation
     _Func->SetObjectPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -495,6 +514,8 @@ void CObject::SetPositionX(float x) const
     _Func->GetObjectPosition(m_ID, &dummy, &y, &z);
     // Perform the requested operation
     _Func->SetObjectPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -508,6 +529,8 @@ void CObject::SetPositionY(float y) const
     _Func->GetObjectPosition(m_ID, &x, &dummy, &z);
     // Perform the requested operation
     _Func->SetObjectPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -521,6 +544,8 @@ void CObject::SetPositionZ(float z) const
     _Func->GetObjectPosition(m_ID, &x, &y, &dummy);
     // Perform the requested operation
     _Func->SetObjectPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -625,6 +650,8 @@ void CObject::MoveToX(float x) const
     _Func->GetObjectPosition(m_ID, &dummy, &y, &z);
     // Perform the requested operation
     _Func->MoveObjectTo(m_ID, x, y, z, mMoveToDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveToDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -638,6 +665,8 @@ void CObject::MoveToY(float y) const
     _Func->GetObjectPosition(m_ID, &x, &dummy, &z);
     // Perform the requested operation
     _Func->MoveObjectTo(m_ID, x, y, z, mMoveToDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveToDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -651,6 +680,8 @@ void CObject::MoveToZ(float z) const
     _Func->GetObjectPosition(m_ID, &x, &y, &dummy);
     // Perform the requested operation
     _Func->MoveObjectTo(m_ID, z, y, z, mMoveToDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveToDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -660,6 +691,8 @@ void CObject::MoveByX(float x) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectBy(m_ID, x, 0.0f, 0.0f, mMoveByDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveByDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -669,6 +702,8 @@ void CObject::MoveByY(float y) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectBy(m_ID, 0.0f, y, 0.0f, mMoveByDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveByDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -678,6 +713,8 @@ void CObject::MoveByZ(float z) const
     Validate();
     // Perform the requested operation
     _Func->MoveObjectBy(m_ID, 0.0f, 0.0f, z, mMoveByDuration);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_OBJECT, m_ID, mMoveByDuration);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -3,6 +3,8 @@
 #include "Entity/Player.hpp"
 #include "Base/Vector3.hpp"
 #include "Core.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -58,6 +60,11 @@ void CPickup::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_PICKUP).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -343,6 +350,8 @@ void CPickup::SetPosition(const Vector3 & pos) const
     Validate();
     // Perform the requested operation
     _Func->SetPickupPosition(m_ID, pos.x, pos.y, pos.z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PICKUP, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -352,6 +361,8 @@ void CPickup::SetPositionEx(float x, float y, float z) const
     Validate();
     // Perform the requested operation
     _Func->SetPickupPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PICKUP, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -422,6 +433,8 @@ void CPickup::SetPositionX(float x) const
     _Func->GetPickupPosition(m_ID, &dummy, &y, &z);
     // Perform the requested operation
     _Func->SetPickupPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PICKUP, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -435,6 +448,8 @@ void CPickup::SetPositionY(float y) const
     _Func->GetPickupPosition(m_ID, &x, &dummy, &z);
     // Perform the requested operation
     _Func->SetPickupPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PICKUP, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -448,6 +463,8 @@ void CPickup::SetPositionZ(float z) const
     _Func->GetPickupPosition(m_ID, &x, &y, &dummy);
     // Perform the requested operation
     _Func->SetPickupPosition(m_ID, z, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PICKUP, m_ID);
 }
 #ifdef VCMP_ENABLE_OFFICIAL
 // ------------------------------------------------------------------------------------------------
@@ -7,6 +7,8 @@
 #include "Library/IO/Buffer.hpp"
 #include "Core.hpp"
 #include "Core/Areas.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -82,6 +84,11 @@ void CPlayer::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_PLAYER).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -864,6 +871,8 @@ void CPlayer::SetPosition(const Vector3 & pos) const
     Validate();
     // Perform the requested operation
     _Func->SetPlayerPosition(m_ID, pos.x, pos.y, pos.z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PLAYER, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -873,6 +882,8 @@ void CPlayer::SetPositionEx(float x, float y, float z) const
     Validate();
     // Perform the requested operation
     _Func->SetPlayerPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PLAYER, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1622,6 +1633,7 @@ void CPlayer::SetCollideAreas(bool toggle) const
         inst.mFlags ^= ENF_AREA_TRACK;
         // Clear current areas
         inst.mAreas.clear();
+        inst.mAreaTracker.Reset();
     }
 }
 
@@ -1665,6 +1677,7 @@ void CPlayer::SetAreasCollide(bool toggle) const
         }
         // Clear current areas
         inst.mAreas.clear();
+        inst.mAreaTracker.Reset();
     }
 }
 
@@ -2050,6 +2063,8 @@ void CPlayer::SetPositionX(float x) const
     _Func->GetPlayerPosition(m_ID, &dummy, &y, &z);
     // Perform the requested operation
     _Func->SetPlayerPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PLAYER, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2063,6 +2078,8 @@ void CPlayer::SetPositionY(float y) const
     _Func->GetPlayerPosition(m_ID, &x, &dummy, &z);
     // Perform the requested operation
     _Func->SetPlayerPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PLAYER, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2076,6 +2093,8 @@ void CPlayer::SetPositionZ(float z) const
     _Func->GetPlayerPosition(m_ID, &x, &y, &dummy);
     // Perform the requested operation
     _Func->SetPlayerPosition(m_ID, x, y, z);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_PLAYER, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 #include "Base/Vector3.hpp"
 #include "Core.hpp"
 #include "Core/Areas.hpp"
+#include "Core/Spatial.hpp"
+#include "Core/Tags.hpp"
 #include "Core/Tasks.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -61,6 +63,11 @@ void CVehicle::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Keep the tag index up to date
+    if (VALID_ENTITY(m_ID))
+    {
+        TagIndex::Get(ENT_VEHICLE).Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -305,6 +312,8 @@ void CVehicle::Respawn() const
     Validate();
     // Perform the requested operation
     _Func->RespawnVehicle(m_ID);
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -395,6 +404,8 @@ void CVehicle::SetPosition(const Vector3 & pos) const
     Validate();
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, pos.x, pos.y, pos.z, static_cast< uint8_t >(false));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -404,6 +415,8 @@ void CVehicle::SetPositionB(const Vector3 & pos, bool empty) const
     Validate();
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, pos.x, pos.y, pos.z, static_cast< uint8_t >(empty));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -413,6 +426,8 @@ void CVehicle::SetPositionEx(float x, float y, float z) const
     Validate();
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, x, y, z, static_cast< uint8_t >(false));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -422,6 +437,8 @@ void CVehicle::SetPositionExB(float x, float y, float z, bool empty) const
     Validate();
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, x, y, z, static_cast< uint8_t >(empty));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1273,6 +1290,7 @@ void CVehicle::SetCollideAreas(bool toggle) const
         inst.mFlags ^= ENF_AREA_TRACK;
         // Clear current areas
         inst.mAreas.clear();
+        inst.mAreaTracker.Reset();
     }
 }
 
@@ -1316,6 +1334,7 @@ void CVehicle::SetAreasCollide(bool toggle) const
         }
         // Clear current areas
         inst.mAreas.clear();
+        inst.mAreaTracker.Reset();
     }
 }
 
@@ -1493,6 +1512,8 @@ void CVehicle::SetPositionX(float x) const
     _Func->GetVehiclePosition(m_ID, &dummy, &y, &z);
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, x, y, z, static_cast< uint8_t >(false));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1506,6 +1527,8 @@ void CVehicle::SetPositionY(float y) const
     _Func->GetVehiclePosition(m_ID, &x, &dummy, &z);
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, x, y, z, static_cast< uint8_t >(false));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1519,6 +1542,8 @@ void CVehicle::SetPositionZ(float z) const
     _Func->GetVehiclePosition(m_ID, &x, &y, &dummy);
     // Perform the requested operation
     _Func->SetVehiclePosition(m_ID, x, y, z, static_cast< uint8_t >(false));
+    // Track the new position of the entity
+    SpatialIndex::Get().Moved(ENT_VEHICLE, m_ID);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -32,295 +32,517 @@ struct CurlInit
     }
 };
 
-/* ------------------------------------------------------------------------------------------------
- * Common session action implementation.
-*/
-struct CpBaseAction : public ThreadPoolItem
+// ------------------------------------------------------------------------------------------------
+static void CpShareLock(CURL * /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void * user)
 {
-    // --------------------------------------------------------------------------------------------
-    CpSession *     mInstance{nullptr}; // Associated session.
-    Function        mCallback{}; // Function to call when completed.
-    LightObj        mObject{}; // Prevent the session from being destroyed.
-    cpr::Response   mResponse{};
-
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpBaseAction(CpSession * session, Function & cb, LightObj && obj)
-        : mInstance(session)
-        , mCallback(std::move(cb))
-        , mObject(std::move(obj))
-        , mResponse()
+    static_cast< CpShare * >(user)->mMtx[data].lock();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void CpShareUnlock(CURL * /*handle*/, curl_lock_data data, void * user)
+{
+    static_cast< CpShare * >(user)->mMtx[data].unlock();
+}
+
+// ------------------------------------------------------------------------------------------------
+CpShare::CpShare()
+    : mHandle(curl_share_init())
+    , mMtx()
+{
+    // Could we create the share handle?
+    if (!mHandle)
     {
+        STHROWF("Unable to create CURL share handle");
     }
+    // The engine thread and the main thread can access the cookies at the same time
+    curl_share_setopt(mHandle, CURLSHOPT_LOCKFUNC, &CpShareLock);
+    curl_share_setopt(mHandle, CURLSHOPT_UNLOCKFUNC, &CpShareUnlock);
+    curl_share_setopt(mHandle, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(mHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+}
+
+// ------------------------------------------------------------------------------------------------
+CpShare::~CpShare()
+{
+    curl_share_cleanup(mHandle);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Destructor.
-    */
-    ~CpBaseAction() override = default;
-
-    /* --------------------------------------------------------------------------------------------
-     * Invoked in main thread by the thread pool after the task was completed.
-     * If it returns true then it will be put back into the queue to be processed again.
-     * If the boolean parameter is trye then the thread-pool is in the process of shutting down.
-    */
-    SQMOD_NODISCARD bool OnCompleted(bool SQ_UNUSED_ARG(stop)) override
+// ------------------------------------------------------------------------------------------------
+static curl_slist * CpCopyList(const curl_slist * list)
+{
+    curl_slist * copy = nullptr;
+    // Append each string, in the same order
+    for (; list; list = list->next)
     {
-        // Is there a callback?
-        if (!mCallback.IsNull())
+        curl_slist * tmp = curl_slist_append(copy, list->data);
+        // Could we allocate the string?
+        if (!tmp)
         {
-            mCallback(mObject, CpResponse(std::move(mResponse))); // Invoke it
+            curl_slist_free_all(copy);
+            STHROWF("Unable to copy CURL list");
         }
-        // Unlock the session
-        mInstance->mPending = nullptr;
-        // Don't re-queue
-        return false;
+        copy = tmp;
     }
+    return copy;
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override { return false; }
-};
-
-/* ------------------------------------------------------------------------------------------------
- * Delete action implementation.
-*/
-struct CpDeleteAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+cpr::Response CpTransfer::Complete()
 {
+    curl_slist * raw = nullptr;
+    // Collect the cookies while the handle can still see the jar of the session
+    curl_easy_getinfo(mHandle, CURLINFO_COOKIELIST, &raw);
+    cpr::Cookies cookies = cpr::util::parseCookies(raw);
+    curl_slist_free_all(raw);
+    // The response can outlive the session, and the jar along with it
+    curl_easy_setopt(mHandle, CURLOPT_SHARE, nullptr);
+    // Build the response from what we received
+    return cpr::Response(mHolder, std::move(mText), std::move(mHeader), std::move(cookies),
+                            cpr::Error(mCode, std::string(mHolder->error.data())));
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpDeleteAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
-    {
-    }
+// ------------------------------------------------------------------------------------------------
+CpMulti::CpMulti()
+    : mMulti(nullptr)
+    , mThread()
+    , mRun(false)
+    , mMtx()
+    , mIncoming()
+    , mActive()
+    , mFinished(1024)
+    , mHostLimit(DEFAULT_HOST_LIMIT)
+    , mTotalLimit(0)
+    , mCacheSize(DEFAULT_CACHE_SIZE)
+    , mMultiplex(true)
+    , mTimeout(0)
+    , mDirty(true)
+    , mActiveCount(0)
+    , mTimedOut(0)
+    , mCompleted(0)
+{
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
+// ------------------------------------------------------------------------------------------------
+CpMulti::~CpMulti()
+{
+    // The thread cannot outlive the instance
+    if (mThread.joinable())
     {
-        mResponse = mInstance->Delete();
-        return false; // We do this once
+        mRun = false;
+        Wake();
+        mThread.join();
     }
-};
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoDelete_(Function & cb)
+CpMulti & CpMulti::Get()
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpDeleteAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    static CpMulti m;
+    return m;
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Get action implementation.
-*/
-struct CpGetAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Start()
 {
-
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpGetAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
+    mMulti = curl_multi_init();
+    // Could we create the multi handle?
+    if (!mMulti)
     {
+        STHROWF("Unable to create CURL multi handle");
     }
+    // The settings must be applied to the new handle
+    mDirty = true;
+    mRun = true;
+    // Start the engine thread
+    mThread = std::thread(&CpMulti::Proc, this);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Wake()
+{
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+    if (mMulti)
     {
-        mResponse = mInstance->Get();
-        return false; // We do this once
+        curl_multi_wakeup(mMulti);
     }
-};
+#endif
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoGet_(Function & cb)
+void CpMulti::Submit(Transfer && t)
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpGetAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    // Start the engine with the first transfer
+    if (!mMulti)
+    {
+        Start();
+    }
+    ++mActiveCount;
+    // Give the transfer to the engine thread
+    {
+        std::lock_guard< std::mutex > lock(mMtx);
+        mIncoming.push_back(std::move(t));
+    }
+    Wake();
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Head action implementation.
-*/
-struct CpHeadAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Stop()
 {
-
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpHeadAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
+    // Is the engine even running?
+    if (!mMulti)
+    {
+        return;
+    }
+    mRun = false;
+    Wake();
+    // Wait for the engine thread to finish
+    if (mThread.joinable())
     {
+        mThread.join();
     }
+    // Abort whatever is still running or waiting to be started
+    for (Transfer & t : mActive)
+    {
+        curl_multi_remove_handle(mMulti, t->mHandle);
+        t->mCode = CURLE_ABORTED_BY_CALLBACK;
+        mFinished.enqueue(std::move(t));
+    }
+    mActive.clear();
+    for (Transfer & t : mIncoming)
+    {
+        t->mCode = CURLE_ABORTED_BY_CALLBACK;
+        mFinished.enqueue(std::move(t));
+    }
+    mIncoming.clear();
+    // Release the multi handle and the connections it kept alive
+    curl_multi_cleanup(mMulti);
+    mMulti = nullptr;
+    // Complete every transfer while the VM still exists
+    FrameSlice slice;
+    Process(slice);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
+// ------------------------------------------------------------------------------------------------
+size_t CpMulti::Process(FrameSlice & slice)
+{
+    // Process only what's currently in the queue
+    const size_t count = mFinished.size_approx();
+    // Complete each transfer individually, as long as the slice allows it
+    for (size_t n = 0; n < count && slice.Allow(); ++n)
     {
-        mResponse = mInstance->Head();
-        return false; // We do this once
+        Transfer t;
+        // Try to get a transfer from the queue
+        if (!mFinished.try_dequeue(t))
+        {
+            break;
+        }
+        slice.Count();
+        --mActiveCount;
+        ++mCompleted;
+        // This request is no longer in progress
+        --(t->mSession->mPending);
+        try
+        {
+            // Collect the response from the easy handle
+            CpResponse r(t->Complete());
+            // Is there a callback?
+            if (!t->mCallback.IsNull())
+            {
+                t->mCallback(t->mObject, r); // Invoke it
+            }
+        }
+        catch (const Sqrat::Exception & e)
+        {
+            LogErr("Squirrel error caught in HTTP transfer callback [%s]", e.what());
+        }
+        catch (const std::exception & e)
+        {
+            LogErr("Program error caught in HTTP transfer callback [%s]", e.what());
+        }
     }
-};
+    // Whatever is left is carried over
+    return mFinished.size_approx();
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoHead_(Function & cb)
+void CpMulti::SetHostLimit(long n)
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpHeadAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    mHostLimit = std::max(n, 0L);
+    mDirty = true;
+    Wake();
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Options action implementation.
-*/
-struct CpOptionsAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+void CpMulti::SetTotalLimit(long n)
 {
+    mTotalLimit = std::max(n, 0L);
+    mDirty = true;
+    Wake();
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpOptionsAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
-    {
-    }
+// ------------------------------------------------------------------------------------------------
+void CpMulti::SetCacheSize(long n)
+{
+    mCacheSize = std::max(n, 0L);
+    mDirty = true;
+    Wake();
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
-    {
-        mResponse = mInstance->Options();
-        return false; // We do this once
-    }
-};
+// ------------------------------------------------------------------------------------------------
+void CpMulti::SetMultiplex(bool toggle)
+{
+    mMultiplex = toggle;
+    mDirty = true;
+    Wake();
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoOptions_(Function & cb)
+void CpMulti::SetTimeout(int64_t ms)
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpOptionsAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    mTimeout = std::max< int64_t >(ms, 0) * 1000;
+    Wake();
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Patch action implementation.
-*/
-struct CpPatchAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Apply()
 {
+    curl_multi_setopt(mMulti, CURLMOPT_MAX_HOST_CONNECTIONS, mHostLimit.load());
+    curl_multi_setopt(mMulti, CURLMOPT_MAX_TOTAL_CONNECTIONS, mTotalLimit.load());
+    curl_multi_setopt(mMulti, CURLMOPT_MAXCONNECTS, mCacheSize.load());
+    curl_multi_setopt(mMulti, CURLMOPT_PIPELINING, mMultiplex.load() ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpPatchAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Finish(CpTransfer * t, CURLcode code)
+{
+    curl_multi_remove_handle(mMulti, t->mHandle);
+    t->mCode = code;
+    // Take the transfer out of the active list by moving the last one in its place
+    const size_t idx = t->mIndex;
+    Transfer tmp = std::move(mActive[idx]);
+    if (idx != mActive.size() - 1)
     {
+        mActive[idx] = std::move(mActive.back());
+        mActive[idx]->mIndex = idx;
     }
+    mActive.pop_back();
+    // Hand it to the main thread
+    mFinished.enqueue(std::move(tmp));
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
+// ------------------------------------------------------------------------------------------------
+void CpMulti::Expire(int64_t now)
+{
+    const int64_t timeout = mTimeout.load();
+    // Walk backwards because finished transfers are replaced by the last one
+    for (size_t i = mActive.size(); i > 0; --i)
     {
-        mResponse = mInstance->Patch();
-        return false; // We do this once
+        CpTransfer * t = mActive[i - 1].get();
+        // Did this transfer take too long?
+        if ((now - t->mStarted) >= timeout)
+        {
+            Finish(t, CURLE_OPERATION_TIMEDOUT);
+            ++mTimedOut;
+        }
     }
-};
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoPatch_(Function & cb)
+void CpMulti::Proc()
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpPatchAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    std::vector< Transfer > incoming;
+    int64_t last_expire = 0;
+    // Keep driving the transfers until we're told to stop
+    while (mRun)
+    {
+        // Were the settings changed?
+        if (mDirty.exchange(false))
+        {
+            Apply();
+        }
+        // Take the transfers that were submitted
+        {
+            std::lock_guard< std::mutex > lock(mMtx);
+            incoming.swap(mIncoming);
+        }
+        const int64_t now = FrameSlice::Now();
+        // Start the submitted transfers
+        for (Transfer & t : incoming)
+        {
+            CpTransfer * p = t.get();
+            // Let the transfer find itself and wait for a connection it can share
+            curl_easy_setopt(p->mHandle, CURLOPT_PRIVATE, p);
+            curl_easy_setopt(p->mHandle, CURLOPT_PIPEWAIT, mMultiplex.load() ? 1L : 0L);
+            p->mStarted = now;
+            p->mIndex = mActive.size();
+            mActive.push_back(std::move(t));
+            // Could the transfer be started?
+            if (curl_multi_add_handle(mMulti, p->mHandle) != CURLM_OK)
+            {
+                Finish(p, CURLE_FAILED_INIT);
+            }
+        }
+        incoming.clear();
+        int running = 0;
+        // Perform whatever can be done without waiting
+        curl_multi_perform(mMulti, &running);
+        int left = 0;
+        // Collect the finished transfers
+        for (CURLMsg * msg = curl_multi_info_read(mMulti, &left); msg; msg = curl_multi_info_read(mMulti, &left))
+        {
+            if (msg->msg == CURLMSG_DONE)
+            {
+                CpTransfer * t = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+                // Is this one of ours?
+                if (t)
+                {
+                    Finish(t, msg->data.result);
+                }
+            }
+        }
+        int wait = MAX_WAIT;
+        // Abandon the transfers that took too long
+        if (mTimeout.load() > 0 && !mActive.empty())
+        {
+            if ((now - last_expire) >= (EXPIRE_WAIT * 1000))
+            {
+                Expire(now);
+                last_expire = now;
+            }
+            wait = EXPIRE_WAIT;
+        }
+        // Wait for activity or until we're woken up
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+        curl_multi_poll(mMulti, nullptr, 0, wait, nullptr);
+#else
+        curl_multi_wait(mMulti, nullptr, 0, std::min(wait, EXPIRE_WAIT), nullptr);
+#endif
+    }
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Post action implementation.
-*/
-struct CpPostAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+size_t ProcessCURL(FrameSlice & slice)
 {
+    return CpMulti::Get().Process(slice);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpPostAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
-    {
-    }
+// ------------------------------------------------------------------------------------------------
+void TerminateCURL()
+{
+    CpMulti::Get().Stop();
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
+// ------------------------------------------------------------------------------------------------
+void CpSession::Submit(Function & cb)
+{
+    cpr::CurlHolder & src = *cpr::Session::GetCurlHolder();
+    CpMulti::Transfer t{new CpTransfer()};
+    // Perform the request on a copy of the prepared handle so the session can prepare more of them
+    t->mHolder = std::make_shared< cpr::CurlHolder >();
+    curl_easy_cleanup(t->mHolder->handle);
+    t->mHolder->handle = curl_easy_duphandle(src.handle);
+    // Let cpr reset the state it keeps between requests
+    static_cast< void >(cpr::Session::Complete(CURLE_OK));
+    // Could we copy the handle?
+    if (!t->mHolder->handle)
     {
-        mResponse = mInstance->Post();
-        return false; // We do this once
+        STHROWF("Unable to duplicate CURL handle");
     }
-};
+    CURL * h = t->mHolder->handle;
+    // The copy refers to the lists of the session, which are replaced by the next request
+    t->mHolder->chunk = CpCopyList(src.chunk);
+    t->mHolder->resolveCurlList = CpCopyList(src.resolveCurlList);
+    curl_easy_setopt(h, CURLOPT_HTTPHEADER, t->mHolder->chunk);
+    curl_easy_setopt(h, CURLOPT_RESOLVE, t->mHolder->resolveCurlList);
+    // Receive into the transfer instead of the session
+    curl_easy_setopt(h, CURLOPT_ERRORBUFFER, t->mHolder->error.data());
+    curl_easy_setopt(h, CURLOPT_WRITEFUNCTION, cpr::util::writeFunction);
+    curl_easy_setopt(h, CURLOPT_WRITEDATA, &t->mText);
+    curl_easy_setopt(h, CURLOPT_HEADERFUNCTION, cpr::util::writeFunction);
+    curl_easy_setopt(h, CURLOPT_HEADERDATA, &t->mHeader);
+    // Send and keep the cookies of the session
+    curl_easy_setopt(h, CURLOPT_SHARE, mShare->mHandle);
+    // Populate transfer information
+    t->mSession = this;
+    t->mHandle = h;
+    t->mCallback = std::move(cb);
+    t->mObject = LightObj(1, SqVM()); // Prevent the session from being destroyed
+    // Count the request as in progress
+    ++mPending;
+    // Give the transfer to the engine
+    try {
+        CpMulti::Get().Submit(std::move(t));
+    } catch (...) {
+        --mPending;
+        throw;
+    }
+}
 
 // ------------------------------------------------------------------------------------------------
-void CpSession::DoPost_(Function & cb)
+void CpSession::DoDelete_(Function & cb)
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpPostAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    cpr::Session::PrepareDelete();
+    Submit(cb);
 }
 
-/* ------------------------------------------------------------------------------------------------
- * Put action implementation.
-*/
-struct CpPutAction : public CpBaseAction
+// ------------------------------------------------------------------------------------------------
+void CpSession::DoGet_(Function & cb)
 {
+    cpr::Session::PrepareGet();
+    Submit(cb);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Base constructor.
-    */
-    CpPutAction(CpSession * session, Function & cb, LightObj && obj)
-        : CpBaseAction(session, cb, std::move(obj))
-    {
-    }
+// ------------------------------------------------------------------------------------------------
+void CpSession::DoHead_(Function & cb)
+{
+    cpr::Session::PrepareHead();
+    Submit(cb);
+}
 
-    /* --------------------------------------------------------------------------------------------
-     * Task process callback.
-    */
-    SQMOD_NODISCARD bool OnProcess() override
-    {
-        mResponse = mInstance->Put();
-        return false; // We do this once
-    }
-};
+// ------------------------------------------------------------------------------------------------
+void CpSession::DoOptions_(Function & cb)
+{
+    cpr::Session::PrepareOptions();
+    Submit(cb);
+}
+
+// ------------------------------------------------------------------------------------------------
+void CpSession::DoPatch_(Function & cb)
+{
+    cpr::Session::PreparePatch();
+    Submit(cb);
+}
+
+// ------------------------------------------------------------------------------------------------
+void CpSession::DoPost_(Function & cb)
+{
+    cpr::Session::PreparePost();
+    Submit(cb);
+}
 
 // ------------------------------------------------------------------------------------------------
 void CpSession::DoPut_(Function & cb)
 {
-    LockCheck();
-    // Create the task and lock session
-    mPending = new CpPutAction(this, cb, LightObj(1, SqVM()));
-    // Queue the task to be processed
-    ThreadPool::Get().Enqueue(mPending);
+    cpr::Session::PreparePut();
+    Submit(cb);
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqCpGetHostLimit() { return CpMulti::Get().GetHostLimit(); }
+static void SqCpSetHostLimit(SQInteger n) { CpMulti::Get().SetHostLimit(static_cast< long >(n)); }
+static SQInteger SqCpGetTotalLimit() { return CpMulti::Get().GetTotalLimit(); }
+static void SqCpSetTotalLimit(SQInteger n) { CpMulti::Get().SetTotalLimit(static_cast< long >(n)); }
+static SQInteger SqCpGetCacheSize() { return CpMulti::Get().GetCacheSize(); }
+static void SqCpSetCacheSize(SQInteger n) { CpMulti::Get().SetCacheSize(static_cast< long >(n)); }
+static bool SqCpGetMultiplex() { return CpMulti::Get().GetMultiplex(); }
+static void SqCpSetMultiplex(bool toggle) { CpMulti::Get().SetMultiplex(toggle); }
+static SQInteger SqCpGetTimeout() { return CpMulti::Get().GetTimeout(); }
+static void SqCpSetTimeout(SQInteger ms) { CpMulti::Get().SetTimeout(ms); }
+static SQInteger SqCpGetActive() { return static_cast< SQInteger >(CpMulti::Get().GetActive()); }
+static SQInteger SqCpGetCompleted() { return static_cast< SQInteger >(CpMulti::Get().GetCompleted()); }
+static SQInteger SqCpGetTimedOut() { return static_cast< SQInteger >(CpMulti::Get().GetTimedOut()); }
+
 // ------------------------------------------------------------------------------------------------
 static const EnumElement g_ErrorCodes[] = {
     {_SC("OK"),                             SQInteger(cpr::ErrorCode::OK)},
@@ -663,6 +885,7 @@ void Register_CURL(HSQUIRRELVM vm)
         .SquirrelFunc(_SC("_typename"), &SqCpSession::Fn)
         // Member Properties
         .Prop(_SC("Locked"), &CpSession::IsLocked)
+        .Prop(_SC("Pending"), &CpSession::GetPending)
         // Member Methods
         .FmtFunc(_SC("SetURL"), &CpSession::SetURL_)
         .Func(_SC("SetParameters"), &CpSession::SetParameters_)
@@ -703,6 +926,25 @@ void Register_CURL(HSQUIRRELVM vm)
         .Func(_SC("AsyncPut"), &CpSession::DoPut_)
     );
 
+    {
+        Table mns(vm);
+        // Settings of the transfer engine shared by asynchronous requests
+        mns.Func(_SC("GetHostLimit"), &SqCpGetHostLimit);
+        mns.Func(_SC("SetHostLimit"), &SqCpSetHostLimit);
+        mns.Func(_SC("GetTotalLimit"), &SqCpGetTotalLimit);
+        mns.Func(_SC("SetTotalLimit"), &SqCpSetTotalLimit);
+        mns.Func(_SC("GetCacheSize"), &SqCpGetCacheSize);
+        mns.Func(_SC("SetCacheSize"), &SqCpSetCacheSize);
+        mns.Func(_SC("GetMultiplex"), &SqCpGetMultiplex);
+        mns.Func(_SC("SetMultiplex"), &SqCpSetMultiplex);
+        mns.Func(_SC("GetTimeout"), &SqCpGetTimeout);
+        mns.Func(_SC("SetTimeout"), &SqCpSetTimeout);
+        mns.Func(_SC("Active"), &SqCpGetActive);
+        mns.Func(_SC("Completed"), &SqCpGetCompleted);
+        mns.Func(_SC("TimedOut"), &SqCpGetTimedOut);
+        cpns.Bind(_SC("Multi"), mns);
+    }
+
     RootTable(vm).Bind(_SC("SqCPR"), cpns);
 
     // --------------------------------------------------------------------------------------------
@@ -8,6 +8,11 @@
 #include <cpr/cpr.h>
 
 // ------------------------------------------------------------------------------------------------
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
@@ -1764,24 +1769,232 @@ struct CpRedirect : public cpr::Redirect
     }
 };
 
+// ------------------------------------------------------------------------------------------------
+struct CpSession;
+
+/* ------------------------------------------------------------------------------------------------
+ * Cookie jar of a session that is shared with the copies of its handle that perform its requests.
+*/
+struct CpShare
+{
+    // --------------------------------------------------------------------------------------------
+    CURLSH *        mHandle; // The share handle.
+    std::mutex      mMtx[CURL_LOCK_DATA_LAST]; // Protects each kind of shared data.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    CpShare();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor (disabled).
+    */
+    CpShare(const CpShare &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~CpShare();
+
+    /* --------------------------------------------------------------------------------------------
+     * Assignment operator (disabled).
+    */
+    CpShare & operator = (const CpShare &) = delete;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Asynchronous request of a session that is performed by the transfer engine.
+*/
+struct CpTransfer
+{
+    // --------------------------------------------------------------------------------------------
+    CpSession *     mSession{nullptr}; // Associated session.
+    CURL *          mHandle{nullptr}; // Copy of the session handle that performs the request.
+    Function        mCallback{}; // Function to call when completed.
+    LightObj        mObject{}; // Prevent the session from being destroyed.
+    // --------------------------------------------------------------------------------------------
+    std::shared_ptr< cpr::CurlHolder > mHolder{}; // Owns the easy handle. Released before the session.
+    std::string     mText{}; // Received body.
+    std::string     mHeader{}; // Received header.
+    // --------------------------------------------------------------------------------------------
+    CURLcode        mCode{CURLE_OK}; // Outcome of the transfer.
+    int64_t         mStarted{0}; // Time-point when the transfer was started. (microseconds)
+    size_t          mIndex{0}; // Position in the list of active transfers.
+
+    /* --------------------------------------------------------------------------------------------
+     * Build the response from what the transfer received. Main thread only.
+    */
+    SQMOD_NODISCARD cpr::Response Complete();
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Single thread that drives every asynchronous session request through a libcurl multi handle.
+ * Connections are cached by the multi handle so, they are kept alive and reused across sessions.
+ * Finished transfers are handed back to the main thread where the callbacks are invoked.
+*/
+struct CpMulti
+{
+    // --------------------------------------------------------------------------------------------
+    typedef std::unique_ptr< CpTransfer > Transfer; // Owning pointer of a transfer.
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr long DEFAULT_HOST_LIMIT = 8; // Default number of connections to a single host.
+    static constexpr long DEFAULT_CACHE_SIZE = 64; // Default number of idle connections kept alive.
+    static constexpr int MAX_WAIT = 1000; // Longest time the engine waits for activity. (milliseconds)
+    static constexpr int EXPIRE_WAIT = 100; // Longest wait while transfers can expire. (milliseconds)
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the engine instance.
+    */
+    SQMOD_NODISCARD static CpMulti & Get();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor (disabled).
+    */
+    CpMulti(const CpMulti &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~CpMulti();
+
+    /* --------------------------------------------------------------------------------------------
+     * Assignment operator (disabled).
+    */
+    CpMulti & operator = (const CpMulti &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Give a prepared transfer to the engine. Starts the engine thread if necessary.
+    */
+    void Submit(Transfer && t);
+
+    /* --------------------------------------------------------------------------------------------
+     * Complete the finished transfers within the given slice. Main thread only.
+    */
+    size_t Process(FrameSlice & slice);
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop the engine thread and complete every transfer as aborted. Main thread only.
+    */
+    void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of connections to a single host. Zero means unlimited.
+    */
+    void SetHostLimit(long n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of connections. Zero means unlimited.
+    */
+    void SetTotalLimit(long n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of idle connections kept alive.
+    */
+    void SetCacheSize(long n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether transfers to the same host share a connection over HTTP/2.
+    */
+    void SetMultiplex(bool toggle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the time after which a transfer is abandoned. (milliseconds) Zero means never.
+    */
+    void SetTimeout(int64_t ms);
+
+    // --------------------------------------------------------------------------------------------
+    SQMOD_NODISCARD long GetHostLimit() const noexcept { return mHostLimit.load(); }
+    SQMOD_NODISCARD long GetTotalLimit() const noexcept { return mTotalLimit.load(); }
+    SQMOD_NODISCARD long GetCacheSize() const noexcept { return mCacheSize.load(); }
+    SQMOD_NODISCARD bool GetMultiplex() const noexcept { return mMultiplex.load(); }
+    SQMOD_NODISCARD int64_t GetTimeout() const noexcept { return mTimeout.load() / 1000; }
+    SQMOD_NODISCARD size_t GetActive() const noexcept { return mActiveCount.load(); }
+    SQMOD_NODISCARD uint64_t GetCompleted() const noexcept { return mCompleted; }
+    SQMOD_NODISCARD uint64_t GetTimedOut() const noexcept { return mTimedOut.load(); }
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    CpMulti();
+
+    /* --------------------------------------------------------------------------------------------
+     * Create the multi handle and start the engine thread. Main thread only.
+    */
+    void Start();
+
+    /* --------------------------------------------------------------------------------------------
+     * Interrupt the engine thread if it is waiting for activity.
+    */
+    void Wake();
+
+    /* --------------------------------------------------------------------------------------------
+     * Engine thread.
+    */
+    void Proc();
+
+    /* --------------------------------------------------------------------------------------------
+     * Apply the settings to the multi handle. Engine thread only.
+    */
+    void Apply();
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a transfer from the multi handle and hand it to the main thread. Engine thread only.
+    */
+    void Finish(CpTransfer * t, CURLcode code);
+
+    /* --------------------------------------------------------------------------------------------
+     * Abandon the transfers that took longer than allowed. Engine thread only.
+    */
+    void Expire(int64_t now);
+
+    // --------------------------------------------------------------------------------------------
+    CURLM *                                     mMulti; // The multi handle.
+    std::thread                                 mThread; // The engine thread.
+    std::atomic< bool >                         mRun; // Whether the engine thread should keep running.
+    std::mutex                                  mMtx; // Protects the submitted transfers.
+    std::vector< Transfer >                     mIncoming; // Transfers waiting to be started.
+    std::vector< Transfer >                     mActive; // Running transfers. Engine thread only.
+    moodycamel::ConcurrentQueue< Transfer >     mFinished; // Transfers waiting to be completed.
+    // --------------------------------------------------------------------------------------------
+    std::atomic< long >                         mHostLimit; // Maximum connections to a single host.
+    std::atomic< long >                         mTotalLimit; // Maximum connections.
+    std::atomic< long >                         mCacheSize; // Maximum idle connections kept alive.
+    std::atomic< bool >                         mMultiplex; // Whether HTTP/2 multiplexing is allowed.
+    std::atomic< int64_t >                      mTimeout; // Time after which a transfer is abandoned. (microseconds)
+    std::atomic< bool >                         mDirty; // Whether the settings must be applied again.
+    // --------------------------------------------------------------------------------------------
+    std::atomic< size_t >                       mActiveCount; // Transfers submitted and not yet completed.
+    std::atomic< uint64_t >                     mTimedOut; // Transfers that were abandoned.
+    uint64_t                                    mCompleted; // Transfers that were completed. Main thread only.
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Wrapper for cpr::Session that can be bound to the script engine.
 */
 struct CpSession : public cpr::Session
 {
-    // Pointer to the pending action associated with this session, if any.
-    ThreadPoolItem * mPending{nullptr};
+    // Cookie jar shared with the requests in progress.
+    std::unique_ptr< CpShare > mShare{};
+    // Number of requests of this session that are in progress.
+    size_t mPending{0};
 
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
     */
-    CpSession() = default;
+    CpSession()
+        : cpr::Session(), mShare(new CpShare())
+    {
+        curl_easy_setopt(cpr::Session::GetCurlHolder()->handle, CURLOPT_SHARE, mShare->mHandle);
+    }
 
     /* --------------------------------------------------------------------------------------------
      * URL constructor.
     */
     explicit CpSession(StackStrF & url)
-        : cpr::Session()
+        : CpSession()
     {
         cpr::Session::SetUrl(cpr::Url(url.mPtr, url.GetSize()));
     }
@@ -1799,7 +2012,14 @@ struct CpSession : public cpr::Session
     /* --------------------------------------------------------------------------------------------
      * Destructor.
     */
-    virtual ~CpSession() = default;
+    virtual ~CpSession()
+    {
+        // The cookie jar cannot be released while the handle still uses it
+        if (mShare)
+        {
+            curl_easy_setopt(cpr::Session::GetCurlHolder()->handle, CURLOPT_SHARE, nullptr);
+        }
+    }
 
     /* --------------------------------------------------------------------------------------------
      * Copy assignment operator (disabled).
@@ -1812,22 +2032,19 @@ struct CpSession : public cpr::Session
     CpSession & operator = (CpSession &&) noexcept = default;
 
     /* --------------------------------------------------------------------------------------------
-     * Throw exception if the session is locked.
+     * Check if the session has requests in progress.
     */
-    void LockCheck() const
+    SQMOD_NODISCARD bool IsLocked() const
     {
-        if (mPending)
-        {
-            STHROWF("Session is currently locked by pending action.");
-        }
+        return mPending != 0;
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Check if the session is locked.
+     * Retrieve the number of requests of this session that are in progress.
     */
-    SQMOD_NODISCARD bool IsLocked() const
+    SQMOD_NODISCARD SQInteger GetPending() const
     {
-        return mPending != nullptr;
+        return static_cast< SQInteger >(mPending);
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -1835,7 +2052,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetURL_(StackStrF & url)
     {
-        LockCheck();
         cpr::Session::SetUrl(cpr::Url(url.mPtr, url.GetSize()));
         return *this; // Allow chaining
     }
@@ -1845,7 +2061,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetParameters_(const CpParameters & parameters)
     {
-        LockCheck();
         cpr::Session::SetParameters(parameters);
         return *this; // Allow chaining
     }
@@ -1855,7 +2070,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & YieldParameters(CpParameters & parameters)
     {
-        LockCheck();
         cpr::Session::SetParameters(std::move(static_cast< cpr::Parameters & >(parameters)));
         return *this; // Allow chaining
     }
@@ -1865,7 +2079,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetHeader_(const CpHeader & header)
     {
-        LockCheck();
         cpr::Session::SetHeader(header.mMap);
         return *this; // Allow chaining
     }
@@ -1875,7 +2088,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetTimeout_(SQInteger ms)
     {
-        LockCheck();
         cpr::Session::SetTimeout(cpr::Timeout(std::chrono::milliseconds{ms}));
         return *this; // Allow chaining
     }
@@ -1885,7 +2097,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetConnectTimeout_(SQInteger ms)
     {
-        LockCheck();
         cpr::Session::SetConnectTimeout(cpr::ConnectTimeout(std::chrono::milliseconds{ms}));
         return *this; // Allow chaining
     }
@@ -1895,7 +2106,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetAuth_(StackStrF & username, StackStrF & password, SQInteger mode)
     {
-        LockCheck();
         cpr::Session::SetAuth(cpr::Authentication(username.ToStr(), password.ToStr(), static_cast<cpr::AuthMode>(mode)));
         return *this; // Allow chaining
     }
@@ -1905,7 +2115,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetUserAgent_(StackStrF & agent)
     {
-        LockCheck();
         cpr::Session::SetUserAgent(cpr::UserAgent(agent.mPtr, agent.GetSize()));
         return *this; // Allow chaining
     }
@@ -1915,7 +2124,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetPayload_(const CpPayload & payload)
     {
-        LockCheck();
         cpr::Session::SetPayload(payload);
         return *this; // Allow chaining
     }
@@ -1925,7 +2133,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & YieldPayload(CpPayload & payload)
     {
-        LockCheck();
         cpr::Session::SetPayload(std::move(static_cast< cpr::Payload & >(payload)));
         return *this; // Allow chaining
     }
@@ -1935,7 +2142,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetProxies_(const CpProxies & proxies)
     {
-        LockCheck();
         cpr::Session::SetProxies(proxies);
         return *this; // Allow chaining
     }
@@ -1945,7 +2151,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & YieldProxies(CpProxies & proxies)
     {
-        LockCheck();
         cpr::Session::SetProxies(std::move(static_cast< cpr::Proxies & >(proxies)));
         return *this; // Allow chaining
     }
@@ -1969,7 +2174,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetRedirect_(CpRedirect & redirect)
     {
-        LockCheck();
         cpr::Session::SetRedirect(redirect);
         return *this; // Allow chaining
     }
@@ -1979,7 +2183,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetCookies_(const CpCookies & cookies)
     {
-        LockCheck();
         cpr::Session::SetCookies(cookies);
         return *this; // Allow chaining
     }
@@ -1989,7 +2192,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetBody_(StackStrF & body)
     {
-        LockCheck();
         cpr::Session::SetBody(cpr::Body(body.mPtr, body.GetSize()));
         return *this; // Allow chaining
     }
@@ -1999,7 +2201,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetLowSpeed_(SQInteger limit, SQInteger time)
     {
-        LockCheck();
         cpr::Session::SetLowSpeed(cpr::LowSpeed(static_cast< int32_t >(limit), static_cast< int32_t >(time)));
         return *this; // Allow chaining
     }
@@ -2009,7 +2210,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetVerifySsl_(bool verify)
     {
-        LockCheck();
         cpr::Session::SetVerifySsl(cpr::VerifySsl(verify));
         return *this; // Allow chaining
     }
@@ -2019,7 +2219,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetUnixSocket_(StackStrF & socket)
     {
-        LockCheck();
         cpr::Session::SetUnixSocket(cpr::UnixSocket(socket.ToStr()));
         return *this; // Allow chaining
     }
@@ -2029,7 +2228,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetSslOptions_(const CpSslOptions & options)
     {
-        LockCheck();
         cpr::Session::SetSslOptions(options);
         return *this; // Allow chaining
     }
@@ -2074,7 +2272,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetVerbose_(bool verbose)
     {
-        LockCheck();
         cpr::Session::SetVerbose(cpr::Verbose(verbose));
         return *this; // Allow chaining
     }
@@ -2084,7 +2281,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetUserAgent(StackStrF & agent)
     {
-        LockCheck();
         if (cpr::Session::GetCurlHolder()->handle)
         {
             curl_easy_setopt(cpr::Session::GetCurlHolder()->handle, CURLOPT_USERAGENT, agent.mPtr);
@@ -2097,7 +2293,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetCookieFile(StackStrF & filename)
     {
-        LockCheck();
         if (cpr::Session::GetCurlHolder()->handle)
         {
             curl_easy_setopt(cpr::Session::GetCurlHolder()->handle, CURLOPT_COOKIEFILE, filename.mPtr);
@@ -2110,7 +2305,6 @@ struct CpSession : public cpr::Session
     */
     CpSession & SetCookieJar(StackStrF & filename)
     {
-        LockCheck();
         if (cpr::Session::GetCurlHolder()->handle)
         {
             curl_easy_setopt(cpr::Session::GetCurlHolder()->handle, CURLOPT_COOKIEJAR, filename.mPtr);
@@ -2123,7 +2317,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoDelete()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Delete());
     }
 
@@ -2132,7 +2325,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoGet()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Get());
     }
 
@@ -2141,7 +2333,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoHead()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Head());
     }
 
@@ -2150,7 +2341,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoOptions()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Options());
     }
 
@@ -2159,7 +2349,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoPatch()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Patch());
     }
 
@@ -2168,7 +2357,6 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoPost()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Post());
     }
 
@@ -2177,13 +2365,17 @@ struct CpSession : public cpr::Session
     */
     CpResponse DoPut()
     {
-        LockCheck();
         return CpResponse(cpr::Session::Put());
     }
 
     //CpResponse Download(const WriteCallback& write);
     //CpResponse Download(std::ofstream& file);
 
+    /* --------------------------------------------------------------------------------------------
+     * Hand a copy of the prepared request to the transfer engine. The session remains usable.
+    */
+    void Submit(Function & cb);
+
     /* --------------------------------------------------------------------------------------------
      * Delete async request.
     */
@@ -16,13 +16,13 @@ void TerminateDiscord()
 }
 
 // ------------------------------------------------------------------------------------------------
-void ProcessDiscord()
+size_t ProcessDiscord(FrameSlice & slice)
 {
+    static size_t s_Cursor = 0;
     // Go over all clusters and allow them to process data
-    for (DpCluster * inst = DpCluster::sHead; inst && inst->mNext != DpCluster::sHead; inst = inst->mNext)
-    {
-        inst->Process();
-    }
+    return ProcessChain< DpCluster >(s_Cursor, slice, [&slice](DpCluster & inst) -> size_t {
+        return inst.Process(slice);
+    });
 }
 
 // ------------------------------------------------------------------------------------------------
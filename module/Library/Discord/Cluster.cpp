@@ -46,20 +46,21 @@ SQMOD_NODISCARD LightObj EventToScriptObject(uint8_t type, uintptr_t data);
 void EventInvokeCleanup(uint8_t type, uintptr_t data);
 
 // ------------------------------------------------------------------------------------------------
-void DpCluster::Process(bool force)
+size_t DpCluster::Process(FrameSlice & slice, bool force)
 {
     // Is there a valid connection?
     if (!mC && !force)
     {
-        return; // No point in going forward
+        return 0; // No point in going forward
     }
     EventItem event;
-    // Retrieve each event individually and process it
-    for (size_t count = mQueue.size_approx(), n = 0; n <= count; ++n)
+    // Retrieve each event individually and process it, as long as the slice allows it
+    for (size_t count = mQueue.size_approx(), n = 0; n <= count && slice.Allow(); ++n)
     {
         // Try to get an event from the queue
         if (mQueue.try_dequeue(event))
         {
+            slice.Count();
             // Fetch the type of event
             const auto id = static_cast< size_t >(event->GetEventID());
             // Is this a valid event and is anyone listening to it?
@@ -85,12 +86,13 @@ void DpCluster::Process(bool force)
         }
     }
     CCResultItem cc_item;
-    // Retrieve each command completion result individually and process it
-    for (size_t count = mCCResults->size_approx(), n = 0; n <= count; ++n)
+    // Retrieve each command completion result individually and process it, as long as the slice allows it
+    for (size_t count = mCCResults->size_approx(), n = 0; n <= count && slice.Allow(); ++n)
     {
         // Try to get a result from the queue
         if (mCCResults->try_dequeue(cc_item))
         {
+            slice.Count();
             CCResult & r = *cc_item;
             // Get the script callback
             Function & cb = *(r.first);
@@ -109,6 +111,8 @@ void DpCluster::Process(bool force)
             mCCList.erase(r.first);
         }
     }
+    // Whatever is left is carried over
+    return mQueue.size_approx() + mCCResults->size_approx();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
 #include "Core/Signal.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include "Library/Discord/Constants.hpp"
@@ -180,9 +181,10 @@ struct DpCluster : public SqChainedInstances< DpCluster >
     dpp::cluster & Valid(const char * m) const { Validate(m); return *mC; }
 
     /* --------------------------------------------------------------------------------------------
-     * Process the cluster. This is used internally on each server frame.
+     * Process the cluster within the given slice. This is used internally on each server frame.
+     * Returns how many events and command results are left.
     */
-    void Process(bool force = false);
+    size_t Process(FrameSlice & slice, bool force = false);
 
     /* --------------------------------------------------------------------------------------------
      * Terminate the cluster. This is used internally when the VM is shutting down.
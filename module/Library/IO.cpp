@@ -6,6 +6,7 @@ namespace SqMod {
 
 // ------------------------------------------------------------------------------------------------
 extern void Register_Buffer(HSQUIRRELVM vm);
+extern void Register_BufferView(HSQUIRRELVM vm);
 extern void Register_Stream(HSQUIRRELVM vm);
 extern void Register_INI(HSQUIRRELVM vm);
 
@@ -13,6 +14,7 @@ extern void Register_INI(HSQUIRRELVM vm);
 void Register_IO(HSQUIRRELVM vm)
 {
     Register_Buffer(vm);
+    Register_BufferView(vm);
     Register_Stream(vm);
     Register_INI(vm);
 }
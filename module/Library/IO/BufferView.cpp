@@ -0,0 +1,200 @@
+// ------------------------------------------------------------------------------------------------
+#include "Library/IO/BufferView.hpp"
+#include "Base/AABB.hpp"
+#include "Base/Circle.hpp"
+#include "Base/Color3.hpp"
+#include "Base/Color4.hpp"
+#include "Base/Quaternion.hpp"
+#include "Base/Sphere.hpp"
+#include "Base/Vector2i.hpp"
+#include "Base/Vector4.hpp"
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMOD_DECL_TYPENAME(Typename, _SC("SqBufferView"))
+
+// ------------------------------------------------------------------------------------------------
+LightObj SqBufferView::Copy() const
+{
+    // Do we even view something?
+    if (!m_Data)
+    {
+        STHROWF("Buffer view is no longer valid. Use Detach() to keep the data after the event");
+    }
+    // Replicate the viewed memory and keep the cursor where it is
+    return LightObj(SqTypeIdentity< SqBuffer >{}, SqVM(), Buffer(m_Data, m_Size, m_Cursor));
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj SqBufferView::ReadRawString(SQInteger length)
+{
+    // Make sure there's something to read from
+    ValidateRead(0);
+    // Start with a length of zero
+    SzType len = 0;
+    // Should we Identify the string length ourselves?
+    if (length < 0)
+    {
+        // Grab the view range to search for
+        const char * ptr = m_Data + m_Cursor, * itr = ptr, * end = m_Data + m_Size;
+        // Attempt to look for a string terminator
+        while (itr != end && *itr != '\0')
+        {
+            ++itr;
+        }
+        // If nothing was found, consider the remaining view part of the requested string
+        len = static_cast< SzType >(itr - ptr);
+    }
+    else
+    {
+        len = ConvTo< SzType >::From(length);
+    }
+    // Validate the obtained length
+    ValidateRead(len);
+    // Remember the current stack size
+    const StackGuard sg;
+    // Attempt to create the string as an object
+    sq_pushstring(SqVM(), m_Data + m_Cursor, len);
+    // Advance the cursor after the string
+    m_Cursor += len;
+    // Return the resulted object
+    return LightObj(-1, SqVM());
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj SqBufferView::ReadClientString()
+{
+    // Make sure the length can be read
+    ValidateRead(sizeof(uint16_t));
+    // Read the length without advancing, in case the string is out of range
+    uint16_t length;
+    std::memcpy(&length, m_Data + m_Cursor, sizeof(uint16_t));
+    // Convert the length to little endian
+    length = static_cast< uint16_t >(((length >> 8) & 0xFF) | ((length & 0xFF) << 8));
+    // Validate the obtained length
+    ValidateRead(static_cast< SzType >(sizeof(uint16_t) + length));
+    // Advance the cursor to the actual string
+    m_Cursor += sizeof(uint16_t);
+    // Remember the current stack size
+    const StackGuard sg;
+    // Attempt to create the string as an object
+    sq_pushstring(SqVM(), m_Data + m_Cursor, length);
+    // Advance the cursor after the string
+    m_Cursor += length;
+    // Return the resulted object
+    return LightObj(-1, SqVM());
+}
+
+// ------------------------------------------------------------------------------------------------
+AABB SqBufferView::ReadAABB()
+{
+    return Take< AABB >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Circle SqBufferView::ReadCircle()
+{
+    return Take< Circle >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Color3 SqBufferView::ReadColor3()
+{
+    return Take< Color3 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Color4 SqBufferView::ReadColor4()
+{
+    return Take< Color4 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Quaternion SqBufferView::ReadQuaternion()
+{
+    return Take< Quaternion >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Sphere SqBufferView::ReadSphere()
+{
+    return Take< Sphere >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector2 SqBufferView::ReadVector2()
+{
+    return Take< Vector2 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector2i SqBufferView::ReadVector2i()
+{
+    return Take< Vector2i >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector3 SqBufferView::ReadVector3()
+{
+    return Take< Vector3 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector4 SqBufferView::ReadVector4()
+{
+    return Take< Vector4 >();
+}
+
+// ================================================================================================
+void Register_BufferView(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(Typename::Str,
+        Class< SqBufferView, NoCopy< SqBufferView > >(vm, Typename::Str)
+        // Constructors
+        .Ctor()
+        // Core Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        // Properties
+        .Prop(_SC("Valid"), &SqBufferView::IsValid)
+        .Prop(_SC("Borrowed"), &SqBufferView::IsBorrowed)
+        .Prop(_SC("Size"), &SqBufferView::GetSize)
+        .Prop(_SC("Position"), &SqBufferView::GetPosition, &SqBufferView::SetPosition)
+        .Prop(_SC("Remaining"), &SqBufferView::GetRemaining)
+        // Member Methods
+        .Func(_SC("Get"), &SqBufferView::Get)
+        .Func(_SC("Move"), &SqBufferView::SetPosition)
+        .Func(_SC("Advance"), &SqBufferView::Advance)
+        .Func(_SC("Detach"), &SqBufferView::Detach)
+        .Func(_SC("Copy"), &SqBufferView::Copy)
+        .Func(_SC("ReadByte"), &SqBufferView::ReadUint8)
+        .Func(_SC("ReadShort"), &SqBufferView::ReadInt16)
+        .Func(_SC("ReadInt"), &SqBufferView::ReadInt32)
+        .Func(_SC("ReadFloat"), &SqBufferView::ReadFloat32)
+        .Func(_SC("ReadInt8"), &SqBufferView::ReadInt8)
+        .Func(_SC("ReadUint8"), &SqBufferView::ReadUint8)
+        .Func(_SC("ReadInt16"), &SqBufferView::ReadInt16)
+        .Func(_SC("ReadUint16"), &SqBufferView::ReadUint16)
+        .Func(_SC("ReadInt32"), &SqBufferView::ReadInt32)
+        .Func(_SC("ReadUint32"), &SqBufferView::ReadUint32)
+        .Func(_SC("ReadInt64"), &SqBufferView::ReadInt64)
+        .Func(_SC("ReadUint64"), &SqBufferView::ReadUint64)
+        .Func(_SC("ReadFloat32"), &SqBufferView::ReadFloat32)
+        .Func(_SC("ReadFloat64"), &SqBufferView::ReadFloat64)
+        .Func(_SC("ReadRawString"), &SqBufferView::ReadRawString)
+        .Func(_SC("ReadClientString"), &SqBufferView::ReadClientString)
+        .Func(_SC("ReadAABB"), &SqBufferView::ReadAABB)
+        .Func(_SC("ReadCircle"), &SqBufferView::ReadCircle)
+        .Func(_SC("ReadColor3"), &SqBufferView::ReadColor3)
+        .Func(_SC("ReadColor4"), &SqBufferView::ReadColor4)
+        .Func(_SC("ReadQuaternion"), &SqBufferView::ReadQuaternion)
+        .Func(_SC("ReadSphere"), &SqBufferView::ReadSphere)
+        .Func(_SC("ReadVector2"), &SqBufferView::ReadVector2)
+        .Func(_SC("ReadVector2i"), &SqBufferView::ReadVector2i)
+        .Func(_SC("ReadVector3"), &SqBufferView::ReadVector3)
+        .Func(_SC("ReadVector4"), &SqBufferView::ReadVector4)
+    );
+}
+
+} // Namespace:: SqMod
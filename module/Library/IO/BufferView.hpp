@@ -0,0 +1,261 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "Library/IO/Buffer.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Read-only view over a range of memory. The memory is either borrowed from the host, in which
+ * case it is only valid for the duration of the event that produced it, or owned after a copy.
+*/
+class SqBufferView
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef Buffer::Value   Value; // The type of value used to represent a byte.
+    typedef Buffer::SzType  SzType; // The type used to represent size in general.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    const Value *   m_Data; // The viewed memory. Either borrowed or pointing inside the owned buffer.
+    SzType          m_Size; // The number of viewed bytes.
+    SzType          m_Cursor; // Read cursor.
+    bool            m_Borrowed; // Whether the memory is borrowed.
+    Buffer          m_Owned; // Storage used once the view owns a copy of the memory.
+
+    /* --------------------------------------------------------------------------------------------
+     * Make sure the specified amount of bytes can be read from the cursor position.
+    */
+    void ValidateRead(SzType n) const
+    {
+        // Do we even view something?
+        if (!m_Data)
+        {
+            STHROWF("Buffer view is no longer valid. Use Detach() to keep the data after the event");
+        }
+        // Is there enough data left?
+        else if (n > (m_Size - m_Cursor))
+        {
+            STHROWF("Cannot read ({}) bytes at ({}) from a view of ({}) bytes", n, m_Cursor, m_Size);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a value from the cursor position and advance the cursor.
+    */
+    template < typename T > T Take()
+    {
+        ValidateRead(sizeof(T));
+        // The data is not guaranteed to be aligned
+        T value;
+        std::memcpy(&value, m_Data + m_Cursor, sizeof(T));
+        // Advance the cursor
+        m_Cursor += sizeof(T);
+        // Return the value
+        return value;
+    }
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor. (invalid view)
+    */
+    SqBufferView()
+        : m_Data(nullptr), m_Size(0), m_Cursor(0), m_Borrowed(false), m_Owned()
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    SqBufferView(const SqBufferView & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    SqBufferView(SqBufferView && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    SqBufferView & operator = (const SqBufferView & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    SqBufferView & operator = (SqBufferView && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * View the specified memory without copying it. The memory must outlive the borrow.
+    */
+    void Borrow(const void * data, size_t size)
+    {
+        m_Data = static_cast< const Value * >(data);
+        m_Size = ConvTo< SzType >::From(size);
+        m_Cursor = 0;
+        m_Borrowed = true;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop viewing borrowed memory. Owned memory is kept.
+    */
+    void Invalidate()
+    {
+        if (m_Borrowed)
+        {
+            m_Data = nullptr;
+            m_Size = 0;
+            m_Cursor = 0;
+            m_Borrowed = false;
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy the borrowed memory so that the view remains valid after the borrow ends.
+    */
+    SqBufferView & Detach()
+    {
+        // Is there anything borrowed?
+        if (m_Borrowed && m_Data)
+        {
+            m_Owned = Buffer(m_Data, m_Size);
+            m_Data = m_Owned.Data();
+            m_Borrowed = false;
+        }
+        // Allow chaining
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the view still has access to its memory.
+    */
+    SQMOD_NODISCARD bool IsValid() const
+    {
+        return (m_Data != nullptr);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the memory is borrowed.
+    */
+    SQMOD_NODISCARD bool IsBorrowed() const
+    {
+        return m_Borrowed;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of viewed bytes.
+    */
+    SQMOD_NODISCARD SzType GetSize() const
+    {
+        return m_Size;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the cursor position.
+    */
+    SQMOD_NODISCARD SzType GetPosition() const
+    {
+        return m_Cursor;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the cursor position.
+    */
+    void SetPosition(SQInteger n)
+    {
+        // Is the position within range?
+        if (n < 0 || static_cast< SQUnsignedInteger >(n) > m_Size)
+        {
+            STHROWF("Position ({}) is out of view range ({})", n, m_Size);
+        }
+        m_Cursor = static_cast< SzType >(n);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes left after the cursor.
+    */
+    SQMOD_NODISCARD SzType GetRemaining() const
+    {
+        return m_Size - m_Cursor;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Advance the cursor by the specified number of bytes.
+    */
+    SqBufferView & Advance(SQInteger n)
+    {
+        SetPosition(static_cast< SQInteger >(m_Cursor) + n);
+        // Allow chaining
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the byte at the specified position.
+    */
+    SQMOD_NODISCARD SQInteger Get(SQInteger n) const
+    {
+        // Do we even view something?
+        if (!m_Data)
+        {
+            STHROWF("Buffer view is no longer valid. Use Detach() to keep the data after the event");
+        }
+        // Is the position within range?
+        else if (n < 0 || static_cast< SQUnsignedInteger >(n) >= m_Size)
+        {
+            STHROWF("Index ({}) is out of view range ({})", n, m_Size);
+        }
+        return static_cast< SQInteger >(static_cast< uint8_t >(m_Data[n]));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy the viewed memory into a new buffer. The buffer cursor matches the view cursor.
+    */
+    SQMOD_NODISCARD LightObj Copy() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Read integer and floating point values.
+    */
+    SQInteger ReadInt8() { return Take< int8_t >(); }
+    SQInteger ReadUint8() { return Take< uint8_t >(); }
+    SQInteger ReadInt16() { return Take< int16_t >(); }
+    SQInteger ReadUint16() { return Take< uint16_t >(); }
+    SQInteger ReadInt32() { return Take< int32_t >(); }
+    SQInteger ReadUint32() { return Take< uint32_t >(); }
+    SQInteger ReadInt64() { return static_cast< SQInteger >(Take< int64_t >()); }
+    SQInteger ReadUint64() { return static_cast< SQInteger >(Take< uint64_t >()); }
+    SQFloat ReadFloat32() { return static_cast< SQFloat >(Take< float >()); }
+    SQFloat ReadFloat64() { return static_cast< SQFloat >(Take< double >()); }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a raw string from the view. A negative length reads until a null terminator.
+    */
+    LightObj ReadRawString(SQInteger length);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a string prefixed with a big endian 16 bit length, as sent by the client.
+    */
+    LightObj ReadClientString();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read base types from the view.
+    */
+    AABB ReadAABB();
+    Circle ReadCircle();
+    Color3 ReadColor3();
+    Color4 ReadColor4();
+    Quaternion ReadQuaternion();
+    Sphere ReadSphere();
+    Vector2 ReadVector2();
+    Vector2i ReadVector2i();
+    Vector3 ReadVector3();
+    Vector4 ReadVector4();
+};
+
+} // Namespace:: SqMod
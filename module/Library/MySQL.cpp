@@ -17,6 +17,9 @@
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+extern void Register_MySQLPool(HSQUIRRELVM vm, Table & sqlns);
+
 // ------------------------------------------------------------------------------------------------
 LightObj GetMySQLFromSession(Poco::Data::SessionImpl * session)
 {
@@ -593,6 +596,7 @@ MySQLConnHnd::MySQLConnHnd()
     , mCharset()
     , mAutoCommit()
     , mInTransaction(false)
+    , mCache([](MYSQL_STMT * stmt) { mysql_stmt_close(stmt); })
 {
     /* ... */
 }
@@ -700,6 +704,8 @@ void MySQLConnHnd::Disconnect()
 {
     if (mPtr != nullptr)
     {
+        // Statements must be closed while the connection is still open
+        mCache.Clear();
         // If this connection is a pooled session then let it clean itself up
         if (mSession.isNull())
         {
@@ -932,6 +938,7 @@ MySQLStmtHnd::MySQLStmtHnd()
     , mMyBinds(nullptr)
     , mConnection()
     , mQuery()
+    , mCached(false)
 {
 
 }
@@ -949,8 +956,17 @@ MySQLStmtHnd::~MySQLStmtHnd()
     {
         delete [] (mBinds);
     }
+    // Can the statement be reused?
+    if (mPtr && mCached && mConnection && mConnection->mPtr)
+    {
+        // Discard pending results and bring it back to its initial state
+        mysql_stmt_free_result(mPtr);
+        mysql_stmt_reset(mPtr);
+        // Give it back to the connection
+        mConnection->mCache.Return(mQuery, mPtr);
+    }
     // Should we release any statement?
-    if (mPtr)
+    else if (mPtr)
     {
         mysql_stmt_close(mPtr);
     }
@@ -981,18 +997,26 @@ void MySQLStmtHnd::Create(const MySQLConnRef & conn, const SQChar * query)
     // Store the connection handle and query string
     mConnection = conn;
     mQuery.assign(query);
-    // Attempt to initialize the statement handle
-    mPtr = mysql_stmt_init(mConnection->mPtr);
-    // Validate the obtained statement handle
+    // Is there an idle statement prepared with the same query string?
+    mPtr = mConnection->mCache.Checkout(mQuery);
+    // Prepare a new one otherwise
     if (!mPtr)
     {
-        SQMOD_THROW_CURRENT(*mConnection, "Cannot initialize MySQL statement");
-    }
-    // Attempt to prepare the statement with the given query
-    else if (mysql_stmt_prepare(mPtr, mQuery.c_str(), static_cast<unsigned long>(mQuery.size())))
-    {
-        SQMOD_THROW_CURRENT(*this, "Cannot prepare MySQL statement");
+        // Attempt to initialize the statement handle
+        mPtr = mysql_stmt_init(mConnection->mPtr);
+        // Validate the obtained statement handle
+        if (!mPtr)
+        {
+            SQMOD_THROW_CURRENT(*mConnection, "Cannot initialize MySQL statement");
+        }
+        // Attempt to prepare the statement with the given query
+        else if (mysql_stmt_prepare(mPtr, mQuery.c_str(), static_cast<unsigned long>(mQuery.size())))
+        {
+            SQMOD_THROW_CURRENT(*this, "Cannot prepare MySQL statement");
+        }
     }
+    // The statement can be reused once we're done with it
+    mCached = true;
     // Retrieve the amount of parameters supported by this statement
     mParams = mysql_stmt_param_count(mPtr);
     // Are there any parameters to allocate?
@@ -1729,6 +1753,17 @@ const MySQLConnRef & MySQLConnection::GetCreated() const
 }
 #endif // _DEBUG
 
+// ------------------------------------------------------------------------------------------------
+void MySQLConnection::SetCacheCapacity(SQInteger n)
+{
+    // Is the capacity valid?
+    if (n < 0)
+    {
+        STHROWF("Invalid statement cache capacity: {} < 0", n);
+    }
+    SQMOD_GET_VALID(*this)->mCache.SetCapacity(static_cast< size_t >(n));
+}
+
 // ------------------------------------------------------------------------------------------------
 SQInteger MySQLConnection::Insert(const SQChar * query)
 {
@@ -3252,6 +3287,11 @@ void Register_MySQL(HSQUIRRELVM vm)
         .Prop(_SC("Charset"), &MySQLConnection::GetCharset, &MySQLConnection::SetCharset)
         .Prop(_SC("AutoCommit"), &MySQLConnection::GetAutoCommit, &MySQLConnection::SetAutoCommit)
         .Prop(_SC("InTransaction"), &MySQLConnection::GetInTransaction)
+        .Prop(_SC("CacheCapacity"), &MySQLConnection::GetCacheCapacity, &MySQLConnection::SetCacheCapacity)
+        .Prop(_SC("CacheSize"), &MySQLConnection::GetCacheSize)
+        .Prop(_SC("CacheHits"), &MySQLConnection::GetCacheHits)
+        .Prop(_SC("CacheMisses"), &MySQLConnection::GetCacheMisses)
+        .Prop(_SC("CacheEvictions"), &MySQLConnection::GetCacheEvictions)
         // Member Methods
         .Func(_SC("Disconnect"), &MySQLConnection::Disconnect)
         .Func(_SC("SelectDb"), &MySQLConnection::SetName)
@@ -3259,6 +3299,8 @@ void Register_MySQL(HSQUIRRELVM vm)
         .Func(_SC("Insert"), &MySQLConnection::Insert)
         .Func(_SC("Query"), &MySQLConnection::Query)
         .Func(_SC("Statement"), &MySQLConnection::GetStatement)
+        .Func(_SC("ClearCache"), &MySQLConnection::ClearCache)
+        .Func(_SC("ResetCacheStats"), &MySQLConnection::ResetCacheStats)
         //.Func(_SC("Transaction"), &MySQLConnection::GetTransaction)
         .FmtFunc(_SC("EscapeString"), &MySQLConnection::EscapeString)
         // Squirrel Methods
@@ -3393,6 +3435,8 @@ void Register_MySQL(HSQUIRRELVM vm)
         .Func(_SC("SetNull"), &MySQLStatement::SetNull)
     );
 
+    Register_MySQLPool(vm, sqlns);
+
     RootTable(vm).Bind(_SC("MySQL"), sqlns);
 }
 
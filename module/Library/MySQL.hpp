@@ -2,6 +2,7 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
+#include "Core/StmtCache.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include "Library/IO/Buffer.hpp"
@@ -258,6 +259,9 @@ public:
     bool        mAutoCommit; // Whether autocommit is enabled on this connection.
     bool        mInTransaction; // Whether the connection is in the middle of a transaction.
 
+    // --------------------------------------------------------------------------------------------
+    StmtCache< MYSQL_STMT * > mCache; // Idle prepared statements that can be reused.
+
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
     */
@@ -461,6 +465,7 @@ public:
     // --------------------------------------------------------------------------------------------
     MySQLConnRef    mConnection; // Reference to the associated connection.
     String          mQuery; // The query string.
+    bool            mCached; // True when the statement goes back to the connection cache.
 
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
@@ -1532,6 +1537,67 @@ public:
         return SQMOD_GET_VALID(*this)->mInTransaction;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of idle prepared statements kept by the connection.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheCapacity() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetCapacity());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of idle prepared statements kept by the connection.
+    */
+    void SetCacheCapacity(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of idle prepared statements kept by the connection.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheSize() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetSize());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that were found in the cache.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheHits() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetHits());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that had to be prepared.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheMisses() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetMisses());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of idle statements that were released to make room for others.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheEvictions() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetEvictions());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all idle prepared statements kept by the connection.
+    */
+    void ClearCache()
+    {
+        SQMOD_GET_VALID(*this)->mCache.Clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the statement cache counters.
+    */
+    void ResetCacheStats()
+    {
+        SQMOD_GET_VALID(*this)->mCache.ResetStats();
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Disconnect from the currently connected database.
     */
@@ -0,0 +1,885 @@
+// ------------------------------------------------------------------------------------------------
+#include "Library/MySQL/Pool.hpp"
+#include "Core/ThreadPool.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <mysql/errmsg.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMOD_DECL_TYPENAME(SqMySQLPool, _SC("SqMySQLPool"))
+SQMOD_DECL_TYPENAME(SqMySQLAsyncBuilder, _SC("SqMySQLAsyncBuilder"))
+SQMOD_DECL_TYPENAME(SqMySQLAsyncResult, _SC("SqMySQLAsyncResult"))
+
+// ------------------------------------------------------------------------------------------------
+static constexpr size_t MYSQL_POOL_MAX_SIZE = 64; // Maximum number of connections in a pool.
+static constexpr unsigned long MYSQL_FETCH_BUFFER = 64; // Initial size of the statement value buffers.
+
+/* ------------------------------------------------------------------------------------------------
+ * What an asynchronous task should produce.
+*/
+enum MySQLAsyncMode
+{
+    MYSQL_ASYNC_EXECUTE = 0, // Number of affected rows.
+    MYSQL_ASYNC_INSERT, // Identifier of the inserted row.
+    MYSQL_ASYNC_QUERY // The result-set.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Asynchronous query that runs on one of the connections of a pool.
+*/
+struct MySQLAsyncTask : public ThreadPoolItem
+{
+    // --------------------------------------------------------------------------------------------
+    MySQLPoolRef                    mPool{}; // The pool that owns the connection. Assigned once dispatched.
+    MySQLConnRef                    mConnection{}; // The connection that runs the query.
+    // --------------------------------------------------------------------------------------------
+    Function                        mResolved{}; // Callback to invoke when the task was completed.
+    Function                        mRejected{}; // Callback to invoke when the task failed.
+    // --------------------------------------------------------------------------------------------
+    String                          mQuery{}; // The query string that will be executed.
+    std::vector< MySQLAsyncParam >  mParams{}; // Statement parameters, if any.
+    LightObj                        mCtx{}; // User specified context object, if any.
+    // --------------------------------------------------------------------------------------------
+    size_t                          mSlot{0}; // The pool slot of the connection.
+    int32_t                         mMode{MYSQL_ASYNC_EXECUTE}; // What the task should produce.
+    bool                            mPrepared{false}; // Whether the query runs as a prepared statement.
+    bool                            mPing{false}; // Whether the connection should be checked first.
+    bool                            mFresh{false}; // Whether the connection was never opened before.
+    // --------------------------------------------------------------------------------------------
+    bool                            mDone{false}; // Whether the task was processed.
+    bool                            mReconnected{false}; // Whether the connection had to be opened again.
+    uint32_t                        mErrNo{0}; // Error code, if any.
+    String                          mError{}; // Error message, if any.
+    // --------------------------------------------------------------------------------------------
+    MySQLResultDataRef              mResult{}; // The outcome of the query.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor. Members are supposed to be validated and filled by the builder.
+    */
+    MySQLAsyncTask() = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~MySQLAsyncTask() override = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Provide a name to what type of task this is. Mainly for debugging purposes.
+    */
+    SQMOD_NODISCARD const char * TypeName() noexcept override { return "mysql async query"; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Provide unique information that may help identify the task. Mainly for debugging purposes.
+    */
+    SQMOD_NODISCARD const char * IdentifiableInfo() noexcept override { return mQuery.c_str(); }
+
+    /* --------------------------------------------------------------------------------------------
+     * Provide the subsystem lane in which the item should be processed.
+    */
+    SQMOD_NODISCARD uint32_t Lane() noexcept override { return TPL_DATABASE; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Database results are usually awaited by the game logic so, they are taken first.
+    */
+    SQMOD_NODISCARD uint32_t Priority() noexcept override { return TPP_HIGH; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Invoked in worker thread. Makes sure the connection is open and still usable.
+    */
+    SQMOD_NODISCARD bool OnPrepare() override
+    {
+        // Has the connection been idle long enough that the server might have dropped it?
+        if (mConnection->mPtr != nullptr && mPing && mysql_ping(mConnection->mPtr) != 0)
+        {
+            mConnection->Disconnect();
+        }
+        // Is the connection open?
+        if (mConnection->mPtr != nullptr)
+        {
+            return true;
+        }
+        try
+        {
+            // The account is never modified after the pool was created
+            mConnection->mErrNo = 0;
+            mConnection->Create(mPool->mAccount);
+            // Only count connections that were lost
+            mReconnected = !mFresh;
+        }
+        catch (const std::exception & e)
+        {
+            mErrNo = (mConnection->mErrNo != 0) ? mConnection->mErrNo : CR_UNKNOWN_ERROR;
+            mError.assign(e.what());
+            // Leave it closed for the next task to try again
+            mConnection->Disconnect();
+            mDone = true;
+            return false;
+        }
+        return true;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Invoked in worker thread. Runs the query and materializes its outcome.
+    */
+    SQMOD_NODISCARD bool OnProcess() override
+    {
+        MySQLStmtRef stmt;
+        // Allocate the outcome
+        mResult = MySQLResultDataRef{new MySQLResultData()};
+        try
+        {
+            if (mPrepared)
+            {
+                ProcessStatement(stmt);
+            }
+            else
+            {
+                ProcessQuery();
+            }
+        }
+        catch (const std::exception & e)
+        {
+            mError.assign(e.what());
+            // Statement errors are more specific
+            if (stmt && stmt->mErrNo != 0)
+            {
+                mErrNo = stmt->mErrNo;
+            }
+            else if (mConnection->mPtr != nullptr)
+            {
+                mErrNo = mysql_errno(mConnection->mPtr);
+            }
+            // Make sure the task is seen as failed
+            if (mErrNo == 0)
+            {
+                mErrNo = CR_UNKNOWN_ERROR;
+            }
+        }
+        // The statement goes back to the connection cache from this thread
+        stmt.Reset();
+        // Was the connection lost? The next task will open it again
+        if (mErrNo == CR_SERVER_GONE_ERROR || mErrNo == CR_SERVER_LOST)
+        {
+            mConnection->Disconnect();
+        }
+        mDone = true;
+        // Don't retry
+        return false;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Invoked in main thread. Delivers the outcome and gives the connection back to the pool.
+    */
+    SQMOD_NODISCARD bool OnCompleted(bool stop) override
+    {
+        // Keep the pool alive until we're done with it
+        MySQLPoolRef pool = std::move(mPool);
+        // Cancelled before it could run?
+        if (!mDone)
+        {
+            mErrNo = CR_UNKNOWN_ERROR;
+            mError.assign("Task was cancelled");
+        }
+        // Update the pool statistics
+        if (mErrNo == 0)
+        {
+            ++(pool->mCompleted);
+        }
+        else
+        {
+            ++(pool->mFailed);
+        }
+        if (mReconnected)
+        {
+            ++(pool->mReconnects);
+        }
+        pool->mSlots[mSlot].mLastUsed = FrameSlice::Now();
+        // Deliver the outcome
+        Deliver(pool);
+        // Give the connection to the next task
+        MySQLPoolHnd::Release(pool, mSlot, stop);
+        // Finished
+        return false;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Invoke the callback that matches the outcome of the task.
+    */
+    void Deliver(const MySQLPoolRef & pool)
+    {
+        if (mErrNo == 0)
+        {
+            if (!mResolved.IsNull())
+            {
+                LightObj p{SqTypeIdentity< MySQLPool >{}, SqVM(), pool};
+                LightObj q(mQuery.data(), static_cast< SQInteger >(mQuery.size()));
+                // Produce the requested value
+                if (mMode == MYSQL_ASYNC_QUERY)
+                {
+                    LightObj r{SqTypeIdentity< MySQLAsyncResult >{}, SqVM(), mResult};
+                    mResolved.Execute(p, mCtx, r, q);
+                }
+                else
+                {
+                    const uint64_t v = (mMode == MYSQL_ASYNC_INSERT) ? mResult->mInsertId : mResult->mAffected;
+                    mResolved.Execute(p, mCtx, static_cast< SQInteger >(v), q);
+                }
+            }
+        }
+        else if (!mRejected.IsNull())
+        {
+            LightObj p{SqTypeIdentity< MySQLPool >{}, SqVM(), pool};
+            LightObj q(mQuery.data(), static_cast< SQInteger >(mQuery.size()));
+            mRejected.Execute(p, mCtx, static_cast< SQInteger >(mErrNo), mError, q);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Run the query as plain text.
+    */
+    void ProcessQuery()
+    {
+        MYSQL * conn = mConnection->mPtr;
+        // Only affected rows are needed
+        if (mMode == MYSQL_ASYNC_EXECUTE)
+        {
+            mResult->mAffected = mConnection->Execute(mQuery.c_str(), static_cast< unsigned long >(mQuery.size()));
+            return;
+        }
+        // Attempt to execute the specified query
+        if (mysql_real_query(conn, mQuery.c_str(), static_cast< unsigned long >(mQuery.size())) != 0)
+        {
+            SQMOD_THROW_CURRENT(*mConnection, "Unable to execute query");
+        }
+        MYSQL_RES * res = mysql_store_result(conn);
+        // Did the query produce a result-set?
+        if (res != nullptr)
+        {
+            // Inserts are not expected to produce one
+            if (mMode == MYSQL_ASYNC_QUERY)
+            {
+                mResult->FromResult(res);
+            }
+            mysql_free_result(res);
+        }
+        // Was a result-set expected and not received?
+        else if (mysql_field_count(conn) != 0)
+        {
+            SQMOD_THROW_CURRENT(*mConnection, "Unable to retrieve result-set");
+        }
+        mResult->mAffected = mysql_affected_rows(conn);
+        mResult->mInsertId = mysql_insert_id(conn);
+        // Discard any remaining results so the connection can be used again
+        while (mysql_next_result(conn) == 0)
+        {
+            res = mysql_store_result(conn);
+            // Just, free the memory associated with the obtained result set
+            if (res != nullptr)
+            {
+                mysql_free_result(res);
+            }
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Run the query as a prepared statement.
+    */
+    void ProcessStatement(MySQLStmtRef & stmt)
+    {
+        stmt = MySQLStmtRef{new MySQLStmtHnd()};
+        // Prepared statements are reused through the connection cache
+        stmt->Create(mConnection, mQuery.c_str());
+        // Do the parameters match the statement?
+        if (mParams.size() != stmt->mParams)
+        {
+            STHROWF("Statement expects {} parameters but {} were bound", stmt->mParams, mParams.size());
+        }
+        // Configure the parameters
+        for (size_t i = 0; i < mParams.size(); ++i)
+        {
+            const MySQLAsyncParam & p = mParams[i];
+            MySQLStmtBind & b = stmt->mBinds[i];
+            // Strings live in the bind buffer, everything else in the bind value
+            if (p.mType == MYSQL_TYPE_STRING)
+            {
+                b.SetInput(p.mType, &(stmt->mMyBinds[i]), p.mStr.data(), static_cast< unsigned long >(p.mStr.size()));
+            }
+            else
+            {
+                b.SetInput(p.mType, &(stmt->mMyBinds[i]));
+            }
+            // Assign the value to the input
+            if (p.mType == MYSQL_TYPE_DOUBLE)
+            {
+                b.mFloat64 = p.mFloat;
+            }
+            else if (p.mType == MYSQL_TYPE_LONGLONG || p.mType == MYSQL_TYPE_TINY)
+            {
+                b.mInt64 = p.mInt;
+            }
+        }
+        // Attempt to bind the parameters
+        if (stmt->mParams > 0 && mysql_stmt_bind_param(stmt->mPtr, stmt->mMyBinds))
+        {
+            SQMOD_THROW_CURRENT(*stmt, "Cannot bind MySQL statement parameters");
+        }
+        // Attempt to execute the statement
+        else if (mysql_stmt_execute(stmt->mPtr))
+        {
+            SQMOD_THROW_CURRENT(*stmt, "Cannot execute MySQL statement");
+        }
+        // Retrieve the rows, if requested
+        if (mMode == MYSQL_ASYNC_QUERY)
+        {
+            mResult->FromStatement(*stmt);
+        }
+        mResult->mAffected = mysql_stmt_affected_rows(stmt->mPtr);
+        mResult->mInsertId = mysql_stmt_insert_id(stmt->mPtr);
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+void MySQLResultData::Init(const MYSQL_FIELD * fields, unsigned int count, size_t rows)
+{
+    mColumns.resize(count);
+    // Prepare each column
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Column & c = mColumns[i];
+        c.mName.assign(fields[i].name == nullptr ? "" : fields[i].name);
+        c.mType = fields[i].type;
+        c.mOffsets.reserve(rows + 1);
+        c.mOffsets.push_back(0);
+        c.mNulls.reserve(rows);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLResultData::Append(size_t col, const char * value, size_t length)
+{
+    Column & c = mColumns[col];
+    // Is this a null value?
+    if (value == nullptr)
+    {
+        c.mNulls.push_back(true);
+    }
+    else
+    {
+        c.mNulls.push_back(false);
+        c.mData.insert(c.mData.end(), value, value + length);
+    }
+    // Values are terminated so they can be converted in-place
+    c.mData.push_back('\0');
+    c.mOffsets.push_back(static_cast< uint32_t >(c.mData.size()));
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLResultData::FromResult(MYSQL_RES * res)
+{
+    const unsigned int count = mysql_num_fields(res);
+    // Prepare the columns
+    Init(mysql_fetch_fields(res), count, static_cast< size_t >(mysql_num_rows(res)));
+    // Copy every row
+    for (MYSQL_ROW row = mysql_fetch_row(res); row != nullptr; row = mysql_fetch_row(res))
+    {
+        const unsigned long * lengths = mysql_fetch_lengths(res);
+        // Copy every value
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Append(i, row[i], lengths[i]);
+        }
+        ++mRows;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLResultData::FromStatement(MySQLStmtHnd & stmt)
+{
+    MYSQL_RES * meta = mysql_stmt_result_metadata(stmt.mPtr);
+    // Did the statement produce a result-set?
+    if (meta == nullptr)
+    {
+        if (mysql_stmt_field_count(stmt.mPtr) != 0)
+        {
+            SQMOD_THROW_CURRENT(stmt, "Cannot retrieve MySQL statement metadata");
+        }
+        return;
+    }
+    // Make sure the metadata is released
+    std::unique_ptr< MYSQL_RES, void (*)(MYSQL_RES *) > guard(meta, [](MYSQL_RES * r) { mysql_free_result(r); });
+    // Receive all the rows at once
+    if (mysql_stmt_store_result(stmt.mPtr))
+    {
+        SQMOD_THROW_CURRENT(stmt, "Cannot store MySQL statement result-set");
+    }
+    const unsigned int count = mysql_num_fields(meta);
+    // Prepare the columns
+    Init(mysql_fetch_fields(meta), count, static_cast< size_t >(mysql_stmt_num_rows(stmt.mPtr)));
+    // Values are received as text, the same as a regular query
+    std::vector< MYSQL_BIND > binds(count);
+    std::vector< std::vector< char > > buffers(count, std::vector< char >(MYSQL_FETCH_BUFFER));
+    std::vector< unsigned long > lengths(count);
+    std::vector< MySQLStmtHnd::BoolType > nulls(count), errors(count);
+    // Configure the bind points
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        std::memset(&binds[i], 0, sizeof(MYSQL_BIND));
+        binds[i].buffer_type = MYSQL_TYPE_STRING;
+        binds[i].buffer = buffers[i].data();
+        binds[i].buffer_length = MYSQL_FETCH_BUFFER;
+        binds[i].length = &lengths[i];
+        binds[i].is_null = &nulls[i];
+        binds[i].error = &errors[i];
+    }
+    // Attempt to bind the result-set
+    if (mysql_stmt_bind_result(stmt.mPtr, binds.data()))
+    {
+        SQMOD_THROW_CURRENT(stmt, "Cannot bind MySQL statement result-set");
+    }
+    // Copy every row
+    for (int r = mysql_stmt_fetch(stmt.mPtr); r != MYSQL_NO_DATA; r = mysql_stmt_fetch(stmt.mPtr))
+    {
+        if (r == 1)
+        {
+            SQMOD_THROW_CURRENT(stmt, "Cannot fetch MySQL statement row");
+        }
+        bool rebind = false;
+        // Copy every value
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (nulls[i])
+            {
+                Append(i, nullptr, 0);
+                continue;
+            }
+            // Was the value truncated?
+            else if (lengths[i] > binds[i].buffer_length)
+            {
+                buffers[i].resize(lengths[i]);
+                binds[i].buffer = buffers[i].data();
+                binds[i].buffer_length = lengths[i];
+                // Retrieve the whole value
+                if (mysql_stmt_fetch_column(stmt.mPtr, &binds[i], i, 0))
+                {
+                    SQMOD_THROW_CURRENT(stmt, "Cannot fetch MySQL statement column");
+                }
+                rebind = true;
+            }
+            Append(i, buffers[i].data(), lengths[i]);
+        }
+        ++mRows;
+        // Use the larger buffers from now on
+        if (rebind && mysql_stmt_bind_result(stmt.mPtr, binds.data()))
+        {
+            SQMOD_THROW_CURRENT(stmt, "Cannot bind MySQL statement result-set");
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+MySQLPoolHnd::MySQLPoolHnd(const MySQLAccount & acc, size_t size)
+    : mAccount(acc), mSlots(size), mWaiting()
+    , mPing(DEFAULT_PING), mBusy(0)
+    , mSubmitted(0), mCompleted(0), mFailed(0), mReconnects(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+MySQLPoolHnd::~MySQLPoolHnd() = default;
+
+// ------------------------------------------------------------------------------------------------
+void MySQLPoolHnd::Submit(const MySQLPoolRef & pool, Task && task)
+{
+    ++(pool->mSubmitted);
+    // Look for a connection that is not in use
+    for (size_t i = 0; i < pool->mSlots.size(); ++i)
+    {
+        Slot & s = pool->mSlots[i];
+        // Is this connection free?
+        if (s.mBusy)
+        {
+            continue;
+        }
+        // Connections are opened by the worker when first needed
+        if (!s.mConnection)
+        {
+            s.mConnection = MySQLConnRef{new MySQLConnHnd()};
+        }
+        s.mBusy = true;
+        ++(pool->mBusy);
+        // Give the connection to the task
+        task->mPool = pool;
+        task->mConnection = s.mConnection;
+        task->mSlot = i;
+        task->mFresh = (s.mLastUsed == 0);
+        task->mPing = !task->mFresh && (FrameSlice::Now() - s.mLastUsed) >= pool->mPing;
+        // Submit the task
+        ThreadPool::Get().Enqueue(std::unique_ptr< ThreadPoolItem >{task.release()});
+        return;
+    }
+    // Wait for a connection to be released
+    pool->mWaiting.push_back(std::move(task));
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLPoolHnd::Release(const MySQLPoolRef & pool, size_t slot, bool stop)
+{
+    pool->mSlots[slot].mBusy = false;
+    --(pool->mBusy);
+    // Are we shutting down?
+    if (stop)
+    {
+        // Nothing else will run so, reject whatever is waiting
+        while (!pool->mWaiting.empty())
+        {
+            Task task = std::move(pool->mWaiting.front());
+            pool->mWaiting.pop_front();
+            // Let the owner know it will never run
+            task->mErrNo = CR_UNKNOWN_ERROR;
+            task->mError.assign("Task was cancelled");
+            ++(pool->mFailed);
+            task->Deliver(pool);
+        }
+    }
+    // Is there a task waiting for this connection?
+    else if (!pool->mWaiting.empty())
+    {
+        Task task = std::move(pool->mWaiting.front());
+        pool->mWaiting.pop_front();
+        // It was already counted once
+        --(pool->mSubmitted);
+        Submit(pool, std::move(task));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t MySQLAsyncResult::ValidColumn(SQInteger col) const
+{
+    if (col < 0 || static_cast< size_t >(col) >= m_Data->mColumns.size())
+    {
+        STHROWF("Column index is out of range: {} >= {}", col, m_Data->mColumns.size());
+    }
+    return static_cast< size_t >(col);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t MySQLAsyncResult::ValidRow(SQInteger row) const
+{
+    if (row < 0 || static_cast< size_t >(row) >= m_Data->mRows)
+    {
+        STHROWF("Row index is out of range: {} >= {}", row, m_Data->mRows);
+    }
+    return static_cast< size_t >(row);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger MySQLAsyncResult::GetColumnIndex(StackStrF & name) const
+{
+    for (size_t i = 0; i < m_Data->mColumns.size(); ++i)
+    {
+        if (m_Data->mColumns[i].mName.compare(0, String::npos, name.mPtr, static_cast< size_t >(name.mLen)) == 0)
+        {
+            return static_cast< SQInteger >(i);
+        }
+    }
+    return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLAsyncResult::GetString(SQInteger row, SQInteger col) const
+{
+    const size_t c = ValidColumn(col);
+    unsigned long len;
+    const char * v = m_Data->Value(c, ValidRow(row), len);
+    // Is the value null?
+    if (v == nullptr)
+    {
+        return LightObj{};
+    }
+    return LightObj(v, static_cast< SQInteger >(len));
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLAsyncResult::GetInteger(SQInteger row, SQInteger col) const
+{
+    const size_t c = ValidColumn(col);
+    unsigned long len;
+    const char * v = m_Data->Value(c, ValidRow(row), len);
+    // Is the value null?
+    if (v == nullptr)
+    {
+        return LightObj{};
+    }
+    return LightObj(SqInPlace{}, SqVM(), DbConvTo< SQInteger >::From(v, len, m_Data->mColumns[c].mType));
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLAsyncResult::GetFloat(SQInteger row, SQInteger col) const
+{
+    const size_t c = ValidColumn(col);
+    unsigned long len;
+    const char * v = m_Data->Value(c, ValidRow(row), len);
+    // Is the value null?
+    if (v == nullptr)
+    {
+        return LightObj{};
+    }
+    return LightObj(SqInPlace{}, SqVM(), DbConvTo< SQFloat >::From(v, len, m_Data->mColumns[c].mType));
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLAsyncResult::GetBoolean(SQInteger row, SQInteger col) const
+{
+    const size_t c = ValidColumn(col);
+    unsigned long len;
+    const char * v = m_Data->Value(c, ValidRow(row), len);
+    // Is the value null?
+    if (v == nullptr)
+    {
+        return LightObj{};
+    }
+    return LightObj(SqInPlace{}, SqVM(), DbConvTo< bool >::From(v, len, m_Data->mColumns[c].mType));
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLAsyncResult::GetValue(SQInteger row, SQInteger col) const
+{
+    // Pick the script type from the column type
+    switch (m_Data->mColumns[ValidColumn(col)].mType)
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_YEAR:
+        case MYSQL_TYPE_BIT:
+            return GetInteger(row, col);
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            return GetFloat(row, col);
+        default:
+            return GetString(row, col);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Table MySQLAsyncResult::GetRow(SQInteger row) const
+{
+    Table tbl(SqVM(), static_cast< SQInteger >(m_Data->mColumns.size()));
+    // Insert the value of each column
+    for (size_t i = 0; i < m_Data->mColumns.size(); ++i)
+    {
+        tbl.SetValue(m_Data->mColumns[i].mName.c_str(), GetValue(row, static_cast< SQInteger >(i)));
+    }
+    return tbl;
+}
+
+// ------------------------------------------------------------------------------------------------
+Array MySQLAsyncResult::GetColumn(SQInteger col) const
+{
+    Array arr(SqVM(), static_cast< SQInteger >(m_Data->mRows));
+    // Insert the value of each row
+    for (size_t i = 0; i < m_Data->mRows; ++i)
+    {
+        arr.SetValue(static_cast< SQInteger >(i), GetValue(static_cast< SQInteger >(i), col));
+    }
+    return arr;
+}
+
+// ------------------------------------------------------------------------------------------------
+MySQLAsyncBuilder::MySQLAsyncBuilder(MySQLPoolRef pool, StackStrF & sql, int32_t mode)
+    : mPool(std::move(pool)), mQuery(sql.mPtr, static_cast< size_t >(sql.mLen)), mMode(mode)
+{
+    if (mQuery.empty())
+    {
+        STHROWF("Invalid or empty MySQL query");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLAsyncBuilder::Submit_(LightObj & ctx)
+{
+    if (!mPool)
+    {
+        STHROWF("Asynchronous query builder instance is invalid.");
+    }
+    MySQLPoolHnd::Task task{new MySQLAsyncTask()};
+    // Populate task information
+    task->mResolved = std::move(mResolved);
+    task->mRejected = std::move(mRejected);
+    task->mQuery = std::move(mQuery);
+    task->mParams = std::move(mParams);
+    task->mMode = mMode;
+    task->mPrepared = mPrepared;
+    task->mCtx = std::move(ctx);
+    // The builder can only be used once
+    MySQLPoolRef pool = std::move(mPool);
+    // Submit the task
+    MySQLPoolHnd::Submit(pool, std::move(task));
+}
+
+// ------------------------------------------------------------------------------------------------
+MySQLAsyncBuilder & MySQLAsyncBuilder::Bind(Array & params)
+{
+    std::vector< MySQLAsyncParam > list;
+    // Capture the values while we're on the main thread
+    params.Foreach([&list](HSQUIRRELVM vm, SQInteger i) -> SQRESULT {
+        MySQLAsyncParam p;
+        switch (sq_gettype(vm, -1))
+        {
+            case OT_NULL: break;
+            case OT_INTEGER:
+            {
+                SQInteger v;
+                sq_getinteger(vm, -1, &v);
+                p.mType = MYSQL_TYPE_LONGLONG;
+                p.mInt = static_cast< int64_t >(v);
+            } break;
+            case OT_FLOAT:
+            {
+                SQFloat v;
+                sq_getfloat(vm, -1, &v);
+                p.mType = MYSQL_TYPE_DOUBLE;
+                p.mFloat = static_cast< double >(v);
+            } break;
+            case OT_BOOL:
+            {
+                SQBool v;
+                sq_getbool(vm, -1, &v);
+                p.mType = MYSQL_TYPE_TINY;
+                p.mInt = v ? 1 : 0;
+            } break;
+            case OT_STRING:
+            {
+                const SQChar * v = nullptr;
+                SQInteger n = 0;
+                sq_getstringandsize(vm, -1, &v, &n);
+                p.mType = MYSQL_TYPE_STRING;
+                p.mStr.assign(v, static_cast< size_t >(n));
+            } break;
+            default: STHROWF("Can't bind ({}) values at index {}", SqTypeName(sq_gettype(vm, -1)), i);
+        }
+        list.push_back(std::move(p));
+        return SQ_OK;
+    });
+    mParams = std::move(list);
+    mPrepared = true;
+    return *this; // Allow chaining
+}
+
+// ------------------------------------------------------------------------------------------------
+MySQLPool::MySQLPool(const MySQLAccount & acc, SQInteger size)
+    : m_Handle()
+{
+    if (size <= 0 || static_cast< size_t >(size) > MYSQL_POOL_MAX_SIZE)
+    {
+        STHROWF("Pool size ({}) must be between 1 and {}", size, MYSQL_POOL_MAX_SIZE);
+    }
+    m_Handle = MySQLPoolRef{new MySQLPoolHnd(acc, static_cast< size_t >(size))};
+}
+
+// ------------------------------------------------------------------------------------------------
+void MySQLPool::SetPingInterval(SQInteger ms)
+{
+    if (ms < 0)
+    {
+        STHROWF("Ping interval ({}) cannot be negative", ms);
+    }
+    m_Handle->mPing = static_cast< int64_t >(ms) * 1000;
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLPool::Execute(StackStrF & sql) const
+{
+    return LightObj{SqTypeIdentity< MySQLAsyncBuilder >{}, SqVM(), m_Handle, sql, MYSQL_ASYNC_EXECUTE};
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLPool::Insert(StackStrF & sql) const
+{
+    return LightObj{SqTypeIdentity< MySQLAsyncBuilder >{}, SqVM(), m_Handle, sql, MYSQL_ASYNC_INSERT};
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj MySQLPool::Query(StackStrF & sql) const
+{
+    return LightObj{SqTypeIdentity< MySQLAsyncBuilder >{}, SqVM(), m_Handle, sql, MYSQL_ASYNC_QUERY};
+}
+
+// ================================================================================================
+void Register_MySQLPool(HSQUIRRELVM vm, Table & sqlns)
+{
+    // Pool workers call mysql_init() concurrently, which is only safe once the library was initialized
+    if (mysql_library_init(0, nullptr, nullptr) != 0)
+    {
+        STHROWF("Unable to initialize the MySQL client library");
+    }
+    sqlns.Bind(_SC("Pool"),
+        Class< MySQLPool >(vm, SqMySQLPool::Str)
+        // Constructors
+        .Ctor< const MySQLAccount &, SQInteger >()
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &SqMySQLPool::Fn)
+        // Properties
+        .Prop(_SC("Size"), &MySQLPool::GetSize)
+        .Prop(_SC("Busy"), &MySQLPool::GetBusy)
+        .Prop(_SC("Waiting"), &MySQLPool::GetWaiting)
+        .Prop(_SC("Submitted"), &MySQLPool::GetSubmitted)
+        .Prop(_SC("Completed"), &MySQLPool::GetCompleted)
+        .Prop(_SC("Failed"), &MySQLPool::GetFailed)
+        .Prop(_SC("Reconnects"), &MySQLPool::GetReconnects)
+        .Prop(_SC("PingInterval"), &MySQLPool::GetPingInterval, &MySQLPool::SetPingInterval)
+        // Member Methods
+        .FmtFunc(_SC("Execute"), &MySQLPool::Execute)
+        .FmtFunc(_SC("Insert"), &MySQLPool::Insert)
+        .FmtFunc(_SC("Query"), &MySQLPool::Query)
+    );
+
+    sqlns.Bind(_SC("AsyncBuilder"),
+        Class< MySQLAsyncBuilder, NoConstructor< MySQLAsyncBuilder > >(vm, SqMySQLAsyncBuilder::Str)
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &SqMySQLAsyncBuilder::Fn)
+        // Member Methods
+        .CbFunc(_SC("Resolved"), &MySQLAsyncBuilder::OnResolved)
+        .CbFunc(_SC("Rejected"), &MySQLAsyncBuilder::OnRejected)
+        .Func(_SC("Bind"), &MySQLAsyncBuilder::Bind)
+        // Overloaded Member Methods
+        .Overload(_SC("Submit"), &MySQLAsyncBuilder::Submit)
+        .Overload(_SC("Submit"), &MySQLAsyncBuilder::Submit_)
+    );
+
+    sqlns.Bind(_SC("AsyncResult"),
+        Class< MySQLAsyncResult, NoConstructor< MySQLAsyncResult > >(vm, SqMySQLAsyncResult::Str)
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &SqMySQLAsyncResult::Fn)
+        // Properties
+        .Prop(_SC("Rows"), &MySQLAsyncResult::GetRows)
+        .Prop(_SC("Columns"), &MySQLAsyncResult::GetColumns)
+        .Prop(_SC("AffectedRows"), &MySQLAsyncResult::GetAffectedRows)
+        .Prop(_SC("InsertId"), &MySQLAsyncResult::GetInsertId)
+        // Member Methods
+        .Func(_SC("ColumnName"), &MySQLAsyncResult::GetColumnName)
+        .Func(_SC("ColumnType"), &MySQLAsyncResult::GetColumnType)
+        .Func(_SC("ColumnTypename"), &MySQLAsyncResult::GetColumnTypename)
+        .FmtFunc(_SC("ColumnIndex"), &MySQLAsyncResult::GetColumnIndex)
+        .Func(_SC("IsNull"), &MySQLAsyncResult::IsNull)
+        .Func(_SC("GetString"), &MySQLAsyncResult::GetString)
+        .Func(_SC("GetInteger"), &MySQLAsyncResult::GetInteger)
+        .Func(_SC("GetFloat"), &MySQLAsyncResult::GetFloat)
+        .Func(_SC("GetBoolean"), &MySQLAsyncResult::GetBoolean)
+        .Func(_SC("GetValue"), &MySQLAsyncResult::GetValue)
+        .Func(_SC("GetRow"), &MySQLAsyncResult::GetRow)
+        .Func(_SC("GetColumn"), &MySQLAsyncResult::GetColumn)
+    );
+}
+
+} // Namespace:: SqMod
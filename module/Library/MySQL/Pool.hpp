@@ -0,0 +1,540 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "Library/MySQL.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <deque>
+#include <memory>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+struct MySQLPoolHnd;
+struct MySQLAsyncTask;
+struct MySQLResultData;
+
+/* ------------------------------------------------------------------------------------------------
+ * Common typedefs.
+*/
+typedef SharedPtr< MySQLPoolHnd > MySQLPoolRef;
+typedef SharedPtr< MySQLResultData > MySQLResultDataRef;
+
+/* ------------------------------------------------------------------------------------------------
+ * Result-set materialized by a worker thread. Each column keeps its values as text in a single
+ * buffer, one after the other, and they are only converted when a script asks for them.
+*/
+struct MySQLResultData
+{
+    /* --------------------------------------------------------------------------------------------
+     * The values of a single column.
+    */
+    struct Column
+    {
+        String                  mName{}; // The name of the column.
+        enum_field_types        mType{MYSQL_TYPE_NULL}; // The type of the column.
+        std::vector< char >     mData{}; // Null terminated values, one after the other.
+        std::vector< uint32_t > mOffsets{}; // Where each value begins, followed by where the last one ends.
+        std::vector< bool >     mNulls{}; // Whether each value is null.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< Column >   mColumns{}; // The columns of the result-set.
+    size_t                  mRows{0}; // Number of rows in the result-set.
+    uint64_t                mAffected{0}; // Rows affected by the query.
+    uint64_t                mInsertId{0}; // Identifier generated by the query, if any.
+
+    /* --------------------------------------------------------------------------------------------
+     * Prepare the columns for the specified fields and number of rows.
+    */
+    void Init(const MYSQL_FIELD * fields, unsigned int count, size_t rows);
+
+    /* --------------------------------------------------------------------------------------------
+     * Append a value to a column. A null pointer is stored as a null value.
+    */
+    void Append(size_t col, const char * value, size_t length);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy the rows of a buffered result-set.
+    */
+    void FromResult(MYSQL_RES * res);
+
+    /* --------------------------------------------------------------------------------------------
+     * Fetch the rows of an executed statement. Values are received as text, like a regular query.
+    */
+    void FromStatement(MySQLStmtHnd & stmt);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value and its length. Returns null if the value is null.
+    */
+    SQMOD_NODISCARD const char * Value(size_t col, size_t row, unsigned long & length) const
+    {
+        const Column & c = mColumns[col];
+        // Is the value null?
+        if (c.mNulls[row])
+        {
+            length = 0;
+            return nullptr;
+        }
+        // The terminator is not part of the value
+        length = static_cast< unsigned long >(c.mOffsets[row + 1] - c.mOffsets[row] - 1);
+        return c.mData.data() + c.mOffsets[row];
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Parameter of an asynchronous statement, captured on the main thread.
+*/
+struct MySQLAsyncParam
+{
+    enum_field_types    mType{MYSQL_TYPE_NULL}; // The type of the parameter.
+    int64_t             mInt{0}; // Integer and boolean values.
+    double              mFloat{0}; // Floating point values.
+    String              mStr{}; // String values.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * The structure that holds the data associated with a pool of connections. Only accessed from
+ * the main thread, except for the connection of a slot while a task is using it.
+*/
+struct MySQLPoolHnd
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr int64_t DEFAULT_PING = 30000000; // Idle microseconds before a connection is checked.
+
+    /* --------------------------------------------------------------------------------------------
+     * A connection of the pool.
+    */
+    struct Slot
+    {
+        MySQLConnRef    mConnection{}; // The connection, opened by the first task that uses it.
+        int64_t         mLastUsed{0}; // Time-point when the connection was last used.
+        bool            mBusy{false}; // Whether a task is using the connection.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unique_ptr< MySQLAsyncTask > Task; // Owning pointer of a task.
+
+    // --------------------------------------------------------------------------------------------
+    MySQLAccount        mAccount; // The account used to open the connections.
+    std::vector< Slot > mSlots; // The connections of the pool.
+    std::deque< Task >  mWaiting; // Tasks waiting for a connection.
+
+    // --------------------------------------------------------------------------------------------
+    int64_t             mPing; // Idle microseconds before a connection is checked before use.
+    size_t              mBusy; // Number of connections in use.
+
+    // --------------------------------------------------------------------------------------------
+    uint64_t            mSubmitted; // Tasks that were submitted.
+    uint64_t            mCompleted; // Tasks that succeeded.
+    uint64_t            mFailed; // Tasks that failed.
+    uint64_t            mReconnects; // Connections that had to be opened again.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    MySQLPoolHnd(const MySQLAccount & acc, size_t size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    MySQLPoolHnd(const MySQLPoolHnd & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    MySQLPoolHnd(MySQLPoolHnd && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~MySQLPoolHnd();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    MySQLPoolHnd & operator = (const MySQLPoolHnd & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    MySQLPoolHnd & operator = (MySQLPoolHnd && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Give a task to the first free connection or leave it waiting for one.
+    */
+    static void Submit(const MySQLPoolRef & pool, Task && task);
+
+    /* --------------------------------------------------------------------------------------------
+     * A task finished with a connection. Hands it to the next waiting task, if any.
+    */
+    static void Release(const MySQLPoolRef & pool, size_t slot, bool stop);
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Read-only view of a result-set that was materialized by a worker thread.
+*/
+class MySQLAsyncResult
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    MySQLResultDataRef m_Data{}; // The materialized result-set.
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate a column index and throw an error if invalid.
+    */
+    SQMOD_NODISCARD size_t ValidColumn(SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate a row index and throw an error if invalid.
+    */
+    SQMOD_NODISCARD size_t ValidRow(SQInteger row) const;
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit MySQLAsyncResult(MySQLResultDataRef data)
+        : m_Data(std::move(data))
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor.
+    */
+    MySQLAsyncResult(const MySQLAsyncResult & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor.
+    */
+    MySQLAsyncResult(MySQLAsyncResult && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator.
+    */
+    MySQLAsyncResult & operator = (const MySQLAsyncResult & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator.
+    */
+    MySQLAsyncResult & operator = (MySQLAsyncResult && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of rows.
+    */
+    SQMOD_NODISCARD SQInteger GetRows() const
+    {
+        return static_cast< SQInteger >(m_Data->mRows);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of columns.
+    */
+    SQMOD_NODISCARD SQInteger GetColumns() const
+    {
+        return static_cast< SQInteger >(m_Data->mColumns.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of rows affected by the query.
+    */
+    SQMOD_NODISCARD SQInteger GetAffectedRows() const
+    {
+        return static_cast< SQInteger >(m_Data->mAffected);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the identifier generated by the query, if any.
+    */
+    SQMOD_NODISCARD SQInteger GetInsertId() const
+    {
+        return static_cast< SQInteger >(m_Data->mInsertId);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the name of a column.
+    */
+    SQMOD_NODISCARD const String & GetColumnName(SQInteger col) const
+    {
+        return m_Data->mColumns[ValidColumn(col)].mName;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the type of a column.
+    */
+    SQMOD_NODISCARD SQInteger GetColumnType(SQInteger col) const
+    {
+        return static_cast< SQInteger >(m_Data->mColumns[ValidColumn(col)].mType);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the name of the type of a column.
+    */
+    SQMOD_NODISCARD const SQChar * GetColumnTypename(SQInteger col) const
+    {
+        return SqMySQLTypename(m_Data->mColumns[ValidColumn(col)].mType);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of the column with the specified name. Returns -1 if there is none.
+    */
+    SQMOD_NODISCARD SQInteger GetColumnIndex(StackStrF & name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a value is null.
+    */
+    SQMOD_NODISCARD bool IsNull(SQInteger row, SQInteger col) const
+    {
+        const size_t c = ValidColumn(col);
+        return m_Data->mColumns[c].mNulls[ValidRow(row)];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value as a string, or null.
+    */
+    SQMOD_NODISCARD LightObj GetString(SQInteger row, SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value as an integer, or null.
+    */
+    SQMOD_NODISCARD LightObj GetInteger(SQInteger row, SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value as a floating point number, or null.
+    */
+    SQMOD_NODISCARD LightObj GetFloat(SQInteger row, SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value as a boolean, or null.
+    */
+    SQMOD_NODISCARD LightObj GetBoolean(SQInteger row, SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a value converted to the script type that best matches the column type.
+    */
+    SQMOD_NODISCARD LightObj GetValue(SQInteger row, SQInteger col) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the values of a row as a table where the keys are the column names.
+    */
+    SQMOD_NODISCARD Table GetRow(SQInteger row) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the values of a column as an array.
+    */
+    SQMOD_NODISCARD Array GetColumn(SQInteger col) const;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Collects the information of an asynchronous request until it is submitted to the pool.
+*/
+struct MySQLAsyncBuilder
+{
+    // --------------------------------------------------------------------------------------------
+    MySQLPoolRef                    mPool{}; // The pool that will run the task.
+    // --------------------------------------------------------------------------------------------
+    Function                        mResolved{}; // Callback to invoke when the task was completed.
+    Function                        mRejected{}; // Callback to invoke when the task failed.
+    // --------------------------------------------------------------------------------------------
+    String                          mQuery{}; // The query string that will be executed.
+    std::vector< MySQLAsyncParam >  mParams{}; // Statement parameters, if any.
+    int32_t                         mMode{0}; // What the task should produce.
+    bool                            mPrepared{false}; // Whether the query runs as a prepared statement.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    MySQLAsyncBuilder(MySQLPoolRef pool, StackStrF & sql, int32_t mode);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    MySQLAsyncBuilder(const MySQLAsyncBuilder & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor.
+    */
+    MySQLAsyncBuilder(MySQLAsyncBuilder && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    MySQLAsyncBuilder & operator = (const MySQLAsyncBuilder & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator.
+    */
+    MySQLAsyncBuilder & operator = (MySQLAsyncBuilder && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Create the task with the supplied information and submit it to the pool.
+    */
+    void Submit() { Submit_(NullLightObj()); }
+
+    /* --------------------------------------------------------------------------------------------
+     * Create the task with the supplied information and submit it to the pool.
+    */
+    void Submit_(LightObj & ctx);
+
+    /* --------------------------------------------------------------------------------------------
+     * Set the callback to be executed if the query was resolved.
+    */
+    MySQLAsyncBuilder & OnResolved(Function & cb)
+    {
+        mResolved = std::move(cb);
+        return *this; // Allow chaining
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Set the callback to be executed if the query was rejected/failed.
+    */
+    MySQLAsyncBuilder & OnRejected(Function & cb)
+    {
+        mRejected = std::move(cb);
+        return *this; // Allow chaining
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Run the query as a prepared statement with the values of the array as parameters.
+    */
+    MySQLAsyncBuilder & Bind(Array & params);
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Pool of connections which run queries on the worker threads and deliver the outcome on the
+ * main thread.
+*/
+class MySQLPool
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    MySQLPoolRef m_Handle{}; // Reference to the actual pool.
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    MySQLPool(const MySQLAccount & acc, SQInteger size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Handle constructor.
+    */
+    explicit MySQLPool(MySQLPoolRef hnd)
+        : m_Handle(std::move(hnd))
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor.
+    */
+    MySQLPool(const MySQLPool & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor.
+    */
+    MySQLPool(MySQLPool && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator.
+    */
+    MySQLPool & operator = (const MySQLPool & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator.
+    */
+    MySQLPool & operator = (MySQLPool && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of connections.
+    */
+    SQMOD_NODISCARD SQInteger GetSize() const
+    {
+        return static_cast< SQInteger >(m_Handle->mSlots.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of connections in use.
+    */
+    SQMOD_NODISCARD SQInteger GetBusy() const
+    {
+        return static_cast< SQInteger >(m_Handle->mBusy);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of tasks waiting for a connection.
+    */
+    SQMOD_NODISCARD SQInteger GetWaiting() const
+    {
+        return static_cast< SQInteger >(m_Handle->mWaiting.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of submitted tasks.
+    */
+    SQMOD_NODISCARD SQInteger GetSubmitted() const
+    {
+        return static_cast< SQInteger >(m_Handle->mSubmitted);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of tasks that succeeded.
+    */
+    SQMOD_NODISCARD SQInteger GetCompleted() const
+    {
+        return static_cast< SQInteger >(m_Handle->mCompleted);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of tasks that failed.
+    */
+    SQMOD_NODISCARD SQInteger GetFailed() const
+    {
+        return static_cast< SQInteger >(m_Handle->mFailed);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of connections that had to be opened again.
+    */
+    SQMOD_NODISCARD SQInteger GetReconnects() const
+    {
+        return static_cast< SQInteger >(m_Handle->mReconnects);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the idle milliseconds after which a connection is checked before use.
+    */
+    SQMOD_NODISCARD SQInteger GetPingInterval() const
+    {
+        return static_cast< SQInteger >(m_Handle->mPing / 1000);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the idle milliseconds after which a connection is checked before use.
+    */
+    void SetPingInterval(SQInteger ms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a request that executes a query and receives the number of affected rows.
+    */
+    SQMOD_NODISCARD LightObj Execute(StackStrF & sql) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a request that executes a query and receives the identifier of the inserted row.
+    */
+    SQMOD_NODISCARD LightObj Insert(StackStrF & sql) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a request that executes a query and receives the result-set.
+    */
+    SQMOD_NODISCARD LightObj Query(StackStrF & sql) const;
+};
+
+} // Namespace:: SqMod
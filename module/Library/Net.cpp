@@ -1,5 +1,6 @@
 // ------------------------------------------------------------------------------------------------
 #include "Library/Net.hpp"
+#include "Library/Net/Server.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <sqratConst.h>
@@ -10,6 +11,9 @@ namespace SqMod {
 // ------------------------------------------------------------------------------------------------
 SQMOD_DECL_TYPENAME(SqWebSocketClient, _SC("SqWebSocketClient"))
 
+// ------------------------------------------------------------------------------------------------
+extern void Register_NetServer(HSQUIRRELVM vm, Table & ns);
+
 // ------------------------------------------------------------------------------------------------
 static std::thread::id sMainThreadID{}; // Main thread ID
 
@@ -60,16 +64,28 @@ void TerminateNet()
     {
         inst->Terminate(); // Terminate() the connection
     }
+    // Go over all servers and stop them
+    for (HttpServer * inst = HttpServer::sHead; inst && inst->mNext != HttpServer::sHead; inst = inst->mNext)
+    {
+        inst->Terminate(); // Terminate() the server
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
-void ProcessNet()
+size_t ProcessNet(FrameSlice & slice)
 {
+    static size_t s_Clients = 0, s_Servers = 0;
+    size_t left = 0;
     // Go over all connections and allow them to process data
-    for (WebSocketClient * inst = WebSocketClient::sHead; inst && inst->mNext != WebSocketClient::sHead; inst = inst->mNext)
-    {
-        inst->Process();
-    }
+    left += ProcessChain< WebSocketClient >(s_Clients, slice, [&slice](WebSocketClient & inst) -> size_t {
+        return inst.Process(slice);
+    });
+    // Go over all servers and allow them to process requests
+    left += ProcessChain< HttpServer >(s_Servers, slice, [&slice](HttpServer & inst) -> size_t {
+        return inst.Process(slice);
+    });
+    // Return what was left for later
+    return left;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -125,16 +141,182 @@ WebSocketClient & WebSocketClient::ConnectExt()
     return *this;
 }
 
+// ------------------------------------------------------------------------------------------------
+size_t WebSocketClient::Process(FrameSlice & slice, bool force)
+{
+    // Is there a valid connection?
+    if (mHandle == nullptr && !force)
+    {
+        return 0; // No point in going forward
+    }
+    Frame frame;
+    // See if connection is closing
+    const bool closing = mClosing.load();
+    // Is the connection closing?
+    if (closing)
+    {
+        mHandle = nullptr; // Prevent further use
+    }
+    // Should the frames be delivered together?
+    if (!mOnBatch.IsNull())
+    {
+        // Collect the frames that fit in the slice. The slice is ignored when closing
+        // because there would be no other chance to process the remaining frames
+        if ((closing || slice.Allow()) && mQueue.try_dequeue(frame))
+        {
+            // The arrays are only created when there is something to deliver
+            Array buffers(SqVM()), sizes(SqVM()), flags(SqVM());
+            do {
+                slice.Count();
+                // Backup the frame size before giving away the buffer
+                sizes.Append(static_cast< SQInteger >(frame.mData.Position()));
+                // Transform the buffer into a script object
+                buffers.Append(LightObj(SqTypeIdentity< SqBuffer >{}, SqVM(), std::move(frame.mData)));
+                flags.Append(static_cast< SQInteger >(frame.mFlags));
+            } while ((closing || slice.Allow()) && mQueue.try_dequeue(frame));
+            // Deliver them together
+            mOnBatch.Execute(buffers, sizes, flags);
+        }
+    }
+    else
+    {
+        // Retrieve each frame individually and process it. The slice is ignored when closing
+        // because there would be no other chance to process the remaining frames
+        for (size_t count = mQueue.size_approx(), n = 0; n <= count && (closing || slice.Allow()); ++n)
+        {
+            // Try to get a frame from the queue
+            if (!mQueue.try_dequeue(frame))
+            {
+                continue;
+            }
+            slice.Count();
+            // Is there a callback to receive it?
+            if (!mOnData.IsNull())
+            {
+                // Backup the frame size before giving away the buffer
+                const auto size = static_cast< SQInteger >(frame.mData.Position());
+                // Transform the buffer into a script object
+                LightObj obj(SqTypeIdentity< SqBuffer >{}, SqVM(), std::move(frame.mData));
+                // Forward the event to the callback
+                mOnData.Execute(obj, size, frame.mFlags);
+            }
+        }
+    }
+    // Is the server closing the connection?
+    if (closing && !mClosed.load() && !mOnClose.IsNull())
+    {
+        // Let the user know
+        mOnClose.Execute();
+        // Prevent calling this callback again
+        mClosed.store(true);
+    }
+    // Whatever is left is carried over
+    return mQueue.size_approx();
+}
+
+// ------------------------------------------------------------------------------------------------
+void WebSocketClient::Enqueue(Frame && frame)
+{
+    const size_t limit = mQueueLimit.load();
+    // Is there room for a data frame?
+    if (limit && (frame.mFlags & 0xF) < MG_WEBSOCKET_OPCODE_CONNECTION_CLOSE && mQueue.size_approx() >= limit)
+    {
+        ++mDropped;
+        // Leave it to the caller
+        return;
+    }
+    // Queue the frame
+    mQueue.enqueue(std::move(frame));
+    // Remember how far the queue got
+    const size_t depth = mQueue.size_approx();
+    if (depth > mPeakDepth.load())
+    {
+        mPeakDepth.store(depth);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void WebSocketClient::Assemble(int flags, const char * data, size_t size)
+{
+    const bool fin = (flags & 0x80) != 0;
+    // Is this the beginning of a message?
+    if ((flags & 0xF) != MG_WEBSOCKET_OPCODE_CONTINUATION)
+    {
+        // A message that never finished is dropped
+        if (mAssemblyState == AsmActive)
+        {
+            ++mDropped;
+        }
+        mAssembly = Frame();
+        mAssemblyState = AsmNone;
+        // Is this message fragmented?
+        if (fin)
+        {
+            Enqueue(Frame(data, size, flags));
+        }
+        else
+        {
+            mAssembly = Frame(data, size, flags);
+            mAssemblyState = AsmActive;
+        }
+        return;
+    }
+    // Is there a message to continue?
+    else if (mAssemblyState == AsmNone)
+    {
+        Enqueue(Frame(data, size, flags)); // Deliver it as it is
+        return;
+    }
+    // Would the message become too large?
+    else if (mAssemblyState == AsmActive && (mAssembly.mData.Position() + size) > MAX_MESSAGE)
+    {
+        ++mDropped;
+        // Release what was received so far and ignore the rest
+        mAssembly = Frame();
+        mAssemblyState = AsmDiscard;
+    }
+    // Add the fragment to the message
+    if (mAssemblyState == AsmActive && size != 0)
+    {
+        mAssembly.mData.Append(data, static_cast< Buffer::SzType >(size));
+    }
+    // Was this the last fragment?
+    if (fin)
+    {
+        // Is there a message to deliver?
+        if (mAssemblyState == AsmActive)
+        {
+            // The message is now complete
+            mAssembly.mFlags |= 0x80;
+            // Appending grows the buffer ahead of the data
+            mAssembly.Fit();
+            Enqueue(std::move(mAssembly));
+        }
+        mAssembly = Frame();
+        mAssemblyState = AsmNone;
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 int WebSocketClient::DataHandler(int flags, char * data, size_t data_len) noexcept
 {
+    ++mReceived;
     // Create a frame instance to store information and queue it
     try
     {
-        mQueue.enqueue(std::make_unique< Frame >(data, data_len, flags));
+        // Should data frames be put back together? Control frames are never fragmented
+        if (mReassemble.load() && (flags & 0xF) < MG_WEBSOCKET_OPCODE_CONNECTION_CLOSE)
+        {
+            Assemble(flags, data, data_len);
+        }
+        else
+        {
+            Enqueue(Frame(data, data_len, flags));
+        }
     }
     catch(...)
     {
+        ++mDropped;
         LogFtl("Failed to queue web-socket data");
     }
     // Should we auto-close the connection
@@ -181,6 +363,13 @@ void Register_Net(HSQUIRRELVM vm)
         .Prop(_SC("Valid"), &WebSocketClient::IsValid)
         .Prop(_SC("Closing"), &WebSocketClient::IsClosing)
         .Prop(_SC("AutoClose"), &WebSocketClient::GetAutoClose, &WebSocketClient::SetAutoClose)
+        .Prop(_SC("OnBatch"), &WebSocketClient::GetOnBatch, &WebSocketClient::SetOnBatch)
+        .Prop(_SC("Reassemble"), &WebSocketClient::GetReassemble, &WebSocketClient::SetReassemble)
+        .Prop(_SC("QueueLimit"), &WebSocketClient::GetQueueLimit, &WebSocketClient::SetQueueLimit)
+        .Prop(_SC("QueueDepth"), &WebSocketClient::GetQueueDepth)
+        .Prop(_SC("PeakDepth"), &WebSocketClient::GetPeakDepth)
+        .Prop(_SC("Received"), &WebSocketClient::GetReceived)
+        .Prop(_SC("Dropped"), &WebSocketClient::GetDropped)
         // Member Methods
         .FmtFunc(_SC("SetTag"), &WebSocketClient::ApplyTag)
         .FmtFunc(_SC("SetData"), &WebSocketClient::ApplyData)
@@ -192,14 +381,18 @@ void Register_Net(HSQUIRRELVM vm)
         .FmtFunc(_SC("SetExtensions"), &WebSocketClient::ApplyExtensions)
         .CbFunc(_SC("BindOnData"), &WebSocketClient::BindOnData)
         .CbFunc(_SC("BindOnClose"), &WebSocketClient::BindOnClose)
+        .CbFunc(_SC("BindOnBatch"), &WebSocketClient::BindOnBatch)
         .Func(_SC("Connect"), &WebSocketClient::Connect)
         .Func(_SC("ConnectExt"), &WebSocketClient::ConnectExt)
         .Func(_SC("SendOpCode"), &WebSocketClient::SendOpCode)
         .Func(_SC("SendBuffer"), &WebSocketClient::SendBuffer)
         .FmtFunc(_SC("SendString"), &WebSocketClient::SendString)
         .Func(_SC("Close"), &WebSocketClient::Close)
+        .Func(_SC("ResetStats"), &WebSocketClient::ResetStats)
     );
     // --------------------------------------------------------------------------------------------
+    Register_NetServer(vm, ns);
+    // --------------------------------------------------------------------------------------------
     RootTable(vm).Bind(_SC("SqNet"), ns);
     // --------------------------------------------------------------------------------------------
     ConstTable(vm).Enum(_SC("SqWsOpCode"), Enumeration(vm)
@@ -2,9 +2,11 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Library/IO/Buffer.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <atomic>
+#include <cstring>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqratFunction.h>
@@ -21,19 +23,15 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
 {
     using Base = SqChainedInstances< WebSocketClient >;
     /* --------------------------------------------------------------------------------------------
-     * WebSocket frame.
+     * WebSocket frame. Stored by value in the queue, whose blocks are reused, while the payload
+     * is allocated with the exact size of the frame and handed to the script without another copy.
     */
     struct Frame
     {
         /* ----------------------------------------------------------------------------------------
-         * Frame data.
+         * Frame data. The cursor is placed after the data.
         */
-        char * mData{nullptr};
-
-        /* ----------------------------------------------------------------------------------------
-         * Frame data capacity.
-        */
-        uint32_t mSize{0};
+        Buffer mData{};
 
         /* ----------------------------------------------------------------------------------------
          * Frame flags.
@@ -48,16 +46,29 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
         /* ----------------------------------------------------------------------------------------
          * Explicit constructor.
         */
-        Frame(char * data, size_t size, int flags)
-            : mData(nullptr), mSize(static_cast< uint32_t >(size)), mFlags(flags)
+        Frame(const char * data, size_t size, int flags)
+            : mData(), mFlags(flags)
         {
             // Do we need to allocate a buffer?
-            if (mSize != 0)
+            if (size != 0)
             {
-                // Allocate the memory buffer.
-                mData = new char[mSize];
-                // Copy the data into the buffer we own
-                std::memcpy(mData, data, mSize);
+                const auto n = static_cast< Buffer::SzType >(size);
+                // Pooled buffers are rounded up, which would give the script a larger buffer
+                mData = Buffer(new Buffer::Value[n], n, n, Buffer::OwnIt{});
+                std::memcpy(mData.Data(), data, size);
+            }
+        }
+
+        /* ----------------------------------------------------------------------------------------
+         * Make the size of the buffer match the data that was written into it.
+        */
+        void Fit()
+        {
+            // Is there any excess capacity?
+            if (mData.Position() != mData.Capacity())
+            {
+                Frame f(mData.Data(), mData.Position(), mFlags);
+                mData = std::move(f.mData);
             }
         }
 
@@ -67,17 +78,14 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
         Frame(const Frame & o) = delete;
 
         /* ----------------------------------------------------------------------------------------
-         * Move constructor (disabled).
+         * Move constructor.
         */
-        Frame(Frame && o) noexcept = delete;
+        Frame(Frame && o) noexcept = default;
 
         /* ----------------------------------------------------------------------------------------
          * Destructor.
         */
-        ~Frame()
-        {
-            delete[] mData;
-        }
+        ~Frame() = default;
 
         /* ----------------------------------------------------------------------------------------
          * Copy assignment operator (disabled).
@@ -85,29 +93,25 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
         Frame & operator = (const Frame & o) = delete;
 
         /* ----------------------------------------------------------------------------------------
-         * Move assignment operator (disabled).
-        */
-        Frame & operator = (Frame && o) noexcept = delete;
-
-        /* ----------------------------------------------------------------------------------------
-         * Forget about the associated memory buffer.
+         * Move assignment operator.
         */
-        void ForgetBuffer() noexcept
-        {
-            mData = nullptr;
-            mSize = 0;
-        }
+        Frame & operator = (Frame && o) noexcept = default;
     };
 
     /* --------------------------------------------------------------------------------------------
-     * Smart frame pointer.
+     * Queue of frames written from other threads.
     */
-    using FramePtr = std::unique_ptr< Frame >;
+    using FrameQueue = moodycamel::ConcurrentQueue< Frame >;
 
     /* --------------------------------------------------------------------------------------------
-     * Queue of frames written from other threads.
+     * Largest message that can be put back together from fragments.
+    */
+    static constexpr size_t MAX_MESSAGE = 0x7FFFFFFF;
+
+    /* --------------------------------------------------------------------------------------------
+     * State of the message being put back together.
     */
-    using FrameQueue = moodycamel::ConcurrentQueue< FramePtr >;
+    enum AssemblyState { AsmNone = 0, AsmActive, AsmDiscard };
 
     /* --------------------------------------------------------------------------------------------
      * Connection handle.
@@ -119,11 +123,51 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
     */
     FrameQueue mQueue{1024};
 
+    /* --------------------------------------------------------------------------------------------
+     * Message being put back together from fragments. (connection thread only)
+    */
+    Frame mAssembly{};
+
+    /* --------------------------------------------------------------------------------------------
+     * State of the message being put back together. (connection thread only)
+    */
+    AssemblyState mAssemblyState{AsmNone};
+
+    /* --------------------------------------------------------------------------------------------
+     * Whether fragmented messages are put back together before they are queued.
+    */
+    std::atomic< bool > mReassemble{false};
+
+    /* --------------------------------------------------------------------------------------------
+     * Maximum number of queued frames. Data frames above this are dropped. Zero if unlimited.
+    */
+    std::atomic< size_t > mQueueLimit{0};
+
+    /* --------------------------------------------------------------------------------------------
+     * Number of frames received from the server.
+    */
+    std::atomic< uint64_t > mReceived{0};
+
+    /* --------------------------------------------------------------------------------------------
+     * Number of frames or messages that were dropped.
+    */
+    std::atomic< uint64_t > mDropped{0};
+
+    /* --------------------------------------------------------------------------------------------
+     * Highest number of frames that were waiting in the queue.
+    */
+    std::atomic< size_t > mPeakDepth{0};
+
     /* --------------------------------------------------------------------------------------------
      * Callback to invoke when receiving data.
     */
     Function mOnData{};
 
+    /* --------------------------------------------------------------------------------------------
+     * Callback to invoke with all the frames that are pending, instead of one at a time.
+    */
+    Function mOnBatch{};
+
     /* --------------------------------------------------------------------------------------------
      * Callback to invoke when the socket is shutting down.
     */
@@ -190,7 +234,8 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
      * Default constructor.
     */
     WebSocketClient()
-        : Base(), mHandle(nullptr), mQueue(1024), mOnData(), mOnClose(), mTag(), mData()
+        : Base(), mHandle(nullptr), mQueue(1024), mAssembly(), mAssemblyState(AsmNone), mReassemble(false)
+        , mQueueLimit(0), mReceived(0), mDropped(0), mPeakDepth(0), mOnData(), mOnBatch(), mOnClose(), mTag(), mData()
         , mPort(0), mSecure(false), mClosing(false), mClosed(false), mAutoClose(false)
         , mHost(), mPath(), mOrigin(), mExtensions()
     {
@@ -201,7 +246,8 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
      * Explicit constructor.
     */
     WebSocketClient(StackStrF & host, uint16_t port, StackStrF & path)
-        : Base(), mHandle(nullptr), mQueue(1024), mOnData(), mOnClose(), mTag(), mData()
+        : Base(), mHandle(nullptr), mQueue(1024), mAssembly(), mAssemblyState(AsmNone), mReassemble(false)
+        , mQueueLimit(0), mReceived(0), mDropped(0), mPeakDepth(0), mOnData(), mOnBatch(), mOnClose(), mTag(), mData()
         , mPort(port), mSecure(false), mClosing(false), mClosed(false), mAutoClose(false)
         , mHost(host.mPtr, host.GetSize())
         , mPath(path.mPtr, path.GetSize())
@@ -214,7 +260,8 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
      * Explicit constructor.
     */
     WebSocketClient(StackStrF & host, uint16_t port, StackStrF & path, bool secure)
-        : Base(), mHandle(nullptr), mQueue(1024), mOnData(), mOnClose(), mTag(), mData()
+        : Base(), mHandle(nullptr), mQueue(1024), mAssembly(), mAssemblyState(AsmNone), mReassemble(false)
+        , mQueueLimit(0), mReceived(0), mDropped(0), mPeakDepth(0), mOnData(), mOnBatch(), mOnClose(), mTag(), mData()
         , mPort(port), mSecure(secure), mClosing(false), mClosed(false), mAutoClose(false)
         , mHost(host.mPtr, host.GetSize())
         , mPath(path.mPtr, path.GetSize())
@@ -227,7 +274,8 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
      * Explicit constructor.
     */
     WebSocketClient(StackStrF & host, uint16_t port, StackStrF & path, bool secure, StackStrF & origin)
-        : Base(), mHandle(nullptr), mQueue(1024), mOnData(), mOnClose(), mTag(), mData()
+        : Base(), mHandle(nullptr), mQueue(1024), mAssembly(), mAssemblyState(AsmNone), mReassemble(false)
+        , mQueueLimit(0), mReceived(0), mDropped(0), mPeakDepth(0), mOnData(), mOnBatch(), mOnClose(), mTag(), mData()
         , mPort(port), mSecure(secure), mClosing(false), mClosed(false), mAutoClose(false)
         , mHost(host.mPtr, host.GetSize())
         , mPath(path.mPtr, path.GetSize())
@@ -241,7 +289,8 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
      * Explicit constructor.
     */
     WebSocketClient(StackStrF & host, uint16_t port, StackStrF & path, bool secure, StackStrF & origin, StackStrF & ext)
-        : Base(), mHandle(nullptr), mQueue(1024), mOnData(), mOnClose(), mTag(), mData()
+        : Base(), mHandle(nullptr), mQueue(1024), mAssembly(), mAssemblyState(AsmNone), mReassemble(false)
+        , mQueueLimit(0), mReceived(0), mDropped(0), mPeakDepth(0), mOnData(), mOnBatch(), mOnClose(), mTag(), mData()
         , mPort(port), mSecure(secure), mClosing(false), mClosed(false), mAutoClose(false)
         , mHost(host.mPtr, host.GetSize())
         , mPath(path.mPtr, path.GetSize())
@@ -652,6 +701,112 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
         return *this;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated batch callback.
+    */
+    SQMOD_NODISCARD Function & GetOnBatch()
+    {
+        return mOnBatch;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated batch callback. While set, it receives the pending frames instead of
+     * the data callback, as an array of buffers, an array of sizes and an array of flags.
+    */
+    void SetOnBatch(Function & cb)
+    {
+        mOnBatch = cb;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated batch callback.
+    */
+    WebSocketClient & BindOnBatch(Function & cb)
+    {
+        mOnBatch = cb;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve whether fragmented messages are put back together.
+    */
+    SQMOD_NODISCARD bool GetReassemble() const
+    {
+        return mReassemble.load();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether fragmented messages are put back together.
+    */
+    void SetReassemble(bool toggle)
+    {
+        mReassemble.store(toggle);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of queued frames.
+    */
+    SQMOD_NODISCARD SQInteger GetQueueLimit() const
+    {
+        return static_cast< SQInteger >(mQueueLimit.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of queued frames.
+    */
+    void SetQueueLimit(SQInteger limit)
+    {
+        // Is the limit valid?
+        if (limit < 0)
+        {
+            STHROWF("Invalid queue limit: {} < 0", limit);
+        }
+        mQueueLimit.store(static_cast< size_t >(limit));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of frames waiting in the queue.
+    */
+    SQMOD_NODISCARD SQInteger GetQueueDepth() const
+    {
+        return static_cast< SQInteger >(mQueue.size_approx());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the highest number of frames that were waiting in the queue.
+    */
+    SQMOD_NODISCARD SQInteger GetPeakDepth() const
+    {
+        return static_cast< SQInteger >(mPeakDepth.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of frames received from the server.
+    */
+    SQMOD_NODISCARD SQInteger GetReceived() const
+    {
+        return static_cast< SQInteger >(mReceived.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of frames or messages that were dropped.
+    */
+    SQMOD_NODISCARD SQInteger GetDropped() const
+    {
+        return static_cast< SQInteger >(mDropped.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the queue statistics.
+    */
+    WebSocketClient & ResetStats()
+    {
+        mReceived.store(0);
+        mDropped.store(0);
+        mPeakDepth.store(mQueue.size_approx());
+        return *this;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Connect to a web-socket as a client.
     */
@@ -703,47 +858,16 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
     */
     void Process(bool force = false)
     {
-        // Is there a valid connection?
-        if (mHandle == nullptr && !force)
-        {
-            return; // No point in going forward
-        }
-        FramePtr frame;
-        // See if connection is closing
-        const bool closing = mClosing.load();
-        // Is the connection closing?
-        if (closing)
-        {
-            mHandle = nullptr; // Prevent further use
-        }
-        // Retrieve each frame individually and process it
-        for (size_t count = mQueue.size_approx(), n = 0; n <= count; ++n)
-        {
-            // Try to get a frame from the queue
-            if (mQueue.try_dequeue(frame) && !mOnData.IsNull())
-            {
-                // Obtain a buffer from the frame
-                Buffer b(frame->mData, frame->mSize, frame->mSize, Buffer::OwnIt{});
-                // Backup the frame size before forgetting about it
-                const SQInteger size = static_cast< SQInteger >(frame->mSize);
-                // Take ownership of the memory
-                frame->ForgetBuffer();
-                // Transform the buffer into a script object
-                LightObj obj(SqTypeIdentity< SqBuffer >{}, SqVM(), std::move(b));
-                // Forward the event to the callback
-                mOnData.Execute(obj, size, frame->mFlags);
-            }
-        }
-        // Is the server closing the connection?
-        if (closing && !mClosed.load() && !mOnClose.IsNull())
-        {
-            // Let the user know
-            mOnClose.Execute();
-            // Prevent calling this callback again
-            mClosed.store(true);
-        }
+        FrameSlice slice;
+        // Process everything
+        Process(slice, force);
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Process received data within the given slice. Returns how many frames are left.
+    */
+    size_t Process(FrameSlice & slice, bool force = false);
+
     /* --------------------------------------------------------------------------------------------
      * Used internally to release script resources, if any. The VM is about to be closed.
      * If you don't close the connection yourself don't care about what is received after this.
@@ -754,6 +878,7 @@ struct WebSocketClient : public SqChainedInstances< WebSocketClient >
         Process(true);
         // Release callbacks
         mOnData.Release();
+        mOnBatch.Release();
         mOnClose.Release();
         // Release user data
         mData.Release();
@@ -771,6 +896,16 @@ protected:
     */
     void CloseHandler() noexcept;
 
+    /* --------------------------------------------------------------------------------------------
+     * Queue a frame unless the queue is full. Control frames are always queued.
+    */
+    void Enqueue(Frame && frame);
+
+    /* --------------------------------------------------------------------------------------------
+     * Put a fragmented data message back together and queue it once complete.
+    */
+    void Assemble(int flags, const char * data, size_t size);
+
     /* --------------------------------------------------------------------------------------------
      * Proxy for DataHandler()
     */
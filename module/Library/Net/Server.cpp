@@ -0,0 +1,996 @@
+// ------------------------------------------------------------------------------------------------
+#include "Library/Net/Server.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMOD_DECL_TYPENAME(SqHttpServer, _SC("SqHttpServer"))
+SQMOD_DECL_TYPENAME(SqHttpRequest, _SC("SqHttpRequest"))
+
+// ------------------------------------------------------------------------------------------------
+static const char * const DEFAULT_TYPE = "text/plain; charset=utf-8";
+
+/* ------------------------------------------------------------------------------------------------
+ * Whether a request path is the route path or somewhere below it.
+*/
+static bool RouteMatches(const String & route, const char * path, size_t len)
+{
+    // Is the path shorter or different?
+    if (len < route.size() || route.compare(0, route.size(), path, route.size()) != 0)
+    {
+        return false;
+    }
+    // Is it the route itself or does the route end with a separator?
+    else if (len == route.size() || route.back() == '/')
+    {
+        return true;
+    }
+    // Only whole path segments match
+    return path[route.size()] == '/';
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Send a response with the specified status, content type, body and additional headers.
+*/
+static void SendResponse(struct mg_connection * conn, const struct mg_request_info * ri, int status,
+                         const String & type, const String & body, const HttpExchange::Headers * headers)
+{
+    const String length = std::to_string(body.size());
+    // Send the headers
+    mg_response_header_start(conn, status);
+    mg_response_header_add(conn, "Content-Type", type.empty() ? DEFAULT_TYPE : type.c_str(), -1);
+    mg_response_header_add(conn, "Content-Length", length.c_str(), static_cast< int >(length.size()));
+    if (headers)
+    {
+        for (const auto & h : *headers)
+        {
+            mg_response_header_add(conn, h.first.c_str(), h.second.c_str(), static_cast< int >(h.second.size()));
+        }
+    }
+    mg_response_header_send(conn);
+    // Is there a body to send?
+    if (!body.empty() && std::strcmp(ri->request_method, "HEAD") != 0)
+    {
+        mg_write(conn, body.data(), body.size());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpExchange::Complete(int status, String && body)
+{
+    {
+        std::lock_guard< std::mutex > lock(mMtx);
+        // Is the worker still waiting for a response?
+        if (mDone || mExpired)
+        {
+            return false;
+        }
+        mStatus = status;
+        mResponse = std::move(body);
+        mDone = true;
+    }
+    mCond.notify_one();
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj HttpRequest::GetHeader(StackStrF & name) const
+{
+    for (const auto & h : mExchange->mHeaders)
+    {
+        if (h.first.size() == name.GetSize() && mg_strncasecmp(h.first.c_str(), name.mPtr, h.first.size()) == 0)
+        {
+            return LightObj(h.second.data(), static_cast< SQInteger >(h.second.size()));
+        }
+    }
+    return LightObj{};
+}
+
+// ------------------------------------------------------------------------------------------------
+Table HttpRequest::GetHeaders() const
+{
+    Table t(SqVM(), static_cast< SQInteger >(mExchange->mHeaders.size()));
+    // Copy the headers into the table
+    for (const auto & h : mExchange->mHeaders)
+    {
+        t.SetValue(h.first.c_str(), h.second);
+    }
+    return t;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpRequest::IsResponded() const
+{
+    std::lock_guard< std::mutex > lock(mExchange->mMtx);
+    return mExchange->mDone;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpRequest::IsExpired() const
+{
+    std::lock_guard< std::mutex > lock(mExchange->mMtx);
+    return mExchange->mExpired;
+}
+
+// ------------------------------------------------------------------------------------------------
+String HttpRequest::GetContentType() const
+{
+    std::lock_guard< std::mutex > lock(mExchange->mMtx);
+    return mExchange->mType.empty() ? String(DEFAULT_TYPE) : mExchange->mType;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpRequest::SetContentType(StackStrF & type)
+{
+    std::lock_guard< std::mutex > lock(mExchange->mMtx);
+    // Has the response been sent already?
+    if (mExchange->mDone)
+    {
+        STHROWF("Response was already given");
+    }
+    mExchange->mType.assign(type.mPtr, type.GetSize());
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpRequest & HttpRequest::SetHeader(StackStrF & name, StackStrF & value)
+{
+    std::lock_guard< std::mutex > lock(mExchange->mMtx);
+    // Has the response been sent already?
+    if (mExchange->mDone)
+    {
+        STHROWF("Response was already given");
+    }
+    // Is the header name valid?
+    else if (name.GetSize() == 0)
+    {
+        STHROWF("Invalid header name");
+    }
+    mExchange->mResponseHeaders.emplace_back(String(name.mPtr, name.GetSize()), String(value.mPtr, value.GetSize()));
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpRequest::Respond(SQInteger status, StackStrF & body)
+{
+    // Is the status valid?
+    if (status < 100 || status > 999)
+    {
+        STHROWF("Invalid HTTP status: {}", status);
+    }
+    return mExchange->Complete(static_cast< int >(status), String(body.mPtr, body.GetSize()));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpRequest::RespondBuffer(SQInteger status, SqBuffer & buf)
+{
+    // Is the status valid?
+    if (status < 100 || status > 999)
+    {
+        STHROWF("Invalid HTTP status: {}", status);
+    }
+    const Buffer & b = buf.Valid();
+    return mExchange->Complete(static_cast< int >(status), String(b.Data(), b.Position()));
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::SetQueueLimit(SQInteger n)
+{
+    if (n < 0)
+    {
+        STHROWF("Invalid queue limit: {} < 0", n);
+    }
+    mQueueLimit.store(static_cast< size_t >(n));
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::SetBodyLimit(SQInteger n)
+{
+    if (n < 0)
+    {
+        STHROWF("Invalid body limit: {} < 0", n);
+    }
+    mBodyLimit.store(static_cast< size_t >(n));
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::SetTimeout(SQInteger ms)
+{
+    if (ms <= 0)
+    {
+        STHROWF("Invalid request timeout: {} <= 0", ms);
+    }
+    mTimeout.store(static_cast< int64_t >(ms));
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::SetClientLimit(SQInteger n)
+{
+    if (n < 0)
+    {
+        STHROWF("Invalid client limit: {} < 0", n);
+    }
+    mClientLimit.store(static_cast< size_t >(n));
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger HttpServer::GetClients()
+{
+    std::lock_guard< std::mutex > lock(mWsMtx);
+    return static_cast< SQInteger >(mWsConns.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj HttpServer::GetOption(StackStrF & name) const
+{
+    for (const auto & o : mOptions)
+    {
+        if (o.first.size() == name.GetSize() && o.first.compare(0, o.first.size(), name.mPtr, name.GetSize()) == 0)
+        {
+            return LightObj(o.second.data(), static_cast< SQInteger >(o.second.size()));
+        }
+    }
+    return LightObj{};
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::SetOption(StackStrF & name, StackStrF & value)
+{
+    Invalid();
+    // Is the option name valid?
+    if (name.GetSize() == 0)
+    {
+        STHROWF("Invalid option name");
+    }
+    String n(name.mPtr, name.GetSize()), v(value.mPtr, value.GetSize());
+    // Replace the option if it was set before
+    for (auto & o : mOptions)
+    {
+        if (o.first == n)
+        {
+            o.second = std::move(v);
+            return *this;
+        }
+    }
+    mOptions.emplace_back(std::move(n), std::move(v));
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::Start()
+{
+    Invalid();
+    std::vector< const char * > options;
+    bool nodelay = false;
+    // Build the option list expected by CivetWeb
+    for (const auto & o : mOptions)
+    {
+        options.push_back(o.first.c_str());
+        options.push_back(o.second.c_str());
+        nodelay = nodelay || (o.first == "tcp_nodelay");
+    }
+    // Responses are written in several parts, which must not wait for each other
+    if (!nodelay)
+    {
+        options.push_back("tcp_nodelay");
+        options.push_back("1");
+    }
+    options.push_back(nullptr);
+    // Error buffer
+    char err_buf[256] = {0};
+    struct mg_callbacks callbacks{};
+    struct mg_init_data init{&callbacks, this, options.data()};
+    struct mg_error_data error{0, 0, err_buf, sizeof(err_buf)};
+    // Workers that wait for the script must not give up right away
+    mStopping.store(false);
+    // Start the server
+    mContext = mg_start2(&init, &error);
+    // Check if the server could be started
+    if (!mContext)
+    {
+        STHROWF("Unable to start HTTP server: {}", err_buf);
+    }
+    // Dispatch every request and WebSocket connection through our own tables
+    mg_set_request_handler(mContext, "**", &HttpServer::RequestHandler_, this);
+    mg_set_websocket_handler(mContext, "**", &HttpServer::WsConnectHandler_, &HttpServer::WsReadyHandler_,
+                                             &HttpServer::WsDataHandler_, &HttpServer::WsCloseHandler_, this);
+    // Start the thread that writes to WebSocket clients
+    mSendRun = true;
+    mSender = std::thread(&HttpServer::SenderProc, this);
+    // Allow chaining
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::Stop()
+{
+    // Is the server running?
+    if (!mContext)
+    {
+        return;
+    }
+    // Waiting workers give up and reply with 503
+    mStopping.store(true);
+    // Stop writing to WebSocket clients
+    {
+        std::lock_guard< std::mutex > lock(mSendMtx);
+        mSendRun = false;
+    }
+    mSendCond.notify_one();
+    if (mSender.joinable())
+    {
+        mSender.join();
+    }
+    mOutgoing.clear();
+    // Wait for the worker threads to finish
+    mg_stop(mContext);
+    mContext = nullptr;
+    // Requests that never reached the script were already answered by their worker
+    std::shared_ptr< HttpExchange > ex;
+    while (mRequests.try_dequeue(ex))
+    {
+        ex.reset();
+    }
+    // Let the script know about the clients that were disconnected
+    FrameSlice slice;
+    Process(slice);
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::Route(StackStrF & path, Function & cb)
+{
+    // Is the path valid?
+    if (path.GetSize() == 0 || path.mPtr[0] != '/')
+    {
+        STHROWF("Route path must begin with a forward slash");
+    }
+    String p(path.mPtr, path.GetSize());
+    // Remember the callback
+    mRoutes[p] = cb;
+    // Let the workers know about the route
+    std::unique_lock< std::shared_mutex > lock(mTableMtx);
+    if (std::find(mPrefixes.begin(), mPrefixes.end(), p) == mPrefixes.end())
+    {
+        mPrefixes.push_back(std::move(p));
+        // The most specific route wins
+        std::stable_sort(mPrefixes.begin(), mPrefixes.end(),
+                         [](const String & a, const String & b) { return a.size() > b.size(); });
+    }
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::Unroute(StackStrF & path)
+{
+    String p(path.mPtr, path.GetSize());
+    {
+        std::unique_lock< std::shared_mutex > lock(mTableMtx);
+        mPrefixes.erase(std::remove(mPrefixes.begin(), mPrefixes.end(), p), mPrefixes.end());
+    }
+    // Requests that are still queued will receive 404
+    mRoutes.erase(p);
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::Cache(StackStrF & path, SQInteger status, StackStrF & type, StackStrF & body)
+{
+    // Is the path valid?
+    if (path.GetSize() == 0 || path.mPtr[0] != '/')
+    {
+        STHROWF("Cached path must begin with a forward slash");
+    }
+    // Is the status valid?
+    else if (status < 100 || status > 999)
+    {
+        STHROWF("Invalid HTTP status: {}", status);
+    }
+    auto c = std::make_shared< HttpCached >();
+    // Prepare the response
+    c->mStatus = static_cast< int >(status);
+    c->mType.assign(type.mPtr, type.GetSize());
+    c->mBody.assign(body.mPtr, body.GetSize());
+    c->mLength = std::to_string(c->mBody.size());
+    // Replace the previous response, if any
+    std::unique_lock< std::shared_mutex > lock(mTableMtx);
+    mCached[String(path.mPtr, path.GetSize())] = std::move(c);
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::Uncache(StackStrF & path)
+{
+    std::unique_lock< std::shared_mutex > lock(mTableMtx);
+    mCached.erase(String(path.mPtr, path.GetSize()));
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+HttpServer & HttpServer::WebSocket(StackStrF & path)
+{
+    // Is the path valid?
+    if (path.GetSize() == 0 || path.mPtr[0] != '/')
+    {
+        STHROWF("WebSocket path must begin with a forward slash");
+    }
+    std::unique_lock< std::shared_mutex > lock(mTableMtx);
+    mEndpoints.emplace(path.mPtr, path.GetSize());
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpServer::SetGroup(SQInteger id, SQInteger group)
+{
+    std::lock_guard< std::mutex > lock(mWsMtx);
+    auto itr = mWsConns.find(static_cast< uint32_t >(id));
+    // Is this client still connected?
+    if (itr == mWsConns.end())
+    {
+        return false;
+    }
+    itr->second->mGroup.store(static_cast< int32_t >(group));
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpServer::Send(SQInteger id, SQInteger opcode, StackStrF & data)
+{
+    {
+        std::lock_guard< std::mutex > lock(mWsMtx);
+        // Is this client still connected?
+        if (id <= 0 || mWsConns.find(static_cast< uint32_t >(id)) == mWsConns.end())
+        {
+            return false;
+        }
+    }
+    Post(WsOutgoing{static_cast< uint32_t >(id), -1, static_cast< int >(opcode),
+                    std::make_shared< const String >(data.mPtr, data.GetSize())});
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool HttpServer::SendBuffer(SQInteger id, SqBuffer & buf, SQInteger opcode)
+{
+    {
+        std::lock_guard< std::mutex > lock(mWsMtx);
+        // Is this client still connected?
+        if (id <= 0 || mWsConns.find(static_cast< uint32_t >(id)) == mWsConns.end())
+        {
+            return false;
+        }
+    }
+    const Buffer & b = buf.Valid();
+    Post(WsOutgoing{static_cast< uint32_t >(id), -1, static_cast< int >(opcode),
+                    std::make_shared< const String >(b.Data(), b.Position())});
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::Broadcast(SQInteger opcode, StackStrF & data)
+{
+    Post(WsOutgoing{0, -1, static_cast< int >(opcode), std::make_shared< const String >(data.mPtr, data.GetSize())});
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::BroadcastGroup(SQInteger group, SQInteger opcode, StackStrF & data)
+{
+    // Is the group valid?
+    if (group < 0)
+    {
+        STHROWF("Invalid broadcast group: {} < 0", group);
+    }
+    Post(WsOutgoing{0, static_cast< int32_t >(group), static_cast< int >(opcode),
+                    std::make_shared< const String >(data.mPtr, data.GetSize())});
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::Post(WsOutgoing && out)
+{
+    {
+        std::lock_guard< std::mutex > lock(mSendMtx);
+        // Is anyone going to send it?
+        if (!mSendRun)
+        {
+            return;
+        }
+        mOutgoing.push_back(std::move(out));
+    }
+    mSendCond.notify_one();
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::SenderProc()
+{
+    std::vector< WsOutgoing > outgoing;
+    std::vector< std::shared_ptr< HttpWsConn > > targets;
+    // Keep sending until told to stop
+    for (;;)
+    {
+        {
+            std::unique_lock< std::mutex > lock(mSendMtx);
+            // Wait for something to send
+            mSendCond.wait(lock, [this] { return !mSendRun || !mOutgoing.empty(); });
+            // Should we stop?
+            if (!mSendRun)
+            {
+                break;
+            }
+            outgoing.swap(mOutgoing);
+        }
+        for (const WsOutgoing & out : outgoing)
+        {
+            // Collect the receivers
+            {
+                std::lock_guard< std::mutex > lock(mWsMtx);
+                if (out.mTarget != 0)
+                {
+                    auto itr = mWsConns.find(out.mTarget);
+                    if (itr != mWsConns.end())
+                    {
+                        targets.push_back(itr->second);
+                    }
+                }
+                else
+                {
+                    for (const auto & c : mWsConns)
+                    {
+                        if (out.mGroup < 0 || c.second->mGroup.load() == out.mGroup)
+                        {
+                            targets.push_back(c.second);
+                        }
+                    }
+                }
+            }
+            // The same payload is written to every receiver
+            for (const auto & c : targets)
+            {
+                std::lock_guard< std::mutex > lock(c->mMtx);
+                // Is the client still connected?
+                if (c->mConn)
+                {
+                    mg_websocket_write(c->mConn, out.mOpCode, out.mData->data(), out.mData->size());
+                }
+            }
+            targets.clear();
+        }
+        outgoing.clear();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int HttpServer::RequestHandler(struct mg_connection * conn) noexcept
+{
+    const struct mg_request_info * ri = mg_get_request_info(conn);
+    try
+    {
+        const char * path = ri->local_uri ? ri->local_uri : "";
+        const size_t len = std::strlen(path);
+        std::shared_ptr< const HttpCached > cached;
+        String route;
+        // Look for a cached response or a script route
+        {
+            std::shared_lock< std::shared_mutex > lock(mTableMtx);
+            auto itr = mCached.find(String(path, len));
+            if (itr != mCached.end())
+            {
+                cached = itr->second;
+            }
+            else
+            {
+                for (const String & r : mPrefixes)
+                {
+                    if (RouteMatches(r, path, len))
+                    {
+                        route = r;
+                        break;
+                    }
+                }
+            }
+        }
+        // Can this be served without the script?
+        if (cached)
+        {
+            // Only requests without side effects get the cached response
+            if (std::strcmp(ri->request_method, "GET") != 0 && std::strcmp(ri->request_method, "HEAD") != 0)
+            {
+                mg_send_http_error(conn, 405, "%s", "Method Not Allowed");
+                return 405;
+            }
+            mg_response_header_start(conn, cached->mStatus);
+            mg_response_header_add(conn, "Content-Type", cached->mType.empty() ? DEFAULT_TYPE : cached->mType.c_str(), -1);
+            mg_response_header_add(conn, "Content-Length", cached->mLength.c_str(), static_cast< int >(cached->mLength.size()));
+            mg_response_header_send(conn);
+            // Is there a body to send?
+            if (!cached->mBody.empty() && ri->request_method[0] != 'H')
+            {
+                mg_write(conn, cached->mBody.data(), cached->mBody.size());
+            }
+            ++mServed;
+            return cached->mStatus;
+        }
+        // Leave it to CivetWeb, which serves static files or replies with 404
+        else if (route.empty())
+        {
+            return 0;
+        }
+        const size_t limit = mQueueLimit.load();
+        // Is the main thread keeping up?
+        if (limit && mRequests.size_approx() >= limit)
+        {
+            ++mRejected;
+            mg_send_http_error(conn, 503, "%s", "Service Unavailable");
+            return 503;
+        }
+        // Is the body too large?
+        else if (ri->content_length > static_cast< long long >(mBodyLimit.load()))
+        {
+            mg_send_http_error(conn, 413, "%s", "Payload Too Large");
+            return 413;
+        }
+        auto ex = std::make_shared< HttpExchange >();
+        // Copy the request information
+        ex->mRoute = std::move(route);
+        ex->mMethod.assign(ri->request_method);
+        ex->mUri.assign(path, len);
+        ex->mQuery.assign(ri->query_string ? ri->query_string : "");
+        ex->mRemote.assign(ri->remote_addr);
+        ex->mPort = ri->remote_port;
+        ex->mHeaders.reserve(static_cast< size_t >(ri->num_headers));
+        for (int i = 0; i < ri->num_headers; ++i)
+        {
+            ex->mHeaders.emplace_back(ri->http_headers[i].name, ri->http_headers[i].value);
+        }
+        // Read the body, which may come without a known length
+        char buf[4096];
+        for (int n = mg_read(conn, buf, sizeof(buf)); n > 0; n = mg_read(conn, buf, sizeof(buf)))
+        {
+            ex->mBody.append(buf, static_cast< size_t >(n));
+            // Did it grow too large?
+            if (ex->mBody.size() > mBodyLimit.load())
+            {
+                mg_send_http_error(conn, 413, "%s", "Payload Too Large");
+                return 413;
+            }
+        }
+        // Give the request to the main thread
+        mRequests.enqueue(ex);
+        // Wait for the response
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mTimeout.load());
+        std::unique_lock< std::mutex > lock(ex->mMtx);
+        while (!ex->mDone && !mStopping.load())
+        {
+            const auto now = std::chrono::steady_clock::now();
+            // Did it take too long?
+            if (now >= deadline)
+            {
+                break;
+            }
+            // Check for shutdown every now and then
+            ex->mCond.wait_for(lock, std::min< std::chrono::steady_clock::duration >(deadline - now,
+                                                            std::chrono::milliseconds(STOP_POLL)));
+        }
+        // Did we get a response?
+        if (!ex->mDone)
+        {
+            ex->mExpired = true;
+            lock.unlock();
+            // Was the server stopping or was the script too slow?
+            if (mStopping.load())
+            {
+                mg_send_http_error(conn, 503, "%s", "Service Unavailable");
+                return 503;
+            }
+            ++mExpired;
+            mg_send_http_error(conn, 504, "%s", "Gateway Timeout");
+            return 504;
+        }
+        lock.unlock();
+        // The response is no longer modified once given
+        SendResponse(conn, ri, ex->mStatus, ex->mType, ex->mResponse, &ex->mResponseHeaders);
+        return ex->mStatus;
+    }
+    catch (...)
+    {
+        mg_send_http_error(conn, 500, "%s", "Internal Server Error");
+    }
+    return 500;
+}
+
+// ------------------------------------------------------------------------------------------------
+int HttpServer::WsConnectHandler(const struct mg_connection * conn) noexcept
+{
+    const struct mg_request_info * ri = mg_get_request_info(conn);
+    try
+    {
+        // Is this a WebSocket endpoint?
+        {
+            std::shared_lock< std::shared_mutex > lock(mTableMtx);
+            if (mEndpoints.find(String(ri->local_uri ? ri->local_uri : "")) == mEndpoints.end())
+            {
+                return 1;
+            }
+        }
+        const size_t limit = mClientLimit.load();
+        // Is there room for another client?
+        if (limit)
+        {
+            std::lock_guard< std::mutex > lock(mWsMtx);
+            if (mWsConns.size() >= limit)
+            {
+                return 1;
+            }
+        }
+    }
+    catch (...)
+    {
+        return 1;
+    }
+    // Proceed with the handshake
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::WsReadyHandler(struct mg_connection * conn) noexcept
+{
+    const struct mg_request_info * ri = mg_get_request_info(conn);
+    try
+    {
+        auto c = std::make_shared< HttpWsConn >();
+        c->mConn = conn;
+        // Register the client
+        {
+            std::lock_guard< std::mutex > lock(mWsMtx);
+            // Identifier zero is used for broadcasts
+            if (mWsNextID == 0)
+            {
+                ++mWsNextID;
+            }
+            c->mID = mWsNextID++;
+            mWsConns.emplace(c->mID, c);
+        }
+        mg_set_user_connection_data(conn, c.get());
+        // Let the script know
+        WsEvent ev;
+        ev.mType = WsOpen;
+        ev.mID = c->mID;
+        ev.mUri.assign(ri->local_uri ? ri->local_uri : "");
+        ev.mRemote.assign(ri->remote_addr);
+        mEvents.enqueue(std::move(ev));
+    }
+    catch (...)
+    {
+        LogFtl("Failed to register web-socket client");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int HttpServer::WsDataHandler(struct mg_connection * conn, int flags, char * data, size_t size) noexcept
+{
+    auto * c = reinterpret_cast< HttpWsConn * >(mg_get_user_connection_data(conn));
+    // Is this client known?
+    if (c != nullptr)
+    {
+        try
+        {
+            WsEvent ev;
+            ev.mType = WsData;
+            ev.mID = c->mID;
+            ev.mFlags = flags;
+            // Do we need to allocate a buffer?
+            if (size != 0)
+            {
+                ev.mData = Buffer(data, static_cast< Buffer::SzType >(size));
+            }
+            mEvents.enqueue(std::move(ev));
+        }
+        catch (...)
+        {
+            LogFtl("Failed to queue web-socket data");
+        }
+    }
+    // Close the connection when the client asks for it
+    return (flags & 0xF) == MG_WEBSOCKET_OPCODE_CONNECTION_CLOSE ? 0 : 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::WsCloseHandler(const struct mg_connection * conn) noexcept
+{
+    auto * c = reinterpret_cast< HttpWsConn * >(mg_get_user_connection_data(conn));
+    // Is this client known?
+    if (c == nullptr)
+    {
+        return;
+    }
+    const uint32_t id = c->mID;
+    // Wait for any write in progress and prevent further ones
+    {
+        std::lock_guard< std::mutex > lock(c->mMtx);
+        c->mConn = nullptr;
+    }
+    mg_set_user_connection_data(conn, nullptr);
+    // Forget the client
+    {
+        std::lock_guard< std::mutex > lock(mWsMtx);
+        mWsConns.erase(id);
+    }
+    // Let the script know
+    try
+    {
+        WsEvent ev;
+        ev.mType = WsClose;
+        ev.mID = id;
+        mEvents.enqueue(std::move(ev));
+    }
+    catch (...)
+    {
+        LogFtl("Failed to queue web-socket close event");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t HttpServer::Process(FrameSlice & slice)
+{
+    std::shared_ptr< HttpExchange > ex;
+    // Give the queued requests to their routes
+    while (slice.Allow() && mRequests.try_dequeue(ex))
+    {
+        slice.Count();
+        // Is the client still waiting?
+        {
+            std::lock_guard< std::mutex > lock(ex->mMtx);
+            if (ex->mExpired)
+            {
+                continue;
+            }
+        }
+        ++mHandled;
+        auto itr = mRoutes.find(ex->mRoute);
+        // Was the route removed in the meantime?
+        if (itr == mRoutes.end() || itr->second.IsNull())
+        {
+            ex->Complete(404, String());
+            continue;
+        }
+        try
+        {
+            // The script can respond now or keep the request and respond later
+            LightObj req(SqTypeIdentity< HttpRequest >{}, SqVM(), ex);
+            itr->second.Execute(req);
+        }
+        catch (const Sqrat::Exception & e)
+        {
+            LogErr("Squirrel error caught in HTTP route [%s]", e.what());
+            ex->Complete(500, String());
+        }
+        catch (const std::exception & e)
+        {
+            LogErr("Program error caught in HTTP route [%s]", e.what());
+            ex->Complete(500, String());
+        }
+    }
+    WsEvent ev;
+    // Deliver the WebSocket events
+    while (slice.Allow() && mEvents.try_dequeue(ev))
+    {
+        slice.Count();
+        try
+        {
+            const auto id = static_cast< SQInteger >(ev.mID);
+            // Forward the event to the callback, if any
+            if (ev.mType == WsOpen && !mOnWsOpen.IsNull())
+            {
+                mOnWsOpen.Execute(id, ev.mUri, ev.mRemote);
+            }
+            else if (ev.mType == WsData && !mOnWsData.IsNull())
+            {
+                // Backup the frame size before giving away the buffer
+                const auto size = static_cast< SQInteger >(ev.mData.Position());
+                // Transform the buffer into a script object
+                LightObj obj(SqTypeIdentity< SqBuffer >{}, SqVM(), std::move(ev.mData));
+                mOnWsData.Execute(id, obj, size, ev.mFlags);
+            }
+            else if (ev.mType == WsClose && !mOnWsClose.IsNull())
+            {
+                mOnWsClose.Execute(id);
+            }
+        }
+        catch (const Sqrat::Exception & e)
+        {
+            LogErr("Squirrel error caught in web-socket server handler [%s]", e.what());
+        }
+        catch (const std::exception & e)
+        {
+            LogErr("Program error caught in web-socket server handler [%s]", e.what());
+        }
+    }
+    // Whatever is left is carried over
+    return mRequests.size_approx() + mEvents.size_approx();
+}
+
+// ------------------------------------------------------------------------------------------------
+void HttpServer::Terminate()
+{
+    // Stop the server while the callbacks can still be invoked
+    Stop();
+    // Release callbacks
+    mRoutes.clear();
+    mOnWsOpen.Release();
+    mOnWsData.Release();
+    mOnWsClose.Release();
+    // Release user data
+    mData.Release();
+}
+
+// ================================================================================================
+void Register_NetServer(HSQUIRRELVM vm, Table & ns)
+{
+    ns.Bind(_SC("HttpRequest"),
+        Class< HttpRequest, NoConstructor< HttpRequest > >(vm, SqHttpRequest::Str)
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &SqHttpRequest::Fn)
+        // Properties
+        .Prop(_SC("Route"), &HttpRequest::GetRoute)
+        .Prop(_SC("Method"), &HttpRequest::GetMethod)
+        .Prop(_SC("Uri"), &HttpRequest::GetUri)
+        .Prop(_SC("Query"), &HttpRequest::GetQuery)
+        .Prop(_SC("Body"), &HttpRequest::GetBody)
+        .Prop(_SC("RemoteAddr"), &HttpRequest::GetRemoteAddr)
+        .Prop(_SC("RemotePort"), &HttpRequest::GetRemotePort)
+        .Prop(_SC("Headers"), &HttpRequest::GetHeaders)
+        .Prop(_SC("Responded"), &HttpRequest::IsResponded)
+        .Prop(_SC("Expired"), &HttpRequest::IsExpired)
+        .Prop(_SC("ContentType"), &HttpRequest::GetContentType, &HttpRequest::SetContentType)
+        // Member Methods
+        .FmtFunc(_SC("GetHeader"), &HttpRequest::GetHeader)
+        .Func(_SC("SetHeader"), &HttpRequest::SetHeader)
+        .FmtFunc(_SC("Respond"), &HttpRequest::Respond)
+        .Func(_SC("RespondBuffer"), &HttpRequest::RespondBuffer)
+    );
+    // --------------------------------------------------------------------------------------------
+    ns.Bind(_SC("HttpServer"),
+        Class< HttpServer, NoCopy< HttpServer > >(vm, SqHttpServer::Str)
+        // Constructors
+        .Ctor()
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &SqHttpServer::Fn)
+        // Properties
+        .Prop(_SC("Tag"), &HttpServer::GetTag, &HttpServer::SetTag)
+        .Prop(_SC("Data"), &HttpServer::GetData, &HttpServer::SetData)
+        .Prop(_SC("Running"), &HttpServer::IsRunning)
+        .Prop(_SC("OnWsOpen"), &HttpServer::GetOnWsOpen, &HttpServer::SetOnWsOpen)
+        .Prop(_SC("OnWsData"), &HttpServer::GetOnWsData, &HttpServer::SetOnWsData)
+        .Prop(_SC("OnWsClose"), &HttpServer::GetOnWsClose, &HttpServer::SetOnWsClose)
+        .Prop(_SC("QueueLimit"), &HttpServer::GetQueueLimit, &HttpServer::SetQueueLimit)
+        .Prop(_SC("BodyLimit"), &HttpServer::GetBodyLimit, &HttpServer::SetBodyLimit)
+        .Prop(_SC("Timeout"), &HttpServer::GetTimeout, &HttpServer::SetTimeout)
+        .Prop(_SC("ClientLimit"), &HttpServer::GetClientLimit, &HttpServer::SetClientLimit)
+        .Prop(_SC("QueueDepth"), &HttpServer::GetQueueDepth)
+        .Prop(_SC("Clients"), &HttpServer::GetClients)
+        .Prop(_SC("Served"), &HttpServer::GetServed)
+        .Prop(_SC("Handled"), &HttpServer::GetHandled)
+        .Prop(_SC("Rejected"), &HttpServer::GetRejected)
+        .Prop(_SC("Expired"), &HttpServer::GetExpired)
+        // Member Methods
+        .FmtFunc(_SC("GetOption"), &HttpServer::GetOption)
+        .Func(_SC("SetOption"), &HttpServer::SetOption)
+        .Func(_SC("Start"), &HttpServer::Start)
+        .Func(_SC("Stop"), &HttpServer::Stop)
+        .Func(_SC("Route"), &HttpServer::Route)
+        .FmtFunc(_SC("Unroute"), &HttpServer::Unroute)
+        .Func(_SC("Cache"), &HttpServer::Cache)
+        .FmtFunc(_SC("Uncache"), &HttpServer::Uncache)
+        .FmtFunc(_SC("WebSocket"), &HttpServer::WebSocket)
+        .Func(_SC("SetGroup"), &HttpServer::SetGroup)
+        .FmtFunc(_SC("Send"), &HttpServer::Send)
+        .Func(_SC("SendBuffer"), &HttpServer::SendBuffer)
+        .FmtFunc(_SC("Broadcast"), &HttpServer::Broadcast)
+        .FmtFunc(_SC("BroadcastGroup"), &HttpServer::BroadcastGroup)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,499 @@
+#pragma once
+
+// ------------------------------------------------------------------------------------------------
+#include "Library/Net.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+struct HttpServer;
+
+/* ------------------------------------------------------------------------------------------------
+ * Request that was handed to the main thread. The worker thread that received it waits until a
+ * response is given, the request expires or the server stops.
+*/
+struct HttpExchange
+{
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< std::pair< String, String > > Headers;
+
+    // --------------------------------------------------------------------------------------------
+    String              mRoute{}; // Route that matched the request.
+    String              mMethod{}; // Request method.
+    String              mUri{}; // Decoded local URI.
+    String              mQuery{}; // Query string, without the question mark.
+    String              mRemote{}; // Address of the client.
+    String              mBody{}; // Request body.
+    Headers             mHeaders{}; // Request headers.
+    int                 mPort{0}; // Port of the client.
+
+    // --------------------------------------------------------------------------------------------
+    std::mutex              mMtx{}; // Guards the response.
+    std::condition_variable mCond{}; // Wakes the waiting worker.
+    bool                    mDone{false}; // Whether a response was given.
+    bool                    mExpired{false}; // Whether the worker gave up waiting.
+    int                     mStatus{200}; // Response status.
+    String                  mType{}; // Response content type.
+    String                  mResponse{}; // Response body.
+    Headers                 mResponseHeaders{}; // Additional response headers.
+
+    /* --------------------------------------------------------------------------------------------
+     * Give the response to the waiting worker. Returns false if it was no longer waiting.
+    */
+    bool Complete(int status, String && body);
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Script handle to a request that was routed to the main thread. The response can be given from
+ * the route callback or at any later time, as long as the request did not expire.
+*/
+struct HttpRequest
+{
+    // --------------------------------------------------------------------------------------------
+    std::shared_ptr< HttpExchange > mExchange; // Shared with the waiting worker.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit HttpRequest(std::shared_ptr< HttpExchange > ex)
+        : mExchange(std::move(ex))
+    {
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor (disabled).
+    */
+    HttpRequest(const HttpRequest &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor. A request that was forgotten without a response fails with status 500.
+    */
+    ~HttpRequest()
+    {
+        mExchange->Complete(500, String());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator (disabled).
+    */
+    HttpRequest & operator = (const HttpRequest &) = delete;
+
+    // --------------------------------------------------------------------------------------------
+    SQMOD_NODISCARD const String & GetRoute() const { return mExchange->mRoute; }
+    SQMOD_NODISCARD const String & GetMethod() const { return mExchange->mMethod; }
+    SQMOD_NODISCARD const String & GetUri() const { return mExchange->mUri; }
+    SQMOD_NODISCARD const String & GetQuery() const { return mExchange->mQuery; }
+    SQMOD_NODISCARD const String & GetBody() const { return mExchange->mBody; }
+    SQMOD_NODISCARD const String & GetRemoteAddr() const { return mExchange->mRemote; }
+    SQMOD_NODISCARD int GetRemotePort() const { return mExchange->mPort; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the value of a request header or null if it was not sent. Case insensitive.
+    */
+    SQMOD_NODISCARD LightObj GetHeader(StackStrF & name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the request headers as a table.
+    */
+    SQMOD_NODISCARD Table GetHeaders() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve whether a response was given.
+    */
+    SQMOD_NODISCARD bool IsResponded() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve whether the client stopped waiting for a response.
+    */
+    SQMOD_NODISCARD bool IsExpired() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the content type of the response.
+    */
+    SQMOD_NODISCARD String GetContentType() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the content type of the response.
+    */
+    void SetContentType(StackStrF & type);
+
+    /* --------------------------------------------------------------------------------------------
+     * Add a header to the response.
+    */
+    HttpRequest & SetHeader(StackStrF & name, StackStrF & value);
+
+    /* --------------------------------------------------------------------------------------------
+     * Give the response. Returns false if the client is no longer waiting for one.
+    */
+    bool Respond(SQInteger status, StackStrF & body);
+
+    /* --------------------------------------------------------------------------------------------
+     * Give the contents of a buffer as the response.
+    */
+    bool RespondBuffer(SQInteger status, SqBuffer & buf);
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Response that is served by the worker threads without involving the script.
+*/
+struct HttpCached
+{
+    int     mStatus{200}; // Response status.
+    String  mType{}; // Content type.
+    String  mLength{}; // Content length, already formatted.
+    String  mBody{}; // Response body.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * WebSocket connection accepted by the server.
+*/
+struct HttpWsConn
+{
+    // --------------------------------------------------------------------------------------------
+    std::mutex                  mMtx{}; // Keeps the connection alive while writing to it.
+    struct mg_connection *      mConn{nullptr}; // Connection handle. Null once closed.
+    uint32_t                    mID{0}; // Identifier given to the script.
+    std::atomic< int32_t >      mGroup{0}; // Group used to select broadcast receivers.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Embedded HTTP and WebSocket server. CivetWeb worker threads serve static files and cached
+ * responses on their own. Requests to script routes and WebSocket events are queued to the main
+ * thread and processed within the frame budget, while the worker waits for the response. Data
+ * sent to WebSocket clients is written by a separate thread so that slow clients never stall
+ * the main thread and broadcasts are encoded once for all receivers.
+*/
+struct HttpServer : public SqChainedInstances< HttpServer >
+{
+    using Base = SqChainedInstances< HttpServer >;
+
+    /* --------------------------------------------------------------------------------------------
+     * Type of WebSocket event.
+    */
+    enum WsEventType { WsOpen = 0, WsData, WsClose };
+
+    /* --------------------------------------------------------------------------------------------
+     * WebSocket event queued for the main thread.
+    */
+    struct WsEvent
+    {
+        WsEventType mType{WsOpen}; // Event type.
+        uint32_t    mID{0}; // Connection identifier.
+        int         mFlags{0}; // Frame flags.
+        Buffer      mData{}; // Frame data.
+        String      mUri{}; // Endpoint of the client when opened.
+        String      mRemote{}; // Address of the client when opened.
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Data waiting to be sent to WebSocket clients. The payload is shared by all receivers.
+    */
+    struct WsOutgoing
+    {
+        uint32_t                        mTarget{0}; // Receiver or zero to broadcast.
+        int32_t                         mGroup{-1}; // Broadcast group or negative for all.
+        int                             mOpCode{0}; // Frame opcode.
+        std::shared_ptr< const String > mData{}; // Frame payload.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr size_t DEFAULT_QUEUE_LIMIT = 1024; // Requests allowed to wait for the main thread.
+    static constexpr size_t DEFAULT_BODY_LIMIT = 1024 * 1024; // Largest request body. (bytes)
+    static constexpr int64_t DEFAULT_TIMEOUT = 30000; // Time a client waits for a response. (milliseconds)
+    static constexpr int STOP_POLL = 100; // How often a waiting worker checks for shutdown. (milliseconds)
+
+    // --------------------------------------------------------------------------------------------
+    struct mg_context *                                 mContext{nullptr}; // Server context.
+    std::vector< std::pair< String, String > >          mOptions{}; // CivetWeb configuration.
+    std::atomic< bool >                                 mStopping{false}; // Whether waiting workers must give up.
+
+    // --------------------------------------------------------------------------------------------
+    std::shared_mutex                                   mTableMtx{}; // Guards the tables used by workers.
+    std::vector< String >                               mPrefixes{}; // Script routes, longest first.
+    std::unordered_map< String, std::shared_ptr< const HttpCached > > mCached{}; // Cached responses.
+    std::unordered_set< String >                        mEndpoints{}; // WebSocket endpoints.
+    std::unordered_map< String, Function >              mRoutes{}; // Route callbacks. (main thread only)
+
+    // --------------------------------------------------------------------------------------------
+    moodycamel::ConcurrentQueue< std::shared_ptr< HttpExchange > > mRequests{1024}; // Requests for the main thread.
+    moodycamel::ConcurrentQueue< WsEvent >             mEvents{1024}; // WebSocket events for the main thread.
+
+    // --------------------------------------------------------------------------------------------
+    std::mutex                                          mWsMtx{}; // Guards the WebSocket connections.
+    std::unordered_map< uint32_t, std::shared_ptr< HttpWsConn > > mWsConns{}; // Open WebSocket connections.
+    uint32_t                                            mWsNextID{1}; // Next connection identifier.
+
+    // --------------------------------------------------------------------------------------------
+    std::thread                                         mSender{}; // Writes data to WebSocket clients.
+    std::mutex                                          mSendMtx{}; // Guards the outgoing queue.
+    std::condition_variable                             mSendCond{}; // Wakes the sender thread.
+    std::vector< WsOutgoing >                           mOutgoing{}; // Data waiting to be sent.
+    bool                                                mSendRun{false}; // Whether the sender keeps going.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< size_t >                               mQueueLimit{DEFAULT_QUEUE_LIMIT};
+    std::atomic< size_t >                               mBodyLimit{DEFAULT_BODY_LIMIT};
+    std::atomic< int64_t >                              mTimeout{DEFAULT_TIMEOUT};
+    std::atomic< size_t >                               mClientLimit{0}; // Zero if unlimited.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< uint64_t >                             mServed{0}; // Cached responses served by workers.
+    std::atomic< uint64_t >                             mRejected{0}; // Requests refused because the queue was full.
+    std::atomic< uint64_t >                             mExpired{0}; // Requests that got no response in time.
+    uint64_t                                            mHandled{0}; // Requests given to routes. (main thread only)
+
+    // --------------------------------------------------------------------------------------------
+    Function                                            mOnWsOpen{}; // Invoked when a client connects.
+    Function                                            mOnWsData{}; // Invoked when a client sends data.
+    Function                                            mOnWsClose{}; // Invoked when a client disconnects.
+    String                                              mTag{}; // User tag.
+    LightObj                                            mData{}; // User data.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    HttpServer()
+        : Base()
+    {
+        ChainInstance(); // Remember this instance
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor (disabled).
+    */
+    HttpServer(const HttpServer &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor. Stops the server.
+    */
+    ~HttpServer()
+    {
+        Stop();
+        // Forget about this instance
+        UnchainInstance();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator (disabled).
+    */
+    HttpServer & operator = (const HttpServer &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Return whether the server is running.
+    */
+    SQMOD_NODISCARD bool IsRunning() const
+    {
+        return mContext != nullptr;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Make sure the server is not running.
+    */
+    void Invalid() const
+    {
+        if (mContext != nullptr)
+        {
+            STHROWF("HTTP server is already running");
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+    SQMOD_NODISCARD const String & GetTag() const { return mTag; }
+    void SetTag(StackStrF & tag) { mTag.assign(tag.mPtr, tag.GetSize()); }
+    SQMOD_NODISCARD LightObj & GetData() { return mData; }
+    void SetData(LightObj & data) { mData = data; }
+    SQMOD_NODISCARD Function & GetOnWsOpen() { return mOnWsOpen; }
+    void SetOnWsOpen(Function & cb) { mOnWsOpen = cb; }
+    SQMOD_NODISCARD Function & GetOnWsData() { return mOnWsData; }
+    void SetOnWsData(Function & cb) { mOnWsData = cb; }
+    SQMOD_NODISCARD Function & GetOnWsClose() { return mOnWsClose; }
+    void SetOnWsClose(Function & cb) { mOnWsClose = cb; }
+
+    // --------------------------------------------------------------------------------------------
+    SQMOD_NODISCARD SQInteger GetQueueLimit() const { return static_cast< SQInteger >(mQueueLimit.load()); }
+    SQMOD_NODISCARD SQInteger GetBodyLimit() const { return static_cast< SQInteger >(mBodyLimit.load()); }
+    SQMOD_NODISCARD SQInteger GetTimeout() const { return static_cast< SQInteger >(mTimeout.load()); }
+    SQMOD_NODISCARD SQInteger GetClientLimit() const { return static_cast< SQInteger >(mClientLimit.load()); }
+    SQMOD_NODISCARD SQInteger GetQueueDepth() const { return static_cast< SQInteger >(mRequests.size_approx()); }
+    SQMOD_NODISCARD SQInteger GetServed() const { return static_cast< SQInteger >(mServed.load()); }
+    SQMOD_NODISCARD SQInteger GetRejected() const { return static_cast< SQInteger >(mRejected.load()); }
+    SQMOD_NODISCARD SQInteger GetExpired() const { return static_cast< SQInteger >(mExpired.load()); }
+    SQMOD_NODISCARD SQInteger GetHandled() const { return static_cast< SQInteger >(mHandled); }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of requests allowed to wait for the main thread. Zero if unlimited.
+    */
+    void SetQueueLimit(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the largest request body accepted by script routes. (bytes)
+    */
+    void SetBodyLimit(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the time a client waits for a script route to respond. (milliseconds)
+    */
+    void SetTimeout(SQInteger ms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of WebSocket clients allowed at once. Zero if unlimited.
+    */
+    void SetClientLimit(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of open WebSocket connections.
+    */
+    SQMOD_NODISCARD SQInteger GetClients();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a CivetWeb option or null if it was not set.
+    */
+    SQMOD_NODISCARD LightObj GetOption(StackStrF & name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify a CivetWeb option, such as "listening_ports", "num_threads" or "document_root".
+    */
+    HttpServer & SetOption(StackStrF & name, StackStrF & value);
+
+    /* --------------------------------------------------------------------------------------------
+     * Start the server with the current options.
+    */
+    HttpServer & Start();
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop the server. Waiting clients get status 503 and WebSocket clients are disconnected.
+    */
+    void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Route requests for a path, and everything below it, to a script callback.
+    */
+    HttpServer & Route(StackStrF & path, Function & cb);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a script route.
+    */
+    HttpServer & Unroute(StackStrF & path);
+
+    /* --------------------------------------------------------------------------------------------
+     * Serve a fixed response for a path without involving the script.
+    */
+    HttpServer & Cache(StackStrF & path, SQInteger status, StackStrF & type, StackStrF & body);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a cached response.
+    */
+    HttpServer & Uncache(StackStrF & path);
+
+    /* --------------------------------------------------------------------------------------------
+     * Accept WebSocket connections on a path.
+    */
+    HttpServer & WebSocket(StackStrF & path);
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the broadcast group of a WebSocket client.
+    */
+    bool SetGroup(SQInteger id, SQInteger group);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send a frame to a WebSocket client.
+    */
+    bool Send(SQInteger id, SQInteger opcode, StackStrF & data);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send the contents of a buffer to a WebSocket client.
+    */
+    bool SendBuffer(SQInteger id, SqBuffer & buf, SQInteger opcode);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send a frame to all WebSocket clients.
+    */
+    void Broadcast(SQInteger opcode, StackStrF & data);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send a frame to the WebSocket clients in a group.
+    */
+    void BroadcastGroup(SQInteger group, SQInteger opcode, StackStrF & data);
+
+    /* --------------------------------------------------------------------------------------------
+     * Process queued requests and WebSocket events within the given slice.
+    */
+    size_t Process(FrameSlice & slice);
+
+    /* --------------------------------------------------------------------------------------------
+     * Used internally to release script resources. The VM is about to be closed.
+    */
+    void Terminate();
+
+protected:
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue data for the sender thread.
+    */
+    void Post(WsOutgoing && out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Sender thread.
+    */
+    void SenderProc();
+
+    /* --------------------------------------------------------------------------------------------
+     * Handle a request. (worker thread)
+    */
+    int RequestHandler(struct mg_connection * conn) noexcept;
+
+    /* --------------------------------------------------------------------------------------------
+     * Decide whether to accept a WebSocket client. (worker thread)
+    */
+    int WsConnectHandler(const struct mg_connection * conn) noexcept;
+
+    /* --------------------------------------------------------------------------------------------
+     * Register a WebSocket client that completed the handshake. (worker thread)
+    */
+    void WsReadyHandler(struct mg_connection * conn) noexcept;
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue data received from a WebSocket client. (worker thread)
+    */
+    int WsDataHandler(struct mg_connection * conn, int flags, char * data, size_t size) noexcept;
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget a WebSocket client that disconnected. (worker thread)
+    */
+    void WsCloseHandler(const struct mg_connection * conn) noexcept;
+
+    // --------------------------------------------------------------------------------------------
+    static int RequestHandler_(struct mg_connection * c, void * u) noexcept
+    {
+        return reinterpret_cast< HttpServer * >(u)->RequestHandler(c);
+    }
+    static int WsConnectHandler_(const struct mg_connection * c, void * u) noexcept
+    {
+        return reinterpret_cast< HttpServer * >(u)->WsConnectHandler(c);
+    }
+    static void WsReadyHandler_(struct mg_connection * c, void * u) noexcept
+    {
+        reinterpret_cast< HttpServer * >(u)->WsReadyHandler(c);
+    }
+    static int WsDataHandler_(struct mg_connection * c, int f, char * d, size_t n, void * u) noexcept
+    {
+        return reinterpret_cast< HttpServer * >(u)->WsDataHandler(c, f, d, n);
+    }
+    static void WsCloseHandler_(const struct mg_connection * c, void * u) noexcept
+    {
+        reinterpret_cast< HttpServer * >(u)->WsCloseHandler(c);
+    }
+};
+
+} // Namespace:: SqMod
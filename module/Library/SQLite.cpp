@@ -6,6 +6,8 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <ctime>
+#include <chrono>
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqstdblob.h>
@@ -603,11 +605,352 @@ LightObj TableToQueryColumns(Table & tbl)
     return LightObj(b.data());
 }
 
+// ------------------------------------------------------------------------------------------------
+std::vector< SQLiteWriter * > SQLiteWriter::sWriters{};
+
+// ------------------------------------------------------------------------------------------------
+size_t ProcessSQLite(FrameSlice & slice)
+{
+    size_t left = 0;
+    // A callback may disable the writer of any connection, so the list can change meanwhile
+    const std::vector< SQLiteWriter * > writers(SQLiteWriter::sWriters);
+    // Go over all writers and deliver the outcome of their transactions
+    for (SQLiteWriter * w : writers)
+    {
+        // Was this writer destroyed by a previous callback?
+        if (std::find(SQLiteWriter::sWriters.begin(), SQLiteWriter::sWriters.end(), w) != SQLiteWriter::sWriters.end())
+        {
+            left += w->Process(slice);
+        }
+    }
+    // Return what was left for later
+    return left;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TerminateSQLite()
+{
+    // Commit what is still pending and release the callbacks while the VM still exists
+    for (SQLiteWriter * w : SQLiteWriter::sWriters)
+    {
+        w->Stop();
+        w->mOwner.mOnCommit.Release();
+        w->mOwner.mOnWriteError.Release();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SQLiteWriter::SQLiteWriter(SQLiteConnHnd & owner)
+    : mOwner(owner)
+    , mPtr(nullptr)
+    , mThread()
+    , mMutex()
+    , mCond()
+    , mPending()
+    , mOldest(0)
+    , mRun(true)
+    , mFlush(false)
+    , mBatch(owner.mWriteBatch)
+    , mDelay(owner.mWriteDelay)
+    , mDepth(0)
+    , mCommits(0)
+    , mErrors(0)
+    , mLatency(0)
+    , mPeakLatency(0)
+    , mResults()
+{
+    // Open a second connection to the same database, only used by the writer thread
+    int32_t status = sqlite3_open_v2(owner.mName.c_str(), &mPtr, owner.mFlags,
+                                        owner.mVFS.empty() ? nullptr : owner.mVFS.c_str());
+    // WAL allows the main connection to keep reading while the writer commits
+    if (status == SQLITE_OK)
+    {
+        status = sqlite3_exec(mPtr, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    }
+    // Was the connection ready to be used?
+    if (status != SQLITE_OK)
+    {
+        // Grab the error message before destroying the handle
+        String msg(mPtr ? sqlite3_errmsg(mPtr) : sqlite3_errstr(status));
+        // Must be destroyed regardless of result
+        sqlite3_close(mPtr);
+        // Prevent further use of this handle
+        mPtr = nullptr;
+        // Now its safe to throw the error
+        STHROWF("Unable to open write-behind connection [{}]", msg);
+    }
+    // Wait for the main connection to release its lock instead of failing right away
+    sqlite3_busy_timeout(mPtr, BUSY_TIMEOUT);
+    // Start the writer thread
+    mThread = std::thread(&SQLiteWriter::Proc, this);
+    // Remember this writer
+    sWriters.push_back(this);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQLiteWriter::~SQLiteWriter()
+{
+    // Commit what is still pending
+    Stop();
+    // Attempt to close the writer connection
+    if (mPtr != nullptr && sqlite3_close(mPtr) != SQLITE_OK)
+    {
+        LogErr("Unable to close SQLite write-behind connection [%s]", sqlite3_errmsg(mPtr));
+    }
+    // Forget about this writer
+    sWriters.erase(std::remove(sWriters.begin(), sWriters.end(), this), sWriters.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Push(String && query)
+{
+    bool wake;
+    {
+        std::lock_guard< std::mutex > lock(mMutex);
+        // Is the writer thread still around?
+        if (!mRun)
+        {
+            STHROWF("SQLite write-behind thread was stopped");
+        }
+        // Is this the oldest pending query?
+        else if (mPending.empty())
+        {
+            mOldest = FrameSlice::Now();
+        }
+        mPending.push_back(std::move(query));
+        // The writer thread sleeps until the first query arrives or the batch is full
+        wake = (mPending.size() == 1 || mPending.size() >= mBatch.load());
+    }
+    ++mDepth;
+    // Should the writer thread be woken up?
+    if (wake)
+    {
+        mCond.notify_one();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Push(std::vector< String >::iterator itr, std::vector< String >::iterator end)
+{
+    // Is there anything to hand over?
+    if (itr == end)
+    {
+        return;
+    }
+    const auto n = static_cast< size_t >(std::distance(itr, end));
+    {
+        std::lock_guard< std::mutex > lock(mMutex);
+        // Is the writer thread still around?
+        if (!mRun)
+        {
+            STHROWF("SQLite write-behind thread was stopped");
+        }
+        // Is the first query the oldest pending query?
+        else if (mPending.empty())
+        {
+            mOldest = FrameSlice::Now();
+        }
+        mPending.insert(mPending.end(), std::make_move_iterator(itr), std::make_move_iterator(end));
+    }
+    mDepth += n;
+    // Let the writer thread see them
+    mCond.notify_one();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Flush()
+{
+    {
+        std::lock_guard< std::mutex > lock(mMutex);
+        mFlush = true;
+    }
+    mCond.notify_one();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Stop()
+{
+    {
+        std::lock_guard< std::mutex > lock(mMutex);
+        mRun = false;
+    }
+    mCond.notify_one();
+    // The writer thread commits the pending queries before it exits
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t SQLiteWriter::Process(FrameSlice & slice)
+{
+    std::vector< Result > results;
+    Result res;
+    // Collect the transactions that fit in the slice
+    while (slice.Allow() && mResults.try_dequeue(res))
+    {
+        slice.Count();
+        results.push_back(std::move(res));
+    }
+    // Whatever is left is carried over
+    const size_t left = mResults.size_approx();
+    // Was there anything to deliver?
+    if (results.empty())
+    {
+        return left;
+    }
+    // The callbacks may disable the writer, so nothing from it is used past this point
+    Function on_commit(mOwner.mOnCommit), on_error(mOwner.mOnWriteError);
+    // Deliver the outcome of each transaction
+    for (const Result & r : results)
+    {
+        try
+        {
+            for (const Failure & f : r.mFailures)
+            {
+                // Is there someone to handle the failure?
+                if (!on_error.IsNull())
+                {
+                    on_error.Execute(f.mStatus, f.mQuery, f.mMessage);
+                }
+                else
+                {
+                    LogWrn("SQLite write-behind query failed (%d) [%s] : %s", f.mStatus, f.mMessage.c_str(), f.mQuery.c_str());
+                }
+            }
+            // Is there someone interested in the transaction?
+            if (!on_commit.IsNull())
+            {
+                on_commit.Execute(static_cast< SQInteger >(r.mCount), r.mChanges,
+                                  static_cast< SQInteger >(r.mLatency), r.mCommitted);
+            }
+        }
+        catch (const Sqrat::Exception & e)
+        {
+            LogErr("Squirrel error caught in write-behind handler [%s]", e.what());
+        }
+        catch (const std::exception & e)
+        {
+            LogErr("Program error caught in write-behind handler [%s]", e.what());
+        }
+    }
+    return left;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Proc()
+{
+    std::vector< String > queries;
+    std::unique_lock< std::mutex > lock(mMutex);
+    // Keep going until stopped and there's nothing left to commit
+    for (;;)
+    {
+        // Is there a reason to commit the pending queries now?
+        if (!mPending.empty() && (!mRun || mFlush || mPending.size() >= mBatch.load() ||
+                                    (FrameSlice::Now() - mOldest) >= mDelay.load()))
+        {
+            const int64_t oldest = mOldest;
+            // Take the pending queries and allow others to be queued meanwhile
+            queries.swap(mPending);
+            mFlush = false;
+            lock.unlock();
+            Commit(queries, oldest);
+            // Keep the memory for the next group
+            queries.clear();
+            lock.lock();
+        }
+        // Were we asked to stop?
+        else if (!mRun)
+        {
+            break;
+        }
+        // Sleep until something is queued
+        else if (mPending.empty())
+        {
+            mFlush = false;
+            mCond.wait(lock);
+        }
+        // Sleep until the oldest query waited long enough
+        else
+        {
+            mCond.wait_for(lock, std::chrono::microseconds(mOldest + mDelay.load() - FrameSlice::Now()));
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteWriter::Commit(std::vector< String > & queries, int64_t oldest)
+{
+    Result res;
+    res.mCount = queries.size();
+    // Used to find how many rows were changed by this transaction
+    const int32_t changes = sqlite3_total_changes(mPtr);
+    // Take the write lock up front so that the transaction does not fail half way through
+    int32_t status = sqlite3_exec(mPtr, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+    // Was the transaction started?
+    if (status == SQLITE_OK)
+    {
+        for (String & q : queries)
+        {
+            // Failed queries are reported and skipped, just like a regular flush
+            if ((status = sqlite3_exec(mPtr, q.c_str(), nullptr, nullptr, nullptr)) != SQLITE_OK)
+            {
+                res.mFailures.push_back(Failure{status, q, sqlite3_errmsg(mPtr)});
+                // Only the queries that were applied remain
+                q.clear();
+            }
+        }
+        // Attempt to commit the changes
+        if ((status = sqlite3_exec(mPtr, "COMMIT", nullptr, nullptr, nullptr)) == SQLITE_OK)
+        {
+            res.mCommitted = true;
+        }
+        else
+        {
+            sqlite3_exec(mPtr, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+    }
+    // Report the queries that were lost with the transaction so they can be queued again
+    if (!res.mCommitted)
+    {
+        const String msg(sqlite3_errmsg(mPtr));
+        for (String & q : queries)
+        {
+            if (!q.empty())
+            {
+                res.mFailures.push_back(Failure{status, std::move(q), msg});
+            }
+        }
+    }
+    // Update statistics
+    res.mChanges = res.mCommitted ? (sqlite3_total_changes(mPtr) - changes) : 0;
+    res.mLatency = FrameSlice::Now() - oldest;
+    mErrors += res.mFailures.size();
+    mCommits += res.mCommitted ? 1 : 0;
+    mLatency.store(res.mLatency);
+    // Only this thread raises the peak latency
+    if (res.mLatency > mPeakLatency.load())
+    {
+        mPeakLatency.store(res.mLatency);
+    }
+    mDepth -= res.mCount;
+    // Let the main thread deliver the outcome
+    mResults.enqueue(std::move(res));
+}
+
 // ------------------------------------------------------------------------------------------------
 SQLiteConnHnd::SQLiteConnHnd()
     : mPtr(nullptr)
     , mStatus(SQLITE_OK)
     , mQueue()
+    , mCache([](sqlite3_stmt * stmt) { sqlite3_finalize(stmt); })
+    , mWriter()
+    , mWriteBatch(SQLiteWriter::DEFAULT_BATCH)
+    , mWriteDelay(SQLiteWriter::DEFAULT_DELAY)
+    , mOnCommit()
+    , mOnWriteError()
+    , mBusyTimeout(-1)
     , mFlags(0)
     , mName()
     , mVFS()
@@ -643,8 +986,12 @@ SQLiteConnHnd::~SQLiteConnHnd()
     // Is there anything to close?
     if (mPtr != nullptr)
     {
+        // Commit whatever was handed to the writer thread first
+        mWriter.reset();
         // Flush remaining queries in the queue and ignore the result
         Flush(static_cast<uint32_t>(mQueue.size()), NullObject(), NullFunction());
+        // Statements must be finalized before the connection can be closed
+        mCache.Clear();
         // NOTE: Should we call sqlite3_interrupt(...) before closing?
         // Attempt to close the database
         // If this connection is a pooled session then let it clean itself up
@@ -702,6 +1049,27 @@ int32_t SQLiteConnHnd::Flush(uint32_t num, Object & env, Function & func)
     {
         return -1; // No connection!
     }
+    // Are the queries applied in the background?
+    else if (mWriter)
+    {
+        // Failures are delivered later, to the write error callback
+        if (!func.IsNull())
+        {
+            STHROWF("Flush error handlers are not used with write-behind. Use the write error callback");
+        }
+        // Can we even hand over that many?
+        if (num > mQueue.size())
+        {
+            num = static_cast<uint32_t>(mQueue.size());
+        }
+        // Hand over whatever was queued before the writer was enabled
+        mWriter->Push(mQueue.begin(), mQueue.begin() + num);
+        mQueue.erase(mQueue.begin(), mQueue.begin() + num);
+        // Don't wait for a commit to be triggered. Changes are reported by the commit callback
+        mWriter->Flush();
+        // The queries were only handed over
+        return static_cast< int32_t >(num);
+    }
     // Is there anything to flush?
     else if (!num || mQueue.empty())
     {
@@ -796,6 +1164,7 @@ SQLiteStmtHnd::SQLiteStmtHnd(SQLiteConnRef conn)
     , mIndexes()
     , mGood(false)
     , mDone(false)
+    , mCached(false)
 {
     /* ... */
 }
@@ -803,8 +1172,17 @@ SQLiteStmtHnd::SQLiteStmtHnd(SQLiteConnRef conn)
 // ------------------------------------------------------------------------------------------------
 SQLiteStmtHnd::~SQLiteStmtHnd()
 {
+    // Can the statement be reused?
+    if (mPtr != nullptr && mCached && mConnection && mConnection->mPtr != nullptr)
+    {
+        // Bring it back to its initial state and release any locks it may hold
+        sqlite3_reset(mPtr);
+        sqlite3_clear_bindings(mPtr);
+        // Give it back to the connection
+        mConnection->mCache.Return(mQuery, mPtr);
+    }
     // Is there anything to finalize?
-    if (mPtr != nullptr)
+    else if (mPtr != nullptr)
     {
         // Attempt to finalize the statement
         if ((sqlite3_finalize(mPtr)) != SQLITE_OK)
@@ -834,8 +1212,10 @@ void SQLiteStmtHnd::Create(const SQChar * query, SQInteger length)
     }
     // Save the query string
     mQuery.assign(query, static_cast< size_t >(length));
-    // Attempt to prepare a statement with the specified query string
-    if ((mStatus = sqlite3_prepare_v2(mConnection->mPtr, mQuery.c_str(), ConvTo< int32_t >::From(mQuery.size()),
+    // Is there an idle statement prepared with the same query string?
+    mPtr = mConnection->mCache.Checkout(mQuery);
+    // Attempt to prepare a statement with the specified query string otherwise
+    if (mPtr == nullptr && (mStatus = sqlite3_prepare_v2(mConnection->mPtr, mQuery.c_str(), ConvTo< int32_t >::From(mQuery.size()),
                                             &mPtr, nullptr)) != SQLITE_OK)
     {
         // Clear the query string since it failed
@@ -847,6 +1227,8 @@ void SQLiteStmtHnd::Create(const SQChar * query, SQInteger length)
     }
     else
     {
+        // The statement can be reused once we're done with it
+        mCached = true;
         // Obtain the number of available columns
         mColumns = sqlite3_column_count(mPtr);
         // Obtain the number of available parameters
@@ -1090,6 +1472,112 @@ Object SQLiteConnection::Query(StackStrF & str) const
     return Object(new SQLiteStatement(m_Handle, str));
 }
 
+// ------------------------------------------------------------------------------------------------
+SQLiteWriter & SQLiteConnection::GetWriter() const
+{
+    // Is the writer enabled?
+    if (!SQMOD_GET_VALID(*this)->mWriter)
+    {
+        STHROWF("Write-behind is not enabled on this connection");
+    }
+    return *m_Handle->mWriter;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteConnection::SetWriteBehind(bool toggle)
+{
+    SQMOD_VALIDATE_CREATED(*this);
+    // Is there anything to change?
+    if (toggle == static_cast< bool >(m_Handle->mWriter))
+    {
+        return;
+    }
+    else if (!toggle)
+    {
+        // Commit what is still pending and wait for the writer thread to finish
+        m_Handle->mWriter->Stop();
+        // Deliver the remaining outcomes before the callbacks are gone
+        FrameSlice slice;
+        m_Handle->mWriter->Process(slice);
+        // Now it's safe to release it
+        m_Handle->mWriter.reset();
+        return;
+    }
+    // The writer needs its own connection to the same database file
+    else if (m_Handle->mMemory || m_Handle->mName.empty())
+    {
+        STHROWF("Write-behind requires a database file");
+    }
+    else if (m_Handle->mFlags & SQLITE_OPEN_READONLY)
+    {
+        STHROWF("Write-behind requires a writable database");
+    }
+    // Writes made directly on this connection must wait for the writer to release the database
+    if (m_Handle->mBusyTimeout < 0)
+    {
+        SetBusyTimeout(SQLiteWriter::BUSY_TIMEOUT);
+    }
+    m_Handle->mWriter = std::make_unique< SQLiteWriter >(*m_Handle);
+    // Hand over whatever was queued so far
+    m_Handle->mWriter->Push(m_Handle->mQueue.begin(), m_Handle->mQueue.end());
+    m_Handle->mQueue.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteConnection::SetWriteBatch(SQInteger n)
+{
+    // Is the size valid?
+    if (n < 1)
+    {
+        STHROWF("Invalid write-behind batch size: {} < 1", n);
+    }
+    SQMOD_GET_VALID(*this)->mWriteBatch = static_cast< size_t >(n);
+    // Is there a writer thread that should see the new trigger?
+    if (m_Handle->mWriter)
+    {
+        m_Handle->mWriter->mBatch.store(m_Handle->mWriteBatch);
+        m_Handle->mWriter->mCond.notify_one();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteConnection::SetWriteDelay(SQInteger ms)
+{
+    // Is the delay valid?
+    if (ms < 0)
+    {
+        STHROWF("Invalid write-behind delay: {} < 0", ms);
+    }
+    SQMOD_GET_VALID(*this)->mWriteDelay = static_cast< int64_t >(ms) * 1000;
+    // Is there a writer thread that should see the new trigger?
+    if (m_Handle->mWriter)
+    {
+        m_Handle->mWriter->mDelay.store(m_Handle->mWriteDelay);
+        m_Handle->mWriter->mCond.notify_one();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteConnection::ResetWriteStats() const
+{
+    SQLiteWriter & w = GetWriter();
+    w.mCommits.store(0);
+    w.mErrors.store(0);
+    w.mLatency.store(0);
+    w.mPeakLatency.store(0);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SQLiteConnection::SetCacheCapacity(SQInteger n)
+{
+    // Is the capacity valid?
+    if (n < 0)
+    {
+        STHROWF("Invalid statement cache capacity: {} < 0", n);
+    }
+    SQMOD_GET_VALID(*this)->mCache.SetCapacity(static_cast< size_t >(n));
+}
+
 // ------------------------------------------------------------------------------------------------
 void SQLiteConnection::Queue(StackStrF & str)
 {
@@ -1099,8 +1587,16 @@ void SQLiteConnection::Queue(StackStrF & str)
     {
         STHROWF("No query string to queue");
     }
+    // Are the queries applied in the background?
+    if (m_Handle->mWriter)
+    {
+        m_Handle->mWriter->Push(String(str.mPtr, static_cast< size_t >(str.mLen)));
+    }
     // Add the specified string to the queue
-    m_Handle->mQueue.emplace_back(str.mPtr, str.mLen);
+    else
+    {
+        m_Handle->mQueue.emplace_back(str.mPtr, str.mLen);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1227,6 +1723,8 @@ void SQLiteConnection::SetBusyTimeout(int32_t millis)
     {
         STHROWF("Unable to set busy timeout [{}]", m_Handle->ErrMsg());
     }
+    // Remember that a timeout was chosen
+    m_Handle->mBusyTimeout = millis;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -3015,6 +3513,21 @@ void Register_SQLite(HSQUIRRELVM vm)
         .Prop(_SC("Trace"), &SQLiteConnection::GetTracing, &SQLiteConnection::SetTracing)
         .Prop(_SC("Profile"), &SQLiteConnection::GetProfiling, &SQLiteConnection::SetProfiling)
         .Prop(_SC("QueueSize"), &SQLiteConnection::QueueSize)
+        .Prop(_SC("CacheCapacity"), &SQLiteConnection::GetCacheCapacity, &SQLiteConnection::SetCacheCapacity)
+        .Prop(_SC("CacheSize"), &SQLiteConnection::GetCacheSize)
+        .Prop(_SC("CacheHits"), &SQLiteConnection::GetCacheHits)
+        .Prop(_SC("CacheMisses"), &SQLiteConnection::GetCacheMisses)
+        .Prop(_SC("CacheEvictions"), &SQLiteConnection::GetCacheEvictions)
+        .Prop(_SC("WriteBehind"), &SQLiteConnection::GetWriteBehind, &SQLiteConnection::SetWriteBehind)
+        .Prop(_SC("WriteBatch"), &SQLiteConnection::GetWriteBatch, &SQLiteConnection::SetWriteBatch)
+        .Prop(_SC("WriteDelay"), &SQLiteConnection::GetWriteDelay, &SQLiteConnection::SetWriteDelay)
+        .Prop(_SC("WriteDepth"), &SQLiteConnection::GetWriteDepth)
+        .Prop(_SC("WriteErrors"), &SQLiteConnection::GetWriteErrors)
+        .Prop(_SC("Commits"), &SQLiteConnection::GetCommits)
+        .Prop(_SC("CommitLatency"), &SQLiteConnection::GetCommitLatency)
+        .Prop(_SC("PeakCommitLatency"), &SQLiteConnection::GetPeakCommitLatency)
+        .Prop(_SC("OnCommit"), &SQLiteConnection::GetOnCommit, &SQLiteConnection::SetOnCommit)
+        .Prop(_SC("OnWriteError"), &SQLiteConnection::GetOnWriteError, &SQLiteConnection::SetOnWriteError)
         // Member Methods
         .Func(_SC("Release"), &SQLiteConnection::Release)
         .FmtFunc(_SC("Exec"), &SQLiteConnection::Exec)
@@ -3028,6 +3541,11 @@ void Register_SQLite(HSQUIRRELVM vm)
         .Func(_SC("CompactQueue"), &SQLiteConnection::CompactQueue)
         .Func(_SC("ClearQueue"), &SQLiteConnection::ClearQueue)
         .Func(_SC("PopQueue"), &SQLiteConnection::PopQueue)
+        .Func(_SC("ClearCache"), &SQLiteConnection::ClearCache)
+        .Func(_SC("ResetCacheStats"), &SQLiteConnection::ResetCacheStats)
+        .Func(_SC("ResetWriteStats"), &SQLiteConnection::ResetWriteStats)
+        .Func(_SC("BindOnCommit"), &SQLiteConnection::BindOnCommit)
+        .Func(_SC("BindOnWriteError"), &SQLiteConnection::BindOnWriteError)
         // Member Overloads
         .Overload< void (SQLiteConnection::*)(StackStrF &) >(_SC("Open"), &SQLiteConnection::Open)
         .Overload< void (SQLiteConnection::*)(StackStrF &, int32_t) >(_SC("Open"), &SQLiteConnection::Open)
@@ -2,6 +2,7 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
+#include "Core/StmtCache.hpp"
 #include "Core/ThreadPool.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -19,6 +20,11 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <condition_variable>
 
 // ------------------------------------------------------------------------------------------------
 #ifdef SQMOD_POCO_HAS_SQLITE
@@ -146,6 +152,142 @@ SQMOD_NODISCARD LightObj ArrayToQueryColumns(Array & arr);
 */
 SQMOD_NODISCARD LightObj TableToQueryColumns(Table & tbl);
 
+/* ------------------------------------------------------------------------------------------------
+ * Applies queued queries to a database file from a dedicated thread, through a second connection
+ * opened in WAL mode. Pending queries are grouped in a single transaction once enough of them were
+ * queued or the oldest one waited long enough. The outcome of each transaction is delivered back
+ * on the main thread, to the callbacks of the connection that owns the writer.
+*/
+struct SQLiteWriter
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    static constexpr size_t     DEFAULT_BATCH = 64; // Queries that trigger a commit by default.
+    static constexpr int64_t    DEFAULT_DELAY = 50000; // Microseconds a query can wait by default.
+    static constexpr int32_t    BUSY_TIMEOUT = 5000; // Milliseconds to wait for the other connection.
+
+    /* --------------------------------------------------------------------------------------------
+     * A query that failed inside a transaction.
+    */
+    struct Failure
+    {
+        int32_t mStatus{SQLITE_OK}; // The received status code.
+        String  mQuery{}; // The query string.
+        String  mMessage{}; // The received error message.
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * The outcome of a transaction.
+    */
+    struct Result
+    {
+        size_t                  mCount{0}; // Queries in the transaction.
+        int32_t                 mChanges{0}; // Rows changed by the transaction.
+        int64_t                 mLatency{0}; // Microseconds from when the oldest query was queued.
+        bool                    mCommitted{false}; // Whether the transaction was committed.
+        std::vector< Failure >  mFailures{}; // Queries that failed.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    static std::vector< SQLiteWriter * > sWriters; // Active writers. Only accessed from the main thread.
+
+    // --------------------------------------------------------------------------------------------
+    SQLiteConnHnd &             mOwner; // The connection that owns this writer.
+    sqlite3 *                   mPtr; // The writer connection. Only used by the writer thread.
+
+    // --------------------------------------------------------------------------------------------
+    std::thread                 mThread; // The writer thread.
+    std::mutex                  mMutex; // Guards the pending queries and the thread state.
+    std::condition_variable     mCond; // Wakes the writer thread.
+    std::vector< String >       mPending; // Queries waiting to be committed.
+    int64_t                     mOldest; // Time-point when the oldest pending query was queued.
+    bool                        mRun; // Whether the writer thread should keep running.
+    bool                        mFlush; // Whether pending queries should be committed right away.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< size_t >       mBatch; // Number of pending queries that triggers a commit.
+    std::atomic< int64_t >      mDelay; // Microseconds a query can wait before a commit is triggered.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< size_t >       mDepth; // Queries that were queued but not yet committed.
+    std::atomic< uint64_t >     mCommits; // Transactions that were committed.
+    std::atomic< uint64_t >     mErrors; // Queries or transactions that failed.
+    std::atomic< int64_t >      mLatency; // Latency of the last transaction.
+    std::atomic< int64_t >      mPeakLatency; // Highest latency of a transaction.
+
+    // --------------------------------------------------------------------------------------------
+    moodycamel::ConcurrentQueue< Result > mResults; // Outcomes waiting to be delivered.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor. Opens a second connection to the database of the owner and starts the
+     * writer thread with the settings of the owner.
+    */
+    explicit SQLiteWriter(SQLiteConnHnd & owner);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    SQLiteWriter(const SQLiteWriter & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    SQLiteWriter(SQLiteWriter && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor. Commits the pending queries before the writer connection is closed.
+    */
+    ~SQLiteWriter();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    SQLiteWriter & operator = (const SQLiteWriter & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    SQLiteWriter & operator = (SQLiteWriter && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Hand a query over to the writer thread.
+    */
+    void Push(String && query);
+
+    /* --------------------------------------------------------------------------------------------
+     * Hand a range of queries over to the writer thread.
+    */
+    void Push(std::vector< String >::iterator itr, std::vector< String >::iterator end);
+
+    /* --------------------------------------------------------------------------------------------
+     * Ask the writer thread to commit the pending queries without waiting for a trigger.
+    */
+    void Flush();
+
+    /* --------------------------------------------------------------------------------------------
+     * Commit the pending queries and wait for the writer thread to finish.
+    */
+    void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Deliver the outcome of the finished transactions. Returns the number left for later.
+    */
+    size_t Process(FrameSlice & slice);
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Writer thread procedure.
+    */
+    void Proc();
+
+    /* --------------------------------------------------------------------------------------------
+     * Apply a group of queries in a single transaction.
+    */
+    void Commit(std::vector< String > & queries, int64_t oldest);
+};
+
 /* ------------------------------------------------------------------------------------------------
  * The structure that holds the data associated with a certain connection.
 */
@@ -178,6 +320,17 @@ public:
     // --------------------------------------------------------------------------------------------
     QueryList   mQueue; // A queue of queries to be executed in groups.
 
+    // --------------------------------------------------------------------------------------------
+    StmtCache< sqlite3_stmt * > mCache; // Idle prepared statements that can be reused.
+
+    // --------------------------------------------------------------------------------------------
+    std::unique_ptr< SQLiteWriter > mWriter; // Applies queued queries in the background, if enabled.
+    size_t      mWriteBatch; // Number of pending queries that triggers a background commit.
+    int64_t     mWriteDelay; // Microseconds a query can wait before a background commit is triggered.
+    Function    mOnCommit; // Receives the outcome of each background transaction.
+    Function    mOnWriteError; // Receives each query that failed in the background.
+    int32_t     mBusyTimeout; // Milliseconds to wait for a locked database. Negative if never set.
+
     // --------------------------------------------------------------------------------------------
     int32_t     mFlags; // The flags used to create the database connection handle.
     String      mName; // The specified name to be used as the database file.
@@ -237,7 +390,9 @@ public:
     void Create(const SQChar * name, int32_t flags, const SQChar * vfs);
 
     /* --------------------------------------------------------------------------------------------
-     * Execute a specific amount of queries from the queue.
+     * Execute a specific amount of queries from the queue. While write-behind is enabled, the
+     * queries are handed to the writer thread instead, their number is returned and an error
+     * callback is refused because failures are delivered to the write error callback.
     */
     int32_t Flush(uint32_t num, Object & env, Function & func);
 
@@ -331,6 +486,7 @@ public:
     // --------------------------------------------------------------------------------------------
     bool        mGood; // True when a row has been fetched with step.
     bool        mDone; // True when the last step had no more rows to fetch.
+    bool        mCached; // True when the statement goes back to the connection cache.
 
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
@@ -842,6 +998,67 @@ public:
     */
     SQMOD_NODISCARD int32_t GetInfo(int32_t operation, bool highwater, bool reset);
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of idle prepared statements kept by the connection.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheCapacity() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetCapacity());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of idle prepared statements kept by the connection.
+    */
+    void SetCacheCapacity(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of idle prepared statements kept by the connection.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheSize() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetSize());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that were found in the cache.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheHits() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetHits());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of statements that had to be prepared.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheMisses() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetMisses());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of idle statements that were released to make room for others.
+    */
+    SQMOD_NODISCARD SQInteger GetCacheEvictions() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mCache.GetEvictions());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all idle prepared statements kept by the connection.
+    */
+    void ClearCache()
+    {
+        SQMOD_GET_VALID(*this)->mCache.Clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the statement cache counters.
+    */
+    void ResetCacheStats()
+    {
+        SQMOD_GET_VALID(*this)->mCache.ResetStats();
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the number of queries in the queue.
     */
@@ -887,14 +1104,161 @@ public:
     int32_t Flush(SQInteger num);
 
     /* --------------------------------------------------------------------------------------------
-     * Flush all queries from the queue and handle errors manually.
+     * Flush all queries from the queue and handle errors manually. Not allowed with write-behind.
     */
     int32_t Flush(Object & env, Function & func);
 
     /* --------------------------------------------------------------------------------------------
-     * Flush a specific amount of queries from the queue and handle errors manually.
+     * Flush a specific amount of queries from the queue and handle errors manually. Not allowed
+     * with write-behind.
     */
     int32_t Flush(SQInteger num, Object & env, Function & func);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether queued queries are applied in the background.
+    */
+    SQMOD_NODISCARD bool GetWriteBehind() const
+    {
+        return static_cast< bool >(SQMOD_GET_VALID(*this)->mWriter);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Enable or disable applying queued queries in the background. While enabled, queued queries
+     * go straight to a writer thread and flushing only asks it to commit without waiting. Writes
+     * made directly on this connection wait for the writer to release the database, for as long
+     * as the busy timeout allows. A default timeout is applied if none was set.
+    */
+    void SetWriteBehind(bool toggle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of pending queries that triggers a commit.
+    */
+    SQMOD_NODISCARD SQInteger GetWriteBatch() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mWriteBatch);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of pending queries that triggers a commit.
+    */
+    void SetWriteBatch(SQInteger n);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds a queued query can wait before a commit is triggered.
+    */
+    SQMOD_NODISCARD SQInteger GetWriteDelay() const
+    {
+        return static_cast< SQInteger >(SQMOD_GET_VALID(*this)->mWriteDelay / 1000);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds a queued query can wait before a commit is triggered.
+    */
+    void SetWriteDelay(SQInteger ms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of queries that were queued but not yet committed.
+    */
+    SQMOD_NODISCARD SQInteger GetWriteDepth() const
+    {
+        return static_cast< SQInteger >(GetWriter().mDepth.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of committed transactions.
+    */
+    SQMOD_NODISCARD SQInteger GetCommits() const
+    {
+        return static_cast< SQInteger >(GetWriter().mCommits.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of queries or transactions that failed in the background.
+    */
+    SQMOD_NODISCARD SQInteger GetWriteErrors() const
+    {
+        return static_cast< SQInteger >(GetWriter().mErrors.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the microseconds between queuing and committing for the last transaction.
+    */
+    SQMOD_NODISCARD SQInteger GetCommitLatency() const
+    {
+        return static_cast< SQInteger >(GetWriter().mLatency.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the highest microseconds between queuing and committing for a transaction.
+    */
+    SQMOD_NODISCARD SQInteger GetPeakCommitLatency() const
+    {
+        return static_cast< SQInteger >(GetWriter().mPeakLatency.load());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the callback that receives the outcome of each background transaction.
+    */
+    SQMOD_NODISCARD Function & GetOnCommit()
+    {
+        return SQMOD_GET_VALID(*this)->mOnCommit;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback that receives the outcome of each background transaction. It receives
+     * the number of queries, the number of changed rows, the latency and whether it was committed.
+    */
+    void SetOnCommit(Function & cb)
+    {
+        SQMOD_GET_VALID(*this)->mOnCommit = cb;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback that receives the outcome of each background transaction.
+    */
+    SQLiteConnection & BindOnCommit(Function & cb)
+    {
+        SQMOD_GET_VALID(*this)->mOnCommit = cb;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the callback that receives each query that failed in the background.
+    */
+    SQMOD_NODISCARD Function & GetOnWriteError()
+    {
+        return SQMOD_GET_VALID(*this)->mOnWriteError;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback that receives each query that failed in the background. It receives
+     * the status code, the query string and the error message.
+    */
+    void SetOnWriteError(Function & cb)
+    {
+        SQMOD_GET_VALID(*this)->mOnWriteError = cb;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the callback that receives each query that failed in the background.
+    */
+    SQLiteConnection & BindOnWriteError(Function & cb)
+    {
+        SQMOD_GET_VALID(*this)->mOnWriteError = cb;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the background writer counters.
+    */
+    void ResetWriteStats() const;
+
+protected:
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the background writer or throw an error if it was not enabled.
+    */
+    SQMOD_NODISCARD SQLiteWriter & GetWriter() const;
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -82,13 +82,278 @@ static void FlushMultiBuffer(HSQUIRRELVM vm, Function & callback, ZMsg::List & l
 }
 
 // ------------------------------------------------------------------------------------------------
-void ZSkt::Flush(HSQUIRRELVM vm)
+ZReactor::Guard::Guard()
+{
+    ZReactor & r = ZReactor::Get();
+    // Let the reactor know that someone waits for the lock
+    ++r.mWaiting;
+    // Interrupt it in case it waits in zmq_poll()
+    r.Wake();
+    // Acquire exclusive access to the sockets
+    r.mMtx.lock();
+}
+
+// ------------------------------------------------------------------------------------------------
+ZReactor::Guard::~Guard()
+{
+    ZReactor & r = ZReactor::Get();
+    // Decrease while holding the lock so the reactor can't miss it
+    --r.mWaiting;
+    // Yield exclusive access to the sockets
+    r.mMtx.unlock();
+    // Let the reactor resume
+    r.mCond.notify_one();
+}
+
+// ------------------------------------------------------------------------------------------------
+ZReactor::ZReactor()
+    : mMtx(), mCond(), mWaiting(0), mSignaled(false), mWakeMtx()
+    , mContext(nullptr), mWakeRecv(nullptr), mWakeSend(nullptr)
+    , mSockets(), mPolled(), mItems(), mDirty(true), mRun(false), mThread()
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+ZReactor::~ZReactor()
+{
+    // The thread must not outlive the reactor
+    Stop();
+}
+
+// ------------------------------------------------------------------------------------------------
+ZReactor & ZReactor::Get()
+{
+    static ZReactor r;
+    return r;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Attach(ZSkt * skt)
+{
+    // Make sure there's someone to service the socket
+    if (!mThread.joinable())
+    {
+        Start();
+    }
+    mSockets.push_back(skt);
+    // The poll items must include it
+    mDirty = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Detach(ZSkt * skt)
+{
+    mSockets.erase(std::remove(mSockets.begin(), mSockets.end(), skt), mSockets.end());
+    // The poll items must not include it
+    mDirty = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Wake()
+{
+    // Is there a signal on the way already?
+    if (mSignaled.exchange(true))
+    {
+        return;
+    }
+    // Acquire exclusive access to the sending side
+    std::lock_guard< std::mutex > guard(mWakeMtx);
+    // Is the reactor running?
+    if (mWakeSend)
+    {
+        zmq_send(mWakeSend, nullptr, 0, ZMQ_DONTWAIT);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Start()
+{
+    // Create a context for the signal
+    mContext = zmq_ctx_new();
+    // Validate the context
+    if (!mContext)
+    {
+        STHROWF("Unable to initialize reactor context: {}", zmq_strerror(errno));
+    }
+    // Create both sides of the signal
+    mWakeRecv = zmq_socket(mContext, ZMQ_PAIR);
+    mWakeSend = zmq_socket(mContext, ZMQ_PAIR);
+    // Connect them
+    if (!mWakeRecv || !mWakeSend || zmq_bind(mWakeRecv, "inproc://sqmod-zmq-reactor") != 0 ||
+        zmq_connect(mWakeSend, "inproc://sqmod-zmq-reactor") != 0)
+    {
+        const int e = errno;
+        // Release what was created
+        Stop();
+        // Now we can report it
+        STHROWF("Unable to initialize reactor signal: {}", zmq_strerror(e));
+    }
+    // Any previous signal was lost
+    mSignaled = false;
+    mDirty = true;
+    mRun = true;
+    // Create the reactor thread
+    mThread = std::thread(&ZReactor::Proc, this);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Stop()
+{
+    // Is the reactor thread running?
+    if (mThread.joinable())
+    {
+        // Scope the exclusive access to the sockets
+        {
+            Guard guard;
+            // Stop the loop
+            mRun = false;
+        }
+        // Wait for the thread
+        mThread.join();
+    }
+    // Acquire exclusive access to the sending side
+    std::lock_guard< std::mutex > guard(mWakeMtx);
+    // Close the signal
+    if (mWakeSend)
+    {
+        zmq_close(mWakeSend);
+        mWakeSend = nullptr;
+    }
+    if (mWakeRecv)
+    {
+        zmq_close(mWakeRecv);
+        mWakeRecv = nullptr;
+    }
+    // Release the context
+    if (mContext)
+    {
+        zmq_ctx_term(mContext);
+        mContext = nullptr;
+    }
+    // Forget about the poll items
+    mPolled.clear();
+    mItems.clear();
+    mDirty = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Rebuild()
+{
+    mPolled.clear();
+    mItems.clear();
+    // The signal goes first
+    mItems.push_back(zmq_pollitem_t{mWakeRecv, 0, ZMQ_POLLIN, 0});
+    // Sockets of a context that was shut down would make zmq_poll() fail
+    for (ZSkt * skt : mSockets)
+    {
+        if (!skt->mTerminated)
+        {
+            mPolled.push_back(skt);
+            mItems.push_back(zmq_pollitem_t{skt->mPtr, 0, ZMQ_POLLIN, 0});
+        }
+    }
+    mDirty = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ZReactor::Prune()
+{
+    size_t n = 0;
+    // Look for the sockets that can't be used anymore
+    for (ZSkt * skt : mPolled)
+    {
+        int events = 0;
+        size_t events_sz = sizeof(int);
+        // Only sockets of a terminated context fail this way
+        if (zmq_getsockopt(skt->mPtr, ZMQ_EVENTS, &events, &events_sz) != 0 && errno == ETERM)
+        {
+            skt->mTerminated = true;
+            ++n;
+        }
+    }
+    // The poll items must not include them anymore
+    if (n)
+    {
+        mDirty = true;
+    }
+    return n;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZReactor::Proc()
+{
+    // The sockets are only released while waiting
+    std::unique_lock< std::mutex > lock(mMtx);
+    // Enter processing loop
+    for (;;)
+    {
+        // Step aside while other threads need the sockets
+        mCond.wait(lock, [this] { return mWaiting.load() == 0; });
+        // Should we stop?
+        if (!mRun)
+        {
+            break;
+        }
+        // Update the poll items if the sockets changed
+        if (mDirty)
+        {
+            Rebuild();
+        }
+        // Send what was queued and see which sockets are waiting for room
+        for (size_t i = 0; i < mPolled.size(); ++i)
+        {
+            mItems[i + 1].events = mPolled[i]->Send() ? (ZMQ_POLLIN | ZMQ_POLLOUT) : ZMQ_POLLIN;
+        }
+        // Wait for something to happen
+        const int r = zmq_poll(mItems.data(), static_cast< int >(mItems.size()), -1);
+        // Did the wait fail?
+        if (r < 0)
+        {
+            // Was the context of some socket shut down?
+            if (errno == ETERM && Prune() == 0)
+            {
+                LogErr("Unable to poll sockets: %s", zmq_strerror(errno));
+                // Don't exhaust resources pointlessly
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                lock.lock();
+            }
+            continue;
+        }
+        // Were we signaled?
+        if (mItems[0].revents & ZMQ_POLLIN)
+        {
+            // Consume the signals
+            while (zmq_recv(mWakeRecv, nullptr, 0, ZMQ_DONTWAIT) >= 0)
+            {
+                // Keep consuming
+            }
+            // Allow new signals only now, otherwise one sent in between would be consumed above and
+            // the flag would stay set with nothing queued. A wake that is skipped because the flag was
+            // still set is not lost either, since the loop checks the waiting threads and the send
+            // queues again before it polls
+            mSignaled = false;
+        }
+        // Receive the messages that arrived (sending happens at the start of the next round)
+        for (size_t i = 0; i < mPolled.size(); ++i)
+        {
+            if (mItems[i + 1].revents & ZMQ_POLLIN)
+            {
+                mPolled[i]->RecvAll(RECV_LIMIT);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ZSkt::Flush(HSQUIRRELVM vm, FrameSlice & slice)
 {
     // Need someone to receive the message
     Item item;
-    // Try to get a message from the queue
-    while (mOutputQueue.try_dequeue(item))
+    // Try to get a message from the queue, as long as the slice allows it
+    while (slice.Allow() && mOutputQueue.try_dequeue(item))
     {
+        slice.Count();
         // Is there a callback to receive the message?
         if (!mOnData.IsNull())
         {
@@ -117,6 +382,8 @@ void ZSkt::Flush(HSQUIRRELVM vm)
             }
         }
     }
+    // Whatever is left is carried over
+    return mOutputQueue.size_approx();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -129,7 +396,7 @@ LightObj ZSocket::GetOpt(int opt)
 {
     int r = 0;
     // Acquire exclusive access to the socket
-    std::lock_guard< std::mutex > guard(Valid().mMtx);
+    ZReactor::Guard guard;
     // Identify option
     switch (opt)
     {
@@ -279,7 +546,7 @@ void ZSocket::SetOpt(int opt, LightObj & value)
 {
     int r = 0;
     // Acquire exclusive access to the socket
-    std::lock_guard< std::mutex > guard(Valid().mMtx);
+    ZReactor::Guard guard;
     // Identify option
     switch (opt)
     {
@@ -433,14 +700,20 @@ static String SqZmqVersion()
 }
 
 // ------------------------------------------------------------------------------------------------
-static void SqZmqProcess()
+size_t ProcessZMQ(FrameSlice & slice)
 {
-    // Go over all sockets and try to update them
-    for (ZSkt * inst = ZSkt::sHead; inst && inst->mNext != ZSkt::sHead; inst = inst->mNext)
-    {
-        // Flush pending messages
-        inst->Flush(SqVM());
-    }
+    static size_t s_Cursor = 0;
+    // Go over all sockets and flush their pending messages
+    return ProcessChain< ZSkt >(s_Cursor, slice, [&slice](ZSkt & inst) -> size_t {
+        return inst.Flush(SqVM(), slice);
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqZmqProcess()
+{
+    // Messages are flushed within the budget of the associated stage
+    return static_cast< SQInteger >(FrameBudget::Get().Run(static_cast< size_t >(FrameBudget::Get().Find("ZMQ"))));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -454,6 +727,8 @@ void ZmqTerminate()
         // Flush pending messages
         inst->Flush(SqVM());
     }
+    // Nothing left for the reactor to service
+    ZReactor::Get().Stop();
 }
 
 // ================================================================================================
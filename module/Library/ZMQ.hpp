@@ -3,15 +3,19 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core/Utility.hpp"
 #include "Library/IO/Buffer.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
+#include <deque>
 #include <mutex>
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <memory>
 #include <chrono>
 #include <utility>
 #include <algorithm>
+#include <condition_variable>
 
 // ------------------------------------------------------------------------------------------------
 #include <zmq.h>
@@ -23,6 +27,7 @@ namespace SqMod {
 // ------------------------------------------------------------------------------------------------
 struct ZCtx;
 struct ZSkt;
+struct ZReactor;
 struct ZContext;
 struct ZSocket;
 
@@ -241,6 +246,133 @@ struct ZMsg
     }
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * Single thread that services all ZMQ sockets. It waits in zmq_poll() on every socket plus an
+ * inproc pair that is signaled whenever messages are queued for sending or another thread needs
+ * to access the sockets. Sockets are only touched while holding the reactor lock.
+*/
+struct ZReactor
+{
+    /* --------------------------------------------------------------------------------------------
+     * Exclusive access to the sockets from outside the reactor thread.
+    */
+    struct Guard
+    {
+        /* ----------------------------------------------------------------------------------------
+         * Interrupt the reactor and acquire the lock.
+        */
+        Guard();
+
+        /* ----------------------------------------------------------------------------------------
+         * Copy constructor (disabled).
+        */
+        Guard(const Guard &) = delete;
+
+        /* ----------------------------------------------------------------------------------------
+         * Release the lock and let the reactor resume.
+        */
+        ~Guard();
+
+        /* ----------------------------------------------------------------------------------------
+         * Assignment operator (disabled).
+        */
+        Guard & operator = (const Guard &) = delete;
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Maximum number of messages moved out of a send queue at once.
+    */
+    static constexpr size_t BATCH = 64;
+
+    /* --------------------------------------------------------------------------------------------
+     * Maximum number of messages received from a socket before the others get a chance.
+    */
+    static constexpr size_t RECV_LIMIT = 256;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the reactor instance.
+    */
+    SQMOD_NODISCARD static ZReactor & Get();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor (disabled).
+    */
+    ZReactor(const ZReactor &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~ZReactor();
+
+    /* --------------------------------------------------------------------------------------------
+     * Assignment operator (disabled).
+    */
+    ZReactor & operator = (const ZReactor &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Start servicing a socket. Starts the reactor thread if necessary. Requires the lock.
+    */
+    void Attach(ZSkt * skt);
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop servicing a socket. Requires the lock.
+    */
+    void Detach(ZSkt * skt);
+
+    /* --------------------------------------------------------------------------------------------
+     * Interrupt the reactor if it is waiting in zmq_poll().
+    */
+    void Wake();
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop the reactor thread and release the signaling sockets.
+    */
+    void Stop();
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    ZReactor();
+
+    /* --------------------------------------------------------------------------------------------
+     * Create the signaling sockets and start the reactor thread. Requires the lock.
+    */
+    void Start();
+
+    /* --------------------------------------------------------------------------------------------
+     * Reactor thread.
+    */
+    void Proc();
+
+    /* --------------------------------------------------------------------------------------------
+     * Rebuild the list of items given to zmq_poll().
+    */
+    void Rebuild();
+
+    /* --------------------------------------------------------------------------------------------
+     * Exclude the sockets where the context was shut down. Returns the number of sockets excluded.
+    */
+    size_t Prune();
+
+    // --------------------------------------------------------------------------------------------
+    std::mutex                      mMtx; // Lock held by the reactor while it services the sockets.
+    std::condition_variable         mCond; // Used to resume the reactor once nobody waits for the lock.
+    std::atomic< int >              mWaiting; // Number of threads that wait for the lock.
+    std::atomic< bool >             mSignaled; // Whether a signal is already on the way.
+    std::mutex                      mWakeMtx; // Serializes access to the sending side of the signal.
+    void *                          mContext; // Context of the signaling sockets.
+    void *                          mWakeRecv; // Receiving side of the signal, polled by the reactor.
+    void *                          mWakeSend; // Sending side of the signal.
+    std::vector< ZSkt * >           mSockets; // Sockets serviced by the reactor.
+    std::vector< ZSkt * >           mPolled; // Sockets in the poll items, in the same order.
+    std::vector< zmq_pollitem_t >   mItems; // Items given to zmq_poll(), the signal being first.
+    bool                            mDirty; // Whether the poll items must be rebuilt.
+    bool                            mRun; // Whether the reactor thread should keep running.
+    std::thread                     mThread; // The reactor thread.
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Core implementation and management for a ZMQ socket.
 */
@@ -267,9 +399,9 @@ struct ZSkt : SqChainedInstances< ZSkt >
     void * mPtr;
 
     /* --------------------------------------------------------------------------------------------
-     * Socket status.
+     * Whether the context of the socket was shut down.
     */
-    bool mRun;
+    bool mTerminated;
 
     /* --------------------------------------------------------------------------------------------
      * Messages should be delivered as string instead of binary data.
@@ -281,11 +413,6 @@ struct ZSkt : SqChainedInstances< ZSkt >
     */
     int mType;
 
-    /* --------------------------------------------------------------------------------------------
-     * Synchronization mutex.
-    */
-    std::mutex mMtx;
-
     /* --------------------------------------------------------------------------------------------
      * Messages received from the socket.
     */
@@ -297,14 +424,14 @@ struct ZSkt : SqChainedInstances< ZSkt >
     Queue mInputQueue;
 
     /* --------------------------------------------------------------------------------------------
-     * Message received callback.
+     * Messages taken from the input queue that the socket had no room for yet. (reactor only)
     */
-    Function mOnData;
+    std::deque< Item > mBacklog;
 
     /* --------------------------------------------------------------------------------------------
-     * Processing thread.
+     * Message received callback.
     */
-    std::thread mThread;
+    Function mOnData;
 
     /* --------------------------------------------------------------------------------------------
      * Socket context.
@@ -316,42 +443,30 @@ struct ZSkt : SqChainedInstances< ZSkt >
     */
     ZSkt(const ZCtx::Ptr & ctx, int type)
         : SqChainedInstances< ZSkt >()
-        , mPtr(nullptr), mRun(true), mStringMessages(true), mType(type), mMtx()
-        , mOutputQueue(4096), mInputQueue(4096)
-        , mOnData(), mThread(), mContext(ctx)
+        , mPtr(nullptr), mTerminated(false), mStringMessages(true), mType(type)
+        , mOutputQueue(4096), mInputQueue(4096), mBacklog()
+        , mOnData(), mContext(ctx)
     {
         // Validate the context
         if (!ctx)
         {
             STHROWF("Invalid context");
         }
-        // Create the processing thread
-        mThread = std::thread(&ZSkt::Proc, this);
-        // Remember this instance
-        ChainInstance();
-        // Wait for the socket to be created before we attempt to use it
-        for (int n = 0; n < 100; ++n)
+        // Scope the exclusive access to the sockets
         {
-            using namespace std::chrono_literals;
-            // Acquire exclusive access to the socket
-            mMtx.lock();
-            // Was the socket created?
-            if (mPtr)
-            {
-                // Release exclusive access to the socket
-                mMtx.unlock();
-                // Socket created
-                break;
-            }
-            else
+            ZReactor::Guard guard;
+            // Create the socket
+            mPtr = zmq_socket(*mContext, mType);
+            // Validate the socket
+            if (!mPtr)
             {
-                // Release exclusive access to the socket
-                mMtx.unlock();
-                // Wait for the socket to be created
-                std::this_thread::sleep_for(10ms);
+                STHROWF("Unable to initialize socket: {}", zmq_strerror(errno));
             }
+            // Let the reactor service it
+            ZReactor::Get().Attach(this);
         }
-        // If it wasn't created by this point then something isn't right
+        // Remember this instance
+        ChainInstance();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -399,88 +514,49 @@ struct ZSkt : SqChainedInstances< ZSkt >
     operator void * () const noexcept { return mPtr; } // NOLINT(google-explicit-constructor)
 
     /* --------------------------------------------------------------------------------------------
-     * Internal processing thread.
-     * NOTE: Messages are being sent in whatever order we can.
-     *       Don't expect them be in the order you sent or receive them.
-     *       That's the cost of simplicity. And something I can live with under the circumstances.
+     * Flush messages from the queue to the script.
     */
-    void Proc()
+    void Flush(HSQUIRRELVM vm)
     {
-        // Acquire exclusive access to the socket
-        mMtx.lock();
-        // Create the socket in this thread
-        mPtr = zmq_socket(*mContext, mType);
-        // Validate the socket
-        if (!mPtr)
-        {
-            LogErr("Unable to initialize socket: %s", zmq_strerror(errno));
-            // Stop the thread
-            return;
-        }
-        // Release exclusive access to the socket
-        mMtx.unlock();
-        // Enter processing loop
-        while (mRun)
-        {
-            using namespace std::chrono_literals;
-            // Acquire exclusive access to the socket
-            mMtx.lock();
-            // Perform tasks until there's none left
-            if (!Recv() && !Send())
-            {
-                // Release exclusive access to the socket
-                mMtx.unlock();
-                // Don't exhaust resources pointlessly
-                std::this_thread::sleep_for(50ms);
-            }
-            else
-            {
-                // Release exclusive access to the socket
-                mMtx.unlock();
-            }
-        }
-        // Acquire exclusive access to the socket
-        mMtx.lock();
-        // Close the socket
-        int r = zmq_close(mPtr);
-        // Forget about it
-        mPtr = nullptr;
-        // Release exclusive access to the socket
-        mMtx.unlock();
-        // Validate result
-        if (r != 0)
-        {
-            LogErr("Unable to close socket: [%d] {%s}", r, zmq_strerror(errno));
-        }
+        FrameSlice slice;
+        // Flush everything
+        Flush(vm, slice);
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Flush messages from the queue to the script.
+     * Flush messages from the queue to the script within the given slice. Returns how many are left.
     */
-    void Flush(HSQUIRRELVM vm);
+    size_t Flush(HSQUIRRELVM vm, FrameSlice & slice);
 
     /* --------------------------------------------------------------------------------------------
      * Stop sockets and prepare for a shutdown.
     */
     void Close()
     {
-        // Is the processing thread running?
-        if (mThread.joinable())
+        // Scope the exclusive access to the sockets
         {
-            // Acquire exclusive access
-            mMtx.lock();
-            // Stop the loop
-            mRun = false;
-            // Yield exclusive access
-            mMtx.unlock();
-            // Wait for the thread
-            mThread.join();
-        }
-        else
-        {
-            mRun = false; // Just in case
+            ZReactor::Guard guard;
+            // Is the socket still open?
+            if (mPtr)
+            {
+                // Hand over whatever was queued so the linger period applies to it
+                Send();
+                // The reactor must not touch it anymore
+                ZReactor::Get().Detach(this);
+                // Close the socket
+                int r = zmq_close(mPtr);
+                // Forget about it
+                mPtr = nullptr;
+                // Validate result
+                if (r != 0)
+                {
+                    LogErr("Unable to close socket: [%d] {%s}", r, zmq_strerror(errno));
+                }
+            }
+            // Messages that could not be sent are discarded
+            mBacklog.clear();
         }
-        // Forget about the context
+        // Forget about the context (may wait for the linger period of other sockets)
         mContext.reset();
     }
 
@@ -490,6 +566,8 @@ struct ZSkt : SqChainedInstances< ZSkt >
     void Send(const Buffer & data)
     {
         mInputQueue.enqueue(std::make_unique< ZMsg >(data));
+        // Let the reactor know
+        ZReactor::Get().Wake();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -498,6 +576,8 @@ struct ZSkt : SqChainedInstances< ZSkt >
     void Send(Buffer && data)
     {
         mInputQueue.enqueue(std::make_unique< ZMsg >(std::move(data)));
+        // Let the reactor know
+        ZReactor::Get().Wake();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -506,6 +586,8 @@ struct ZSkt : SqChainedInstances< ZSkt >
     void Send(const ZMsg::List & list)
     {
         mInputQueue.enqueue(std::make_unique< ZMsg >(list));
+        // Let the reactor know
+        ZReactor::Get().Wake();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -514,6 +596,55 @@ struct ZSkt : SqChainedInstances< ZSkt >
     void Send(ZMsg::List && list)
     {
         mInputQueue.enqueue(std::make_unique< ZMsg >(std::move(list)));
+        // Let the reactor know
+        ZReactor::Get().Wake();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Receive the messages that are waiting on the socket, up to the specified limit. Requires the
+     * reactor lock.
+    */
+    void RecvAll(size_t limit)
+    {
+        for (size_t n = 0; n < limit && Recv(); ++n)
+        {
+            // Keep receiving
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Send the queued messages to the socket, in batches, until the socket has no room for more.
+     * Returns true if messages are still waiting for room. Requires the reactor lock.
+    */
+    bool Send()
+    {
+        Item batch[ZReactor::BATCH];
+        // Keep going until the socket or the queue runs out
+        for (;;)
+        {
+            // Messages that were held back go first, to preserve the order
+            while (!mBacklog.empty())
+            {
+                // Is there room for this message?
+                if (!SendItem(*mBacklog.front()))
+                {
+                    return true; // Wait for the socket to become writable
+                }
+                mBacklog.pop_front();
+            }
+            // Take the next batch of messages from the queue
+            const size_t n = mInputQueue.try_dequeue_bulk(batch, ZReactor::BATCH);
+            // Was there anything left?
+            if (n == 0)
+            {
+                return false;
+            }
+            // Send them through the backlog so that they are kept if the socket fills up
+            for (size_t i = 0; i < n; ++i)
+            {
+                mBacklog.push_back(std::move(batch[i]));
+            }
+        }
     }
 
 protected:
@@ -536,8 +667,16 @@ protected:
         }
         // Ask for a message, if any
         r = zmq_msg_recv(&msg, mPtr, ZMQ_DONTWAIT);
+        // Did we have a message?
+        if (r < 0)
+        {
+            // Release this message
+            zmq_msg_close(&msg);
+            // No message was retrieved
+            return false;
+        }
         // Is this a multi-part message?
-        if (zmq_msg_more(&msg) == 1)
+        else if (zmq_msg_more(&msg) == 1)
         {
             return RecvMore(msg, r);
         }
@@ -546,16 +685,10 @@ protected:
                                                         static_cast< Buffer::SzType >(zmq_msg_size(&msg))));
         // Release this message
         zmq_msg_close(&msg);
-        // Did we have a message?
-        if (r >= 0)
-        {
-            // Put it in the queue
-            mOutputQueue.enqueue(std::move(item));
-            // We received a message
-            return true;
-        }
-        // No message was retrieved
-        return false;
+        // Put it in the queue
+        mOutputQueue.enqueue(std::move(item));
+        // We received a message
+        return true;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -588,16 +721,16 @@ protected:
                 // Abort everything
                 return false;
             }
-            // Ask for another message, if any (blocking operation!)
+            // Ask for another message (parts of a message arrive together)
             r = zmq_msg_recv(&msg, mPtr, 0);
             // Do we actually have a message?
             if (r >= 0)
             {
                 // Save it to the list
                 item->Push(msg);
-                // Close the message
-                zmq_msg_close(&msg);
             }
+            // Close the message
+            zmq_msg_close(&msg);
             // See if the message part last received from the socket was a data part with more parts to follow.
             zmq_getsockopt(mPtr, ZMQ_RCVMORE, &more, &more_sz);
         } while (more);
@@ -613,64 +746,66 @@ protected:
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Send one queued message to the socket.
+     * Send a queued message to the socket. Returns false if the socket had no room for it.
     */
-    bool Send()
+    bool SendItem(ZMsg & data) const
     {
-        // Need someone to receive the message
-        Item data;
-        // Try to get a message from the queue
-        if (mInputQueue.try_dequeue(data))
+        if (data.mMulti)
         {
-            if (data->mMulti)
-            {
-                SendMore(data->mList);
-            }
-            else
-            {
-                SendOne(data->mBuff);
-            }
-            // One item was found in the queue
-            return true;
+            return SendMore(data.mList);
         }
         else
         {
-            return false; // No item in the queue
+            return SendOne(data.mBuff);
         }
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Send a single message to the socket.
+     * Send a single message to the socket. Returns false if the socket had no room for it.
     */
-    void SendOne(Buffer & buff) const
+    bool SendOne(Buffer & buff) const
     {
         // Attempt to send the message
         int r = zmq_send(mPtr, buff.Data(), buff.Position(), ZMQ_DONTWAIT);
-        // Could we send what the message had?
-        if (r >= 0 && static_cast< Buffer::SzType >(r) != buff.Position())
+        // Could we send the message?
+        if (r < 0)
         {
+            // Should we try again later?
+            if (errno == EAGAIN)
+            {
+                return false;
+            }
             LogErr("Unable to send data to socket: [%d], {%s}", r, zmq_strerror(errno));
-            // NOTE: Should we put the buffer back into the queue?
         }
+        // The message was dealt with
+        return true;
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Send a multi-part message to the socket.
+     * Send a multi-part message to the socket. Returns false if the socket had no room for it.
     */
-    void SendMore(ZMsg::List & list) const
+    bool SendMore(ZMsg::List & list) const
     {
         // Send all message parts
         for (size_t i = 0, n = list.size(); i < n; ++i)
         {
             // Attempt to send the message
-            int r = zmq_send(mPtr, list[i].Data(), list[i].Position(), (i + 1) == n ? ZMQ_DONTWAIT : ZMQ_SNDMORE);
-            // Could we send what the message had?
-            if (r >= 0 && static_cast< Buffer::SzType >(r) != list[i].Position())
+            int r = zmq_send(mPtr, list[i].Data(), list[i].Position(),
+                                (i + 1) == n ? ZMQ_DONTWAIT : (ZMQ_SNDMORE | ZMQ_DONTWAIT));
+            // Could we send the message part?
+            if (r < 0)
             {
+                // Once the first part is accepted the others are guaranteed to be accepted as well
+                if (i == 0 && errno == EAGAIN)
+                {
+                    return false;
+                }
                 LogErr("Unable to send multi-part data to socket: [%d], %s", r, zmq_strerror(errno));
                 // NOTE: Should we abort the whole thing? But we probably already sent some.
             }
         }
+        // The message was dealt with
+        return true;
     }
 };
 
@@ -943,7 +1078,7 @@ struct ZSocket
     ZSocket & Bind(StackStrF & ep)
     {
         // Acquire exclusive access to the socket
-        std::lock_guard< std::mutex > guard(Valid().mMtx);
+        ZReactor::Guard guard;
         // Attempt to bind the socket
         int r = zmq_bind(Valid(), ep.mPtr);
         // Validate result
@@ -961,7 +1096,7 @@ struct ZSocket
     ZSocket & Connect(StackStrF & ep)
     {
         // Acquire exclusive access to the socket
-        std::lock_guard< std::mutex > guard(Valid().mMtx);
+        ZReactor::Guard guard;
         // Attempt to connect the socket
         int r = zmq_connect(Valid(), ep.mPtr);
         // Validate result
@@ -979,7 +1114,7 @@ struct ZSocket
     ZSocket & Disconnect(StackStrF & ep)
     {
         // Acquire exclusive access to the socket
-        std::lock_guard< std::mutex > guard(Valid().mMtx);
+        ZReactor::Guard guard;
         // Attempt to connect the socket
         int r = zmq_disconnect(Valid(), ep.mPtr);
         // Validate result
@@ -9,9 +9,12 @@
 #include <cstring>
 #include <cstdarg>
 #include <memory>
+#include <chrono>
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqratUtil.h>
+#include <sqratConst.h>
 
 // ------------------------------------------------------------------------------------------------
 #ifdef SQMOD_OS_WINDOWS
@@ -76,11 +79,20 @@ inline WORD GetLevelColor(BYTE level)
 
 } // Namespace::
 
+#else
+
+// ------------------------------------------------------------------------------------------------
+#include <unistd.h>
+#include <sys/uio.h>
+
 #endif // SQMOD_OS_WINDOWS
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+static constexpr size_t LOG_BATCH_SLOTS = 64; // Maximum number of slots written with a single call.
+
 /* ------------------------------------------------------------------------------------------------
  * Identify the message prefix.
 */
@@ -119,6 +131,42 @@ static inline uint8_t GetLevelIdx(uint8_t level)
 
 #ifndef SQMOD_OS_WINDOWS
 
+/* ------------------------------------------------------------------------------------------------
+ * Write a list of buffers to a file descriptor, resuming after partial writes.
+*/
+static void WriteVector(int fd, struct iovec * iov, int cnt)
+{
+    while (cnt > 0)
+    {
+        const ssize_t r = writev(fd, iov, cnt);
+        // Did the write fail?
+        if (r < 0)
+        {
+            // Interrupted by a signal?
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            OutputError("Unable to write to the log file : %s", std::strerror(errno));
+            // The data is lost
+            return;
+        }
+        auto left = static_cast< size_t >(r);
+        // Skip the buffers that were written completely
+        while (cnt > 0 && left >= iov->iov_len)
+        {
+            left -= iov->iov_len;
+            ++iov, --cnt;
+        }
+        // Adjust the buffer that was written partially
+        if (cnt > 0)
+        {
+            iov->iov_base = static_cast< char * >(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Identify the message prefix and color.
 */
@@ -278,6 +326,7 @@ Logger::Logger() noexcept
     : m_ThreadID(std::this_thread::get_id())
     , m_Message()
     , m_Queue(4096)
+    , m_Pool(POOL_SIZE)
     , m_ConsoleLevels(LOGL_ANY)
     , m_LogFileLevels(~LOGL_DBG)
     , m_ConsoleTime(false)
@@ -286,6 +335,26 @@ Logger::Logger() noexcept
     , m_StringTruncate(32)
     , m_File(nullptr)
     , m_Filename()
+    , m_Pattern()
+    , m_NameMutex()
+    , m_Slots()
+    , m_SlotCount(0)
+    , m_SlotRequest(4096)
+    , m_Head(0)
+    , m_Tail(0)
+    , m_Writer()
+    , m_Writing(false)
+    , m_WriterMutex()
+    , m_WriterCV()
+    , m_Active(false)
+    , m_FlushInterval(200)
+    , m_RotateSize(0)
+    , m_RotateInterval(0)
+    , m_Overflow(LOGO_COUNT)
+    , m_Dropped(0)
+    , m_Missed(0)
+    , m_Written(0)
+    , m_Rotations(0)
     , m_LogCb{}
 {
     /* ... */
@@ -300,6 +369,20 @@ Logger::~Logger()
 // ------------------------------------------------------------------------------------------------
 void Logger::Close()
 {
+    // Is the writer thread running?
+    if (m_Writer.joinable())
+    {
+        {
+            std::lock_guard< std::mutex > lock(m_WriterMutex);
+            // Tell the writer to stop after writing what was buffered
+            m_Writing = false;
+        }
+        m_WriterCV.notify_one();
+        // Wait for it to finish
+        m_Writer.join();
+    }
+    // Stop buffering file messages
+    m_Active = false;
     // Is there a file handle to close?
     if (m_File)
     {
@@ -318,31 +401,315 @@ void Logger::SetLogFilename(const char * filename)
     // Close the current logging file, if any
     Close();
     // Clear the current name
-    m_Filename.clear();
+    {
+        std::lock_guard< std::mutex > lock(m_NameMutex);
+        m_Filename.clear();
+    }
+    m_Pattern.clear();
     // Was there a name specified?
     if (!filename || *filename == '\0')
     {
         return; // We're done here!
     }
+    // Remember the pattern for rotation
+    m_Pattern.assign(filename);
+    // Attempt to open the file for writing
+    if (!OpenFile(false))
+    {
+        return; // We're done here!
+    }
+    // (Re)allocate the ring of slots, if necessary
+    if (!m_Slots || m_SlotCount != m_SlotRequest)
+    {
+        m_Slots = std::make_unique< Slot[] >(m_SlotRequest);
+        m_SlotCount = m_SlotRequest;
+    }
+    // The ring starts empty
+    m_Head = 0;
+    m_Tail = 0;
+    m_Missed = 0;
+    // Start the writer thread
+    m_Writing = true;
+    m_Writer = std::thread(&Logger::WriterProc, this);
+    // File messages can be buffered now
+    m_Active = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetBufferSlots(size_t count)
+{
+    // Keep the ring within sensible bounds and make it a power of two
+    count = std::min(std::max(count, size_t{16}), size_t{1} << 20u);
+    size_t n = 16;
+    while (n < count)
+    {
+        n <<= 1u;
+    }
+    // Applied when the file is opened
+    m_SlotRequest = n;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetOverflow(uint8_t policy)
+{
+    if (policy > LOGO_COUNT)
+    {
+        STHROWF("Unknown log overflow policy ({})", int(policy));
+    }
+    m_Overflow = policy;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::OpenFile(bool rotate)
+{
     // This should be enough for any kind of path
     char buffer[1024];
     // Obtain the current time for generating the filename
     const std::time_t t = std::time(nullptr);
     // Generate the filename using the current time-stamp
-    if (std::strftime(buffer, sizeof(buffer), filename, std::localtime(&t)) > 0)
+    if (std::strftime(buffer, sizeof(buffer), m_Pattern.c_str(), std::localtime(&t)) == 0)
     {
-        m_Filename.assign(buffer);
+        return false;
     }
-    else
+    std::string name(buffer);
+    // Don't overwrite existing files when rotating (pattern without time or within the same second)
+    if (rotate)
     {
-        return; // We're done here!
+        for (uint32_t n = 1; ; ++n)
+        {
+            std::FILE * f = std::fopen(name.c_str(), "r");
+            // Is the name free?
+            if (!f)
+            {
+                break;
+            }
+            std::fclose(f);
+            // Try the next index
+            name.assign(fmt::format("{}.{}", buffer, n));
+        }
     }
     // Attempt to open the file for writing
-    m_File = std::fopen(m_Filename.c_str(), "w");
+    m_File = std::fopen(name.c_str(), "w");
     // See if the file could be opened
     if (!m_File)
     {
-        OutputError("Unable to open the log file (%s) : %s", m_Filename.c_str(), std::strerror(errno));
+        OutputError("Unable to open the log file (%s) : %s", name.c_str(), std::strerror(errno));
+        // Can't write to it
+        return false;
+    }
+    // Publish the name of the file
+    std::lock_guard< std::mutex > lock(m_NameMutex);
+    m_Filename = std::move(name);
+    // Success
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Rotate()
+{
+    // Close the current file
+    if (m_File)
+    {
+        std::fflush(m_File);
+        std::fclose(m_File);
+        m_File = nullptr;
+    }
+    // Open the next one. Buffered slots are discarded until a file can be opened
+    if (OpenFile(true))
+    {
+        ++m_Rotations;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::WriteSlots(uint64_t & size)
+{
+    const size_t mask = m_SlotCount - 1;
+    // Only what was buffered so far
+    const size_t head = m_Head.load(std::memory_order_acquire);
+    size_t tail = m_Tail.load(std::memory_order_relaxed);
+    // Whether the last slot ends a line
+    bool end = true;
+    // Write the slots in batches
+    while (tail != head)
+    {
+        const size_t n = std::min(head - tail, LOG_BATCH_SLOTS);
+        size_t bytes = 0;
+#ifdef SQMOD_OS_WINDOWS
+        for (size_t i = 0; i < n; ++i)
+        {
+            Slot & slot = m_Slots[(tail + i) & mask];
+            // Is there a file to write to?
+            if (m_File)
+            {
+                std::fwrite(slot.mData, 1, slot.mLen, m_File);
+            }
+            bytes += slot.mLen;
+            end = slot.mEnd;
+        }
+        // Push the batch to the file
+        if (m_File)
+        {
+            std::fflush(m_File);
+        }
+#else
+        struct iovec iov[LOG_BATCH_SLOTS];
+        // Gather the slots
+        for (size_t i = 0; i < n; ++i)
+        {
+            Slot & slot = m_Slots[(tail + i) & mask];
+            iov[i].iov_base = slot.mData;
+            iov[i].iov_len = slot.mLen;
+            bytes += slot.mLen;
+            end = slot.mEnd;
+        }
+        // Write them with a single call
+        if (m_File)
+        {
+            WriteVector(fileno(m_File), iov, static_cast< int >(n));
+        }
+#endif // SQMOD_OS_WINDOWS
+        // Give the slots back to the main thread
+        tail += n;
+        m_Tail.store(tail, std::memory_order_release);
+        // Update statistics
+        size += bytes;
+        m_Written += bytes;
+    }
+    return end;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::WriterProc()
+{
+    using Clock = std::chrono::steady_clock;
+    // Size of the current file
+    uint64_t size = 0;
+    // When was the current file opened
+    Clock::time_point opened = Clock::now();
+    // Keep writing until told to stop
+    while (m_Writing.load())
+    {
+        {
+            std::unique_lock< std::mutex > lock(m_WriterMutex);
+            // Wake up periodically or when enough slots were buffered
+            m_WriterCV.wait_for(lock, std::chrono::milliseconds(m_FlushInterval.load()), [this]() {
+                return !m_Writing.load() || GetBuffered() >= (m_SlotCount >> 2u);
+            });
+        }
+        // Write what was buffered and rotate only at the end of a line
+        if (!WriteSlots(size) || size == 0)
+        {
+            continue;
+        }
+        const uint64_t rsize = m_RotateSize.load();
+        const uint32_t rtime = m_RotateInterval.load();
+        // Is it time to rotate the file?
+        if ((rsize > 0 && size >= rsize) || (rtime > 0 && (Clock::now() - opened) >= std::chrono::seconds(rtime)))
+        {
+            Rotate();
+            // Start over
+            size = 0;
+            opened = Clock::now();
+        }
+    }
+    // Write whatever is left
+    WriteSlots(size);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::BufferLine(const char * const * parts, const size_t * sizes, size_t count, bool urgent)
+{
+    constexpr size_t cap = sizeof(Slot::mData);
+    const size_t mask = m_SlotCount - 1;
+    // Compute the size of the line
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += sizes[i];
+    }
+    // Lines larger than the whole ring are truncated
+    total = std::min(total, m_SlotCount * cap);
+    // Number of slots required by the line
+    const size_t needed = (total + cap - 1) / cap;
+    size_t head = m_Head.load(std::memory_order_relaxed);
+    // Is there enough room in the ring?
+    while (m_SlotCount - (head - m_Tail.load(std::memory_order_acquire)) < needed)
+    {
+        // Should we wait for the writer?
+        if (m_Overflow != LOGO_BLOCK)
+        {
+            ++m_Dropped;
+            // Should the loss be reported?
+            if (m_Overflow == LOGO_COUNT)
+            {
+                ++m_Missed;
+            }
+            return false;
+        }
+        // Hurry the writer and give it some time
+        m_WriterCV.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    Slot * slot = &m_Slots[head & mask];
+    slot->mLen = 0;
+    // Copy the parts of the line into consecutive slots
+    for (size_t i = 0, left = total; i < count && left > 0; ++i)
+    {
+        const char * p = parts[i];
+        size_t n = std::min(sizes[i], left);
+        left -= n;
+        while (n > 0)
+        {
+            // Move to the next slot if this one is full
+            if (slot->mLen == cap)
+            {
+                slot->mEnd = false;
+                slot = &m_Slots[(++head) & mask];
+                slot->mLen = 0;
+            }
+            const size_t c = std::min(n, cap - slot->mLen);
+            std::memcpy(slot->mData + slot->mLen, p, c);
+            slot->mLen += static_cast< uint16_t >(c);
+            p += c, n -= c;
+        }
+    }
+    slot->mEnd = true;
+    // Publish the slots to the writer
+    m_Head.store(head + 1, std::memory_order_release);
+    // Wake the writer if this is important or the ring starts to fill
+    if (urgent || GetBuffered() >= (m_SlotCount >> 2u))
+    {
+        m_WriterCV.notify_one();
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+Logger::MsgPtr Logger::AcquireMessage(uint8_t lvl, bool sub)
+{
+    MsgPtr msg;
+    // Is there an idle instance that we can reuse?
+    if (m_Pool.try_dequeue(msg))
+    {
+        msg->Reset(lvl, sub);
+        return msg;
+    }
+    // Create a new one
+    return std::make_unique< Message >(lvl, sub);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::RecycleMessage(MsgPtr & msg)
+{
+    // Don't hold on to unusually large messages or to more instances than necessary
+    if (msg && msg->mStr.capacity() <= 4096 && m_Pool.size_approx() < POOL_SIZE)
+    {
+        m_Pool.enqueue(std::move(msg));
+    }
+    else
+    {
+        msg.reset();
     }
 }
 
@@ -392,19 +759,26 @@ void Logger::Release()
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::ProcessQueue()
+size_t Logger::ProcessQueue(FrameSlice & slice)
 {
     // Process only what's currently in the queue
     const size_t count = m_Queue.size_approx();
-    // Retrieve each message individually and process it
-    for (size_t n = 0; n <= count; ++n)
+    MsgPtr msg;
+    // Retrieve each message individually and process it, as long as the slice allows it
+    for (size_t n = 0; n <= count && slice.Allow(); ++n)
     {
         // Try to get a message from the queue
-        if (m_Queue.try_dequeue(m_Message))
+        if (m_Queue.try_dequeue(msg))
         {
+            // Reuse the previous message and mark this one as current
+            RecycleMessage(m_Message);
+            m_Message = std::move(msg);
+            slice.Count();
             ProcessMessage(); // Process it
         }
     }
+    // Whatever is left is carried over
+    return m_Queue.size_approx();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -452,6 +826,8 @@ void Logger::PushMessage(MsgPtr & msg)
     // Are we in the main thread?
     if (m_ThreadID == std::this_thread::get_id())
     {
+        // Reuse the previous message
+        RecycleMessage(m_Message);
         // Take ownership of this message and mark it as current/last message
         m_Message = std::move(msg);
         // Finish the message
@@ -482,6 +858,8 @@ void Logger::PushMessage(MsgPtr * msg, size_t len)
     {
         for (size_t i = 0; i < len; ++i)
         {
+            // Reuse the previous message
+            RecycleMessage(m_Message);
             // Take ownership of this message and mark it as current/last message
             m_Message = std::move(msg[i]);
             // Finish the message
@@ -538,21 +916,38 @@ void Logger::ProcessMessage()
         OutputConsoleMessage(m_Message);
     }
     // Are we allowed to write it to a file?
-    if (m_File && (m_LogFileLevels & m_Message->mLvl))
+    if (m_Active && (m_LogFileLevels & m_Message->mLvl))
     {
+        // Were there messages discarded since the last one that was written?
+        if (m_Missed > 0)
+        {
+            const std::string note = fmt::format("{} {} log message(s) discarded because the write buffer was full\n",
+                                                 GetLevelTag(LOGL_WRN), m_Missed);
+            const char * p = note.data();
+            const size_t n = note.size();
+            // Report them if there's room
+            if (BufferLine(&p, &n, 1, false))
+            {
+                m_Missed = 0;
+            }
+        }
+        const char * parts[6];
+        size_t sizes[6], count = 0;
         // Write the level tag
-        std::fputs(GetLevelTag(m_Message->mLvl), m_File);
-        std::fputc(' ', m_File);
+        parts[count] = GetLevelTag(m_Message->mLvl), sizes[count++] = std::strlen(parts[0]);
+        parts[count] = " ", sizes[count++] = 1;
         // Should we include the time-stamp?
         if (m_LogFileTime)
         {
-            std::fputs(m_Message->mBuf, m_File);
-            std::fputc(' ', m_File);
+            parts[count] = m_Message->mBuf, sizes[count++] = std::strlen(m_Message->mBuf);
+            parts[count] = " ", sizes[count++] = 1;
         }
         // Write the message
-        std::fputs(m_Message->mStr.data(), m_File);
+        parts[count] = m_Message->mStr.data(), sizes[count++] = m_Message->mStr.size();
         // Append a new line
-        std::fputc('\n', m_File);
+        parts[count] = "\n", sizes[count++] = 1;
+        // Hand it over to the writer thread. Errors are written as soon as possible
+        BufferLine(parts, sizes, count, m_Message->mLvl >= LOGL_ERR);
     }
 }
 
@@ -563,7 +958,7 @@ void Logger::Send(uint8_t level, bool sub, const char * msg)
     if ((m_ConsoleLevels & level) || (m_LogFileLevels & level))
     {
         // Create a new message builder
-        MsgPtr message(new Message(level, sub));
+        MsgPtr message = AcquireMessage(level, sub);
         // Generate the log message
         message->Append(msg);
         // Process the message in the buffer
@@ -578,7 +973,7 @@ void Logger::Send(uint8_t level, bool sub, const char * msg, size_t len)
     if ((m_ConsoleLevels & level) || (m_LogFileLevels & level))
     {
         // Create a new message builder
-        MsgPtr message(new Message(level, sub));
+        MsgPtr message = AcquireMessage(level, sub);
         // Generate the log message
         message->Append(msg, len);
         // Process the message in the buffer
@@ -593,7 +988,7 @@ void Logger::SendFv(uint8_t level, bool sub, const char * fmt, va_list args)
     if ((m_ConsoleLevels & level) || (m_LogFileLevels & level))
     {
         // Create a new message builder
-        MsgPtr message(new Message(level, sub));
+        MsgPtr message = AcquireMessage(level, sub);
         // Generate the log message
         message->AppendFv(fmt, args);
         // Process the message in the buffer
@@ -610,7 +1005,7 @@ void Logger::WriteF(uint8_t level, bool sub, const char * fmt, ...)
         va_list args;
         va_start(args, fmt);
         // Create a new message builder
-        MsgPtr message(new Message(level, sub));
+        MsgPtr message = AcquireMessage(level, sub);
         // Generate the log message
         message->AppendFv(fmt, args);
         // Finalize the variable argument list
@@ -639,7 +1034,7 @@ void Logger::DebugFv(HSQUIRRELVM vm, const char * fmt, va_list args)
     // So we will push them in bulk after generating them
     std::array< MsgPtr, 3 > messages{nullptr, nullptr, nullptr};
     // Create a new message builder
-    MsgPtr message = std::make_unique< Message >(LOGL_ERR, true);
+    MsgPtr message = AcquireMessage(LOGL_ERR, true);
     // Used to acquire stack information
     SQStackInfos si;
     // Write the given error message
@@ -678,7 +1073,7 @@ void Logger::DebugFv(HSQUIRRELVM vm, const char * fmt, va_list args)
     // Assign the error message
     messages[0] = std::move(message);
     // Create a new message builder
-    message = std::make_unique< Message >(LOGL_INF, true);
+    message = AcquireMessage(LOGL_INF, true);
     // Trace list (so it can be reused later in locals)
     std::vector< std::string > locations;
     std::vector< std::string > closures;
@@ -702,7 +1097,7 @@ void Logger::DebugFv(HSQUIRRELVM vm, const char * fmt, va_list args)
     // Assign the error message
     messages[1] = std::move(message);
     // Create a new message builder
-    message = std::make_unique< Message >(LOGL_INF, true);
+    message = AcquireMessage(LOGL_INF, true);
     // Temporary variables to retrieve stack information
     const SQChar * s_ = nullptr, * name;
     SQInteger i_;
@@ -1086,7 +1481,7 @@ static void SqLogToggleLogFileLevel(SQInteger level, bool toggle)
 }
 
 // ------------------------------------------------------------------------------------------------
-static const String & SqLogGetLogFilename()
+static String SqLogGetLogFilename()
 {
     return Logger::Get().GetLogFilename();
 }
@@ -1109,6 +1504,80 @@ static void SqLogSetStringTruncate(SQInteger nc)
     Logger::Get().SetStringTruncate(ConvTo< uint32_t >::From(nc));
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetBufferSlots()
+{
+    return static_cast< SQInteger >(Logger::Get().GetBufferSlots());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetBufferSlots(SQInteger count)
+{
+    Logger::Get().SetBufferSlots(ConvTo< size_t >::From(count));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetFlushInterval()
+{
+    return static_cast< SQInteger >(Logger::Get().GetFlushInterval());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetFlushInterval(SQInteger ms)
+{
+    Logger::Get().SetFlushInterval(ConvTo< uint32_t >::From(ms));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRotateSize()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRotateSize());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRotateSize(SQInteger size)
+{
+    Logger::Get().SetRotateSize(ConvTo< uint64_t >::From(size));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRotateInterval()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRotateInterval());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRotateInterval(SQInteger sec)
+{
+    Logger::Get().SetRotateInterval(ConvTo< uint32_t >::From(sec));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetOverflow()
+{
+    return static_cast< SQInteger >(Logger::Get().GetOverflow());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetOverflow(SQInteger policy)
+{
+    Logger::Get().SetOverflow(ConvTo< uint8_t >::From(policy));
+}
+
+// ------------------------------------------------------------------------------------------------
+static Table SqLogStats()
+{
+    const Logger & l = Logger::Get();
+    // Create the table with the statistics
+    Table t(SqVM());
+    t.SetValue(_SC("Dropped"), static_cast< SQInteger >(l.GetDropped()));
+    t.SetValue(_SC("Buffered"), static_cast< SQInteger >(l.GetBuffered()));
+    t.SetValue(_SC("Written"), static_cast< SQInteger >(l.GetWritten()));
+    t.SetValue(_SC("Rotations"), static_cast< SQInteger >(l.GetRotations()));
+    // Return the table
+    return t;
+}
+
 // ================================================================================================
 void Register_Log(HSQUIRRELVM vm)
 {
@@ -1155,6 +1624,23 @@ void Register_Log(HSQUIRRELVM vm)
         .Func(_SC("SetLogFilename"), &SqLogSetLogFilename)
         .Func(_SC("GetStringTruncate"), &SqLogGetStringTruncate)
         .Func(_SC("SetStringTruncate"), &SqLogSetStringTruncate)
+        .Func(_SC("GetBufferSlots"), &SqLogGetBufferSlots)
+        .Func(_SC("SetBufferSlots"), &SqLogSetBufferSlots)
+        .Func(_SC("GetFlushInterval"), &SqLogGetFlushInterval)
+        .Func(_SC("SetFlushInterval"), &SqLogSetFlushInterval)
+        .Func(_SC("GetRotateSize"), &SqLogGetRotateSize)
+        .Func(_SC("SetRotateSize"), &SqLogSetRotateSize)
+        .Func(_SC("GetRotateInterval"), &SqLogGetRotateInterval)
+        .Func(_SC("SetRotateInterval"), &SqLogSetRotateInterval)
+        .Func(_SC("GetOverflow"), &SqLogGetOverflow)
+        .Func(_SC("SetOverflow"), &SqLogSetOverflow)
+        .Func(_SC("Stats"), &SqLogStats)
+    );
+
+    ConstTable(vm).Enum(_SC("SqLogOverflow"), Enumeration(vm)
+        .Const(_SC("Drop"),     static_cast< SQInteger >(LOGO_DROP))
+        .Const(_SC("Block"),    static_cast< SQInteger >(LOGO_BLOCK))
+        .Const(_SC("Count"),    static_cast< SQInteger >(LOGO_COUNT))
     );
 }
 
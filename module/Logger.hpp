@@ -2,13 +2,17 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "SqBase.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <cstdio>
 #include <string>
 
 // ------------------------------------------------------------------------------------------------
+#include <mutex>
+#include <atomic>
 #include <thread>
+#include <condition_variable>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqratFunction.h>
@@ -33,6 +37,16 @@ enum LogLvl
     LOGL_ANY = 0xFFu
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * What happens to a log file message when the write buffer is full.
+*/
+enum LogOverflow
+{
+    LOGO_DROP = 0, // Discard the message.
+    LOGO_BLOCK, // Wait for the writer thread to make room.
+    LOGO_COUNT // Discard the message and write how many were discarded once there is room.
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Class responsible for logging output.
 */
@@ -89,6 +103,19 @@ protected:
          * Copy constructor (disabled).
         */
         Message(const Message & o) = delete;
+        /* ----------------------------------------------------------------------------------------
+         * Prepare the message to be reused. The string keeps its capacity.
+        */
+        void Reset(uint8_t lvl, bool sub)
+        {
+            mStr.clear();
+            mLen = 0;
+            mLvl = lvl;
+            mInc = std::numeric_limits< uint8_t >::max();
+            mSub = sub;
+            mTms = false;
+            mBuf[0] = '\0';
+        }
         /* ----------------------------------------------------------------------------------------
          * Stamp the log message.
         */
@@ -125,8 +152,23 @@ public:
     */
     using MsgPtr = std::unique_ptr< Message >;
 
+    /* --------------------------------------------------------------------------------------------
+     * Size of a slot from the log file write buffer.
+    */
+    static constexpr size_t SLOT_SIZE = 256;
+
 private:
 
+    /* --------------------------------------------------------------------------------------------
+     * Fixed size chunk of the log file write buffer. Lines that don't fit span multiple slots.
+    */
+    struct Slot
+    {
+        uint16_t    mLen; // Number of bytes used from the slot.
+        bool        mEnd; // Whether this slot ends a line.
+        char        mData[SLOT_SIZE - sizeof(uint16_t) - sizeof(bool)]; // Slot contents.
+    };
+
     // --------------------------------------------------------------------------------------------
     static Logger s_Inst; // Logger instance.
 
@@ -145,6 +187,11 @@ private:
     */
     using MsgQueue = moodycamel::ConcurrentQueue< MsgPtr >;
 
+    /* --------------------------------------------------------------------------------------------
+     * Maximum number of idle message instances kept around for reuse.
+    */
+    static constexpr size_t POOL_SIZE = 256;
+
 private:
 
     // --------------------------------------------------------------------------------------------
@@ -153,6 +200,7 @@ private:
     // --------------------------------------------------------------------------------------------
     MsgPtr          m_Message; // Last and/or currently processed log message.
     MsgQueue        m_Queue; // Queue of messages outside of main thread.
+    MsgQueue        m_Pool; // Message instances that can be reused.
 
     // --------------------------------------------------------------------------------------------
     uint8_t         m_ConsoleLevels; // The levels allowed to be outputted to console.
@@ -167,8 +215,36 @@ private:
     uint32_t        m_StringTruncate; // The length at which to truncate strings in debug.
 
     // --------------------------------------------------------------------------------------------
-    std::FILE*      m_File; // Handle to the file where the logs should be saved.
+    std::FILE*      m_File; // Handle to the file where the logs should be saved. Owned by the writer.
     std::string     m_Filename; // The name of the file where the logs are saved.
+    std::string     m_Pattern; // The time format from which the log file names are generated.
+    mutable std::mutex m_NameMutex; // Guards the file name which is changed by the writer on rotation.
+
+    // --------------------------------------------------------------------------------------------
+    std::unique_ptr< Slot[] >   m_Slots; // Preallocated ring of slots waiting to be written.
+    size_t                      m_SlotCount; // Number of slots in the ring. Always a power of two.
+    size_t                      m_SlotRequest; // Number of slots to allocate when the file is opened.
+    std::atomic< size_t >       m_Head; // Slots filled by the main thread so far.
+    std::atomic< size_t >       m_Tail; // Slots consumed by the writer so far.
+
+    // --------------------------------------------------------------------------------------------
+    std::thread                 m_Writer; // Thread which writes the buffered slots to the file.
+    std::atomic_bool            m_Writing; // Whether the writer thread is allowed to run.
+    std::mutex                  m_WriterMutex; // Only used to put the writer to sleep.
+    std::condition_variable     m_WriterCV;
+    bool                        m_Active; // Whether log file messages are buffered. Main thread only.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< uint32_t >     m_FlushInterval; // Maximum time in milliseconds the writer can sleep.
+    std::atomic< uint64_t >     m_RotateSize; // Size in bytes after which the file is rotated. Zero to disable.
+    std::atomic< uint32_t >     m_RotateInterval; // Time in seconds after which the file is rotated. Zero to disable.
+    uint8_t                     m_Overflow; // What happens to messages when the ring is full.
+
+    // --------------------------------------------------------------------------------------------
+    uint64_t                    m_Dropped; // Messages discarded because the ring was full.
+    uint64_t                    m_Missed; // Discarded messages not yet reported in the file.
+    std::atomic< uint64_t >     m_Written; // Bytes written to log files.
+    std::atomic< uint64_t >     m_Rotations; // How many times the log file was rotated.
 
     // --------------------------------------------------------------------------------------------
     Function        m_LogCb[7]; //Callback to receive debug information instead of console.
@@ -190,6 +266,42 @@ protected:
     */
     void ProcessMessage();
 
+    /* --------------------------------------------------------------------------------------------
+     * Obtain a message instance, reusing an idle one if possible.
+    */
+    MsgPtr AcquireMessage(uint8_t lvl, bool sub);
+
+    /* --------------------------------------------------------------------------------------------
+     * Give back a message instance so that it can be reused.
+    */
+    void RecycleMessage(MsgPtr & msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy a line into the ring of slots. Returns false if the line was discarded.
+    */
+    bool BufferLine(const char * const * parts, const size_t * sizes, size_t count, bool urgent);
+
+    /* --------------------------------------------------------------------------------------------
+     * Open a log file with the name generated from the current pattern.
+    */
+    bool OpenFile(bool rotate);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the buffered slots to the file. Invoked by the writer thread.
+     * Returns whether the last written slot ended a line.
+    */
+    bool WriteSlots(uint64_t & size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Close the current log file and open a new one. Invoked by the writer thread.
+    */
+    void Rotate();
+
+    /* --------------------------------------------------------------------------------------------
+     * Internal function used to write the buffered slots.
+    */
+    void WriterProc();
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -243,7 +355,18 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Processes the messages that have gathered in the queue.
     */
-    void ProcessQueue();
+    void ProcessQueue()
+    {
+        FrameSlice slice;
+        // Process everything
+        ProcessQueue(slice);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Processes the messages that have gathered in the queue within the given slice.
+     * Returns how many messages are left.
+    */
+    size_t ProcessQueue(FrameSlice & slice);
 
     /* --------------------------------------------------------------------------------------------
      * Enable or disable console message time stamping.
@@ -394,8 +517,10 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Retrieve the log file name.
     */
-    SQMOD_NODISCARD const std::string & GetLogFilename() const
+    SQMOD_NODISCARD std::string GetLogFilename() const
     {
+        std::lock_guard< std::mutex > lock(m_NameMutex);
+        // The writer can change it on rotation
         return m_Filename;
     }
 
@@ -404,6 +529,112 @@ public:
     */
     void SetLogFilename(const char * filename);
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of slots in the log file write buffer.
+    */
+    SQMOD_NODISCARD size_t GetBufferSlots() const
+    {
+        return m_SlotRequest;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of slots in the log file write buffer. Applied when the file is opened.
+    */
+    void SetBufferSlots(size_t count);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum time in milliseconds the writer waits before writing buffered messages.
+    */
+    SQMOD_NODISCARD uint32_t GetFlushInterval() const
+    {
+        return m_FlushInterval;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum time in milliseconds the writer waits before writing buffered messages.
+    */
+    void SetFlushInterval(uint32_t ms)
+    {
+        m_FlushInterval = ms > 0 ? ms : 1;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size in bytes after which the log file is rotated.
+    */
+    SQMOD_NODISCARD uint64_t GetRotateSize() const
+    {
+        return m_RotateSize;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the size in bytes after which the log file is rotated. Zero to disable.
+    */
+    void SetRotateSize(uint64_t size)
+    {
+        m_RotateSize = size;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the time in seconds after which the log file is rotated.
+    */
+    SQMOD_NODISCARD uint32_t GetRotateInterval() const
+    {
+        return m_RotateInterval;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the time in seconds after which the log file is rotated. Zero to disable.
+    */
+    void SetRotateInterval(uint32_t sec)
+    {
+        m_RotateInterval = sec;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve what happens to log file messages when the write buffer is full.
+    */
+    SQMOD_NODISCARD uint8_t GetOverflow() const
+    {
+        return m_Overflow;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify what happens to log file messages when the write buffer is full.
+    */
+    void SetOverflow(uint8_t policy);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of log file messages discarded because the write buffer was full.
+    */
+    SQMOD_NODISCARD uint64_t GetDropped() const
+    {
+        return m_Dropped;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of slots waiting to be written to the log file.
+    */
+    SQMOD_NODISCARD size_t GetBuffered() const
+    {
+        return m_Head.load() - m_Tail.load();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes written to log files.
+    */
+    SQMOD_NODISCARD uint64_t GetWritten() const
+    {
+        return m_Written.load();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of times the log file was rotated.
+    */
+    SQMOD_NODISCARD uint64_t GetRotations() const
+    {
+        return m_Rotations.load();
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Bind a script callback to a log level.
     */
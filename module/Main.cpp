@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Logger.hpp"
 #include "Core.hpp"
+#include "Core/FrameBudget.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <cstdio>
@@ -26,11 +27,6 @@ extern void InitializeNet();
 extern void InitializePocoDataConnectors();
 extern void ProcessRoutines();
 extern void ProcessTasks();
-extern void ProcessThreads();
-extern void ProcessNet();
-#ifdef SQMOD_DISCORD
-    extern void ProcessDiscord();
-#endif
 
 /* ------------------------------------------------------------------------------------------------
  * Will the scripts be reloaded at the end of the current event?
@@ -176,16 +172,9 @@ static void OnServerFrame(float elapsed_time)
     // Process routines and tasks, if any
     ProcessRoutines();
     ProcessTasks();
-    // Process threads
-    ProcessThreads();
-    // Process network
-    ProcessNet();
-    // Process Discord
-#ifdef SQMOD_DISCORD
-    ProcessDiscord();
-#endif
-    // Process log messages from other threads
-    Logger::Get().ProcessQueue();
+    // Process completed work from other threads (thread pool, network, discord, log messages)
+    // within the budget of each stage. Whatever doesn't fit is carried over to the next frame
+    FrameBudget::Get().Process();
     // See if a reload was requested
     SQMOD_RELOAD_CHECK(g_Reload)
 }
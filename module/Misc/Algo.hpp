@@ -2,6 +2,7 @@
 
 // ------------------------------------------------------------------------------------------------
 #include "Core.hpp"
+#include "Core/Tags.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
@@ -579,6 +580,7 @@ template <> struct InstSpec< CBlip >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_BLIP_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_BLIP; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "blip"; // Lowercase name of this entity type.
@@ -620,6 +622,7 @@ template <> struct InstSpec< CCheckpoint >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_CHECKPOINT_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_CHECKPOINT; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "checkpoint"; // Lowercase name of this entity type.
@@ -661,6 +664,7 @@ template <> struct InstSpec< CKeyBind >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_KEYBIND_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_KEYBIND; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "keybind"; // Lowercase name of this entity type.
@@ -702,6 +706,7 @@ template <> struct InstSpec< CObject >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_OBJECT_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_OBJECT; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "object"; // Lowercase name of this entity type.
@@ -743,6 +748,7 @@ template <> struct InstSpec< CPickup >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_PICKUP_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_PICKUP; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "pickup"; // Lowercase name of this entity type.
@@ -784,6 +790,7 @@ template <> struct InstSpec< CPlayer >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_PLAYER_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_PLAYER; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "player"; // Lowercase name of this entity type.
@@ -825,6 +832,7 @@ template <> struct InstSpec< CVehicle >
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_VEHICLE_POOL; // Maximum identifier for this entity type.
+    static constexpr int32_t Type = ENT_VEHICLE; // Entity type identifier used by the tag index.
 
     // --------------------------------------------------------------------------------------------
     static constexpr const SQChar * LcName = "vehicle"; // Lowercase name of this entity type.
@@ -1179,6 +1187,48 @@ public:
     */
     Entity & operator = (Entity && o) = delete;
 
+    /* --------------------------------------------------------------------------------------------
+     * Process the entities where the tag is or begins with the specified string, in the order of
+     * their identifiers.
+    */
+    template < typename Collector > static inline void EachTagged(const SQChar * tag, bool cs, bool prefix, Collector collect)
+    {
+        TagIndex::Result ids;
+        // Ask the index which entities have a matching tag
+        TagIndex::Get(Inst::Type).Find(tag, strlen(tag), cs, prefix, ids);
+        // Process each matching entity
+        for (const int32_t id : ids)
+        {
+            const auto & inst = *(Inst::CBegin() + id);
+            // Was the entity destroyed in the meantime?
+            if (ValidInst()(inst))
+            {
+                collect(inst);
+            }
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Process the entities where the tag is or begins with the specified string, in the order of
+     * their identifiers, until the collector says otherwise.
+    */
+    template < typename Collector > static inline void EachTaggedWhile(const SQChar * tag, bool cs, bool prefix, Collector collect)
+    {
+        TagIndex::Result ids;
+        // Ask the index which entities have a matching tag
+        TagIndex::Get(Inst::Type).Find(tag, strlen(tag), cs, prefix, ids);
+        // Process each matching entity
+        for (const int32_t id : ids)
+        {
+            const auto & inst = *(Inst::CBegin() + id);
+            // Was the entity destroyed or did the collector ask to stop?
+            if (ValidInst()(inst) && !collect(inst))
+            {
+                break;
+            }
+        }
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Find the entity that matches the specified identifier.
     */
@@ -1229,8 +1279,15 @@ public:
         const StackGuard sg;
         // Allocate an empty array on the stack
         sq_newarray(SqVM(), 0);
-        // Process each entity in the pool
-        EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTagged(tag, cs, false, AppendElem());
+        }
+        else
+        {
+            EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, !neg, cs);
+        }
         // Return the array at the top of the stack
         return Var< Array >(SqVM(), -1).value;
     }
@@ -1245,8 +1302,15 @@ public:
         const StackGuard sg;
         // Allocate an empty array on the stack
         sq_newarray(SqVM(), 0);
-        // Process each entity in the pool
-        EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, strlen(tag), !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTagged(tag, cs, true, AppendElem());
+        }
+        else
+        {
+            EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, strlen(tag), !neg, cs);
+        }
         // Return the array at the top of the stack
         return Var< Array >(SqVM(), -1).value;
     }
@@ -1307,9 +1371,21 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element receiver
         RecvElem recv;
-        // Process each entity in the pool
-        FirstEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< RecvElem >(recv), tag, !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            const int32_t id = TagIndex::Get(Inst::Type).First(tag, strlen(tag), cs, false);
+            // Was there an entity with this tag?
+            if (id >= 0)
+            {
+                recv(*(Inst::CBegin() + id));
+            }
+        }
+        else
+        {
+            FirstEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< RecvElem >(recv), tag, !neg, cs);
+        }
         // Return the received element, if any
         return recv.mObj;
     }
@@ -1322,9 +1398,21 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element receiver
         RecvElem recv;
-        // Process each entity in the pool
-        FirstBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< RecvElem >(recv), tag, strlen(tag), !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            const int32_t id = TagIndex::Get(Inst::Type).First(tag, strlen(tag), cs, true);
+            // Was there an entity with this tag?
+            if (id >= 0)
+            {
+                recv(*(Inst::CBegin() + id));
+            }
+        }
+        else
+        {
+            FirstBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< RecvElem >(recv), tag, strlen(tag), !neg, cs);
+        }
         // Return the received element, if any
         return recv.mObj;
     }
@@ -1410,9 +1498,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(func);
-        // Process each entity in the pool
-        EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTaggedWhile(tag, cs, false, std::reference_wrapper< ForwardElem >(fwd));
+        }
+        else
+        {
+            EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1425,9 +1520,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, func);
-        // Process each entity in the pool
-        EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTaggedWhile(tag, cs, false, std::reference_wrapper< ForwardElemData >(fwd));
+        }
+        else
+        {
+            EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1440,9 +1542,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(func);
-        // Process each entity in the pool
-        EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElem >(fwd), tag, strlen(tag), !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTaggedWhile(tag, cs, true, std::reference_wrapper< ForwardElem >(fwd));
+        }
+        else
+        {
+            EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElem >(fwd), tag, strlen(tag), !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1455,9 +1564,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, func);
-        // Process each entity in the pool
-        EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElemData >(fwd), tag, strlen(tag), !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            EachTaggedWhile(tag, cs, true, std::reference_wrapper< ForwardElemData >(fwd));
+        }
+        else
+        {
+            EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElemData >(fwd), tag, strlen(tag), !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1574,9 +1690,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element counter
         CountElem cnt;
-        // Process each entity in the pool
-        EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< CountElem >(cnt), tag, !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            cnt.mCount = static_cast< uint32_t >(TagIndex::Get(Inst::Type).Count(tag, strlen(tag), cs, false));
+        }
+        else
+        {
+            EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< CountElem >(cnt), tag, !neg, cs);
+        }
         // Return the count
         return cnt;
     }
@@ -1589,9 +1712,16 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element counter
         CountElem cnt;
-        // Process each entity in the pool
-        EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< CountElem >(cnt), tag, strlen(tag), !neg, cs);
+        // Look the tag up in the index unless the entities that do not match are wanted
+        if (!neg)
+        {
+            cnt.mCount = static_cast< uint32_t >(TagIndex::Get(Inst::Type).Count(tag, strlen(tag), cs, true));
+        }
+        else
+        {
+            EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+                            std::reference_wrapper< CountElem >(cnt), tag, strlen(tag), !neg, cs);
+        }
         // Return the count
         return cnt;
     }
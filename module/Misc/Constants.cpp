@@ -51,8 +51,9 @@ static const EnumElement g_SqMod[] = {
     {_SC("Infinity"),       INFINITY},
     {_SC("Inf"),            INFINITY},
     {_SC("Nan"),            NAN},
-    {_SC("MaxTasks"),       SQMOD_MAX_TASKS},
-    {_SC("MaxRoutines"),    SQMOD_MAX_ROUTINES},
+    // Slots created up front for tasks and routines, the pools grow past this when needed
+    {_SC("MaxTasks"),       SQMOD_INITIAL_TASKS},
+    {_SC("MaxRoutines"),    SQMOD_INITIAL_ROUTINES},
     {_SC("MaxBlips"),       SQMOD_BLIP_POOL},
     {_SC("MaxCheckpoints"), SQMOD_CHECKPOINT_POOL},
     {_SC("MaxKeybinds"),    SQMOD_KEYBIND_POOL},
@@ -565,6 +565,16 @@ struct SQLiteAsyncExec : public ThreadPoolItem
     */
     SQMOD_NODISCARD const char * IdentifiableInfo() noexcept override { return mQueryStr; }
 
+    /* --------------------------------------------------------------------------------------------
+     * Provide the subsystem lane in which the item should be processed.
+    */
+    SQMOD_NODISCARD uint32_t Lane() noexcept override { return TPL_DATABASE; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Database results are usually awaited by the game logic so, they are taken first.
+    */
+    SQMOD_NODISCARD uint32_t Priority() noexcept override { return TPP_HIGH; }
+
     /* --------------------------------------------------------------------------------------------
      * Invoked in worker thread by the thread pool after obtaining the task from the queue.
      * Must return true to indicate that the task can be performed. False indicates failure.
@@ -673,6 +683,16 @@ struct SQLiteAsyncStmtBase : public ThreadPoolItem
     */
     SQMOD_NODISCARD const char * IdentifiableInfo() noexcept override { return mQueryStr; }
 
+    /* --------------------------------------------------------------------------------------------
+     * Provide the subsystem lane in which the item should be processed.
+    */
+    SQMOD_NODISCARD uint32_t Lane() noexcept override { return TPL_DATABASE; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Database results are usually awaited by the game logic so, they are taken first.
+    */
+    SQMOD_NODISCARD uint32_t Priority() noexcept override { return TPP_HIGH; }
+
     /* --------------------------------------------------------------------------------------------
      * Invoked in worker thread by the thread pool after obtaining the task from the queue.
      * Must return true to indicate that the task can be performed. False indicates failure.
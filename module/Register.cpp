@@ -66,10 +66,13 @@ extern void Register_Loot(HSQUIRRELVM vm);
 extern void Register_Privilege(HSQUIRRELVM vm);
 extern void Register_Routine(HSQUIRRELVM vm);
 extern void Register_Tasks(HSQUIRRELVM vm);
+extern void Register_ThreadPool(HSQUIRRELVM vm);
+extern void Register_FrameBudget(HSQUIRRELVM vm);
 
 // ------------------------------------------------------------------------------------------------
 extern void Register_Misc(HSQUIRRELVM vm);
 extern void Register_Areas(HSQUIRRELVM vm);
+extern void Register_Spatial(HSQUIRRELVM vm);
 extern void Register_Signal(HSQUIRRELVM vm);
 #ifdef VCMP_ENABLE_OFFICIAL
     extern void Register_Official(HSQUIRRELVM vm);
@@ -135,9 +138,12 @@ bool RegisterAPI(HSQUIRRELVM vm)
     Register_Privilege(vm);
     Register_Routine(vm);
     Register_Tasks(vm);
+    Register_ThreadPool(vm);
+    Register_FrameBudget(vm);
 
     Register_Misc(vm);
     Register_Areas(vm);
+    Register_Spatial(vm);
     Register_Signal(vm);
 #ifdef VCMP_ENABLE_OFFICIAL
     Register_Official(vm);
@@ -698,8 +698,8 @@ enum EntityType
 */
 
 #define SQMOD_STACK_SIZE            2048
-#define SQMOD_MAX_TASKS             1024
-#define SQMOD_MAX_ROUTINES          1024
+#define SQMOD_INITIAL_TASKS         1024
+#define SQMOD_INITIAL_ROUTINES      1024
 #define SQMOD_MAX_CMD_ARGS          12
 #define SQMOD_PLAYER_MSG_PREFIXES   16
 #define SQMOD_PLAYER_TMP_BUFFER     128
@@ -547,4 +547,155 @@ public:
     }
 };
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// InlineAllocator is the allocator to use for small value types that can both be constructed and copied
+///
+/// \tparam C Type of class
+///
+/// \remarks
+/// The C++ object is stored inside the user-data block of the Squirrel instance instead of the heap and is not
+/// registered in the per-class instance map. Creating or copying an instance therefore performs no allocation
+/// besides the one Squirrel makes for the instance itself. Because of that, instances of such types have no
+/// identity: pushing the same C++ pointer twice creates two distinct script objects.
+///
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class C>
+class InlineAllocator {
+
+    // The header must come first so that the block can be read like the pair used by the other allocators
+    struct Block {
+        std::pair<C*, SharedPtr<std::unordered_map<C*, HSQOBJECT>> > header;
+        alignas(C) unsigned char value[sizeof(C)];
+    };
+
+    static_assert(alignof(Block) <= SQ_ALIGNMENT, "type is over-aligned for inline instance storage");
+
+    template <class F>
+    static SQInteger Construct(HSQUIRRELVM vm, SQInteger idx, F&& f)
+    {
+        Block* block = nullptr;
+        sq_getinstanceup(vm, idx, reinterpret_cast<SQUserPointer*>(&block), nullptr);
+        // Squirrel clears the block when the instance is created so a constructed block has a value pointer
+        if (block == nullptr || block->header.first != nullptr) {
+            return sq_throwerror(vm, (ClassType<C>::ClassName() + string(_SC(" instance has no free inline storage"))).c_str());
+        }
+        // Construct the value first. If that throws then the block remains unconstructed
+        C* ptr = f(static_cast<void*>(block->value));
+        new (&block->header) std::pair<C*, SharedPtr<std::unordered_map<C*, HSQOBJECT>> >(ptr, SharedPtr<std::unordered_map<C*, HSQOBJECT>>());
+        sq_setreleasehook(vm, idx, &Delete);
+        return 0;
+    }
+
+public:
+
+    /// Size of the user-data block that the class must reserve for each instance
+    static constexpr SQInteger StorageSize = static_cast<SQInteger>(sizeof(Block));
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Associates a newly created instance with a copy of an object allocated with the new operator
+    ///
+    /// \param vm  VM that has an instance object of the correct type at idx
+    /// \param idx Index of the stack that the instance object is at
+    /// \param ptr Should be the return value from a call to the new operator (ownership is taken)
+    ///
+    /// \remarks
+    /// Exists for compatibility with custom constructors. The object is moved into inline storage and deleted.
+    ///
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static void SetInstance(HSQUIRRELVM vm, SQInteger idx, C* ptr)
+    {
+        std::unique_ptr<C> guard(ptr);
+        if (SQ_FAILED(Construct(vm, idx, [ptr](void* mem) { return new (mem) C(std::move(*ptr)); }))) {
+            SQTHROW(vm, LastErrorString(vm));
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Called by Sqrat to set up an instance on the stack for the template class
+    ///
+    /// \param vm VM that has an instance object of the correct type at position 1 in its stack
+    ///
+    /// \return Squirrel error code
+    ///
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static SQInteger New(HSQUIRRELVM vm) {
+        return Construct(vm, 1, [](void* mem) { return new (mem) C(); });
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @cond DEV
+    /// following iNew functions are used only if constructors are bound via Ctor() in Sqrat::Class (safe to ignore)
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static SQInteger iNew(HSQUIRRELVM vm) {
+        return New(vm);
+    }
+
+    template <class... A>
+    static SQInteger iNew(HSQUIRRELVM vm) {
+        try {
+            return Construct(vm, 1, [vm](void* mem) -> C * {
+                return ArgFwd<A...>{}.Call(vm, 2, [mem](HSQUIRRELVM /*vm*/, A... a) -> C * {
+                    return new (mem) C(a...);
+                });
+            });
+        } catch (const Poco::Exception& e) {
+            return sq_throwerror(vm, e.displayText().c_str());
+        } catch (const std::exception& e) {
+            return sq_throwerror(vm, e.what());
+        } catch (...) {
+            return sq_throwerror(vm, _SC("unknown exception occured"));
+        }
+        return 0;
+    }
+
+    /// @endcond
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Called by Sqrat to set up the instance at idx on the stack as a copy of a value of the same type
+    ///
+    /// \param vm    VM that has an instance object of the correct type at idx
+    /// \param idx   Index of the stack that the instance object is at
+    /// \param value A pointer to data of the same type as the instance object
+    ///
+    /// \return Squirrel error code
+    ///
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static SQInteger Copy(HSQUIRRELVM vm, SQInteger idx, const void* value) {
+        return Construct(vm, idx, [value](void* mem) { return new (mem) C(*static_cast<const C*>(value)); });
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Called by Sqrat to destroy an instance's data (the memory belongs to the Squirrel instance)
+    ///
+    /// \param ptr  Pointer to the data contained by the instance
+    /// \param size Size of the data contained by the instance
+    ///
+    /// \return Squirrel error code
+    ///
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static SQInteger Delete(SQUserPointer ptr, SQInteger size) {
+        SQUNUSED(size);
+        auto* block = reinterpret_cast<Block*>(ptr);
+        block->header.first->~C();
+        block->header.~pair();
+        return 0;
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @cond DEV
+/// Retrieves the size of the user-data block an allocator needs in each instance (zero when it allocates elsewhere)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class A, class = void>
+struct AllocatorStorage {
+    static constexpr SQInteger Size = 0;
+};
+
+template<class A>
+struct AllocatorStorage<A, std::void_t<decltype(A::StorageSize)>> {
+    static constexpr SQInteger Size = A::StorageSize;
+};
+
+/// @endcond
+
 }
@@ -815,6 +815,11 @@ protected:
         // set the typetag of the class
         sq_settypetag(vm, -1, cd->staticData.Get());
 
+        // reserve inline storage in each instance if the allocator wants it
+        if (AllocatorStorage<A>::Size > 0) {
+            sq_setclassudsize(vm, -1, AllocatorStorage<A>::Size);
+        }
+
         // add the default constructor
         sq_pushstring(vm, _SC("constructor"), -1);
         sq_newclosure(vm, &A::New, 0);
@@ -1097,6 +1102,11 @@ protected:
         // set the typetag of the class
         sq_settypetag(vm, -1, cd->staticData.Get());
 
+        // reserve inline storage in each instance if the allocator wants it
+        if (AllocatorStorage<A>::Size > 0) {
+            sq_setclassudsize(vm, -1, AllocatorStorage<A>::Size);
+        }
+
         // add the default constructor
         sq_pushstring(vm, _SC("constructor"), -1);
         sq_newclosure(vm, &A::New, 0);
@@ -318,7 +318,7 @@ public:
                 return nullptr;
             }
 
-            if (instance == nullptr) {
+            if (instance == nullptr || instance->first == nullptr) {
                 SQTHROW(vm, _SC("got unconstructed native class (call base.constructor in the constructor of Squirrel classes that extend native classes)"));
                 return nullptr;
             }
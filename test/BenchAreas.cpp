@@ -0,0 +1,194 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/AreaKernel.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+/* ------------------------------------------------------------------------------------------------
+ * Compares the point-in-polygon kernels of areas with the scalar loop they replaced. Every polygon
+ * is tested with the same random points (most of them inside the bounding box) in three ways:
+ *  - scalar: bounding box check followed by the old loop over the points of the polygon
+ *  - single: bounding box check followed by the vectorized edge kernel, as Area::IsInside does
+ *  - batch: the kernel which tests several points per edge, as Area::TestPoints does
+ * All three must give the same answer for every point.
+ *
+ * Usage: BenchAreas [scale]
+*/
+
+// ------------------------------------------------------------------------------------------------
+using namespace SqMod;
+
+// ------------------------------------------------------------------------------------------------
+typedef std::chrono::steady_clock Clock;
+
+// ------------------------------------------------------------------------------------------------
+struct Point
+{
+    float x, y;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Nanoseconds elapsed since the specified time-point, divided by the number of operations.
+*/
+static double PerOp(Clock::time_point start, size_t ops)
+{
+    const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - start);
+    return static_cast< double >(elapsed.count()) / static_cast< double >(ops ? ops : 1);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * The test used by areas before the edges were precomputed.
+*/
+static bool OldIsInside(const std::vector< Point > & points, float x, float y)
+{
+    float x1, x2;
+    int crossings = 0;
+    for (size_t i = 0, n = points.size(); i < n; ++i)
+    {
+        const Point & a = points[i];
+        const Point & b = points[(i + 1) % n];
+        if (a.x < b.x)
+        {
+            x1 = a.x;
+            x2 = b.x;
+        }
+        else
+        {
+            x1 = b.x;
+            x2 = a.x;
+        }
+        if (x > x1 && x <= x2 && (y < a.y || y <= b.y))
+        {
+            const float dx = (b.x - a.x);
+            const float dy = (b.y - a.y);
+            float k;
+
+            if (fabsf(dx) < 0.000001f)
+            {
+                k = static_cast< float >(0xffffffffu); // NOLINT(bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions)
+            }
+            else
+            {
+                k = (dy / dx);
+            }
+
+            const float m = (a.y - k * a.x);
+            const float y2 = (k * x + m);
+            if (y <= y2)
+            {
+                ++crossings;
+            }
+        }
+    }
+    return (crossings % 2 == 1);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Run the three tests over one polygon. Returns the number of points where they disagree.
+*/
+static size_t Run(std::mt19937 & rng, size_t edges, size_t count, size_t rounds)
+{
+    std::uniform_real_distribution< float > radius(60.0f, 100.0f);
+    std::vector< Point > points(edges);
+    float l = 1e9f, b = 1e9f, r = -1e9f, t = -1e9f;
+    // A star shaped polygon with a jagged outline, so that many edges are close to each point
+    for (size_t i = 0; i < edges; ++i)
+    {
+        const float a = 6.2831853f * static_cast< float >(i) / static_cast< float >(edges);
+        const float d = radius(rng);
+        points[i] = Point{cosf(a) * d, sinf(a) * d};
+        l = std::min(l, points[i].x), b = std::min(b, points[i].y);
+        r = std::max(r, points[i].x), t = std::max(t, points[i].y);
+    }
+    std::vector< float > e;
+    const size_t s = AreaBuildEdges(points.data(), points.size(), e);
+    // Points slightly past the bounding box so that some of them are rejected early
+    std::uniform_real_distribution< float > coord(-110.0f, 110.0f);
+    std::vector< float > xs(count), ys(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+    std::vector< uint8_t > scalar(count), single(count), batch(count);
+    size_t sink = 0;
+    // The old loop
+    auto start = Clock::now();
+    for (size_t n = 0; n < rounds; ++n)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float x = xs[i], y = ys[i];
+            scalar[i] = (l <= x && r >= x && b <= y && t >= y && OldIsInside(points, x, y)) ? 1 : 0;
+        }
+        sink += scalar[n % count];
+    }
+    const double scalar_ns = PerOp(start, count * rounds);
+    // One point at a time through the edge kernel
+    start = Clock::now();
+    for (size_t n = 0; n < rounds; ++n)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float x = xs[i], y = ys[i];
+            single[i] = (l <= x && r >= x && b <= y && t >= y && (AreaCountCrossings(e.data(), s, x, y) % 2 == 1)) ? 1 : 0;
+        }
+        sink += single[n % count];
+    }
+    const double single_ns = PerOp(start, count * rounds);
+    // Several points at a time
+    start = Clock::now();
+    for (size_t n = 0; n < rounds; ++n)
+    {
+        AreaTestPoints(e.data(), s, edges, l, b, r, t, xs.data(), ys.data(), count, batch.data());
+        sink += batch[n % count];
+    }
+    const double batch_ns = PerOp(start, count * rounds);
+    // Compare the answers
+    size_t inside = 0, mismatch = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        inside += scalar[i];
+        mismatch += (scalar[i] != single[i] || scalar[i] != batch[i]) ? 1 : 0;
+    }
+    std::printf("%6zu %8zu %8zu %11.1f %11.1f %11.1f %8.2fx %8.2fx %8zu\n", edges, count, inside,
+                scalar_ns, single_ns, batch_ns, scalar_ns / single_ns, scalar_ns / batch_ns, mismatch);
+    // Keep the loops from being optimized away
+    if (sink == static_cast< size_t >(-1))
+    {
+        std::printf("\n");
+    }
+    return mismatch;
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+    const size_t scale = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    std::mt19937 rng(1234);
+    size_t mismatch = 0;
+#if defined(SQMOD_AREA_AVX)
+    std::printf("kernels: AVX + SSE2\n");
+#elif defined(SQMOD_AREA_SSE2)
+    std::printf("kernels: SSE2\n");
+#else
+    std::printf("kernels: scalar\n");
+#endif
+    std::printf("%6s %8s %8s %11s %11s %11s %9s %9s %8s\n", "edges", "points", "inside",
+                "scalar ns", "single ns", "batch ns", "single", "batch", "mismatch");
+    // From small zones to detailed outlines, including counts which are not a multiple of the lanes
+    for (size_t edges : {4, 5, 8, 13, 32, 64, 127, 256})
+    {
+        mismatch += Run(rng, edges, 1000, scale * 10);
+    }
+    // Did any of the kernels disagree with the old loop?
+    if (mismatch != 0)
+    {
+        std::fprintf(stderr, "The kernels disagree with the old loop on %zu points\n", mismatch);
+    }
+    return mismatch == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
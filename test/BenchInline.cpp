@@ -0,0 +1,156 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/Common.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <sqratScript.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+
+/* ------------------------------------------------------------------------------------------------
+ * Measures the cost of `c = a + b` on a small value type bound with each Sqrat allocator. Every
+ * operator new made while the loop runs is counted, which includes the native object, the instance
+ * header and the identity map node of the default allocator. The inline allocator must not make any.
+ * The instances themselves are allocated by the virtual machine, which does not use operator new.
+ *
+ * Usage: BenchInline [scale]
+*/
+
+// ------------------------------------------------------------------------------------------------
+using namespace SqMod;
+
+// ------------------------------------------------------------------------------------------------
+static std::atomic< size_t > g_Allocations{0};
+
+// ------------------------------------------------------------------------------------------------
+void * operator new(size_t size)
+{
+    ++g_Allocations;
+    if (void * p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// ------------------------------------------------------------------------------------------------
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, size_t) noexcept { std::free(p); }
+
+/* ------------------------------------------------------------------------------------------------
+ * Trivially copyable stand-in for the math types of the plug-in.
+*/
+struct Vec3
+{
+    float x{0}, y{0}, z{0};
+    Vec3() = default;
+    Vec3(float a, float b, float c) : x(a), y(b), z(c) { }
+    Vec3 operator + (const Vec3 & o) const { return {x + o.x, y + o.y, z + o.z}; }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Number of operator new calls so far.
+*/
+static SQInteger Allocations()
+{
+    return static_cast< SQInteger >(g_Allocations.load());
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Monotonic time in nanoseconds.
+*/
+static SQInteger Nanoseconds()
+{
+    return static_cast< SQInteger >(std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward script output and errors to the console.
+*/
+static void PrintFunc(HSQUIRRELVM /*vm*/, const SQChar * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    std::vprintf(fmt, args);
+    va_end(args);
+    std::printf("\n");
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Bind the type with the specified allocator and run the loop. Returns the allocations per operation.
+*/
+template < class A > static double Run(const char * name, SQInteger count)
+{
+    HSQUIRRELVM vm = sq_open(1024);
+    Sqrat::DefaultVM::Set(vm);
+    sq_setforeignptr(vm, new Sqrat::VMContext());
+    sq_setprintfunc(vm, PrintFunc, PrintFunc);
+    // Bind the type and the probes
+    Sqrat::RootTable(vm).Bind(_SC("Vec3"), Sqrat::Class< Vec3, A >(vm, _SC("Vec3"))
+        .template Ctor< float, float, float >()
+        .Var(_SC("x"), &Vec3::x)
+        .Func(_SC("_add"), &Vec3::operator+));
+    Sqrat::RootTable(vm)
+        .Func(_SC("Allocations"), &Allocations)
+        .Func(_SC("Nanoseconds"), &Nanoseconds)
+        .SetValue(_SC("COUNT"), count);
+    // Run the loop and leave the results in the root table
+    Sqrat::Script script;
+    script.CompileString(_SC("local a = Vec3(1, 2, 3), b = Vec3(4, 5, 6), c = null;\n"
+                             "local n = Allocations(), t = Nanoseconds();\n"
+                             "for (local i = 0; i < COUNT; ++i) c = a + b;\n"
+                             "::ELAPSED <- Nanoseconds() - t;\n"
+                             "::ALLOCATED <- Allocations() - n;\n"
+                             "::RESULT <- c.x;\n"));
+    script.Run();
+    script.Release();
+    // Retrieve the results
+    Sqrat::RootTable root(vm);
+    const auto elapsed = root.GetSlot(_SC("ELAPSED")).Cast< SQInteger >();
+    const auto allocated = root.GetSlot(_SC("ALLOCATED")).Cast< SQInteger >();
+    const auto result = root.GetSlot(_SC("RESULT")).Cast< SQFloat >();
+    root.Release();
+    const double per_op = static_cast< double >(allocated) / static_cast< double >(count);
+    std::printf("%-10s %10lld %14.2f %12.1f\n", name, static_cast< long long >(count), per_op,
+                static_cast< double >(elapsed) / static_cast< double >(count));
+    // Release everything that belongs to the virtual machine
+    Sqrat::GetVMContext(vm)->classes.clear();
+    delete Sqrat::GetVMContext(vm);
+    sq_close(vm);
+    // The sum must be correct as well
+    return (result == 5.0f) ? per_op : -1.0;
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+    const SQInteger scale = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 10;
+    // The virtual machine allocates through rpmalloc, same as in the plug-in
+    if (rpmalloc_initialize() != 0)
+    {
+        std::fprintf(stderr, "Failed to initialize memory allocator\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("%-10s %10s %14s %12s\n", "allocator", "a + b", "allocs/op", "ns/op");
+    const double def = Run< Sqrat::DefaultAllocator< Vec3 > >("default", scale * 100000);
+    const double inl = Run< Sqrat::InlineAllocator< Vec3 > >("inline", scale * 100000);
+    rpmalloc_finalize();
+    // The default allocator must allocate, otherwise the counter is not working
+    if (def <= 0.0)
+    {
+        std::fprintf(stderr, "The default allocator made no allocations or gave a wrong sum\n");
+        return EXIT_FAILURE;
+    }
+    // The inline allocator must not allocate at all
+    else if (inl != 0.0)
+    {
+        std::fprintf(stderr, "The inline allocator made allocations or gave a wrong sum\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
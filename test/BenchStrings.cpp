@@ -0,0 +1,106 @@
+// ------------------------------------------------------------------------------------------------
+#include <squirrel.h>
+#include <rpmalloc.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+/* ------------------------------------------------------------------------------------------------
+ * Measures string interning and table lookup throughput of the virtual machine. Every key is pushed
+ * as a string (which interns it) and used as a slot in a table, then looked up again by pushing the
+ * same text, which has to find the interned string and then the slot. Two sets of keys are used:
+ * short distinct keys and long keys which share most of their characters.
+ *
+ * Usage: BenchStrings [scale]
+*/
+
+// ------------------------------------------------------------------------------------------------
+typedef std::chrono::steady_clock Clock;
+
+/* ------------------------------------------------------------------------------------------------
+ * Nanoseconds elapsed since the specified time-point, divided by the number of operations.
+*/
+static double PerOp(Clock::time_point start, size_t ops)
+{
+    const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - start);
+    return static_cast< double >(elapsed.count()) / static_cast< double >(ops ? ops : 1);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Insert the keys into a table and look them up again. Returns false if a lookup went wrong.
+*/
+static bool Run(HSQUIRRELVM vm, const char * name, const std::vector< std::string > & keys)
+{
+    sq_newtable(vm);
+    // Intern the keys and create the slots
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        sq_pushstring(vm, keys[i].c_str(), static_cast< SQInteger >(keys[i].size()));
+        sq_pushinteger(vm, static_cast< SQInteger >(i));
+        sq_newslot(vm, -3, SQFalse);
+    }
+    const double insert = PerOp(start, keys.size());
+    // Look every key up again
+    bool ok = true;
+    start = Clock::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        SQInteger val = -1;
+        sq_pushstring(vm, keys[i].c_str(), static_cast< SQInteger >(keys[i].size()));
+        if (SQ_FAILED(sq_get(vm, -2)) || SQ_FAILED(sq_getinteger(vm, -1, &val)))
+        {
+            ok = false;
+            break;
+        }
+        ok &= (val == static_cast< SQInteger >(i));
+        sq_pop(vm, 1);
+    }
+    const double lookup = PerOp(start, keys.size());
+    sq_pop(vm, 1);
+    std::printf("%-24s %8zu %14.1f %14.1f\n", name, keys.size(), insert, lookup);
+    return ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+    const size_t scale = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    // The virtual machine allocates through rpmalloc, same as in the plug-in
+    if (rpmalloc_initialize() != 0)
+    {
+        std::fprintf(stderr, "Failed to initialize memory allocator\n");
+        return EXIT_FAILURE;
+    }
+    HSQUIRRELVM vm = sq_open(1024);
+    std::vector< std::string > keys;
+    bool ok = true;
+    std::printf("%-24s %8s %14s %14s\n", "keys", "count", "insert ns/key", "lookup ns/key");
+    // Short distinct keys, like most identifiers in scripts
+    for (size_t i = 0; i < scale * 10000; ++i)
+    {
+        keys.push_back("key" + std::to_string(i));
+    }
+    ok &= Run(vm, "short", keys);
+    keys.clear();
+    // Long keys of the same length which share a long prefix, like chat lines or JSON documents
+    for (size_t i = 0; i < scale * 2000; ++i)
+    {
+        std::string k(248, 'x');
+        k.append(std::to_string(10000000 + i));
+        keys.push_back(std::move(k));
+    }
+    ok &= Run(vm, "long, shared prefix", keys);
+    sq_close(vm);
+    rpmalloc_finalize();
+    // Did any of the lookups fail?
+    if (!ok)
+    {
+        std::fprintf(stderr, "A key was not found or had the wrong value\n");
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,139 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core/TimerHeap.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+// ------------------------------------------------------------------------------------------------
+using namespace SqMod;
+
+/* ------------------------------------------------------------------------------------------------
+ * Measures the per-frame cost of scheduling routines/tasks through TimerHeap against the interval
+ * sweep that was used before it (every slot visited each frame and decremented by the frame delta).
+ * The clock advances by a fixed amount of time each frame and each timer count is measured with
+ * two profiles: busy timers with intervals between 10ms and 2s, where a large share of them expire
+ * every frame, and idle timers with intervals between 10s and 10min. The sweep always visits at
+ * least 1024 slots, same as the fixed arrays it used to go through.
+ *
+ * Usage: BenchTimers [frames] [timers...]
+*/
+
+// ------------------------------------------------------------------------------------------------
+static constexpr TimerHeap::Time FRAME_TIME = 16667; // Simulated frame duration in microseconds.
+
+// ------------------------------------------------------------------------------------------------
+typedef std::chrono::steady_clock Clock;
+
+/* ------------------------------------------------------------------------------------------------
+ * Generate the intervals (in milliseconds) of the specified number of timers.
+*/
+static std::vector< int32_t > MakeIntervals(size_t count, int32_t min, int32_t max)
+{
+    std::mt19937 rng(static_cast< uint32_t >(count));
+    std::uniform_int_distribution< int32_t > dist(min, max);
+    std::vector< int32_t > intervals(count);
+    for (auto & i : intervals)
+    {
+        i = dist(rng);
+    }
+    return intervals;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Run the timers through a TimerHeap. Returns the average nanoseconds per frame.
+*/
+static double RunHeap(const std::vector< int32_t > & intervals, size_t frames, size_t & fired)
+{
+    TimerHeap timers;
+    TimerHeap::Time now = FRAME_TIME;
+    for (size_t i = 0; i < intervals.size(); ++i)
+    {
+        timers.Schedule(static_cast< TimerHeap::Slot >(i), now + intervals[i] * 1000L);
+    }
+    const auto start = Clock::now();
+    for (size_t f = 0; f < frames; ++f)
+    {
+        now += FRAME_TIME;
+        timers.Expire(now, [&](TimerHeap::Slot slot, TimerHeap::Time deadline) {
+            ++fired;
+            timers.Schedule(slot, std::max(deadline + intervals[slot] * 1000L, now + 1));
+        });
+    }
+    const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - start);
+    return static_cast< double >(elapsed.count()) / static_cast< double >(frames);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Run the timers through the old interval sweep. Returns the average nanoseconds per frame.
+*/
+static double RunSweep(const std::vector< int32_t > & intervals, size_t frames, size_t & fired)
+{
+    std::vector< int32_t > remaining(intervals);
+    // Unused slots were still visited
+    if (remaining.size() < 1024)
+    {
+        remaining.resize(1024, 0);
+    }
+    const auto delta = static_cast< int32_t >(FRAME_TIME / 1000L);
+    const auto start = Clock::now();
+    for (size_t f = 0; f < frames; ++f)
+    {
+        for (size_t i = 0; i < remaining.size(); ++i)
+        {
+            if (remaining[i])
+            {
+                remaining[i] -= delta;
+                if (remaining[i] <= 0)
+                {
+                    ++fired;
+                    remaining[i] = intervals[i];
+                }
+            }
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - start);
+    return static_cast< double >(elapsed.count()) / static_cast< double >(frames);
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+    const size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    std::vector< size_t > counts{10, 1000, 100000};
+    // Were the timer counts specified?
+    if (argc > 2)
+    {
+        counts.clear();
+        for (int i = 2; i < argc; ++i)
+        {
+            counts.push_back(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+    // Busy and idle interval ranges, in milliseconds
+    const struct { const char * name; int32_t min, max; } profiles[] = {
+        {"busy", 10, 2000}, {"idle", 10000, 600000}
+    };
+    std::printf("%8s %10s %14s %14s %12s %12s\n", "profile", "timers", "heap ns/frame", "sweep ns/frame", "heap fired", "sweep fired");
+    for (const auto & p : profiles)
+    {
+        for (const size_t count : counts)
+        {
+            const std::vector< int32_t > intervals = MakeIntervals(count, p.min, p.max);
+            size_t heap_fired = 0, sweep_fired = 0;
+            const double heap = RunHeap(intervals, frames, heap_fired);
+            const double sweep = RunSweep(intervals, frames, sweep_fired);
+            std::printf("%8s %10zu %14.1f %14.1f %12zu %12zu\n", p.name, count, heap, sweep, heap_fired, sweep_fired);
+            // The heap carries the remainder between frames, so it can only fire more often than the sweep
+            if (heap_fired < sweep_fired)
+            {
+                std::fprintf(stderr, "The heap fired fewer timers than the sweep with %zu timers\n", count);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/* ------------------------------------------------------------------------------------------------
+ * Measures HTTP request throughput against the local server started by Harness.sh. The same number
+ * of GET requests goes through blocking Session.Get() calls on the main thread, then through the
+ * transfer engine (Session.AsyncGet) with the host limit on and off. Meant to be run through
+ * RunServer.sh, which expects "pass" (or the reason of the failure) in $SQMOD_TEST_RESULT.
+ * The timings are printed to the server console.
+*/
+
+// Longest time the whole benchmark may take (milliseconds)
+const TIMEOUT = 60000;
+// The server under test
+g_URL <- SqSysEnv.GetOr("SQMOD_TEST_HTTP_URL", "");
+// Number of sessions and requests per session (can be changed from the environment)
+g_Sessions <- SqSysEnv.GetOr("SQMOD_TEST_HTTP_SESSIONS", "64").tointeger();
+g_Requests <- SqSysEnv.GetOr("SQMOD_TEST_HTTP_REQUESTS", "8").tointeger();
+
+g_Failures <- [];
+g_Finished <- false;
+
+/* ------------------------------------------------------------------------------------------------
+ * Record the outcome and stop the server.
+*/
+function Finish()
+{
+    if (g_Finished) return;
+    g_Finished = true;
+    local result = g_Failures.len() == 0 ? "pass" : g_Failures.reduce(@(a, b) a + "; " + b);
+    SqStream.StringToFile(SqSysEnv.Get("SQMOD_TEST_RESULT"), result);
+    print("HTTP benchmark: " + result);
+    SqServer.Shutdown();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Print the time taken by a run.
+*/
+function Report(name, start)
+{
+    local ms = (SqChrono.EpochMicro() - start) / 1000.0;
+    local total = g_Sessions * g_Requests;
+    print(format("%-28s %6d requests %10.1f ms %10.1f req/s", name, total, ms, total * 1000.0 / ms));
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * One request at a time, each blocking the main thread until the response arrives.
+*/
+function Blocking()
+{
+    local sessions = array(g_Sessions).map(@(v) SqCPR.Session(g_URL));
+    local start = SqChrono.EpochMicro();
+    for (local r = 0; r < g_Requests; ++r)
+    {
+        foreach (s in sessions)
+        {
+            local res = s.Get();
+            if (res.StatusCode != 200) g_Failures.push("blocking request returned " + res.StatusCode);
+        }
+    }
+    Report("blocking perform", start);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Every request submitted at once to the transfer engine. Calls next when all of them completed.
+*/
+function Async(name, limit, next)
+{
+    SqCPR.Multi.SetHostLimit(limit);
+    local sessions = array(g_Sessions).map(@(v) SqCPR.Session(g_URL));
+    local pending = g_Sessions * g_Requests;
+    local start = SqChrono.EpochMicro();
+    foreach (s in sessions)
+    {
+        for (local r = 0; r < g_Requests; ++r)
+        {
+            s.AsyncGet(function(session, res) {
+                if (res.StatusCode != 200) g_Failures.push(name + " request failed: " + res.Error.Message);
+                if (--pending == 0)
+                {
+                    Report(name, start);
+                    // Keep the sessions alive until every request completed
+                    sessions.clear();
+                    next();
+                }
+            });
+        }
+    }
+}
+
+// Was the script started by the harness?
+if (g_URL == "")
+{
+    g_Failures.push("SQMOD_TEST_HTTP_URL is not set, run through Harness.sh");
+    Finish();
+}
+else
+{
+    Blocking();
+    Async("engine, host limit 8", 8, function() {
+        Async("engine, no host limit", 0, Finish);
+    });
+}
+
+// Don't wait forever if a callback never arrives
+SqRoutine(this, function() {
+    g_Failures.push("timed out");
+    Finish();
+}, TIMEOUT, 1);
@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# Start a local keep-alive HTTP server, run the specified command against it and stop it.
+# The command finds the server through SQMOD_TEST_HTTP_URL.
+# The port, the delay of each response (milliseconds) and the body size can be changed through
+# SQMOD_TEST_HTTP_PORT, SQMOD_TEST_HTTP_DELAY and SQMOD_TEST_HTTP_BODY.
+# Usage: Harness.sh command [arguments...]
+set -euo pipefail
+
+PYTHON=$(command -v python3) || { echo "Cannot find python3" >&2; exit 1; }
+PORT=${SQMOD_TEST_HTTP_PORT:-18080}
+DELAY=${SQMOD_TEST_HTTP_DELAY:-10}
+BODY=${SQMOD_TEST_HTTP_BODY:-512}
+
+PID=""
+cleanup() {
+    if [ -n "$PID" ]; then
+        kill "$PID" 2>/dev/null || true
+        wait "$PID" 2>/dev/null || true
+    fi
+}
+trap cleanup EXIT
+
+"$PYTHON" "$(dirname "$(realpath "$0")")/Server.py" "$PORT" "$DELAY" "$BODY" &
+PID=$!
+
+# Wait for the server to accept connections
+ready() {
+    "$PYTHON" - "$PORT" <<'PY'
+import socket, sys
+socket.create_connection(("127.0.0.1", int(sys.argv[1])), timeout=1).close()
+PY
+}
+for _ in $(seq 1 50); do
+    if ready 2>/dev/null; then
+        break
+    fi
+    sleep 0.1
+done
+ready || { echo "The HTTP server did not start" >&2; exit 1; }
+
+export SQMOD_TEST_HTTP_URL="http://127.0.0.1:$PORT/"
+
+# Run the test itself
+"$@"
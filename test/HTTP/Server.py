@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+# Local HTTP/1.1 server with keep-alive and a fixed delay per request, used to measure HTTP clients.
+# Usage: Server.py port [delay-milliseconds] [body-bytes]
+import sys
+import time
+import http.server
+
+PORT = int(sys.argv[1])
+DELAY = float(sys.argv[2] if len(sys.argv) > 2 else 10) / 1000.0
+BODY = b"x" * int(sys.argv[3] if len(sys.argv) > 3 else 512)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    # Keep connections open between requests
+    protocol_version = "HTTP/1.1"
+    # Headers and body are written separately, don't let a reused connection wait for an ACK
+    disable_nagle_algorithm = True
+
+    def do_GET(self):
+        # Simulate the latency of a remote service
+        time.sleep(DELAY)
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(BODY)))
+        self.end_headers()
+        self.wfile.write(BODY)
+
+    def log_message(self, *args):
+        pass
+
+
+class Server(http.server.ThreadingHTTPServer):
+    # Many clients connect at once when the host limit is off
+    request_queue_size = 1024
+    daemon_threads = True
+
+
+Server(("127.0.0.1", PORT), Handler).serve_forever()
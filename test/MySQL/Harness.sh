@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+# Start a throwaway MariaDB/MySQL server, run the specified command against it and tear it down.
+# The command finds the server through these variables:
+#   SQMOD_TEST_MYSQL_HOST, SQMOD_TEST_MYSQL_PORT, SQMOD_TEST_MYSQL_SOCKET
+#   SQMOD_TEST_MYSQL_USER, SQMOD_TEST_MYSQL_PASS, SQMOD_TEST_MYSQL_NAME
+# Usage: Harness.sh command [arguments...]
+set -euo pipefail
+
+# Find the server tools (MariaDB names first, MySQL names as a fall-back)
+find_tool() {
+    for name in "$@"; do
+        for dir in "" /usr/sbin/ /usr/local/sbin/ /usr/libexec/; do
+            if command -v "${dir}${name}" >/dev/null 2>&1; then
+                command -v "${dir}${name}"
+                return 0
+            fi
+        done
+    done
+    echo "Cannot find any of: $*" >&2
+    return 1
+}
+SERVER=$(find_tool mariadbd mysqld)
+INSTALL=$(find_tool mariadb-install-db mysql_install_db)
+CLIENT=$(find_tool mariadb mysql)
+ADMIN=$(find_tool mariadb-admin mysqladmin)
+
+# Everything lives in a temporary directory which is removed on exit
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/sqmod-mysql.XXXXXX")
+PORT=${SQMOD_TEST_MYSQL_PORT:-33306}
+SOCKET="$WORK/mysql.sock"
+PID=""
+cleanup() {
+    if [ -n "$PID" ]; then
+        "$ADMIN" --no-defaults --socket="$SOCKET" -uroot shutdown >/dev/null 2>&1 || kill "$PID" 2>/dev/null || true
+        wait "$PID" 2>/dev/null || true
+    fi
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# Create the data directory and start the server on its own socket and port
+"$INSTALL" --no-defaults --datadir="$WORK/data" --user="$(id -un)" --auth-root-authentication-method=normal \
+    >"$WORK/install.log" 2>&1 || { cat "$WORK/install.log" >&2; exit 1; }
+"$SERVER" --no-defaults --datadir="$WORK/data" --socket="$SOCKET" --port="$PORT" --bind-address=127.0.0.1 \
+    --pid-file="$WORK/mysql.pid" --user="$(id -un)" --log-error="$WORK/error.log" &
+PID=$!
+
+# Wait for the server to accept connections
+for _ in $(seq 1 60); do
+    if "$ADMIN" --no-defaults --socket="$SOCKET" -uroot ping >/dev/null 2>&1; then
+        break
+    fi
+    sleep 0.5
+done
+"$ADMIN" --no-defaults --socket="$SOCKET" -uroot ping >/dev/null || { cat "$WORK/error.log" >&2; exit 1; }
+
+# Create the database and the account used by the tests
+"$CLIENT" --no-defaults --socket="$SOCKET" -uroot <<SQL
+CREATE DATABASE sqmod_test;
+CREATE USER 'sqmod'@'localhost' IDENTIFIED BY 'sqmod';
+CREATE USER 'sqmod'@'127.0.0.1' IDENTIFIED BY 'sqmod';
+GRANT ALL PRIVILEGES ON sqmod_test.* TO 'sqmod'@'localhost';
+GRANT ALL PRIVILEGES ON sqmod_test.* TO 'sqmod'@'127.0.0.1';
+SQL
+
+export SQMOD_TEST_MYSQL_HOST=127.0.0.1
+export SQMOD_TEST_MYSQL_PORT="$PORT"
+export SQMOD_TEST_MYSQL_SOCKET="$SOCKET"
+export SQMOD_TEST_MYSQL_USER=sqmod
+export SQMOD_TEST_MYSQL_PASS=sqmod
+export SQMOD_TEST_MYSQL_NAME=sqmod_test
+
+# Run the test itself
+"$@"
@@ -0,0 +1,143 @@
+/* ------------------------------------------------------------------------------------------------
+ * Exercises the asynchronous MySQL pool against the server started by Harness.sh. Meant to be run
+ * through RunServer.sh, which expects "pass" (or the reason of the failure) in $SQMOD_TEST_RESULT.
+*/
+
+// Number of connections in the pool
+const POOL_SIZE = 4;
+// Number of rows inserted concurrently, more than the pool has connections so that some must wait
+const ROW_COUNT = 64;
+
+g_Failures <- [];
+g_Pending <- 0;
+g_Finished <- false;
+
+/* ------------------------------------------------------------------------------------------------
+ * Record the outcome and stop the server.
+*/
+function Finish()
+{
+    if (g_Finished) return;
+    g_Finished = true;
+    local result = g_Failures.len() == 0 ? "pass" : g_Failures.reduce(@(a, b) a + "; " + b);
+    SqStream.StringToFile(SqSysEnv.Get("SQMOD_TEST_RESULT"), result);
+    print("MySQL pool test: " + result);
+    SqServer.Shutdown();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Remember a failed check.
+*/
+function Expect(cond, what)
+{
+    if (!cond) g_Failures.push(what);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Account for a finished task and move on to the next step once all of them are done.
+*/
+function Done(next)
+{
+    if (--g_Pending == 0) next();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Report unexpected errors and move on to the specified step.
+*/
+function Rejected(next)
+{
+    return function(pool, ctx, errno, error, query) {
+        g_Failures.push(format("%s failed with %d: %s", ctx, errno, error));
+        Done(next);
+    };
+}
+
+// The account created by the harness
+local acc = MySQL.Account(SqSysEnv.Get("SQMOD_TEST_MYSQL_HOST"), SqSysEnv.Get("SQMOD_TEST_MYSQL_USER"),
+                          SqSysEnv.Get("SQMOD_TEST_MYSQL_PASS"), SqSysEnv.Get("SQMOD_TEST_MYSQL_NAME"),
+                          SqSysEnv.Get("SQMOD_TEST_MYSQL_PORT").tointeger());
+g_Pool <- MySQL.Pool(acc, POOL_SIZE);
+// Check the connections before every task from now on
+g_Pool.PingInterval = 0;
+
+/* ------------------------------------------------------------------------------------------------
+ * Insert rows from several connections at once, with bound parameters.
+*/
+function Insert()
+{
+    for (local i = 0; i < ROW_COUNT; ++i)
+    {
+        ++g_Pending;
+        g_Pool.Insert("INSERT INTO pool_test (num, txt) VALUES (?, ?)")
+            .Bind([i, i % 2 ? null : "row " + i])
+            .Resolved(function(pool, ctx, id, query) {
+                Expect(id > 0, "insert id " + id);
+                Done(Check);
+            })
+            .Rejected(Rejected(Check))
+            .Submit("insert");
+    }
+    Expect(g_Pool.Waiting > 0, "no task had to wait for a connection");
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Read the rows back, then make sure errors are reported.
+*/
+function Check()
+{
+    ++g_Pending;
+    g_Pool.Query("SELECT num, txt FROM pool_test WHERE num >= ? ORDER BY num")
+        .Bind([0])
+        .Resolved(function(pool, ctx, res, query) {
+            Expect(res.Rows == ROW_COUNT, "expected " + ROW_COUNT + " rows, got " + res.Rows);
+            Expect(res.Columns == 2, "expected 2 columns, got " + res.Columns);
+            for (local r = 0; r < res.Rows; ++r)
+            {
+                Expect(res.GetInteger(r, 0) == r, "row " + r + " has number " + res.GetInteger(r, 0));
+                if (r % 2)
+                {
+                    Expect(res.IsNull(r, 1), "row " + r + " should have no text");
+                }
+                else
+                {
+                    Expect(res.GetString(r, 1) == "row " + r, "row " + r + " has text " + res.GetString(r, 1));
+                }
+            }
+            Done(Invalid);
+        })
+        .Rejected(Rejected(Invalid))
+        .Submit("select");
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * An invalid query must be rejected with the server error.
+*/
+function Invalid()
+{
+    ++g_Pending;
+    g_Pool.Execute("SELECT * FROM no_such_table")
+        .Resolved(function(pool, ctx, rows, query) {
+            g_Failures.push("query on a missing table succeeded");
+            Done(Finish);
+        })
+        .Rejected(function(pool, ctx, errno, error, query) {
+            Expect(errno != 0, "rejected without an error number");
+            Done(Finish);
+        })
+        .Submit("invalid");
+}
+
+// Start with a fresh table
+++g_Pending;
+g_Pool.Execute("CREATE TABLE pool_test (id INT AUTO_INCREMENT PRIMARY KEY, num INT NOT NULL, txt VARCHAR(32) NULL)")
+    .Resolved(function(pool, ctx, rows, query) {
+        Done(Insert);
+    })
+    .Rejected(Rejected(Finish))
+    .Submit("create");
+
+// Don't wait forever if a callback never arrives
+SqRoutine(this, function() {
+    g_Failures.push("timed out with " + g_Pending + " tasks pending");
+    Finish();
+}, 30000, 1);
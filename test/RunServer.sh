@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Run a script in a VC:MP server with the plug-in loaded and report the result it wrote.
+# The script must write "pass" (or the reason it failed) to $SQMOD_TEST_RESULT and shut the server down.
+# Usage: RunServer.sh server-executable plug-in script [timeout-seconds]
+set -euo pipefail
+
+SERVER=$(realpath "$1")
+PLUGIN=$(realpath "$2")
+SCRIPT=$(realpath "$3")
+TIMEOUT=${4:-60}
+
+# Give the server a directory of its own with just this plug-in and script
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/sqmod-server.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT
+mkdir "$WORK/plugins"
+ln -s "$PLUGIN" "$WORK/plugins/$(basename "$PLUGIN")"
+cat >"$WORK/server.cfg" <<CFG
+gamemode SqMod tests
+maxplayers 1
+port 0
+plugins $(basename "$PLUGIN" .so)
+CFG
+cat >"$WORK/sqmod.ini" <<INI
+[Log]
+ConsoleDebug=true
+ConsoleUser=true
+ConsoleSuccess=true
+ConsoleInfo=true
+ConsoleWarning=true
+ConsoleError=true
+ConsoleFatal=true
+
+[Scripts]
+Execute=$SCRIPT
+INI
+
+export SQMOD_TEST_RESULT="$WORK/result"
+# The script shuts the server down when it is done, the timeout only catches hangs
+(cd "$WORK" && timeout "$TIMEOUT" "$SERVER") || true
+
+if [ ! -f "$SQMOD_TEST_RESULT" ]; then
+    echo "The script did not report a result" >&2
+    exit 1
+fi
+RESULT=$(cat "$SQMOD_TEST_RESULT")
+echo "$(basename "$SCRIPT"): $RESULT"
+[ "$RESULT" = "pass" ]
@@ -0,0 +1,105 @@
+// ------------------------------------------------------------------------------------------------
+#include "sqpcheader.h"
+#include "sqstring.h"
+
+// ------------------------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+/* ------------------------------------------------------------------------------------------------
+ * Regression test for colliding string keys. Squirrel picks the bucket of a string by masking its
+ * hash with the node count of the table (or string table), so the keys below are checked against
+ * the bucket they would land in. The test uses two attacks:
+ *  - keys which collided under the old hash, which only sampled some of the characters of long strings
+ *  - keys brute forced to collide under a known seed, which must not collide under the seed of the process
+*/
+
+// ------------------------------------------------------------------------------------------------
+static constexpr size_t BUCKETS = 1024; // Number of buckets the keys are distributed over.
+static constexpr size_t MAX_LOAD = 32; // Most keys allowed in a single bucket with the process seed.
+static constexpr unsigned long long FIXED_SEED = 0x5EED5EED5EED5EEDULL; // Seed known by the attacker.
+
+/* ------------------------------------------------------------------------------------------------
+ * The string hash used before every character was hashed.
+*/
+static SQHash OldHash(const SQChar * s, size_t l)
+{
+    SQHash h = (SQHash)l;
+    size_t step = (l >> 5) | 1;
+    for (; l >= step; l -= step)
+    {
+        h = h ^ ((h << 5) + (h >> 2) + (unsigned short)*(s++));
+    }
+    return h;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * The current string hash with a seed that is known in advance.
+*/
+static SQHash FixedHash(const SQChar * s, size_t l)
+{
+    return (SQHash)XXH3_64bits_withSeed(s, sq_rsl(l), FIXED_SEED);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Find how many keys ended up in the most crowded bucket.
+*/
+template < class F > static size_t MaxLoad(const std::vector< std::string > & keys, F && hash)
+{
+    std::vector< size_t > buckets(BUCKETS, 0);
+    size_t max = 0;
+    for (const auto & k : keys)
+    {
+        const size_t n = ++buckets[hash(k.c_str(), k.size()) & (BUCKETS - 1)];
+        max = n > max ? n : max;
+    }
+    return max;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Report the outcome of a check. The load must either reach the specified limit or stay within it.
+*/
+static bool Check(const char * what, size_t load, size_t limit, bool collide)
+{
+    const bool ok = collide ? (load >= limit) : (load <= limit);
+    std::printf("%-52s max bucket load %6zu  %s\n", what, load, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+int main()
+{
+    bool ok = true;
+    // Long keys of the same length which only differ after the characters the old hash sampled
+    std::vector< std::string > sampled;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::string k(248, 'x');
+        k.append(std::to_string(10000000 + i));
+        sampled.push_back(std::move(k));
+    }
+    ok &= Check("shared prefix, old hash (should collide)", MaxLoad(sampled, OldHash), sampled.size(), true);
+    ok &= Check("shared prefix, process seed", MaxLoad(sampled, _hashstr), MAX_LOAD, false);
+    // Short keys which all land in the first bucket under a seed known to the attacker
+    std::vector< std::string > crafted;
+    for (size_t i = 0; crafted.size() < 256; ++i)
+    {
+        std::string k = "key" + std::to_string(i);
+        if ((FixedHash(k.c_str(), k.size()) & (BUCKETS - 1)) == 0)
+        {
+            crafted.push_back(std::move(k));
+        }
+    }
+    ok &= Check("crafted for a known seed, that seed (should collide)", MaxLoad(crafted, FixedHash), crafted.size(), true);
+    ok &= Check("crafted for a known seed, process seed", MaxLoad(crafted, _hashstr), MAX_LOAD, false);
+    // The process must not have ended up with the seed the attacker knows
+    if (_sq_hashseed == FIXED_SEED)
+    {
+        std::printf("the process seed is the known seed  FAILED\n");
+        ok = false;
+    }
+    // Did any of the checks fail?
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}